@@ -31,12 +31,89 @@
 #include <math.h>
 #include <assert.h>
 #include <Windows.h>
+#include <process.h>
 #include "Common.h"
 #include "Memory.h"
 #include "AudioFileReader.h"
 #include "AudioFileWriter.h"
+#include "PcmFileReader.h"
+#include "SampleMixer.h"
 #include "AudioFile.h"
 
+/** 读取所有样本值时，每次调用 AudioFileReader_read() 读取的每声道样本数 */
+#define READ_ALL_CHUNK_SAMPLE_COUNT_PER_CHANNEL     (44100 * 10)
+
+/** 实际样本数超出时长估计值时，每次扩大 buffer 的每声道样本数 */
+#define READ_ALL_GROW_SAMPLE_COUNT_PER_CHANNEL      (44100 * 30)
+
+/** 并行解码时每个范围的最小时长 (以秒为单位)，较短的音频不值得并行解码 */
+#define PARALLEL_DECODE_MIN_RANGE_SECONDS           60
+
+/** 并行解码时每个范围在起点之前预读的时长 (以秒为单位)，使解码器和重采样器在起点处已进入稳定状态 */
+#define PARALLEL_DECODE_PREROLL_SECONDS             2
+
+/** 预读阶段每次读取的每声道样本数 */
+#define PARALLEL_DECODE_PREROLL_CHUNK_SAMPLE_COUNT_PER_CHANNEL      4096
+
+/**
+ * 并行解码中的一个范围
+ */
+typedef struct {
+    /** 输入文件名，从内存读取时为 NULL */
+    const TCHAR                 *filename;
+    /** 从内存读取时的数据 */
+    const void                  *data;
+    /** 从内存读取时的数据大小 */
+    size_t                      size;
+    /** 输出样本类型 */
+    const AudioSampleType       *sampleType;
+
+    /** 已打开的 reader (第一个范围使用调用者打开的 reader, 其他范围为 NULL, 由解码线程自行打开) */
+    AudioFileReader             *reader;
+
+    /** 范围的起点 (每声道样本数) */
+    int64_t                     rangeStart;
+    /** 范围的终点 (不包含，每声道样本数)，最后一个范围为共享 buffer 的容量 */
+    int64_t                     rangeEnd;
+    /** 是否为最后一个范围 (读取到输入结束为止) */
+    bool                        isLastRange;
+
+    /** 所有范围共享的样本值 buffer */
+    AudioSampleValue_t          *samplesBuffer;
+
+    /** 最后一个范围超出共享 buffer 容量的样本值 */
+    AudioSampleValue_t          *overflowBuffer;
+    /** overflowBuffer 的容量 (每声道样本数) */
+    int                         overflowCapacity;
+    /** overflowBuffer 中的每声道样本数 */
+    int                         overflowSampleCount;
+
+    /** 所有范围已解码的每声道样本数之和，用于显示进度 */
+    volatile LONG64             *decodedSampleCount;
+    /** 总的每声道样本数 (估计值)，用于显示进度 */
+    int64_t                     expectingSampleCount;
+    /** 是否显示进度 (只在调用者线程中显示) */
+    bool                        reportProgress;
+
+    /** 解码线程的句柄 */
+    HANDLE                      threadHandle;
+
+    /** 是否成功解码了整个范围 */
+    bool                        succeeded;
+} ParallelDecodeRange;
+
+/** 并行解码的线程数，为 1 时不并行解码 */
+static int s_decodeThreadCount = 1;
+
+/** 要读取的时间范围的起点 (以秒为单位) */
+static double s_timeRangeStartSeconds = 0.0;
+
+/** 要读取的时间范围的时长 (以秒为单位)，小于等于 0 时读取到输入结束为止 */
+static double s_timeRangeDurationSeconds = 0.0;
+
+/** 在时间范围前后额外读取的上下文长度 (每声道样本数) */
+static int s_timeRangeContextLength = 0;
+
 AudioDataSource *AudioDataSource_alloc(void) {
     AudioDataSource *dataSource = MEMORY_ALLOC_STRUCT(AudioDataSource);
 
@@ -51,7 +128,12 @@ void AudioDataSource_free(AudioDataSource **objPtr) {
     AudioDataSource *obj = *objPtr;
 
     if (obj->sampleValues != NULL) {
-        Memory_free(&obj->sampleValues);
+        if (obj->_sampleValuesDeallocator != NULL) {
+            obj->_sampleValuesDeallocator(obj->sampleValues, obj->_sampleValuesDeallocatorArg);
+            obj->sampleValues = NULL;
+        } else {
+            Memory_free(&obj->sampleValues);
+        }
     }
 
     if (obj->filenameUtf8 != NULL) {
@@ -61,6 +143,39 @@ void AudioDataSource_free(AudioDataSource **objPtr) {
     Memory_free(objPtr);
 }
 
+void AudioDataSource_trim(AudioDataSource *obj, int offset, int length) {
+    if (offset < 0) {
+        offset = 0;
+    }
+    if (offset > obj->sampleCountPerChannel) {
+        offset = obj->sampleCountPerChannel;
+    }
+    if (length > (obj->sampleCountPerChannel - offset)) {
+        length = obj->sampleCountPerChannel - offset;
+    }
+
+    if ((offset == 0) && (length == obj->sampleCountPerChannel)) {
+        return;
+    }
+
+    size_t keptSize = MEMORY_ARRAY_SIZE(AudioSampleValue_t, ((size_t)length * obj->channelCount));
+
+    if (obj->_sampleValuesDeallocator != NULL) {
+        // 不是通过 Memory_alloc() 分配的样本值数组 (如内存映射文件) 复制保留的部分后释放
+        AudioSampleValue_t *sampleValues = (AudioSampleValue_t *)MEMORY_ALLOC_ARRAY(AudioSampleValue_t, ((size_t)length * obj->channelCount));
+        memcpy(sampleValues, (obj->sampleValues + ((size_t)offset * obj->channelCount)), keptSize);
+
+        obj->_sampleValuesDeallocator(obj->sampleValues, obj->_sampleValuesDeallocatorArg);
+        obj->_sampleValuesDeallocator = NULL;
+        obj->_sampleValuesDeallocatorArg = NULL;
+        obj->sampleValues = sampleValues;
+    } else {
+        memmove(obj->sampleValues, (obj->sampleValues + ((size_t)offset * obj->channelCount)), keptSize);
+    }
+
+    obj->sampleCountPerChannel = length;
+}
+
 AudioDataSource *AudioDataSource_createEmpty(AudioDataSource *objRef) {
     AudioDataSource *objDup = AudioDataSource_alloc();
 
@@ -80,55 +195,91 @@ AudioDataSource *AudioDataSource_createEmpty(AudioDataSource *objRef) {
 }
 
 void AudioDataSource_addSamples(AudioDataSource *obj, AudioDataSource *obj2) {
-    int samplesCountInTotal = obj->sampleCountPerChannel * obj->channelCount;
+    size_t samplesCountInTotal = (size_t)obj->sampleCountPerChannel * obj->channelCount;
 
-    for (int i = 0; i < samplesCountInTotal; i++) {
-        obj->sampleValues[i] += obj2->sampleValues[i];
-    }
+    const float *sources[] = { obj->sampleValues, obj2->sampleValues };
+    const float gains[] = { 1.0f, 1.0f };
+    SampleMixer_mix(obj->sampleValues, sources, gains, 2, samplesCountInTotal);
 }
 
 void AudioDataSource_subSamples(AudioDataSource *obj, AudioDataSource *obj2) {
-    int samplesCountInTotal = obj->sampleCountPerChannel * obj->channelCount;
+    size_t samplesCountInTotal = (size_t)obj->sampleCountPerChannel * obj->channelCount;
 
-    for (int i = 0; i < samplesCountInTotal; i++) {
-        obj->sampleValues[i] -= obj2->sampleValues[i];
-    }
+    const float *sources[] = { obj->sampleValues, obj2->sampleValues };
+    const float gains[] = { 1.0f, -1.0f };
+    SampleMixer_mix(obj->sampleValues, sources, gains, 2, samplesCountInTotal);
 }
 
-AudioDataSource *AudioFile_readAll(const TCHAR *filename, const AudioSampleType *outputSampleType) {
-    AudioFileReader *obj = AudioFileReader_open(filename, outputSampleType);
-    if (obj == NULL) {
-        return NULL;
-    }
+void AudioFile_setDecodeThreadCount(int threadCount) {
+    s_decodeThreadCount = (threadCount > 1) ? threadCount : 1;
+}
 
-    int expectingSamplesCountPerChannel = (int)ceil(obj->durationInSeconds * obj->outputSampleType->sampleRate);
+void AudioFile_setTimeRange(double startSeconds, double durationSeconds, int contextLength) {
+    s_timeRangeStartSeconds = (startSeconds > 0.0) ? startSeconds : 0.0;
+    s_timeRangeDurationSeconds = (durationSeconds > 0.0) ? durationSeconds : 0.0;
+    s_timeRangeContextLength = (contextLength > 0) ? contextLength : 0;
+}
 
-    int samplesBufferSize = sizeof(AudioSampleValue_t) * (expectingSamplesCountPerChannel * obj->outputSampleType->channelCount);
-    AudioSampleValue_t *samplesBuffer = (AudioSampleValue_t *)Memory_alloc(samplesBufferSize);
+/**
+ * 判断是否只读取部分时间范围
+ */
+static bool _hasTimeRange(void) {
+    return ((s_timeRangeStartSeconds > 0.0) || (s_timeRangeDurationSeconds > 0.0));
+}
 
-    int totalSamplesCountPerChannel = 0;
-    int didReadSampleCountPerChannel = 0;
-    AudioSampleValue_t *samplesBufferPtr = samplesBuffer;
-    do {
-        int samplesBufferRemainingSampleCountPerChannel = expectingSamplesCountPerChannel - totalSamplesCountPerChannel;
+/**
+ * 获取要读取的样本范围 (包含前后的上下文)
+ *
+ * @param   readStartOut            读取的起点 (每声道样本数)
+ * @param   readLengthOut           读取的长度 (每声道样本数)，读取到输入结束为止时为 -1
+ */
+static void _getTimeRangeReadRange(int sampleRate, int64_t *readStartOut, int64_t *readLengthOut) {
+    int64_t rangeStart = llround(s_timeRangeStartSeconds * sampleRate);
+    int64_t contextLengthAtBegin = (rangeStart < s_timeRangeContextLength) ? rangeStart : s_timeRangeContextLength;
 
-        didReadSampleCountPerChannel = AudioFileReader_read(obj, samplesBufferPtr, samplesBufferRemainingSampleCountPerChannel);
-        if (didReadSampleCountPerChannel < 0) {
-            break;
-        }
+    *readStartOut = rangeStart - contextLengthAtBegin;
+    *readLengthOut = (s_timeRangeDurationSeconds > 0.0)
+            ? (contextLengthAtBegin + llround(s_timeRangeDurationSeconds * sampleRate) + s_timeRangeContextLength) : -1;
+}
 
-        samplesBufferPtr += didReadSampleCountPerChannel * obj->outputSampleType->channelCount;
+/**
+ * 根据实际读取到的样本数，设置 AudioDataSource 中前后上下文的长度
+ */
+static void _setTimeRangeContextLengths(AudioDataSource *dataSource) {
+    int64_t rangeStart = llround(s_timeRangeStartSeconds * dataSource->sampleRate);
+    int contextLengthAtBegin = (int)((rangeStart < s_timeRangeContextLength) ? rangeStart : s_timeRangeContextLength);
+    if (contextLengthAtBegin > dataSource->sampleCountPerChannel) {
+        contextLengthAtBegin = dataSource->sampleCountPerChannel;
+    }
 
-        totalSamplesCountPerChannel += didReadSampleCountPerChannel;
-        if (totalSamplesCountPerChannel >= expectingSamplesCountPerChannel) {
-            break;
+    int contextLengthAtEnd = 0;
+    if (s_timeRangeDurationSeconds > 0.0) {
+        int64_t rangeLength = llround(s_timeRangeDurationSeconds * dataSource->sampleRate);
+        int64_t lengthAfterRange = dataSource->sampleCountPerChannel - contextLengthAtBegin - rangeLength;
+        if (lengthAfterRange > 0) {
+            contextLengthAtEnd = (int)((lengthAfterRange < s_timeRangeContextLength) ? lengthAfterRange : s_timeRangeContextLength);
         }
+    }
 
-        Common_updateProgress(STAGE_AUDIO_FILE_READER, totalSamplesCountPerChannel, expectingSamplesCountPerChannel);
-    } while (didReadSampleCountPerChannel >= 0);
+    dataSource->contextLengthAtBegin = contextLengthAtBegin;
+    dataSource->contextLengthAtEnd = contextLengthAtEnd;
+}
 
-    Common_updateProgress(STAGE_AUDIO_FILE_READER, totalSamplesCountPerChannel, totalSamplesCountPerChannel);
+/**
+ * 打开音频文件或内存中的已编码音频数据
+ */
+static AudioFileReader *_openReader(const TCHAR *filename, const void *data, size_t size, const AudioSampleType *outputSampleType) {
+    if (filename != NULL) {
+        return AudioFileReader_open(filename, outputSampleType);
+    }
 
+    return AudioFileReader_openMemory(data, size, outputSampleType);
+}
+
+/**
+ * 使用已读取的样本值创建 AudioDataSource, 然后关闭 AudioFileReader
+ */
+static AudioDataSource *_createDataSourceAndClose(AudioFileReader *obj, AudioSampleValue_t *samplesBuffer, int sampleCountPerChannel) {
     size_t filenameUtf8ActualSizeInBytes = strlen(obj->filenameUtf8) + 1;
     char *filenameUtf8 = (char *)MEMORY_ALLOC_ARRAY(char, filenameUtf8ActualSizeInBytes);
     memcpy(filenameUtf8, obj->filenameUtf8, filenameUtf8ActualSizeInBytes);
@@ -143,12 +294,466 @@ AudioDataSource *AudioFile_readAll(const TCHAR *filename, const AudioSampleType
     dataSource->filenameUtf8 = filenameUtf8;
     dataSource->sampleRate = sampleRate;
     dataSource->sampleValues = samplesBuffer;
-    dataSource->sampleCountPerChannel = totalSamplesCountPerChannel;
+    dataSource->sampleCountPerChannel = sampleCountPerChannel;
     dataSource->channelCount = channelCount;
 
     return dataSource;
 }
 
+/**
+ * 从 reader 的当前位置读取并丢弃 targetPosition 之前的样本值，同一次读取中位于 targetPosition 之后的样本值复制到 destBuffer 中
+ *
+ * @return  成功时返回复制到 destBuffer 中的每声道样本数，在到达 targetPosition 之前结束、无法确定位置或已越过 targetPosition 时返回 -1
+ */
+static int _skipTo(AudioFileReader *reader, int64_t targetPosition, AudioSampleValue_t *destBuffer, int destCapacity) {
+    int channelCount = reader->outputSampleType->channelCount;
+
+    if (reader->position == targetPosition) {
+        return 0;
+    }
+
+    AudioSampleValue_t *prerollBuffer = MEMORY_ALLOC_ARRAY(AudioSampleValue_t, (PARALLEL_DECODE_PREROLL_CHUNK_SAMPLE_COUNT_PER_CHANNEL * channelCount));
+
+    int copiedSampleCountPerChannel = -1;
+
+    while (true) {
+        int didReadSampleCountPerChannel = AudioFileReader_read(reader, prerollBuffer, PARALLEL_DECODE_PREROLL_CHUNK_SAMPLE_COUNT_PER_CHANNEL);
+        if ((didReadSampleCountPerChannel < 0) || (reader->position < 0)) {
+            MSG_DEBUG(_T("skipping to %lld: no samples before the target position\n"), targetPosition);
+            break;
+        }
+
+        int64_t chunkStart = reader->position - didReadSampleCountPerChannel;
+        if (chunkStart > targetPosition) {
+            MSG_DEBUG(_T("skipping to %lld: seeking arrived at %lld\n"), targetPosition, chunkStart);
+            break;
+        }
+
+        if (reader->position > targetPosition) {
+            int64_t copyLength = reader->position - targetPosition;
+            if (copyLength > destCapacity) {
+                copyLength = destCapacity;
+            }
+            memcpy(destBuffer, (prerollBuffer + ((targetPosition - chunkStart) * channelCount)),
+                    MEMORY_ARRAY_SIZE(AudioSampleValue_t, (copyLength * channelCount)));
+
+            copiedSampleCountPerChannel = (int)copyLength;
+            break;
+        }
+    }
+
+    Memory_free(&prerollBuffer);
+
+    return copiedSampleCountPerChannel;
+}
+
+/**
+ * 从已打开的 AudioFileReader 读取 [readStart, readStart + readLength) 范围内的样本值，然后关闭该 AudioFileReader
+ *
+ * readStart 大于 0 时，可以定位的输入先定位到起点之前 PARALLEL_DECODE_PREROLL_SECONDS 秒处，预读后从起点开始使用样本值
+ * (定位失败时重新打开输入)，无法定位的输入从头读取并丢弃起点之前的样本值
+ *
+ * @param   readLength          要读取的每声道样本数，小于 0 时读取到输入结束为止
+ */
+static AudioDataSource *_readRangeAndClose(AudioFileReader *obj, const TCHAR *filename, const void *data, size_t size,
+        const AudioSampleType *outputSampleType, int64_t readStart, int64_t readLength) {
+    // 时长只是估计值 (从管道读取时可能未知)，实际样本数更多时扩大 buffer
+    int expectingSamplesCountPerChannel = (int)ceil(obj->durationInSeconds * outputSampleType->sampleRate - readStart);
+    if (readLength >= 0) {
+        expectingSamplesCountPerChannel = (int)readLength;
+    } else if (expectingSamplesCountPerChannel <= 0) {
+        MSG_DEBUG(_T("The duration of the input audio is unknown.\n"));
+        expectingSamplesCountPerChannel = 0;
+    }
+
+    int channelCount = outputSampleType->channelCount;
+
+    int samplesBufferCapacityPerChannel = (expectingSamplesCountPerChannel > 0)
+            ? expectingSamplesCountPerChannel : READ_ALL_GROW_SAMPLE_COUNT_PER_CHANNEL;
+    if ((readLength < 0) && (samplesBufferCapacityPerChannel < PARALLEL_DECODE_PREROLL_CHUNK_SAMPLE_COUNT_PER_CHANNEL)) {
+        // 跳过起点之前的样本值时，最后一次预读中位于起点之后的样本值需要全部放入 buffer
+        samplesBufferCapacityPerChannel = PARALLEL_DECODE_PREROLL_CHUNK_SAMPLE_COUNT_PER_CHANNEL;
+    }
+    AudioSampleValue_t *samplesBuffer = (AudioSampleValue_t *)MEMORY_ALLOC_ARRAY(AudioSampleValue_t,
+            ((size_t)samplesBufferCapacityPerChannel * channelCount));
+
+    int totalSamplesCountPerChannel = 0;
+
+    if (readStart > 0) {
+        bool skipped = false;
+
+        if (AudioFileReader_isSeekable(obj)) {
+            int64_t seekPosition = readStart - ((int64_t)PARALLEL_DECODE_PREROLL_SECONDS * outputSampleType->sampleRate);
+            if (AudioFileReader_seek(obj, ((seekPosition > 0) ? seekPosition : 0)) >= 0) {
+                totalSamplesCountPerChannel = _skipTo(obj, readStart, samplesBuffer, samplesBufferCapacityPerChannel);
+                skipped = (totalSamplesCountPerChannel >= 0);
+            }
+
+            if (!skipped) {
+                MSG_DEBUG(_T("Seeking to the start position failed, reading from the beginning.\n"));
+                AudioFileReader_close(&obj);
+                obj = _openReader(filename, data, size, outputSampleType);
+                if (obj == NULL) {
+                    Memory_free(&samplesBuffer);
+                    return NULL;
+                }
+            }
+        }
+
+        if (!skipped) {
+            totalSamplesCountPerChannel = _skipTo(obj, readStart, samplesBuffer, samplesBufferCapacityPerChannel);
+            if (totalSamplesCountPerChannel < 0) {
+                MSG_ERROR(_T("The start position is beyond the end of the input.\n"));
+                Memory_free(&samplesBuffer);
+                AudioFileReader_close(&obj);
+                return NULL;
+            }
+        }
+    }
+
+    while ((readLength < 0) || (totalSamplesCountPerChannel < readLength)) {
+        if (totalSamplesCountPerChannel == samplesBufferCapacityPerChannel) {
+            // 按比例扩大，使长度未知的长音频不会被反复复制
+            int growSampleCountPerChannel = samplesBufferCapacityPerChannel / 2;
+            if (growSampleCountPerChannel < READ_ALL_GROW_SAMPLE_COUNT_PER_CHANNEL) {
+                growSampleCountPerChannel = READ_ALL_GROW_SAMPLE_COUNT_PER_CHANNEL;
+            }
+            samplesBufferCapacityPerChannel += growSampleCountPerChannel;
+            samplesBuffer = (AudioSampleValue_t *)Memory_realloc(samplesBuffer,
+                    MEMORY_ARRAY_SIZE(AudioSampleValue_t, ((size_t)samplesBufferCapacityPerChannel * channelCount)));
+        }
+
+        // 每次最多读取一个进度更新间隔的样本数，使进度显示保持更新
+        int readSampleCountPerChannel = samplesBufferCapacityPerChannel - totalSamplesCountPerChannel;
+        if (readSampleCountPerChannel > READ_ALL_CHUNK_SAMPLE_COUNT_PER_CHANNEL) {
+            readSampleCountPerChannel = READ_ALL_CHUNK_SAMPLE_COUNT_PER_CHANNEL;
+        }
+        if ((readLength >= 0) && (readSampleCountPerChannel > (readLength - totalSamplesCountPerChannel))) {
+            readSampleCountPerChannel = (int)(readLength - totalSamplesCountPerChannel);
+        }
+
+        int didReadSampleCountPerChannel = AudioFileReader_read(obj,
+                (samplesBuffer + ((size_t)totalSamplesCountPerChannel * channelCount)), readSampleCountPerChannel);
+        if (didReadSampleCountPerChannel < 0) {
+            if (didReadSampleCountPerChannel != AVERROR_EOF) {
+                MSG_WARNING(_T("Decoding stopped because of an error, the audio may be incomplete.\n"));
+            }
+            break;
+        }
+
+        totalSamplesCountPerChannel += didReadSampleCountPerChannel;
+
+        Common_updateProgress(STAGE_AUDIO_FILE_READER, totalSamplesCountPerChannel,
+                ((totalSamplesCountPerChannel > expectingSamplesCountPerChannel) ? totalSamplesCountPerChannel : expectingSamplesCountPerChannel));
+    }
+
+    if (totalSamplesCountPerChannel == 0) {
+        MSG_ERROR(_T("No audio samples were read from the input.\n"));
+        Memory_free(&samplesBuffer);
+        AudioFileReader_close(&obj);
+        return NULL;
+    }
+
+    Common_updateProgress(STAGE_AUDIO_FILE_READER, totalSamplesCountPerChannel, totalSamplesCountPerChannel);
+
+    return _createDataSourceAndClose(obj, samplesBuffer, totalSamplesCountPerChannel);
+}
+
+/**
+ * 读取一段样本值到 buffer 中，并更新进度
+ *
+ * @return  成功时返回读取的每声道样本数，所有样本值都已读取或失败时返回小于 0 的错误码
+ */
+static int _readRangeChunk(ParallelDecodeRange *range, AudioFileReader *reader, AudioSampleValue_t *destBuffer, int64_t sampleCountPerChannel) {
+    if (sampleCountPerChannel > READ_ALL_CHUNK_SAMPLE_COUNT_PER_CHANNEL) {
+        sampleCountPerChannel = READ_ALL_CHUNK_SAMPLE_COUNT_PER_CHANNEL;
+    }
+
+    int didReadSampleCountPerChannel = AudioFileReader_read(reader, destBuffer, (int)sampleCountPerChannel);
+    if (didReadSampleCountPerChannel <= 0) {
+        return didReadSampleCountPerChannel;
+    }
+
+    LONG64 decodedSampleCount = InterlockedAdd64(range->decodedSampleCount, didReadSampleCountPerChannel);
+    if (range->reportProgress) {
+        Common_updateProgress(STAGE_AUDIO_FILE_READER, decodedSampleCount,
+                ((decodedSampleCount > range->expectingSampleCount) ? decodedSampleCount : range->expectingSampleCount));
+    }
+
+    return didReadSampleCountPerChannel;
+}
+
+/**
+ * 解码一个范围，写入共享 buffer 中该范围对应的位置
+ *
+ * 除第一个范围外，先定位到范围起点之前 PARALLEL_DECODE_PREROLL_SECONDS 秒处，
+ * 预读并丢弃起点之前的样本值，使各范围在起点处的样本值与顺序解码时相同
+ */
+static void _decodeRange(ParallelDecodeRange *range) {
+    int channelCount = range->sampleType->channelCount;
+
+    AudioFileReader *reader = range->reader;
+    if (reader == NULL) {
+        reader = _openReader(range->filename, range->data, range->size, range->sampleType);
+        if (reader == NULL) {
+            goto end;
+        }
+    }
+
+    int64_t position = 0;
+
+    if (range->rangeStart > 0) {
+        int64_t seekPosition = range->rangeStart - ((int64_t)PARALLEL_DECODE_PREROLL_SECONDS * range->sampleType->sampleRate);
+        if (AudioFileReader_seek(reader, ((seekPosition > 0) ? seekPosition : 0)) < 0) {
+            goto end;
+        }
+
+        // 预读阶段，丢弃范围起点之前的样本值 (定位到了范围起点之后时无法拼接)
+        int copiedSampleCountPerChannel = _skipTo(reader, range->rangeStart,
+                (range->samplesBuffer + (range->rangeStart * channelCount)), (int)(range->rangeEnd - range->rangeStart));
+        if (copiedSampleCountPerChannel < 0) {
+            goto end;
+        }
+
+        position = range->rangeStart + copiedSampleCountPerChannel;
+    }
+
+    // 直接读取到共享 buffer 中
+    while (position < range->rangeEnd) {
+        int didReadSampleCountPerChannel = _readRangeChunk(range, reader,
+                (range->samplesBuffer + (position * channelCount)), (range->rangeEnd - position));
+        if (didReadSampleCountPerChannel < 0) {
+            // 只有最后一个范围可以在到达终点之前结束
+            if ((didReadSampleCountPerChannel == AVERROR_EOF) && range->isLastRange) {
+                range->rangeEnd = position;
+                range->succeeded = true;
+            }
+            goto end;
+        }
+
+        position += didReadSampleCountPerChannel;
+    }
+
+    if (!range->isLastRange) {
+        range->succeeded = true;
+        goto end;
+    }
+
+    // 最后一个范围的实际样本数超出了时长估计值，其余样本值读取到单独的 buffer 中
+    while (true) {
+        if (range->overflowSampleCount == range->overflowCapacity) {
+            range->overflowCapacity += READ_ALL_GROW_SAMPLE_COUNT_PER_CHANNEL;
+            range->overflowBuffer = (AudioSampleValue_t *)Memory_realloc(range->overflowBuffer,
+                    MEMORY_ARRAY_SIZE(AudioSampleValue_t, ((size_t)range->overflowCapacity * channelCount)));
+        }
+
+        int didReadSampleCountPerChannel = _readRangeChunk(range, reader,
+                (range->overflowBuffer + ((size_t)range->overflowSampleCount * channelCount)),
+                (range->overflowCapacity - range->overflowSampleCount));
+        if (didReadSampleCountPerChannel < 0) {
+            range->succeeded = (didReadSampleCountPerChannel == AVERROR_EOF);
+            goto end;
+        }
+
+        range->overflowSampleCount += didReadSampleCountPerChannel;
+    }
+
+end:
+    // 调用者打开的 reader 由调用者关闭
+    if ((reader != NULL) && (reader != range->reader)) {
+        AudioFileReader_close(&reader);
+    }
+}
+
+static unsigned __stdcall _decodeRangeThreadProc(void *arg) {
+    _decodeRange((ParallelDecodeRange *)arg);
+
+    return 0;
+}
+
+/**
+ * 将音频分为多个范围同时解码，然后关闭 AudioFileReader
+ *
+ * @return  成功时返回包含所有样本值的 AudioDataSource 对象，任一范围失败时返回 NULL
+ */
+static AudioDataSource *_readAllInParallelAndClose(AudioFileReader *obj, const TCHAR *filename, const void *data, size_t size,
+        int rangeCount) {
+    AudioDataSource *dataSource = NULL;
+
+    int channelCount = obj->outputSampleType->channelCount;
+
+    int64_t expectingSamplesCountPerChannel = (int64_t)ceil(obj->durationInSeconds * obj->outputSampleType->sampleRate);
+    int64_t rangeLength = (expectingSamplesCountPerChannel + rangeCount - 1) / rangeCount;
+
+    AudioSampleValue_t *samplesBuffer = (AudioSampleValue_t *)MEMORY_ALLOC_ARRAY(AudioSampleValue_t,
+            ((size_t)expectingSamplesCountPerChannel * channelCount));
+
+    volatile LONG64 decodedSampleCount = 0;
+
+    ParallelDecodeRange *ranges = MEMORY_ALLOC_ARRAY(ParallelDecodeRange, rangeCount);
+    for (int i = 0; i < rangeCount; i++) {
+        ParallelDecodeRange *range = &ranges[i];
+
+        range->filename = filename;
+        range->data = data;
+        range->size = size;
+        range->sampleType = obj->outputSampleType;
+        range->reader = (i == 0) ? obj : NULL;
+        range->rangeStart = rangeLength * i;
+        range->isLastRange = (i == (rangeCount - 1));
+        range->rangeEnd = range->isLastRange ? expectingSamplesCountPerChannel : (rangeLength * (i + 1));
+        range->samplesBuffer = samplesBuffer;
+        range->decodedSampleCount = &decodedSampleCount;
+        range->expectingSampleCount = expectingSamplesCountPerChannel;
+        range->reportProgress = (i == 0);
+    }
+
+    // 第一个范围在当前线程中解码，其他范围各使用一个线程
+    for (int i = 1; i < rangeCount; i++) {
+        ranges[i].threadHandle = (HANDLE)_beginthreadex(NULL, 0, _decodeRangeThreadProc, &ranges[i], 0, NULL);
+        if (ranges[i].threadHandle == NULL) {
+            MSG_WARNING(_T("Failed to start decoding thread, decoding in the current thread.\n"));
+            _decodeRange(&ranges[i]);
+        }
+    }
+
+    _decodeRange(&ranges[0]);
+
+    bool succeeded = true;
+    for (int i = 0; i < rangeCount; i++) {
+        if (ranges[i].threadHandle != NULL) {
+            WaitForSingleObject(ranges[i].threadHandle, INFINITE);
+            CloseHandle(ranges[i].threadHandle);
+        }
+
+        if (!ranges[i].succeeded) {
+            succeeded = false;
+        }
+    }
+
+    ParallelDecodeRange *lastRange = &ranges[rangeCount - 1];
+
+    if (succeeded) {
+        int64_t totalSamplesCountPerChannel = lastRange->rangeEnd + lastRange->overflowSampleCount;
+
+        // 拼接最后一个范围超出时长估计值的部分
+        if (lastRange->overflowSampleCount > 0) {
+            samplesBuffer = (AudioSampleValue_t *)Memory_realloc(samplesBuffer,
+                    MEMORY_ARRAY_SIZE(AudioSampleValue_t, ((size_t)totalSamplesCountPerChannel * channelCount)));
+            memcpy((samplesBuffer + (lastRange->rangeEnd * channelCount)), lastRange->overflowBuffer,
+                    MEMORY_ARRAY_SIZE(AudioSampleValue_t, ((size_t)lastRange->overflowSampleCount * channelCount)));
+        }
+
+        Common_updateProgress(STAGE_AUDIO_FILE_READER, totalSamplesCountPerChannel, totalSamplesCountPerChannel);
+
+        dataSource = _createDataSourceAndClose(obj, samplesBuffer, (int)totalSamplesCountPerChannel);
+        samplesBuffer = NULL;
+    } else {
+        AudioFileReader_close(&obj);
+    }
+
+    for (int i = 0; i < rangeCount; i++) {
+        if (ranges[i].overflowBuffer != NULL) {
+            Memory_free(&ranges[i].overflowBuffer);
+        }
+    }
+    Memory_free(&ranges);
+
+    if (samplesBuffer != NULL) {
+        Memory_free(&samplesBuffer);
+    }
+
+    return dataSource;
+}
+
+/**
+ * 打开音频文件或内存中的已编码音频数据，并读取所有样本值
+ *
+ * 设置了多个解码线程，且输入可以定位、时长足够长时并行解码，并行解码失败时改为顺序解码
+ */
+static AudioDataSource *_readAll(const TCHAR *filename, const void *data, size_t size, const AudioSampleType *outputSampleType) {
+    AudioFileReader *obj = _openReader(filename, data, size, outputSampleType);
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    if ((filename != NULL) && _hasTimeRange()) {
+        // 只解码所需的时间范围及其前后的上下文
+        int64_t readStart = 0;
+        int64_t readLength = -1;
+        _getTimeRangeReadRange(outputSampleType->sampleRate, &readStart, &readLength);
+
+        AudioDataSource *dataSource = _readRangeAndClose(obj, filename, data, size, outputSampleType, readStart, readLength);
+        if (dataSource != NULL) {
+            _setTimeRangeContextLengths(dataSource);
+        }
+
+        return dataSource;
+    }
+
+    if ((s_decodeThreadCount > 1) && AudioFileReader_isSeekable(obj)) {
+        int rangeCount = (int)(obj->durationInSeconds / PARALLEL_DECODE_MIN_RANGE_SECONDS);
+        if (rangeCount > s_decodeThreadCount) {
+            rangeCount = s_decodeThreadCount;
+        }
+
+        if (rangeCount > 1) {
+            AudioDataSource *dataSource = _readAllInParallelAndClose(obj, filename, data, size, rangeCount);
+            if (dataSource != NULL) {
+                return dataSource;
+            }
+
+            MSG_WARNING(_T("Parallel decoding failed, decoding sequentially.\n"));
+
+            obj = _openReader(filename, data, size, outputSampleType);
+            if (obj == NULL) {
+                return NULL;
+            }
+        }
+    }
+
+    return _readRangeAndClose(obj, filename, data, size, outputSampleType, 0, -1);
+}
+
+AudioDataSource *AudioFile_readAll(const TCHAR *filename, const AudioSampleType *outputSampleType) {
+    if (filename == NULL) {
+        return NULL;
+    }
+
+    // 无需重采样的未压缩 PCM 文件直接映射读取，不经过解码器
+    AudioDataSource *dataSource = PcmFileReader_readAll(filename, outputSampleType);
+    if (dataSource != NULL) {
+        if (_hasTimeRange()) {
+            // 映射的文件只复制所需的时间范围及其前后的上下文
+            int64_t readStart = 0;
+            int64_t readLength = -1;
+            _getTimeRangeReadRange(outputSampleType->sampleRate, &readStart, &readLength);
+
+            if (readStart >= dataSource->sampleCountPerChannel) {
+                MSG_ERROR(_T("The start position is beyond the end of the input.\n"));
+                AudioDataSource_free(&dataSource);
+                return NULL;
+            }
+
+            AudioDataSource_trim(dataSource, (int)readStart,
+                    ((readLength >= 0) ? (int)readLength : (dataSource->sampleCountPerChannel - (int)readStart)));
+            _setTimeRangeContextLengths(dataSource);
+        }
+
+        return dataSource;
+    }
+
+    return _readAll(filename, NULL, 0, outputSampleType);
+}
+
+AudioDataSource *AudioFile_readAllFromMemory(const void *data, size_t size, const AudioSampleType *outputSampleType) {
+    if (data == NULL) {
+        return NULL;
+    }
+
+    return _readAll(NULL, data, size, outputSampleType);
+}
+
 bool AudioFile_writeAll(const TCHAR *filename, const AudioFileFormat *fileFormat, const AudioSampleType *inputSampleType,
         void *sampleValues, int sampleCountPerChannel) {
     AudioFileWriter *obj = AudioFileWriter_open(filename, fileFormat, inputSampleType);
@@ -158,9 +763,10 @@ bool AudioFile_writeAll(const TCHAR *filename, const AudioFileFormat *fileFormat
 
     int writtenSampleCountPerChannel = AudioFileWriter_write(obj, sampleValues, sampleCountPerChannel);
 
-    AudioFileWriter_close(&obj);
+    // 最后的帧和尾部信息在关闭时写入，关闭失败时文件不完整
+    bool closed = AudioFileWriter_close(&obj);
 
-    if (writtenSampleCountPerChannel != sampleCountPerChannel) {
+    if ((writtenSampleCountPerChannel != sampleCountPerChannel) || !closed) {
         return false;
     }
 
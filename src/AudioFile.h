@@ -56,6 +56,22 @@ typedef struct {
 
     /** 声道数 */
     int                     channelCount;
+
+    /**
+     * 样本值数组的释放函数，为 NULL 时使用 Memory_free() 释放
+     *
+     * 样本值数组不是通过 Memory_alloc() 分配时 (如来自内存映射文件) 由创建者设置
+     */
+    void                    (*_sampleValuesDeallocator)(AudioSampleValue_t *sampleValues, void *deallocatorArg);
+
+    /** 传递给 _sampleValuesDeallocator 的参数 */
+    void                    *_sampleValuesDeallocatorArg;
+
+    /** 开头仅作为模型上下文、不应输出的每声道样本数 (只读取部分时间范围时) */
+    int                     contextLengthAtBegin;
+
+    /** 结尾仅作为模型上下文、不应输出的每声道样本数 (只读取部分时间范围时) */
+    int                     contextLengthAtEnd;
 } AudioDataSource;
 
 /**
@@ -72,6 +88,15 @@ AudioDataSource *AudioDataSource_alloc(void);
  */
 void AudioDataSource_free(AudioDataSource **objPtr);
 
+/**
+ * 只保留 AudioDataSource 中 [offset, offset + length) 范围内的样本值
+ *
+ * @param   obj                     指向 AudioDataSource 结构体的指针
+ * @param   offset                  保留部分的起点 (每声道样本数)
+ * @param   length                  保留部分的长度 (每声道样本数)
+ */
+void AudioDataSource_trim(AudioDataSource *obj, int offset, int length);
+
 /**
  * 创建一个与 objRef 的信息相同，但样本值都为零的 AudioDataSource
  *
@@ -97,9 +122,34 @@ void AudioDataSource_addSamples(AudioDataSource *obj, AudioDataSource *obj2);
  */
 void AudioDataSource_subSamples(AudioDataSource *obj, AudioDataSource *obj2);
 
+/**
+ * 设置读取所有样本值时使用的解码线程数
+ *
+ * 大于 1 时，可以定位且足够长的输入会被分为多个范围同时解码 (每个范围在起点之前预读一段后开始使用样本值，
+ * 与顺序解码的结果一致)，任一范围失败时改为顺序解码
+ *
+ * @param   threadCount             解码线程数，默认为 1 (顺序解码)
+ */
+void AudioFile_setDecodeThreadCount(int threadCount);
+
+/**
+ * 设置 AudioFile_readAll() 只读取的时间范围
+ *
+ * 可以定位的输入定位到起点之前并预读一段后开始使用样本值，无法定位的输入从头读取并丢弃起点之前的样本值。
+ * 范围前后各额外读取 contextLength 的样本值作为模型的上下文，其长度记录在 AudioDataSource 的
+ * contextLengthAtBegin 和 contextLengthAtEnd 中
+ *
+ * @param   startSeconds            起点 (以秒为单位)，为 0 时从头开始
+ * @param   durationSeconds         时长 (以秒为单位)，为 0 时读取到输入结束为止
+ * @param   contextLength           范围前后额外读取的每声道样本数
+ */
+void AudioFile_setTimeRange(double startSeconds, double durationSeconds, int contextLength);
+
 /**
  * 打开一个音频文件，并读取所有样本值
  *
+ * 采样率和声道数与 outputSampleType 相同的未压缩 PCM 文件 (WAV, RF64, AIFF) 通过内存映射直接读取，不经过解码器
+ *
  * @param   filename                要读取音频文件的文件名
  * @param   outputSampleType        输出样本类型
  *
@@ -107,6 +157,17 @@ void AudioDataSource_subSamples(AudioDataSource *obj, AudioDataSource *obj2);
  */
 AudioDataSource *AudioFile_readAll(const TCHAR *filename, const AudioSampleType *outputSampleType);
 
+/**
+ * 从内存中的已编码音频数据 (完整的音频文件内容) 读取所有样本值
+ *
+ * @param   data                    已编码音频数据
+ * @param   size                    已编码音频数据的大小 (以字节为单位)
+ * @param   outputSampleType        输出样本类型
+ *
+ * @return  成功时返回包含所读取到样本值的 AudioDataSource 对象，失败时返回 NULL
+ */
+AudioDataSource *AudioFile_readAllFromMemory(const void *data, size_t size, const AudioSampleType *outputSampleType);
+
 /**
  * 创建一个音频文件，并写入指定的样本值
  *
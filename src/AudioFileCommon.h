@@ -25,6 +25,8 @@
 #ifndef _AUDIO_FILE_COMMON_H_
 #define _AUDIO_FILE_COMMON_H_
 
+#include "libavcodec/codec_id.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -63,6 +65,9 @@ typedef struct {
 
     /** 比特率 */
     int64_t                     bitRate;
+
+    /** 编码格式，为 AV_CODEC_ID_NONE 时使用文件格式默认的编码格式 */
+    enum AVCodecID              codecId;
 } AudioFileFormat;
 
 /**
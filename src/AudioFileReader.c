@@ -28,6 +28,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
+#include <emmintrin.h>
 #include "libavformat/avformat.h"
 #include "libavcodec/avcodec.h"
 #include "libswresample/swresample.h"
@@ -36,11 +37,219 @@
 #include "AudioFileCommon.h"
 #include "AudioFileReader.h"
 
-AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleType *outputSampleType) {
+/** 从内存读取时自定义 IO context 使用的 buffer 大小 */
+#define MEMORY_IO_BUFFER_SIZE       (64 * 1024)
+
+/** 快速打开时探测容器格式和流信息所读取的最大字节数 */
+#define FAST_OPEN_PROBE_SIZE        (256 * 1024)
+
+/** 快速打开时分析流信息的最大时长 (以 AV_TIME_BASE 为单位) */
+#define FAST_OPEN_ANALYZE_DURATION  (AV_TIME_BASE / 2)
+
+/** 使用多相重采样器时，每次由 libswresample 转换后提交给多相重采样器的每声道样本数 */
+#define POLYPHASE_RESAMPLER_INPUT_CHUNK_SAMPLE_COUNT_PER_CHANNEL    4096
+
+/** 文件的读取方式，blockSize 为 0 时使用 FFmpeg 默认的文件读取方式 */
+static FileInputStreamConfig s_fileInputConfig = { 0 };
+
+/** 指定的输入容器格式，为 NULL 时自动探测 */
+static const AVInputFormat *s_inputFormat = NULL;
+
+/** 指定的原始 PCM 输入的采样率 */
+static int s_inputSampleRate = 0;
+
+/** 指定的原始 PCM 输入的声道数 */
+static int s_inputChannelCount = 0;
+
+/** 转换采样率时使用的多相重采样器质量 */
+static PolyphaseResamplerQuality s_resamplerQuality = POLYPHASE_RESAMPLER_QUALITY_MEDIUM;
+
+/** 是否快速打开 */
+static bool s_fastOpen = false;
+
+void AudioFileReader_setFileInputConfig(const FileInputStreamConfig *config) {
+    s_fileInputConfig = *config;
+}
+
+void AudioFileReader_setResamplerQuality(PolyphaseResamplerQuality quality) {
+    s_resamplerQuality = quality;
+}
+
+void AudioFileReader_setFastOpen(bool fastOpen) {
+    s_fastOpen = fastOpen;
+}
+
+bool AudioFileReader_setInputFormat(const TCHAR *formatSpec) {
+    char formatName[32] = { '\0' };
+    int sampleRate = 0;
+    int channelCount = 0;
+
+    // 格式为 <格式名称>[:<采样率>[:<声道数>]]
+    const TCHAR *p = formatSpec;
+    size_t formatNameLength = 0;
+    while ((*p != _T('\0')) && (*p != _T(':'))) {
+        if (formatNameLength >= (sizeof(formatName) - 1)) {
+            return false;
+        }
+        formatName[formatNameLength++] = (char)*p++;
+    }
+
+    if (*p == _T(':')) {
+        sampleRate = _tstoi(++p);
+        if (sampleRate <= 0) {
+            return false;
+        }
+
+        p = _tcschr(p, _T(':'));
+        if (p != NULL) {
+            channelCount = _tstoi(++p);
+            if ((channelCount <= 0) || (channelCount > AV_NUM_DATA_POINTERS)) {
+                return false;
+            }
+        }
+    }
+
+    const AVInputFormat *inputFormat = av_find_input_format(formatName);
+    if (inputFormat == NULL) {
+        MSG_ERROR(_T("Unknown input format \"") _T(A_STR_FMT) _T("\".\n"), formatName);
+        return false;
+    }
+
+    s_inputFormat = inputFormat;
+    s_inputSampleRate = sampleRate;
+    s_inputChannelCount = channelCount;
+
+    return true;
+}
+
+bool AudioFileReader_isStandardInput(const TCHAR *filename) {
+    return (_tcscmp(filename, _T("-")) == 0) || (_tcsncmp(filename, _T("pipe:"), 5) == 0);
+}
+
+static int _memoryRead(void *opaque, uint8_t *buf, int bufSize) {
+    AudioFileReader *obj = (AudioFileReader *)opaque;
+
+    size_t remainingSize = obj->_memorySize - obj->_memoryPosition;
+    if (remainingSize == 0) {
+        return AVERROR_EOF;
+    }
+
+    int readSize = (remainingSize < (size_t)bufSize) ? (int)remainingSize : bufSize;
+    memcpy(buf, (obj->_memoryData + obj->_memoryPosition), readSize);
+    obj->_memoryPosition += readSize;
+
+    return readSize;
+}
+
+static int64_t _memorySeek(void *opaque, int64_t offset, int whence) {
+    AudioFileReader *obj = (AudioFileReader *)opaque;
+
+    int64_t newPosition;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return (int64_t)obj->_memorySize;
+
+        case SEEK_SET:
+            newPosition = offset;
+            break;
+
+        case SEEK_CUR:
+            newPosition = (int64_t)obj->_memoryPosition + offset;
+            break;
+
+        case SEEK_END:
+            newPosition = (int64_t)obj->_memorySize + offset;
+            break;
+
+        default:
+            return AVERROR(EINVAL);
+    }
+
+    if ((newPosition < 0) || (newPosition > (int64_t)obj->_memorySize)) {
+        return AVERROR(EINVAL);
+    }
+
+    obj->_memoryPosition = (size_t)newPosition;
+
+    return newPosition;
+}
+
+/**
+ * 查找第一个音频流
+ *
+ * @return  找到时返回音频流的 index, 未找到时返回 nb_streams
+ */
+static size_t _findAudioStream(const AVFormatContext *formatContext) {
+    size_t audioStreamIndex = 0;
+    while (audioStreamIndex < formatContext->nb_streams) {
+        if (formatContext->streams[audioStreamIndex]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+            break;
+        }
+
+        audioStreamIndex++;
+    }
+
+    return audioStreamIndex;
+}
+
+/**
+ * 快速打开时获取流信息
+ *
+ * 忽略音频流以外的流，容器的头信息中已有音频流的采样率和声道数时不读取 packet,
+ * 否则在 FAST_OPEN_PROBE_SIZE 和 FAST_OPEN_ANALYZE_DURATION 的限制内读取
+ *
+ * @return  成功时返回 true, 无法确定音频流的参数时返回 false
+ */
+static bool _findStreamInfoFast(AudioFileReader *obj) {
+    AVFormatContext *formatContext = obj->_inputFormatContext;
+
+    size_t audioStreamIndex = _findAudioStream(formatContext);
+
+    // 其他流 (视频、字幕、封面等) 的 packet 不需要读取和解码
+    for (size_t i = 0; i < formatContext->nb_streams; i++) {
+        if (i != audioStreamIndex) {
+            formatContext->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    const AVCodecParameters *codecpar = (audioStreamIndex < formatContext->nb_streams)
+            ? formatContext->streams[audioStreamIndex]->codecpar : NULL;
+    if ((codecpar != NULL) && (codecpar->codec_id != AV_CODEC_ID_NONE)
+            && (codecpar->sample_rate > 0) && (codecpar->ch_layout.nb_channels > 0)) {
+        MSG_DEBUG(_T("Fast open: audio parameters found in the header\n"));
+        return true;
+    }
+
+    int ret = avformat_find_stream_info(formatContext, NULL);
+    if (ret < 0) {
+        MSG_DEBUG(_T("Fast open: avformat_find_stream_info() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+        return false;
+    }
+
+    audioStreamIndex = _findAudioStream(formatContext);
+    if (audioStreamIndex == formatContext->nb_streams) {
+        return false;
+    }
+
+    codecpar = formatContext->streams[audioStreamIndex]->codecpar;
+
+    return ((codecpar->sample_rate > 0) && (codecpar->ch_layout.nb_channels > 0));
+}
+
+/**
+ * 打开音频文件或内存中的已编码音频数据
+ *
+ * @param   fastOpen            是否快速打开
+ * @param   fastOpenFailedOut   快速打开时无法确定音频流的参数 (应改为完整探测后重新打开) 时设为 true
+ */
+static AudioFileReader *_open(const TCHAR *filename, const void *data, size_t size, const AudioSampleType *outputSampleType,
+        bool fastOpen, bool *fastOpenFailedOut) {
     int ret;
     AudioFileReader *obj = NULL;
 
-    if ((filename == NULL) || (outputSampleType == NULL)) {
+    *fastOpenFailedOut = false;
+
+    if (((filename == NULL) && (data == NULL)) || (outputSampleType == NULL)) {
         goto err;
     }
 
@@ -50,7 +259,16 @@ AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleTy
         goto err;
     }
 
-    obj->filenameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(filename);
+    bool isStandardInput = (filename != NULL) && AudioFileReader_isStandardInput(filename);
+
+    if (isStandardInput) {
+        // 使用 FFmpeg 的 pipe 协议读取标准输入
+        obj->filenameUtf8 = _strdup("pipe:0");
+    } else if (filename != NULL) {
+        obj->filenameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(filename);
+    } else {
+        obj->filenameUtf8 = _strdup("memory");
+    }
     if (obj->filenameUtf8 == NULL) {
         MSG_ERROR(_T("converting filename to UTF-8 encoding failed\n"));
         goto err;
@@ -70,38 +288,94 @@ AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleTy
         goto err;
     }
 
-    // 打开输入文件，并读取头信息
-    ret = avformat_open_input(&obj->_inputFormatContext, obj->filenameUtf8, NULL, NULL);
-    if (ret < 0) {
-        MSG_ERROR(_T("avformat_open_input() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
-        goto err;
+    if (filename == NULL) {
+        // 从内存读取，使用自定义的 IO context
+        obj->_memoryData = (const uint8_t *)data;
+        obj->_memorySize = size;
+        obj->_memoryPosition = 0;
+
+        uint8_t *ioBuffer = (uint8_t *)av_malloc(MEMORY_IO_BUFFER_SIZE);
+        if (ioBuffer == NULL) {
+            MSG_ERROR(_T("allocating IO buffer failed\n"));
+            goto err;
+        }
+
+        obj->_customIoContext = avio_alloc_context(ioBuffer, MEMORY_IO_BUFFER_SIZE, 0, obj, _memoryRead, NULL, _memorySeek);
+        if (obj->_customIoContext == NULL) {
+            av_free(ioBuffer);
+            MSG_ERROR(_T("avio_alloc_context() failed\n"));
+            goto err;
+        }
+
+        obj->_inputFormatContext->pb = obj->_customIoContext;
+    } else if ((s_fileInputConfig.blockSize > 0) && !isStandardInput) {
+        // 从文件读取，使用较大的 buffer, 并按配置使用内存映射或后台预读
+        obj->_fileInputStream = FileInputStream_open(filename, &s_fileInputConfig);
+        if (obj->_fileInputStream == NULL) {
+            goto err;
+        }
+
+        uint8_t *ioBuffer = (uint8_t *)av_malloc(s_fileInputConfig.blockSize);
+        if (ioBuffer == NULL) {
+            MSG_ERROR(_T("allocating IO buffer failed\n"));
+            goto err;
+        }
+
+        obj->_customIoContext = avio_alloc_context(ioBuffer, s_fileInputConfig.blockSize, 0, obj->_fileInputStream,
+                FileInputStream_read, NULL, FileInputStream_seek);
+        if (obj->_customIoContext == NULL) {
+            av_free(ioBuffer);
+            MSG_ERROR(_T("avio_alloc_context() failed\n"));
+            goto err;
+        }
+
+        obj->_inputFormatContext->pb = obj->_customIoContext;
     }
 
-    // 读取文件中的 packets, 获取 stream 信息
-    ret = avformat_find_stream_info(obj->_inputFormatContext, NULL);
-    if (ret < 0) {
-        MSG_ERROR(_T("avformat_find_stream_info() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
-        goto err;
+    // 指定了原始 PCM 的采样率和声道数时，作为容器格式的选项传入
+    AVDictionary *inputFormatOptions = NULL;
+    if (s_inputSampleRate > 0) {
+        av_dict_set_int(&inputFormatOptions, "sample_rate", s_inputSampleRate, 0);
+    }
+    if (s_inputChannelCount > 0) {
+        AVChannelLayout inputChannelLayout;
+        char inputChannelLayoutDescription[64];
+        av_channel_layout_default(&inputChannelLayout, s_inputChannelCount);
+        av_channel_layout_describe(&inputChannelLayout, inputChannelLayoutDescription, sizeof(inputChannelLayoutDescription));
+        av_dict_set(&inputFormatOptions, "ch_layout", inputChannelLayoutDescription, 0);
     }
 
-    // 计算总时长
-    double durationInSeconds = (double)((double)obj->_inputFormatContext->duration / (double)AV_TIME_BASE);
-    obj->durationInSeconds = durationInSeconds;
+    // 快速打开时限制探测所读取的数据量
+    if (fastOpen) {
+        obj->_inputFormatContext->probesize = FAST_OPEN_PROBE_SIZE;
+        obj->_inputFormatContext->max_analyze_duration = FAST_OPEN_ANALYZE_DURATION;
+    }
 
-    if (g_verboseMode) {
-        av_dump_format(obj->_inputFormatContext, 0, obj->filenameUtf8, false);
-        MSG_INFO(_T("Duration: %lf seconds\n"), obj->durationInSeconds);
+    // 打开输入文件，并读取头信息
+    ret = avformat_open_input(&obj->_inputFormatContext, obj->filenameUtf8, s_inputFormat, &inputFormatOptions);
+    av_dict_free(&inputFormatOptions);
+    if (ret < 0) {
+        MSG_ERROR(_T("avformat_open_input() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+        goto err;
     }
 
-    // 查找第一个音频流
-    size_t audioStreamIndex = 0;
-    while (audioStreamIndex < obj->_inputFormatContext->nb_streams) {
-        if (obj->_inputFormatContext->streams[audioStreamIndex]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-            break;
+    if (fastOpen) {
+        // 只获取音频流的信息
+        if (!_findStreamInfoFast(obj)) {
+            *fastOpenFailedOut = true;
+            goto err;
+        }
+    } else {
+        // 读取文件中的 packets, 获取 stream 信息
+        ret = avformat_find_stream_info(obj->_inputFormatContext, NULL);
+        if (ret < 0) {
+            MSG_ERROR(_T("avformat_find_stream_info() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+            goto err;
         }
-
-        audioStreamIndex++;
     }
+
+    // 查找第一个音频流
+    size_t audioStreamIndex = _findAudioStream(obj->_inputFormatContext);
     if (audioStreamIndex == obj->_inputFormatContext->nb_streams) {
         MSG_ERROR(_T("audio stream not found\n"));
         goto err;
@@ -110,6 +384,20 @@ AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleTy
 
     AVStream *stream = obj->_inputFormatContext->streams[audioStreamIndex];
 
+    // 计算总时长 (从管道读取等情况下可能未知，快速打开时未估计容器的总时长，使用音频流的时长)
+    if (obj->_inputFormatContext->duration != AV_NOPTS_VALUE) {
+        obj->durationInSeconds = (double)obj->_inputFormatContext->duration / (double)AV_TIME_BASE;
+    } else if ((stream->duration != AV_NOPTS_VALUE) && (stream->duration > 0)) {
+        obj->durationInSeconds = (double)stream->duration * av_q2d(stream->time_base);
+    } else {
+        obj->durationInSeconds = 0.0;
+    }
+
+    if (g_verboseMode) {
+        av_dump_format(obj->_inputFormatContext, 0, obj->filenameUtf8, false);
+        MSG_INFO(_T("Duration: %lf seconds\n"), obj->durationInSeconds);
+    }
+
     // 获取音频流的 decoder
     obj->_audioDecoder = avcodec_find_decoder(stream->codecpar->codec_id);
     if (obj->_audioDecoder == NULL) {
@@ -146,6 +434,14 @@ AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleTy
         goto err;
     }
 
+    // 快速打开时未解码任何 frame, 解码器的参数可能仍未确定
+    if (fastOpen && ((obj->_audioDecoderContext->sample_fmt == AV_SAMPLE_FMT_NONE)
+            || (obj->_audioDecoderContext->sample_rate <= 0) || (obj->_audioDecoderContext->ch_layout.nb_channels <= 0))) {
+        MSG_DEBUG(_T("Fast open: the decoder parameters are unknown\n"));
+        *fastOpenFailedOut = true;
+        goto err;
+    }
+
     // 获取输出声道布局
     AVChannelLayout outputChannelLayout;
     if (outputSampleType->channelCount == 1) {
@@ -164,12 +460,23 @@ AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleTy
         goto err;
     }
 
+    // 输出 32 位浮点数且需要转换采样率时，由多相重采样器转换采样率，libswresample 只转换样本值格式和声道布局
+    int resamplerOutputSampleRate = obj->outputSampleType->sampleRate;
+    if ((s_resamplerQuality != POLYPHASE_RESAMPLER_QUALITY_NONE) && (outputSampleFormat == AV_SAMPLE_FMT_FLT)
+            && (obj->_audioDecoderContext->sample_rate != obj->outputSampleType->sampleRate)) {
+        obj->_polyphaseResampler = PolyphaseResampler_create(obj->_audioDecoderContext->sample_rate,
+                obj->outputSampleType->sampleRate, obj->outputSampleType->channelCount, s_resamplerQuality);
+        if (obj->_polyphaseResampler != NULL) {
+            resamplerOutputSampleRate = obj->_audioDecoderContext->sample_rate;
+        }
+    }
+
     // 初始化 libswresample 重采样器的 context
     swr_alloc_set_opts2(
         &obj->_resamplerContext,                    // swresample context
         &outputChannelLayout,                       // [output] channel layout
         outputSampleFormat,                         // [output] sample format
-        obj->outputSampleType->sampleRate,          // [output] sample rate
+        resamplerOutputSampleRate,                  // [output] sample rate
         &obj->_audioDecoderContext->ch_layout,      // [input] channel layout
         obj->_audioDecoderContext->sample_fmt,      // [input] sample format
         obj->_audioDecoderContext->sample_rate,     // [input] sample rate
@@ -202,10 +509,34 @@ AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleTy
         goto err;
     }
 
-    // 设置 _resamplerOutputBuffer 的初始值为空
-    obj->_resamplerOutputBufferSampleCountPerChannel = 0;
-    obj->_resamplerOutputBufferSize = 0;
-    obj->_resamplerOutputBuffer = NULL;
+    // 重采样结果直接写入调用者的 buffer, 只支持交错存储的输出样本值格式
+    if (av_sample_fmt_is_planar(outputSampleFormat)) {
+        MSG_ERROR(_T("planar output sample format is not supported\n"));
+        goto err;
+    }
+    obj->_outputFrameSize = av_get_bytes_per_sample(outputSampleFormat) * obj->outputSampleType->channelCount;
+
+    // 解码器已输出目标采样率的 32 位浮点数 (交错或平面存储)，且声道布局相同时，不经过 libswresample
+    const AVChannelLayout *decoderChannelLayout = &obj->_audioDecoderContext->ch_layout;
+    obj->_passthrough = (outputSampleFormat == AV_SAMPLE_FMT_FLT)
+            && (resamplerOutputSampleRate == obj->_audioDecoderContext->sample_rate)
+            && ((obj->_audioDecoderContext->sample_fmt == AV_SAMPLE_FMT_FLT) || (obj->_audioDecoderContext->sample_fmt == AV_SAMPLE_FMT_FLTP))
+            && (decoderChannelLayout->nb_channels == outputChannelLayout.nb_channels)
+            && ((decoderChannelLayout->order == AV_CHANNEL_ORDER_UNSPEC) || (av_channel_layout_compare(decoderChannelLayout, &outputChannelLayout) == 0));
+    obj->_passthroughFrameOffset = 0;
+    obj->_passthroughFrameLength = 0;
+
+    if (obj->_passthrough) {
+        MSG_DEBUG(_T("Sample conversion: passthrough (%s)\n"),
+                ((obj->_audioDecoderContext->sample_fmt == AV_SAMPLE_FMT_FLTP) && (outputChannelLayout.nb_channels > 1)) ? _T("interleave") : _T("copy"));
+    } else {
+        MSG_DEBUG(_T("Sample conversion: libswresample%s\n"), ((obj->_polyphaseResampler != NULL) ? _T(" + polyphase resampler") : _T("")));
+    }
+
+    obj->_decoderDrained = false;
+    obj->_resamplerDrained = false;
+    obj->_positionPending = false;
+    obj->position = 0;
 
     return obj;
 
@@ -217,92 +548,386 @@ err:
     return NULL;
 }
 
-int AudioFileReader_read(AudioFileReader *obj, void *destBuffer, int destBufferSampleCountPerChannel) {
-    int ret;
+AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleType *outputSampleType) {
+    if (filename == NULL) {
+        return NULL;
+    }
 
-    // 从输入流中读取下一个 frame 为 packet
-    ret = av_read_frame(obj->_inputFormatContext, obj->_tempPacket);
-    if (ret < 0) {
-        return -1;
+    // 快速打开失败时改为完整探测 (标准输入无法重新读取，总是完整探测)
+    bool fastOpen = s_fastOpen && !AudioFileReader_isStandardInput(filename);
+    bool fastOpenFailed = false;
+
+    AudioFileReader *obj = _open(filename, NULL, 0, outputSampleType, fastOpen, &fastOpenFailed);
+    if ((obj == NULL) && fastOpenFailed) {
+        MSG_DEBUG(_T("Fast open failed, probing the whole input\n"));
+        obj = _open(filename, NULL, 0, outputSampleType, false, &fastOpenFailed);
     }
 
-    // 如果 packet 不是所找到音频流的，跳过
-    if (obj->_tempPacket->stream_index != obj->_audioStreamIndex) {
-        return 0;
+    return obj;
+}
+
+AudioFileReader *AudioFileReader_openMemory(const void *data, size_t size, const AudioSampleType *outputSampleType) {
+    if (data == NULL) {
+        return NULL;
     }
 
-    // 将该 packet 提交给解码器
-    ret = avcodec_send_packet(obj->_audioDecoderContext, obj->_tempPacket);
-    if (ret < 0) {
-        MSG_ERROR(_T("avcodec_send_packet() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
-        return -1;
+    bool fastOpenFailed = false;
+
+    AudioFileReader *obj = _open(NULL, data, size, outputSampleType, s_fastOpen, &fastOpenFailed);
+    if ((obj == NULL) && fastOpenFailed) {
+        MSG_DEBUG(_T("Fast open failed, probing the whole input\n"));
+        obj = _open(NULL, data, size, outputSampleType, false, &fastOpenFailed);
     }
 
-    // 从解码器获取可用的 frame
-    ret = avcodec_receive_frame(obj->_audioDecoderContext, obj->_tempFrame);
-    if ((ret == AVERROR(EAGAIN)) || (ret == AVERROR_EOF)) {
-        // those two return values are special and mean there is no output
-        // frame available, but there were no errors during decoding
-        return 0;
-    } else if (ret < 0) {
-        MSG_ERROR(_T("avcodec_receive_frame() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+    return obj;
+}
+
+/**
+ * 获取 frame 的起始位置 (输出采样率下的每声道样本数)，无法确定时返回 -1
+ */
+static int64_t _getFramePosition(const AudioFileReader *obj, const AVFrame *frame) {
+    if (frame->best_effort_timestamp == AV_NOPTS_VALUE) {
         return -1;
     }
 
-    // 获取输出样本值格式
-    enum AVSampleFormat outputSampleFormat = AudioFileCommon_getAvSampleFormat(obj->outputSampleType->sampleValueFormat);
+    AVStream *stream = obj->_inputFormatContext->streams[obj->_audioStreamIndex];
 
-    // 分配输出 buffer 的空间
-    int resamplerUpperBoundOutputSampleCountPerChannel = swr_get_out_samples(obj->_resamplerContext, obj->_tempFrame->nb_samples);
-    if ((obj->_resamplerOutputBuffer == NULL)
-            || (resamplerUpperBoundOutputSampleCountPerChannel > obj->_resamplerOutputBufferSampleCountPerChannel)) {
-        // 如果是扩大 buffer 空间的情况，先释放原有空间
-        if (obj->_resamplerOutputBuffer != NULL) {
-            av_freep(&obj->_resamplerOutputBuffer);
-        }
+    int64_t timestamp = frame->best_effort_timestamp;
+    if (stream->start_time != AV_NOPTS_VALUE) {
+        timestamp -= stream->start_time;
+    }
 
-        obj->_resamplerOutputBufferSampleCountPerChannel = resamplerUpperBoundOutputSampleCountPerChannel;
+    return av_rescale_q(timestamp, stream->time_base, (AVRational){ 1, obj->outputSampleType->sampleRate });
+}
 
-        obj->_resamplerOutputBufferSize = av_samples_get_buffer_size(NULL,
-                obj->outputSampleType->channelCount, resamplerUpperBoundOutputSampleCountPerChannel, outputSampleFormat, 1);
+/**
+ * 向解码器提交下一个属于音频流的 packet，到达文件末尾时提交冲刷请求
+ *
+ * @return  成功时返回 0, 失败时返回小于 0 的错误码
+ */
+static int _sendNextPacket(AudioFileReader *obj) {
+    int ret;
+
+    while (true) {
+        // 从输入流中读取下一个 packet
+        ret = av_read_frame(obj->_inputFormatContext, obj->_tempPacket);
+        if (ret == AVERROR_EOF) {
+            // 已到达文件末尾，提交空 packet 以取出解码器中剩余的 frame
+            ret = avcodec_send_packet(obj->_audioDecoderContext, NULL);
+            if (ret < 0) {
+                MSG_ERROR(_T("avcodec_send_packet() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+                return ret;
+            }
+
+            return 0;
+        } else if (ret < 0) {
+            MSG_ERROR(_T("av_read_frame() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+            return ret;
+        }
+
+        // 如果 packet 不是所找到音频流的，跳过
+        if (obj->_tempPacket->stream_index != obj->_audioStreamIndex) {
+            av_packet_unref(obj->_tempPacket);
+            continue;
+        }
 
-        obj->_resamplerOutputBuffer = (uint8_t*)av_malloc(obj->_resamplerOutputBufferSize);
-        if (obj->_resamplerOutputBuffer == NULL) {
-            MSG_ERROR(_T("allocating resampler output buffer failed\n"));
-            return -1;
+        // 将该 packet 提交给解码器 (之前的 frame 都已取出，因此不会返回 EAGAIN)
+        ret = avcodec_send_packet(obj->_audioDecoderContext, obj->_tempPacket);
+        av_packet_unref(obj->_tempPacket);
+        if (ret < 0) {
+            MSG_ERROR(_T("avcodec_send_packet() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+            return ret;
         }
+
+        return 0;
     }
+}
 
-    // 转换 frame 到输出 buffer
-    int outputSampleCountPerChannel = swr_convert(obj->_resamplerContext,
-            &obj->_resamplerOutputBuffer, obj->_resamplerOutputBufferSampleCountPerChannel,
-            (const uint8_t **)obj->_tempFrame->data, obj->_tempFrame->nb_samples);
-    if (outputSampleCountPerChannel < 0) {
-        MSG_ERROR(_T("swr_convert() failed\n"));
-        return -1;
+/**
+ * 判断解码得到的 frame 是否可以直通 (打开时的判断结果，且 frame 的格式与打开时相同)
+ */
+static bool _isPassthroughFrame(const AudioFileReader *obj, const AVFrame *frame) {
+    return obj->_passthrough
+            && (frame->format == obj->_audioDecoderContext->sample_fmt)
+            && (frame->sample_rate == obj->_audioDecoderContext->sample_rate)
+            && (frame->ch_layout.nb_channels == obj->outputSampleType->channelCount);
+}
+
+/**
+ * 将平面存储的双声道 32 位浮点数样本值交错存储
+ */
+static void _interleaveStereo(float *dest, const float *left, const float *right, int sampleCountPerChannel) {
+    int i = 0;
+
+    for (; (i + 4) <= sampleCountPerChannel; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+
+        _mm_storeu_ps((dest + (i * 2)), _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps((dest + (i * 2) + 4), _mm_unpackhi_ps(l, r));
     }
 
-    // 计算要复制到 destBuffer 的每声道样本数
-    int copySampleCountPerChannel = outputSampleCountPerChannel;
+    for (; i < sampleCountPerChannel; i++) {
+        dest[i * 2] = left[i];
+        dest[(i * 2) + 1] = right[i];
+    }
+}
+
+/**
+ * 将直通的 _tempFrame 中尚未复制的样本值复制到 destBuffer, 全部复制后释放 frame 的数据
+ *
+ * @return  复制的每声道样本数
+ */
+static int _copyPassthroughSamples(AudioFileReader *obj, uint8_t *destBuffer, int destBufferSampleCountPerChannel) {
+    AVFrame *frame = obj->_tempFrame;
+    int channelCount = obj->outputSampleType->channelCount;
+
+    int copySampleCountPerChannel = obj->_passthroughFrameLength - obj->_passthroughFrameOffset;
     if (copySampleCountPerChannel > destBufferSampleCountPerChannel) {
         copySampleCountPerChannel = destBufferSampleCountPerChannel;
     }
 
-    // 复制重采样结果到 destBuffer
-    if (copySampleCountPerChannel > 0) {
-        int copyDataLengthInBytes = av_samples_get_buffer_size(NULL,
-                obj->outputSampleType->channelCount, copySampleCountPerChannel, outputSampleFormat, 1);
-        assert(copyDataLengthInBytes <= obj->_resamplerOutputBufferSize);
+    int offset = obj->_passthroughFrameOffset;
 
-        memcpy(destBuffer, obj->_resamplerOutputBuffer, copyDataLengthInBytes);
+    if ((frame->format == AV_SAMPLE_FMT_FLTP) && (channelCount == 2)) {
+        _interleaveStereo((float *)destBuffer, ((const float *)frame->extended_data[0] + offset),
+                ((const float *)frame->extended_data[1] + offset), copySampleCountPerChannel);
+    } else {
+        // 交错存储，或只有一个声道的平面存储
+        memcpy(destBuffer, ((const uint8_t *)frame->extended_data[0] + ((size_t)offset * obj->_outputFrameSize)),
+                ((size_t)copySampleCountPerChannel * obj->_outputFrameSize));
     }
 
-    // 清扫临时 packet 的数据
-    av_packet_unref(obj->_tempPacket);
+    obj->_passthroughFrameOffset += copySampleCountPerChannel;
+
+    if (obj->_passthroughFrameOffset == obj->_passthroughFrameLength) {
+        av_frame_unref(frame);
+        obj->_passthroughFrameOffset = 0;
+        obj->_passthroughFrameLength = 0;
+    }
 
     return copySampleCountPerChannel;
 }
 
+/**
+ * 解码并通过 libswresample 转换样本值 (可以直通的 frame 直接复制)，直到填满 destBuffer 或所有样本值都已取出
+ *
+ * @return  成功时返回写入的每声道样本数 (所有样本值都已取出时为 0)，失败时返回小于 0 的错误码
+ */
+static int _decodeAndConvert(AudioFileReader *obj, void *destBuffer, int destBufferSampleCountPerChannel) {
+    int ret;
+
+    // 重采样器只需要一个非 NULL 的输入指针，以便在不冲刷的情况下取出已缓存的样本
+    const uint8_t *noInputData[AV_NUM_DATA_POINTERS] = { NULL };
+
+    int totalSampleCountPerChannel = 0;
+
+    while (totalSampleCountPerChannel < destBufferSampleCountPerChannel) {
+        uint8_t *outputPtr = (uint8_t *)destBuffer + ((size_t)totalSampleCountPerChannel * obj->_outputFrameSize);
+        int outputSpaceSampleCountPerChannel = destBufferSampleCountPerChannel - totalSampleCountPerChannel;
+
+        // 先取出上次读取时未能写入 destBuffer 的直通 frame 中的样本
+        if (obj->_passthroughFrameLength > 0) {
+            totalSampleCountPerChannel += _copyPassthroughSamples(obj, outputPtr, outputSpaceSampleCountPerChannel);
+            continue;
+        }
+
+        if (obj->_decoderDrained) {
+            if (obj->_resamplerDrained) {
+                break;
+            }
+
+            // 解码器已无更多 frame, 冲刷重采样器中剩余的样本 (包括重采样延迟部分)
+            ret = swr_convert(obj->_resamplerContext, &outputPtr, outputSpaceSampleCountPerChannel, NULL, 0);
+            if (ret < 0) {
+                MSG_ERROR(_T("swr_convert() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+                return ret;
+            }
+            if (ret == 0) {
+                obj->_resamplerDrained = true;
+            }
+
+            totalSampleCountPerChannel += ret;
+            continue;
+        }
+
+        // 先取出上次读取时未能写入 destBuffer, 而缓存在重采样器中的样本
+        ret = swr_convert(obj->_resamplerContext, &outputPtr, outputSpaceSampleCountPerChannel, noInputData, 0);
+        if (ret < 0) {
+            MSG_ERROR(_T("swr_convert() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+            return ret;
+        }
+        if (ret > 0) {
+            totalSampleCountPerChannel += ret;
+            continue;
+        }
+
+        // 从解码器获取下一个 frame, 没有可用的 frame 时提交下一个 packet
+        ret = avcodec_receive_frame(obj->_audioDecoderContext, obj->_tempFrame);
+        if (ret == AVERROR(EAGAIN)) {
+            ret = _sendNextPacket(obj);
+            if (ret < 0) {
+                return ret;
+            }
+            continue;
+        } else if (ret == AVERROR_EOF) {
+            obj->_decoderDrained = true;
+            continue;
+        } else if (ret < 0) {
+            MSG_ERROR(_T("avcodec_receive_frame() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+            return ret;
+        }
+
+        // 定位后的第一个 frame, 由其时间戳确定当前位置 (此时重采样器为空，尚未输出任何样本)
+        if (obj->_positionPending) {
+            obj->_positionPending = false;
+            obj->position = _getFramePosition(obj, obj->_tempFrame) - totalSampleCountPerChannel;
+        }
+
+        // 格式相同的 frame 直接复制到 destBuffer, 放不下的部分留在 _tempFrame 中
+        if (_isPassthroughFrame(obj, obj->_tempFrame)) {
+            obj->_passthroughFrameOffset = 0;
+            obj->_passthroughFrameLength = obj->_tempFrame->nb_samples;
+            if (obj->_passthroughFrameLength == 0) {
+                av_frame_unref(obj->_tempFrame);
+                continue;
+            }
+
+            totalSampleCountPerChannel += _copyPassthroughSamples(obj, outputPtr, outputSpaceSampleCountPerChannel);
+            continue;
+        }
+
+        // 将 frame 直接重采样到 destBuffer, 放不下的部分由重采样器缓存
+        ret = swr_convert(obj->_resamplerContext, &outputPtr, outputSpaceSampleCountPerChannel,
+                (const uint8_t **)obj->_tempFrame->extended_data, obj->_tempFrame->nb_samples);
+        av_frame_unref(obj->_tempFrame);
+        if (ret < 0) {
+            MSG_ERROR(_T("swr_convert() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+            return ret;
+        }
+
+        totalSampleCountPerChannel += ret;
+    }
+
+    return totalSampleCountPerChannel;
+}
+
+/**
+ * 通过多相重采样器读取样本值 (解码和 libswresample 转换的结果先写入多相重采样器的输入 buffer)
+ *
+ * @return  成功时返回写入的每声道样本数 (所有样本值都已取出时为 0)，失败时返回小于 0 的错误码
+ */
+static int _readResampled(AudioFileReader *obj, float *destBuffer, int destBufferSampleCountPerChannel) {
+    PolyphaseResampler *resampler = obj->_polyphaseResampler;
+    int channelCount = obj->outputSampleType->channelCount;
+
+    int totalSampleCountPerChannel = 0;
+
+    while (totalSampleCountPerChannel < destBufferSampleCountPerChannel) {
+        int didProcessSampleCountPerChannel = PolyphaseResampler_process(resampler,
+                (destBuffer + ((size_t)totalSampleCountPerChannel * channelCount)),
+                (destBufferSampleCountPerChannel - totalSampleCountPerChannel));
+        if (didProcessSampleCountPerChannel > 0) {
+            totalSampleCountPerChannel += didProcessSampleCountPerChannel;
+            continue;
+        }
+
+        // 已冲刷且全部输出
+        if (obj->_resamplerDrained) {
+            break;
+        }
+
+        float *inputBuffer = PolyphaseResampler_getInputBuffer(resampler, POLYPHASE_RESAMPLER_INPUT_CHUNK_SAMPLE_COUNT_PER_CHANNEL);
+        int didConvertSampleCountPerChannel = _decodeAndConvert(obj, inputBuffer, POLYPHASE_RESAMPLER_INPUT_CHUNK_SAMPLE_COUNT_PER_CHANNEL);
+        if (didConvertSampleCountPerChannel < 0) {
+            return didConvertSampleCountPerChannel;
+        }
+
+        if (didConvertSampleCountPerChannel == 0) {
+            // 输入已结束 (此时 _resamplerDrained 为 true)，取出多相重采样器中剩余的样本值
+            PolyphaseResampler_flush(resampler);
+            continue;
+        }
+
+        PolyphaseResampler_commitInput(resampler, didConvertSampleCountPerChannel);
+    }
+
+    return totalSampleCountPerChannel;
+}
+
+int AudioFileReader_read(AudioFileReader *obj, void *destBuffer, int destBufferSampleCountPerChannel) {
+    int totalSampleCountPerChannel = (obj->_polyphaseResampler != NULL)
+            ? _readResampled(obj, (float *)destBuffer, destBufferSampleCountPerChannel)
+            : _decodeAndConvert(obj, destBuffer, destBufferSampleCountPerChannel);
+    if (totalSampleCountPerChannel < 0) {
+        return totalSampleCountPerChannel;
+    }
+
+    if (obj->position >= 0) {
+        obj->position += totalSampleCountPerChannel;
+    }
+
+    if ((totalSampleCountPerChannel == 0) && obj->_resamplerDrained) {
+        return AVERROR_EOF;
+    }
+
+    return totalSampleCountPerChannel;
+}
+
+bool AudioFileReader_isSeekable(const AudioFileReader *obj) {
+    const AVIOContext *pb = obj->_inputFormatContext->pb;
+    if ((pb == NULL) || ((pb->seekable & AVIO_SEEKABLE_NORMAL) == 0)) {
+        return false;
+    }
+
+    return (obj->durationInSeconds > 0.0);
+}
+
+int AudioFileReader_seek(AudioFileReader *obj, int64_t samplePosition) {
+    int ret;
+
+    AVStream *stream = obj->_inputFormatContext->streams[obj->_audioStreamIndex];
+
+    int64_t timestamp = av_rescale_q(samplePosition, (AVRational){ 1, obj->outputSampleType->sampleRate }, stream->time_base);
+    if (stream->start_time != AV_NOPTS_VALUE) {
+        timestamp += stream->start_time;
+    }
+
+    // 定位到目标位置或其之前的位置
+    ret = avformat_seek_file(obj->_inputFormatContext, (int)obj->_audioStreamIndex, INT64_MIN, timestamp, timestamp, 0);
+    if (ret < 0) {
+        MSG_ERROR(_T("avformat_seek_file() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+        return ret;
+    }
+
+    // 清空解码器中的数据，重新初始化重采样器 (清空缓存的样本和延迟部分)
+    avcodec_flush_buffers(obj->_audioDecoderContext);
+
+    ret = swr_init(obj->_resamplerContext);
+    if (ret < 0) {
+        MSG_ERROR(_T("swr_init() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+        return ret;
+    }
+
+    if (obj->_polyphaseResampler != NULL) {
+        PolyphaseResampler_reset(obj->_polyphaseResampler);
+    }
+
+    // 丢弃未复制完的直通 frame
+    if (obj->_passthroughFrameLength > 0) {
+        av_frame_unref(obj->_tempFrame);
+        obj->_passthroughFrameOffset = 0;
+        obj->_passthroughFrameLength = 0;
+    }
+
+    obj->_decoderDrained = false;
+    obj->_resamplerDrained = false;
+    obj->_positionPending = true;
+    obj->position = -1;
+
+    return 0;
+}
+
 void AudioFileReader_close(AudioFileReader **objPtr) {
     if (objPtr == NULL) {
         return;
@@ -310,10 +935,6 @@ void AudioFileReader_close(AudioFileReader **objPtr) {
 
     AudioFileReader *obj = *objPtr;
 
-    if (obj->_resamplerOutputBuffer != NULL) {
-        av_freep(&obj->_resamplerOutputBuffer);
-    }
-
     if (obj->_tempFrame != NULL) {
         av_frame_free(&obj->_tempFrame);
     }
@@ -326,6 +947,10 @@ void AudioFileReader_close(AudioFileReader **objPtr) {
         swr_free(&obj->_resamplerContext);
     }
 
+    if (obj->_polyphaseResampler != NULL) {
+        PolyphaseResampler_free(&obj->_polyphaseResampler);
+    }
+
     if (obj->_audioDecoderContext != NULL) {
         avcodec_close(obj->_audioDecoderContext);
         obj->_audioDecoderContext = NULL;
@@ -335,6 +960,21 @@ void AudioFileReader_close(AudioFileReader **objPtr) {
         avformat_close_input(&obj->_inputFormatContext);
     }
 
+    // 自定义 IO context 不会被 avformat_close_input() 释放
+    if (obj->_customIoContext != NULL) {
+        av_freep(&obj->_customIoContext->buffer);
+        avio_context_free(&obj->_customIoContext);
+    }
+
+    if (obj->_fileInputStream != NULL) {
+        if (g_verboseMode) {
+            MSG_INFO(_T("Input I/O: %.1f MB read, %.3f seconds waiting for I/O\n"),
+                    ((double)obj->_fileInputStream->readByteCount / (1024.0 * 1024.0)), obj->_fileInputStream->ioWaitSeconds);
+        }
+
+        FileInputStream_close(&obj->_fileInputStream);
+    }
+
     if (obj->outputSampleType != NULL) {
         Memory_free(&obj->outputSampleType);
     }
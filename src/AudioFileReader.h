@@ -30,6 +30,8 @@
 #include "libavcodec/avcodec.h"
 #include "libswresample/swresample.h"
 #include "AudioFileCommon.h"
+#include "FileInputStream.h"
+#include "PolyphaseResampler.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,22 +48,41 @@ typedef struct {
     /** 文件名 (UTF-8 编码) */
     char                *filenameUtf8;
 
-    /** 音频总时长 (以秒为单位) */
+    /** 音频总时长 (以秒为单位)，未知时为 0 */
     double              durationInSeconds;
 
     /** 输出样本值的样本类型 */
     AudioSampleType     *outputSampleType;
 
+    /**
+     * 下一个要读取的样本在整个音频中的位置 (每声道样本数)
+     *
+     * 定位后由读取到的第一个 frame 的时间戳确定，无法确定时为 -1
+     */
+    int64_t             position;
+
     // 以下部分为 private 成员，仅内部使用
 
     /** 输入容器格式的 context */
     AVFormatContext     *_inputFormatContext;
+    /** 从内存或通过 FileInputStream 读取时使用的自定义 IO context (使用 FFmpeg 默认的文件读取方式时为 NULL) */
+    AVIOContext         *_customIoContext;
+    /** 通过 FileInputStream 读取文件时的输入流 */
+    FileInputStream     *_fileInputStream;
+    /** 从内存读取时的数据 */
+    const uint8_t       *_memoryData;
+    /** 从内存读取时的数据大小 (以字节为单位) */
+    size_t              _memorySize;
+    /** 从内存读取时的当前读取位置 */
+    size_t              _memoryPosition;
     /** 解码器 */
     const AVCodec       *_audioDecoder;
     /** 解码器的 context */
     AVCodecContext      *_audioDecoderContext;
-    /** 重采样器 */
+    /** 重采样器 (使用多相重采样器时只转换样本值格式和声道布局，不改变采样率) */
     SwrContext          *_resamplerContext;
+    /** 多相重采样器，不使用时为 NULL */
+    PolyphaseResampler  *_polyphaseResampler;
 
     /** 所找到音频流的 index */
     size_t              _audioStreamIndex;
@@ -72,18 +93,79 @@ typedef struct {
     /** 解码 packet 时使用的空 frame */
     AVFrame             *_tempFrame;
 
-    /** 存储重采样结果的 buffer 所能容纳的每声道样本数 */
-    int                 _resamplerOutputBufferSampleCountPerChannel;
-    /** 存储重采样结果的 buffer 大小 (以字节为单位) */
-    int                 _resamplerOutputBufferSize;
-    /** 存储重采样结果的 buffer */
-    uint8_t             *_resamplerOutputBuffer;
+    /** 单个输出帧 (所有声道各一个样本值) 的大小 (以字节为单位) */
+    int                 _outputFrameSize;
+
+    /** 解码器输出的样本值格式与 libswresample 的输出格式相同，frame 不经过 libswresample 直接复制 (或交错) */
+    bool                _passthrough;
+    /** 直通时 _tempFrame 中已复制的每声道样本数 */
+    int                 _passthroughFrameOffset;
+    /** 直通时 _tempFrame 中的每声道样本数，为 0 时 _tempFrame 中没有未复制完的样本 */
+    int                 _passthroughFrameLength;
+
+    /** 解码器中的所有 frame 均已取出 */
+    bool                _decoderDrained;
+    /** 重采样器中的所有样本 (包括延迟部分) 均已取出 */
+    bool                _resamplerDrained;
+    /** 已定位，需由下一个 frame 的时间戳确定 position */
+    bool                _positionPending;
 } AudioFileReader;
 
+/**
+ * 设置之后打开的音频文件的读取方式
+ *
+ * blockSize 为 0 时使用 FFmpeg 默认的文件读取方式 (默认值)，否则通过 FileInputStream 读取，
+ * 并以 blockSize 作为 AVIOContext 的 buffer 大小
+ *
+ * @param   config              读取方式配置
+ */
+void AudioFileReader_setFileInputConfig(const FileInputStreamConfig *config);
+
+/**
+ * 指定之后打开的音频文件的容器格式 (不自动探测)
+ *
+ * 用于从管道读取无法探测格式的数据，如原始 PCM (s16le, f32le 等)，此时可同时指定采样率和声道数
+ *
+ * @param   formatSpec          格式字符串 <FFmpeg 容器格式名称>[:<采样率>[:<声道数>]]，如 "s16le:48000:2"
+ *
+ * @return  成功时返回 true, 格式字符串无效或容器格式不存在时返回 false
+ */
+bool AudioFileReader_setInputFormat(const TCHAR *formatSpec);
+
+/**
+ * 设置之后打开的音频文件转换采样率时使用的多相重采样器质量
+ *
+ * 输出样本值为 32 位浮点数且需要转换采样率时，由多相重采样器转换采样率，无法创建时 (如处理器不支持 AVX2)
+ * 改为由 libswresample 转换
+ *
+ * @param   quality             重采样质量，默认为 POLYPHASE_RESAMPLER_QUALITY_MEDIUM,
+ *                              为 POLYPHASE_RESAMPLER_QUALITY_NONE 时总是使用 libswresample
+ */
+void AudioFileReader_setResamplerQuality(PolyphaseResamplerQuality quality);
+
+/**
+ * 设置之后打开的音频文件是否快速打开
+ *
+ * 快速打开时限制探测容器格式和流信息所读取的数据量，只获取音频流的信息 (忽略视频等其他流)，
+ * 容器的头信息中已有音频参数时不再读取 packet。无法确定音频参数时自动改为完整探测后重新打开
+ *
+ * @param   fastOpen            是否快速打开，默认为 false
+ */
+void AudioFileReader_setFastOpen(bool fastOpen);
+
+/**
+ * 检查文件名是否表示标准输入 ("-" 或 "pipe:" 开头)
+ *
+ * @param   filename            文件名
+ *
+ * @return  表示标准输入时返回 true, 否则返回 false
+ */
+bool AudioFileReader_isStandardInput(const TCHAR *filename);
+
 /**
  * 打开要读取的音频文件，并初始化 AudioFileReader 对象
  *
- * @param   filename            要打开文件的文件名
+ * @param   filename            要打开文件的文件名，为 "-" 或 "pipe:" 时从标准输入读取
  * @param   outputSampleType    输出样本值的样本类型
  *
  * @return  成功时，返回指向已分配和初始化的 AudioFileReader 对象的指针；
@@ -91,18 +173,59 @@ typedef struct {
  */
 AudioFileReader *AudioFileReader_open(const TCHAR *filename, const AudioSampleType *outputSampleType);
 
+/**
+ * 打开内存中的已编码音频数据 (完整的音频文件内容)，并初始化 AudioFileReader 对象
+ *
+ * 在 AudioFileReader 关闭之前，调用者须保证 data 指向的内存有效
+ *
+ * @param   data                已编码音频数据
+ * @param   size                已编码音频数据的大小 (以字节为单位)
+ * @param   outputSampleType    输出样本值的样本类型
+ *
+ * @return  成功时，返回指向已分配和初始化的 AudioFileReader 对象的指针；
+ *          失败时，返回 NULL
+ */
+AudioFileReader *AudioFileReader_openMemory(const void *data, size_t size, const AudioSampleType *outputSampleType);
+
 /**
  * 读取样本值
  *
+ * 重采样结果直接写入 destBuffer，未写入的部分保留在重采样器中，下次读取时优先取出。
+ * 到达输入文件末尾后会依次冲刷解码器和重采样器，因此所有样本值都会被读取
+ *
  * @param   obj                                 指向 AudioFileReader 对象的指针
  * @param   destBuffer                          指向目标缓冲区的指针，所读取的样本值将存储在该缓冲区中
  * @param   destBufferSampleCountPerChannel     destBuffer 所能容纳的每声道样本数
  *
- * @return  成功时，返回实际读取并写入到 destBuffer 的每声道样本数；
- *          失败时，返回小于 0 的错误码
+ * @return  成功时，返回实际读取并写入到 destBuffer 的每声道样本数 (除最后一次外，等于 destBufferSampleCountPerChannel)；
+ *          所有样本值都已读取时，返回 AVERROR_EOF；
+ *          失败时，返回其他小于 0 的错误码
  */
 int AudioFileReader_read(AudioFileReader *obj, void *destBuffer, int destBufferSampleCountPerChannel);
 
+/**
+ * 检查是否可以定位 (输入支持随机访问且时长已知)
+ *
+ * @param   obj             指向 AudioFileReader 对象的指针
+ *
+ * @return  可以定位时返回 true, 否则返回 false
+ */
+bool AudioFileReader_isSeekable(const AudioFileReader *obj);
+
+/**
+ * 定位到指定位置之前最近的可解码位置，并清空解码器和重采样器
+ *
+ * 实际到达的位置由之后读取时的 position 给出，可能早于 samplePosition 较多 (取决于容器格式的索引精度)，
+ * 调用者应丢弃 samplePosition 之前的样本值。定位后开头的少量样本值受解码器和重采样器启动过程影响，
+ * 需要精确结果时应定位到更早的位置 (预读)
+ *
+ * @param   obj             指向 AudioFileReader 对象的指针
+ * @param   samplePosition  目标位置 (输出采样率下的每声道样本数)
+ *
+ * @return  成功时返回 0, 失败时返回小于 0 的错误码
+ */
+int AudioFileReader_seek(AudioFileReader *obj, int64_t samplePosition);
+
 /**
  * 关闭已打开的音频文件
  *
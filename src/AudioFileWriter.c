@@ -29,6 +29,7 @@
 #include <assert.h>
 #include "libavutil/channel_layout.h"
 #include "libavutil/opt.h"
+#include "libavutil/avstring.h"
 #include "libavutil/mathematics.h"
 #include "libavutil/timestamp.h"
 #include "libavformat/avformat.h"
@@ -39,6 +40,41 @@
 #include "AudioFileCommon.h"
 #include "AudioFileWriter.h"
 
+/** 编码器设置 */
+static AudioEncoderSettings s_encoderSettings = {
+    .flacCompressionLevel = -1,
+    .mp3Quality = -1,
+    .aacCoder = NULL
+};
+
+void AudioFileWriter_setEncoderSettings(const AudioEncoderSettings *settings) {
+    s_encoderSettings = *settings;
+}
+
+/** 输出文件的写入方式 */
+static FileOutputStreamConfig s_fileOutputConfig = { 0 };
+
+void AudioFileWriter_setFileOutputConfig(const FileOutputStreamConfig *config) {
+    s_fileOutputConfig = *config;
+}
+
+/** 文件名表示标准输出时实际写入的文件描述符 */
+static int s_standardOutputFd = 1;
+
+void AudioFileWriter_setStandardOutput(int fd) {
+    s_standardOutputFd = fd;
+}
+
+bool AudioFileWriter_isStandardOutput(const TCHAR *filename) {
+    return (_tcscmp(filename, _T("-")) == 0) || (_tcscmp(filename, _T("pipe:")) == 0)
+            || (_tcscmp(filename, _T("pipe:1")) == 0);
+}
+
+bool AudioFileWriter_isStreamingOutput(const TCHAR *filename) {
+    return AudioFileWriter_isStandardOutput(filename) || (_tcsncmp(filename, _T("pipe:"), 5) == 0)
+            || (_tcsnicmp(filename, _T("\\\\.\\pipe\\"), 9) == 0);
+}
+
 #if defined(_DEBUG) && 0
 static void _logPacket(const AVFormatContext *formatContext, const AVPacket *packet) {
     AVRational *timeBase = &formatContext->streams[packet->stream_index]->time_base;
@@ -58,22 +94,23 @@ static void _logPacket(const AVFormatContext *formatContext, const AVPacket *pac
  * 写入一个 AVFrame
  *
  * @param   obj     指向 AudioFileWriter 对象的指针
+ * @param   stream  指向要写入的音频流的指针
  * @param   frame   指向要写入 AVFrame 的指针
  *
  * @return  成功时返回 1 或 0, 失败时返回 < 0 的值
  */
-static int _writeFrame(AudioFileWriter *obj, AVFrame *frame, AVPacket *packet) {
+static int _writeFrame(AudioFileWriter *obj, AudioFileWriterStream *stream, AVFrame *frame, AVPacket *packet) {
     int ret;
 
     // 将该帧提供给编码器
-    ret = avcodec_send_frame(obj->_audioEncoderContext, frame);
+    ret = avcodec_send_frame(stream->_audioEncoderContext, frame);
     if (ret < 0) {
         MSG_ERROR(_T("avcodec_send_frame() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
         return ret;
     }
 
     while (ret >= 0) {
-        ret = avcodec_receive_packet(obj->_audioEncoderContext, packet);
+        ret = avcodec_receive_packet(stream->_audioEncoderContext, packet);
         if ((ret == AVERROR(EAGAIN)) || (ret == AVERROR_EOF)) {
             // AVERROR(EAGAIN):   output is not available in the current state - user must try to send input
             // AVERROR_EOF:       the encoder has been fully flushed, and there will be no more output packets
@@ -84,8 +121,8 @@ static int _writeFrame(AudioFileWriter *obj, AVFrame *frame, AVPacket *packet) {
         }
 
         // Rescale output packet timestamp values from codec to stream timebase
-        av_packet_rescale_ts(packet, obj->_audioEncoderContext->time_base, obj->_audioStream->time_base);
-        packet->stream_index = obj->_audioStream->index;
+        av_packet_rescale_ts(packet, stream->_audioEncoderContext->time_base, stream->_audioStream->time_base);
+        packet->stream_index = stream->_audioStream->index;
 
         // Write the compressed frame to the media file.
         _logPacket(obj->_outputFormatContext, packet);
@@ -110,53 +147,58 @@ static int _writeFrame(AudioFileWriter *obj, AVFrame *frame, AVPacket *packet) {
 /**
  * 添加一个音频流
  *
- * @param   obj     指向 AudioFileWriter 对象的指针
+ * @param   obj         指向 AudioFileWriter 对象的指针
+ * @param   stream      指向要添加的音频流的指针
+ * @param   title       音频流的标题 (UTF-8 编码)，为 NULL 时不设置
+ * @param   isDefault   是否为默认播放的音频流
  *
  * @return  成功时返回 true, 失败时返回 false
  */
-static bool _addAudioStream(AudioFileWriter *obj) {
-    // 从输出容器格式中获取音频的 Codec ID
-    enum AVCodecID audioCodecId = obj->_outputFormatContext->oformat->audio_codec;
+static bool _addAudioStream(AudioFileWriter *obj, AudioFileWriterStream *stream, const char *title, bool isDefault) {
+    // 使用指定的编码格式，未指定时从输出容器格式中获取音频的 Codec ID
+    enum AVCodecID audioCodecId = obj->fileFormat->codecId;
+    if (audioCodecId == AV_CODEC_ID_NONE) {
+        audioCodecId = obj->_outputFormatContext->oformat->audio_codec;
+    }
     if (audioCodecId == AV_CODEC_ID_NONE) {
         MSG_ERROR(_T("audio codec not found\n"));
         return false;
     }
 
     // 查找可用的音频编码器
-    obj->_audioEncoder = avcodec_find_encoder(audioCodecId);
-    if (obj->_audioEncoder == NULL) {
+    stream->_audioEncoder = avcodec_find_encoder(audioCodecId);
+    if (stream->_audioEncoder == NULL) {
         MSG_ERROR(_T("cannot find encoder for '") _T(A_STR_FMT) _T("'\n"), avcodec_get_name(audioCodecId));
         return false;
     }
-    if (obj->_audioEncoder->type != AVMEDIA_TYPE_AUDIO) {
+    if (stream->_audioEncoder->type != AVMEDIA_TYPE_AUDIO) {
         MSG_ERROR(_T("found audio encoder is not the type of AVMEDIA_TYPE_AUDIO\n"));
         return false;
     }
 
-    // 为编码器创建临时 packet
-    obj->_tempPacket = av_packet_alloc();
-    if (obj->_tempPacket == NULL) {
-        MSG_ERROR(_T("av_packet_alloc() failed\n"));
-        return false;
-    }
-
     // 添加一个新的音频流
-    obj->_audioStream = avformat_new_stream(obj->_outputFormatContext, NULL);
-    if (obj->_audioStream == NULL) {
+    stream->_audioStream = avformat_new_stream(obj->_outputFormatContext, NULL);
+    if (stream->_audioStream == NULL) {
         MSG_ERROR(_T("avformat_new_stream() failed\n"));
         return false;
     }
-    obj->_audioStream->id = obj->_outputFormatContext->nb_streams - 1;
+    stream->_audioStream->id = obj->_outputFormatContext->nb_streams - 1;
+
+    // 只有默认的音频流在播放器中默认启用 (MP4 中其他音频流的轨道为禁用状态)
+    stream->_audioStream->disposition = isDefault ? AV_DISPOSITION_DEFAULT : 0;
+    if (title != NULL) {
+        av_dict_set(&stream->_audioStream->metadata, "title", title, 0);
+    }
 
     // 为音频编码器分配一个 AVCodecContext
-    obj->_audioEncoderContext = avcodec_alloc_context3(obj->_audioEncoder);
-    if (obj->_audioEncoderContext == NULL) {
+    stream->_audioEncoderContext = avcodec_alloc_context3(stream->_audioEncoder);
+    if (stream->_audioEncoderContext == NULL) {
         MSG_ERROR(_T("avcodec_alloc_context3() failed\n"));
         return false;
     }
 
-    const AVCodec *encoder = obj->_audioEncoder;
-    AVCodecContext *context = obj->_audioEncoderContext;
+    const AVCodec *encoder = stream->_audioEncoder;
+    AVCodecContext *context = stream->_audioEncoderContext;
 
     int sampleRate = obj->inputSampleType->sampleRate;
     int64_t bitRate = obj->fileFormat->bitRate;
@@ -211,13 +253,18 @@ static bool _addAudioStream(AudioFileWriter *obj) {
         av_channel_layout_copy(&context->ch_layout, &channelLayout);
     }
 
+    // 编码器支持多线程时，由编码器自动选择线程数
+    if ((encoder->capabilities & (AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS | AV_CODEC_CAP_OTHER_THREADS)) != 0) {
+        context->thread_count = 0;
+    }
+
     // 设置 flags (有些文件格式有单独的头信息)
     if (obj->_outputFormatContext->oformat->flags & AVFMT_GLOBALHEADER) {
         context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
     }
 
     // 设置时间的基本单位
-    obj->_audioStream->time_base = (AVRational) {
+    stream->_audioStream->time_base = (AVRational) {
         .num = 1,
         .den = context->sample_rate
     };
@@ -225,6 +272,26 @@ static bool _addAudioStream(AudioFileWriter *obj) {
     return true;
 }
 
+/**
+ * 根据编码器设置生成传给 avcodec_open2() 的编码器选项
+ *
+ * @param   stream      指向音频流的指针
+ * @param   options     用于存储编码器选项的 AVDictionary
+ */
+static void _getEncoderOptions(AudioFileWriterStream *stream, AVDictionary **options) {
+    const AVCodec *encoder = stream->_audioEncoder;
+
+    if ((encoder->id == AV_CODEC_ID_FLAC) && (s_encoderSettings.flacCompressionLevel >= 0)) {
+        av_dict_set_int(options, "compression_level", s_encoderSettings.flacCompressionLevel, 0);
+    } else if ((encoder->id == AV_CODEC_ID_MP3) && (s_encoderSettings.mp3Quality >= 0)) {
+        // libmp3lame 将 compression_level 作为 LAME 的编码算法质量 (lame_set_quality)
+        av_dict_set_int(options, "compression_level", s_encoderSettings.mp3Quality, 0);
+    } else if ((encoder->id == AV_CODEC_ID_AAC) && (strcmp(encoder->name, "aac") == 0)
+            && (s_encoderSettings.aacCoder != NULL)) {
+        av_dict_set(options, "aac_coder", s_encoderSettings.aacCoder, 0);
+    }
+}
+
 /**
  * 分配一个音频帧
  *
@@ -266,19 +333,20 @@ static bool _allocAudioFrame(AVFrame **destFramePtr, enum AVSampleFormat sampleF
  * 初始化音频编码器，并分配必要的缓冲区
  *
  * @param   obj         指向 AudioFileWriter 对象的指针
+ * @param   stream      指向音频流的指针
  * @param   opt_arg     可选参数
  *
  * @return  成功时返回 true, 失败时返回 false
  */
-static bool _openAudio(AudioFileWriter *obj, AVDictionary *opt_arg) {
+static bool _openAudio(AudioFileWriter *obj, AudioFileWriterStream *stream, AVDictionary *opt_arg) {
     int ret;
 
-    AVCodecContext *encoderContext = obj->_audioEncoderContext;
+    AVCodecContext *encoderContext = stream->_audioEncoderContext;
 
     // 初始化音频编码器的 context
     AVDictionary *opt = NULL;
     av_dict_copy(&opt, opt_arg, 0);
-    ret = avcodec_open2(encoderContext, obj->_audioEncoder, &opt);
+    ret = avcodec_open2(encoderContext, stream->_audioEncoder, &opt);
     av_dict_free(&opt);
     if (ret < 0) {
         MSG_ERROR(_T("avcodec_open2() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
@@ -294,23 +362,10 @@ static bool _openAudio(AudioFileWriter *obj, AVDictionary *opt_arg) {
         frameSize = encoderContext->frame_size;
     }
 
-    // 分配用于存储原始样本值数据的 bufferFrame
-    obj->_bufferFrameSampleCountPerChannel = frameSize;
-    obj->_bufferFrame = NULL;
-    if (!_allocAudioFrame(&obj->_bufferFrame, AudioFileCommon_getAvSampleFormat(obj->inputSampleType->sampleValueFormat),
-            encoderContext->sample_rate, &encoderContext->ch_layout, frameSize)) {
-        return false;
-    }
-
-    // 分配用于存储重采样 (调整采样格式) 后的样本值的 resampledFrame
-    obj->_bufferFrameResampled = NULL;
-    if (!_allocAudioFrame(&obj->_bufferFrameResampled, encoderContext->sample_fmt,
-            encoderContext->sample_rate, &encoderContext->ch_layout, frameSize)) {
-        return false;
-    }
+    stream->_bufferFrameSampleCountPerChannel = frameSize;
 
     // 复制音频流的参数
-    ret = avcodec_parameters_from_context(obj->_audioStream->codecpar, encoderContext);
+    ret = avcodec_parameters_from_context(stream->_audioStream->codecpar, encoderContext);
     if (ret < 0) {
         MSG_ERROR(_T("avcodec_parameters_from_context() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
         return false;
@@ -323,10 +378,38 @@ static bool _openAudio(AudioFileWriter *obj, AVDictionary *opt_arg) {
         return false;
     }
 
+    stream->_passthrough = (encoderContext->sample_fmt == inputSampleFormat)
+            && (encoderContext->ch_layout.nb_channels == obj->inputSampleType->channelCount);
+
+    // 有延迟的编码器可能在 avcodec_send_frame() 返回后仍保留 frame 的引用，此时不能引用调用者的数据
+    stream->_zeroCopy = stream->_passthrough
+            && ((encoderContext->codec->capabilities & AV_CODEC_CAP_DELAY) == 0);
+
+    if (stream->_zeroCopy) {
+        // 分配用于引用调用者数据的 inputFrame (不分配缓冲区)
+        stream->_inputFrame = NULL;
+        if (!_allocAudioFrame(&stream->_inputFrame, inputSampleFormat,
+                encoderContext->sample_rate, &encoderContext->ch_layout, 0)) {
+            return false;
+        }
+    }
+
+    // 分配用于存储重采样 (调整采样格式) 或复制后的样本值的 bufferFrame (不足一帧的样本值也暂存在其中)
+    stream->_bufferFrame = NULL;
+    if (!_allocAudioFrame(&stream->_bufferFrame, encoderContext->sample_fmt,
+            encoderContext->sample_rate, &encoderContext->ch_layout, frameSize)) {
+        return false;
+    }
+    stream->_bufferedSampleCountPerChannel = 0;
+
+    if (stream->_passthrough) {
+        return true;
+    }
+
     // 初始化 libswresample 重采样器的 context
-    obj->_resamplerContext = NULL;
+    stream->_resamplerContext = NULL;
     ret = swr_alloc_set_opts2(
-        &obj->_resamplerContext,        // swresample context
+        &stream->_resamplerContext,        // swresample context
         &encoderContext->ch_layout,     // [output] channel layout
         encoderContext->sample_fmt,     // [output] sample format
         encoderContext->sample_rate,    // [output] sample rate
@@ -340,13 +423,13 @@ static bool _openAudio(AudioFileWriter *obj, AVDictionary *opt_arg) {
         MSG_ERROR(_T("swr_alloc_set_opts2() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
         return false;
     }
-    if (obj->_resamplerContext == NULL) {
+    if (stream->_resamplerContext == NULL) {
         MSG_ERROR(_T("swr_alloc_set_opts2() failed\n"));
         return false;
     }
 
     // 初始化 libswresample 重采样器
-    ret = swr_init(obj->_resamplerContext);
+    ret = swr_init(stream->_resamplerContext);
     if (ret < 0) {
         MSG_ERROR(_T("swr_init() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
         return false;
@@ -356,72 +439,169 @@ static bool _openAudio(AudioFileWriter *obj, AVDictionary *opt_arg) {
 }
 
 /**
- * 编码一个音频帧，并送入 muxer
+ * 设置 frame 的时间戳并送入编码器
  *
  * @param   obj     指向 AudioFileWriter 对象的指针
+ * @param   stream  指向音频流的指针
+ * @param   frame   指向要写入 AVFrame 的指针
  *
  * @return  成功时如果编码完成，则返回 1, 否则返回 0；
  *          失败时返回 < 0 的值
  */
-static int _writeBufferFrame(AudioFileWriter *obj) {
-    int ret;
-
-    assert(obj->_bufferFrame != NULL);
-
-    // 计算当前 buffer frame 重采样后的每声道样本数
-    int resampledFrameSampleCountPerChannel = (int)av_rescale_rnd(
-        swr_get_delay(obj->_resamplerContext, obj->_audioEncoderContext->sample_rate) + obj->_bufferFrame->nb_samples,
-        obj->_audioEncoderContext->sample_rate,
-        obj->_audioEncoderContext->sample_rate,
-        AV_ROUND_UP
+static int _encodeFrame(AudioFileWriter *obj, AudioFileWriterStream *stream, AVFrame *frame) {
+    frame->pts = av_rescale_q(
+        stream->_totalWrittenSampleCount,
+        (AVRational) { 1, stream->_audioEncoderContext->sample_rate },
+        stream->_audioEncoderContext->time_base
     );
-    // 因为重采样仅调整采样格式，采样率和声道数保持不变，
-    // 计算所得的重采样后每声道样本数应该与重采样之前的相等
-    assert(resampledFrameSampleCountPerChannel == obj->_bufferFrame->nb_samples);
+    stream->_totalWrittenSampleCount += frame->nb_samples;
 
-    // When we pass a frame to the encoder, it may keep a reference to it internally.
-    // Make sure we do not overwrite it here
-    ret = av_frame_make_writable(obj->_bufferFrameResampled);
+    int ret = _writeFrame(obj, stream, frame, obj->_tempPacket);
     if (ret < 0) {
+        MSG_ERROR(_T("_writeFrame() failed\n"));
         return ret;
     }
 
-    // 进行重采样转换
-    ret = swr_convert(
-        obj->_resamplerContext,
-        obj->_bufferFrameResampled->data,           // [out]
-        resampledFrameSampleCountPerChannel,        // [out]
-        (const uint8_t **)obj->_bufferFrame->data,  // [in]
-        obj->_bufferFrame->nb_samples               // [in]
-    );
-    if (ret < 0) {
-        MSG_ERROR(_T("swr_convert() failed\n"));
-        return ret;
+    return ret;
+}
+
+/**
+ * 引用调用者缓冲区的 AVBufferRef 的释放函数 (内存由调用者管理，此处不释放)
+ */
+static void _freeNothing(void *opaque, uint8_t *data) {
+}
+
+/**
+ * 将调用者缓冲区中的一帧样本值直接作为 frame 的数据送入编码器 (_zeroCopy 为 true 时使用)
+ *
+ * @param   obj                     指向 AudioFileWriter 对象的指针
+ * @param   stream                  指向音频流的指针
+ * @param   sampleValues            指向样本值的指针
+ * @param   sampleCountPerChannel   样本值的数量 (单个声道)
+ * @param   dataLengthInBytes       样本值的字节数
+ *
+ * @return  成功时如果编码完成，则返回 1, 否则返回 0；
+ *          失败时返回 < 0 的值
+ */
+static int _writeCallerFrame(AudioFileWriter *obj, AudioFileWriterStream *stream, uint8_t *sampleValues, int sampleCountPerChannel, int dataLengthInBytes) {
+    AVFrame *frame = stream->_inputFrame;
+
+    // 以只读的 AVBufferRef 引用调用者的缓冲区，编码器在 av_frame_ref() 时不会复制数据
+    frame->buf[0] = av_buffer_create(sampleValues, dataLengthInBytes, _freeNothing, NULL, AV_BUFFER_FLAG_READONLY);
+    if (frame->buf[0] == NULL) {
+        MSG_ERROR(_T("av_buffer_create() failed\n"));
+        return AVERROR(ENOMEM);
     }
+    frame->data[0] = sampleValues;
+    frame->extended_data = frame->data;
+    frame->linesize[0] = dataLengthInBytes;
+    frame->nb_samples = sampleCountPerChannel;
 
-    obj->_bufferFrameResampled->pts = av_rescale_q(
-        obj->_totalWrittenSampleCount,
-        (AVRational) { 1, obj->_audioEncoderContext->sample_rate },
-        obj->_audioEncoderContext->time_base
-    );
-    obj->_totalWrittenSampleCount += resampledFrameSampleCountPerChannel;
+    int ret = _encodeFrame(obj, stream, frame);
+
+    av_buffer_unref(&frame->buf[0]);
+    frame->data[0] = NULL;
+
+    return ret;
+}
+
+/**
+ * 将调用者缓冲区中的样本值重采样 (仅调整采样格式) 或复制到 bufferFrame 中已暂存的样本值之后
+ *
+ * @param   stream                  指向音频流的指针
+ * @param   sampleValues            指向样本值的指针
+ * @param   sampleCountPerChannel   样本值的数量 (单个声道，不超过 bufferFrame 的剩余空间)
+ *
+ * @return  成功时返回 0, 失败时返回 < 0 的值
+ */
+static int _fillBufferFrame(AudioFileWriterStream *stream, const uint8_t *sampleValues, int sampleCountPerChannel) {
+    int ret;
+
+    AVFrame *frame = stream->_bufferFrame;
 
-    ret = _writeFrame(obj, obj->_bufferFrameResampled, obj->_tempPacket);
+    // When we pass a frame to the encoder, it may keep a reference to it internally.
+    // Make sure we do not overwrite it here (已暂存的样本值会复制到新的缓冲区中)
+    ret = av_frame_make_writable(frame);
     if (ret < 0) {
-        MSG_ERROR(_T("_writeFrame() failed\n"));
         return ret;
     }
 
+    // 计算各平面中写入位置的指针 (packed 格式只有一个平面)
+    int channelCount = frame->ch_layout.nb_channels;
+    bool isPlanar = (av_sample_fmt_is_planar(frame->format) != 0);
+    int planeCount = isPlanar ? channelCount : 1;
+    int bytesPerPlaneSample = av_get_bytes_per_sample(frame->format) * (isPlanar ? 1 : channelCount);
+    if (planeCount > AV_NUM_DATA_POINTERS) {
+        return AVERROR(EINVAL);
+    }
+
+    uint8_t *destData[AV_NUM_DATA_POINTERS];
+    for (int i = 0; i < planeCount; i++) {
+        destData[i] = frame->extended_data[i] + ((size_t)stream->_bufferedSampleCountPerChannel * bytesPerPlaneSample);
+    }
+
+    if (stream->_passthrough) {
+        memcpy(destData[0], sampleValues, ((size_t)sampleCountPerChannel * bytesPerPlaneSample));
+    } else {
+        // 进行重采样转换 (因为重采样仅调整采样格式，采样率和声道数保持不变，转换后的每声道样本数与转换前相等)
+        const uint8_t *inputData[1] = { sampleValues };
+        ret = swr_convert(
+            stream->_resamplerContext,
+            destData,                                   // [out]
+            sampleCountPerChannel,                      // [out]
+            inputData,                                  // [in]
+            sampleCountPerChannel                       // [in]
+        );
+        if (ret < 0) {
+            MSG_ERROR(_T("swr_convert() failed\n"));
+            return ret;
+        }
+        assert(ret == sampleCountPerChannel);
+    }
+
+    stream->_bufferedSampleCountPerChannel += sampleCountPerChannel;
+
+    return 0;
+}
+
+/**
+ * 将 bufferFrame 中暂存的样本值送入编码器
+ *
+ * 除最后一个 frame (在关闭时送入) 外，暂存的样本值应正好为一帧
+ *
+ * @param   obj                     指向 AudioFileWriter 对象的指针
+ * @param   stream                  指向音频流的指针
+ *
+ * @return  成功时如果编码完成，则返回 1, 否则返回 0；
+ *          失败时返回 < 0 的值
+ */
+static int _encodeBufferFrame(AudioFileWriter *obj, AudioFileWriterStream *stream) {
+    AVFrame *frame = stream->_bufferFrame;
+
+    frame->nb_samples = stream->_bufferedSampleCountPerChannel;
+    int ret = _encodeFrame(obj, stream, frame);
+
+    // 恢复为完整的帧大小，av_frame_make_writable() 按 nb_samples 复制数据
+    frame->nb_samples = stream->_bufferFrameSampleCountPerChannel;
+    stream->_bufferedSampleCountPerChannel = 0;
+
     return ret;
 }
 
 AudioFileWriter *AudioFileWriter_open(const TCHAR *filename,
         const AudioFileFormat *fileFormat, const AudioSampleType *inputSampleType) {
+    return AudioFileWriter_openStreams(filename, fileFormat, inputSampleType, 1, NULL);
+}
+
+AudioFileWriter *AudioFileWriter_openStreams(const TCHAR *filename,
+        const AudioFileFormat *fileFormat, const AudioSampleType *inputSampleType,
+        int streamCount, const TCHAR * const *streamTitles) {
     int ret;
     AVDictionary *opt = NULL;
     AudioFileWriter *obj = NULL;
 
-    if ((filename == NULL) || (fileFormat == NULL) || (inputSampleType == NULL)) {
+    if ((filename == NULL) || (fileFormat == NULL) || (inputSampleType == NULL)
+            || (streamCount <= 0) || (streamCount > AUDIO_FILE_WRITER_MAX_STREAM_COUNT)) {
         goto err;
     }
 
@@ -431,7 +611,16 @@ AudioFileWriter *AudioFileWriter_open(const TCHAR *filename,
         goto err;
     }
 
-    obj->filenameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(filename);
+    bool isStreamingOutput = AudioFileWriter_isStreamingOutput(filename);
+
+    if (AudioFileWriter_isStandardOutput(filename)) {
+        // 使用 FFmpeg 的 pipe 协议写入标准输出 (或调用者指定的文件描述符)
+        char pipeFilename[32];
+        snprintf(pipeFilename, sizeof(pipeFilename), "pipe:%d", s_standardOutputFd);
+        obj->filenameUtf8 = _strdup(pipeFilename);
+    } else {
+        obj->filenameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(filename);
+    }
     if (obj->filenameUtf8 == NULL) {
         MSG_ERROR(_T("converting filename to UTF-8 encoding failed\n"));
         goto err;
@@ -469,16 +658,42 @@ AudioFileWriter *AudioFileWriter_open(const TCHAR *filename,
         goto err;
     }
 
-    // 添加一个音频流 (使用格式默认的编码器)
-    if (!_addAudioStream(obj)) {
-        MSG_ERROR(_T("_addAudioStream() failed\n"));
+    // 为编码器创建临时 packet (各音频流共用)
+    obj->_tempPacket = av_packet_alloc();
+    if (obj->_tempPacket == NULL) {
+        MSG_ERROR(_T("av_packet_alloc() failed\n"));
         goto err;
     }
 
-    // 初始化音频编码器，并分配必要的缓冲区
-    if (!_openAudio(obj, opt)) {
-        MSG_ERROR(_T("_openAudio() failed\n"));
-        goto err;
+    // 添加音频流，各音频流使用各自的编码器，写入同一个容器
+    for (int i = 0; i < streamCount; i++) {
+        AudioFileWriterStream *stream = &obj->_streams[i];
+        obj->streamCount = i + 1;
+
+        char *titleUtf8 = NULL;
+        if (streamTitles != NULL) {
+            titleUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(streamTitles[i]);
+        }
+
+        // 添加一个音频流 (未指定编码格式时使用格式默认的编码器)，第一个音频流为默认音频流
+        bool streamAdded = _addAudioStream(obj, stream, titleUtf8, (i == 0));
+        if (titleUtf8 != NULL) {
+            Memory_free(&titleUtf8);
+        }
+        if (!streamAdded) {
+            MSG_ERROR(_T("_addAudioStream() failed\n"));
+            goto err;
+        }
+
+        // 初始化音频编码器，并分配必要的缓冲区
+        AVDictionary *encoderOptions = NULL;
+        _getEncoderOptions(stream, &encoderOptions);
+        bool audioOpened = _openAudio(obj, stream, encoderOptions);
+        av_dict_free(&encoderOptions);
+        if (!audioOpened) {
+            MSG_ERROR(_T("_openAudio() failed\n"));
+            goto err;
+        }
     }
 
     if (g_verboseMode) {
@@ -486,14 +701,42 @@ AudioFileWriter *AudioFileWriter_open(const TCHAR *filename,
     }
 
     // 打开输出文件
-    ret = avio_open(&obj->_outputFormatContext->pb, obj->filenameUtf8, AVIO_FLAG_WRITE);
-    if (ret < 0) {
-        MSG_ERROR(_T("avio_open() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
-        goto err;
+    if ((s_fileOutputConfig.blockSize > 0) && !isStreamingOutput) {
+        // 通过 FileOutputStream 写入，muxer 写入的数据由后台线程写入文件，编码不必等待存储设备
+        obj->_fileOutputStream = FileOutputStream_open(filename, &s_fileOutputConfig);
+        if (obj->_fileOutputStream == NULL) {
+            goto err;
+        }
+
+        uint8_t *ioBuffer = (uint8_t *)av_malloc(obj->_fileOutputStream->_config.blockSize);
+        if (ioBuffer == NULL) {
+            MSG_ERROR(_T("allocating IO buffer failed\n"));
+            goto err;
+        }
+
+        obj->_outputFormatContext->pb = avio_alloc_context(ioBuffer, obj->_fileOutputStream->_config.blockSize, 1,
+                obj->_fileOutputStream, NULL, FileOutputStream_write, FileOutputStream_seek);
+        if (obj->_outputFormatContext->pb == NULL) {
+            av_free(ioBuffer);
+            MSG_ERROR(_T("avio_alloc_context() failed\n"));
+            goto err;
+        }
+    } else {
+        ret = avio_open(&obj->_outputFormatContext->pb, obj->filenameUtf8, AVIO_FLAG_WRITE);
+        if (ret < 0) {
+            MSG_ERROR(_T("avio_open() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+            goto err;
+        }
+    }
+
+    // 流式输出不能回写，MP4 (及 MOV) 格式改为写入空的 moov 之后逐个写入分片
+    if (isStreamingOutput && av_match_name(obj->_outputFormatContext->oformat->name, "mp4,mov,ipod,3gp,3g2,psp,ismv,f4v")) {
+        av_dict_set(&opt, "movflags", "frag_keyframe+empty_moov+default_base_moof", 0);
     }
 
     // 写入头信息
     ret = avformat_write_header(obj->_outputFormatContext, &opt);
+    av_dict_free(&opt);
     if (ret < 0) {
         MSG_ERROR(_T("avformat_write_header() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
         goto err;
@@ -511,55 +754,99 @@ err:
 }
 
 int AudioFileWriter_write(AudioFileWriter *obj, void *sampleValues, int sampleCountPerChannel) {
+    return AudioFileWriter_writeStream(obj, 0, sampleValues, sampleCountPerChannel);
+}
+
+int AudioFileWriter_writeStream(AudioFileWriter *obj, int streamIndex, void *sampleValues, int sampleCountPerChannel) {
+    if ((streamIndex < 0) || (streamIndex >= obj->streamCount)) {
+        MSG_ERROR(_T("invalid stream index: %d\n"), streamIndex);
+        return 0;
+    }
+
+    AudioFileWriterStream *stream = &obj->_streams[streamIndex];
+
     int sampleValueSize = AudioFileCommon_getSampleValueSize(obj->inputSampleType->sampleValueFormat);
     if (sampleValueSize == -1) {
         MSG_ERROR(_T("AudioFileCommon_getSampleValueSize() failed\n"));
         return 0;
     }
 
+    int frameSampleCountPerChannel = stream->_bufferFrameSampleCountPerChannel;
+    int bytesPerSampleFrame = obj->inputSampleType->channelCount * sampleValueSize;
+
     uint8_t *sampleValuePtr = sampleValues;
     int totalWrittenSampleCountPerChannel = 0;
     while (totalWrittenSampleCountPerChannel < sampleCountPerChannel) {
-        // 该行不能放到循环外执行
-        uint8_t *bufferFrameData = obj->_bufferFrame->data[0];
-
-        // 计算本次循环要向 buffer frame 复制的样本数
-        int frameSampleCountPerChannel = min(obj->_bufferFrameSampleCountPerChannel, (sampleCountPerChannel - totalWrittenSampleCountPerChannel));
-
-        // 复制样本数据到 buffer frame 中
-        int frameSampleDataLengthInBytes = frameSampleCountPerChannel * obj->_audioEncoderContext->ch_layout.nb_channels * sampleValueSize;
-        memcpy(bufferFrameData, sampleValuePtr, frameSampleDataLengthInBytes);
-        sampleValuePtr += frameSampleDataLengthInBytes;
-
-        // 设置 buffer frame 的每声道样本数为实际复制的数量
-        obj->_bufferFrame->nb_samples = frameSampleCountPerChannel;
-
-        // 写入 buffer frame
-        int ret = _writeBufferFrame(obj);
+        int remainingSampleCountPerChannel = sampleCountPerChannel - totalWrittenSampleCountPerChannel;
+
+        int ret;
+        int currentSampleCountPerChannel;
+        if ((stream->_bufferedSampleCountPerChannel == 0) && (remainingSampleCountPerChannel >= frameSampleCountPerChannel)) {
+            // 完整的一帧直接从调用者的缓冲区送入编码器 (或转换到编码器的 frame 中)，不经过中间缓冲区
+            currentSampleCountPerChannel = frameSampleCountPerChannel;
+            if (stream->_zeroCopy) {
+                ret = _writeCallerFrame(obj, stream, sampleValuePtr, currentSampleCountPerChannel,
+                        (currentSampleCountPerChannel * bytesPerSampleFrame));
+            } else {
+                ret = _fillBufferFrame(stream, sampleValuePtr, currentSampleCountPerChannel);
+                if (ret >= 0) {
+                    ret = _encodeBufferFrame(obj, stream);
+                }
+            }
+        } else {
+            // 不足一帧的部分暂存到 bufferFrame 中，与之后写入的样本值合并为完整的帧再送入编码器
+            currentSampleCountPerChannel = min((frameSampleCountPerChannel - stream->_bufferedSampleCountPerChannel),
+                    remainingSampleCountPerChannel);
+            ret = _fillBufferFrame(stream, sampleValuePtr, currentSampleCountPerChannel);
+            if ((ret >= 0) && (stream->_bufferedSampleCountPerChannel == frameSampleCountPerChannel)) {
+                ret = _encodeBufferFrame(obj, stream);
+            }
+        }
         if (ret < 0) {
-            MSG_ERROR(_T("_writeBufferFrame() failed\n"));
+            MSG_ERROR(_T("writing frame failed\n"));
             return totalWrittenSampleCountPerChannel;
         }
 
-        totalWrittenSampleCountPerChannel += frameSampleCountPerChannel;
+        sampleValuePtr += (size_t)currentSampleCountPerChannel * bytesPerSampleFrame;
+
+        totalWrittenSampleCountPerChannel += currentSampleCountPerChannel;
     }
 
     return totalWrittenSampleCountPerChannel;
 }
 
-void AudioFileWriter_close(AudioFileWriter **objPtr) {
-    if (objPtr == NULL) {
-        return;
+int AudioFileWriter_getFrameSampleCount(const AudioFileWriter *obj, int streamIndex) {
+    if ((streamIndex < 0) || (streamIndex >= obj->streamCount)) {
+        return 1;
+    }
+
+    return obj->_streams[streamIndex]._bufferFrameSampleCountPerChannel;
+}
+
+bool AudioFileWriter_close(AudioFileWriter **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return false;
     }
 
     AudioFileWriter *obj = *objPtr;
+    bool succeeded = true;
+
+    // 使各编码器对已缓冲的 packet 做 flush 处理，并结束 stream
+    if (obj->_headerWritten) {
+        for (int i = 0; i < obj->streamCount; i++) {
+            // 送入暂存的最后不足一帧的样本值 (编码器只允许最后一个 frame 小于帧大小)
+            if ((obj->_streams[i]._bufferedSampleCountPerChannel > 0)
+                    && (_encodeBufferFrame(obj, &obj->_streams[i]) < 0)) {
+                MSG_ERROR(_T("_encodeBufferFrame() failed: error occurred when try to write the last frame\n"));
+                succeeded = false;
+            }
 
-    // 使编码器对已缓冲的 packet 做 flush 处理，并结束 stream
-    {
-        // 可参看 avcodec_send_frame() 函数对 frame 参数为 NULL 时的说明
-        int ret = _writeFrame(obj, NULL, obj->_tempPacket);
-        if (ret < 0) {
-            MSG_ERROR(_T("_writeFrame() failed: error occurred when try to flush packets\n"));
+            // 可参看 avcodec_send_frame() 函数对 frame 参数为 NULL 时的说明
+            int ret = _writeFrame(obj, &obj->_streams[i], NULL, obj->_tempPacket);
+            if (ret < 0) {
+                MSG_ERROR(_T("_writeFrame() failed: error occurred when try to flush packets\n"));
+                succeeded = false;
+            }
         }
     }
 
@@ -568,44 +855,85 @@ void AudioFileWriter_close(AudioFileWriter **objPtr) {
         int ret = av_write_trailer(obj->_outputFormatContext);
         if (ret < 0) {
             MSG_ERROR(_T("av_write_trailer() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+            succeeded = false;
         }
     }
 
-    // 释放 AVCodecContext
-    if (obj->_audioEncoderContext != NULL) {
-        avcodec_free_context(&obj->_audioEncoderContext);
-    }
+    for (int i = 0; i < obj->streamCount; i++) {
+        AudioFileWriterStream *stream = &obj->_streams[i];
 
-    // 释放缓冲 frame
-    if (obj->_bufferFrameResampled != NULL) {
-        av_frame_free(&obj->_bufferFrameResampled);
-    }
-    if (obj->_bufferFrame != NULL) {
-        av_frame_free(&obj->_bufferFrame);
+        // 释放 AVCodecContext
+        if (stream->_audioEncoderContext != NULL) {
+            avcodec_free_context(&stream->_audioEncoderContext);
+        }
+
+        // 释放缓冲 frame
+        if (stream->_bufferFrame != NULL) {
+            av_frame_free(&stream->_bufferFrame);
+        }
+        if (stream->_inputFrame != NULL) {
+            av_frame_free(&stream->_inputFrame);
+        }
+
+        // 释放 libswresample 的 context
+        if (stream->_resamplerContext != NULL) {
+            swr_free(&stream->_resamplerContext);
+        }
     }
+
     if (obj->_tempPacket != NULL) {
         av_packet_free(&obj->_tempPacket);
     }
 
-    // 释放 libswresample 的 context
-    if (obj->_resamplerContext != NULL) {
-        swr_free(&obj->_resamplerContext);
-    }
-
     // 释放 AVFormatContext
     if (obj->_outputFormatContext != NULL) {
         // 关闭输出文件
-        if (((obj->_outputFormatContext->oformat->flags & AVFMT_NOFILE) == 0)
+        if (obj->_fileOutputStream != NULL) {
+            // 自定义 IO context 不能用 avio_closep() 关闭，写出 buffer 中剩余的数据后释放
+            if (obj->_outputFormatContext->pb != NULL) {
+                avio_flush(obj->_outputFormatContext->pb);
+                if (obj->_outputFormatContext->pb->error < 0) {
+                    MSG_ERROR(_T("avio_flush() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(obj->_outputFormatContext->pb->error));
+                    succeeded = false;
+                }
+                av_freep(&obj->_outputFormatContext->pb->buffer);
+                avio_context_free(&obj->_outputFormatContext->pb);
+            }
+        } else if (((obj->_outputFormatContext->oformat->flags & AVFMT_NOFILE) == 0)
                 && (obj->_outputFormatContext->pb != NULL)) {
+            // avio_closep() 只返回关闭文件时的错误，之前写入时的错误记录在 pb->error 中
+            if (obj->_outputFormatContext->pb->error < 0) {
+                MSG_ERROR(_T("Failed to write output file \"") _T(A_STR_FMT) _T("\": ") _T(A_STR_FMT) _T("\n"),
+                        obj->filenameUtf8, av_err2str(obj->_outputFormatContext->pb->error));
+                succeeded = false;
+            }
+
             int ret = avio_closep(&obj->_outputFormatContext->pb);
             if (ret < 0) {
                 MSG_ERROR(_T("avio_closep() failed: ") _T(A_STR_FMT) _T("\n"), av_err2str(ret));
+                succeeded = false;
             }
         }
 
         avformat_free_context(obj->_outputFormatContext);
     }
 
+    // 等待后台线程写完所有数据后关闭文件
+    if (obj->_fileOutputStream != NULL) {
+        if (!FileOutputStream_flush(obj->_fileOutputStream)) {
+            MSG_ERROR(_T("Failed to write output file \"") _T(A_STR_FMT) _T("\".\n"), obj->filenameUtf8);
+            succeeded = false;
+        }
+
+        if (g_verboseMode) {
+            MSG_INFO(_T("Output I/O: %.1f MB written, %.3f seconds waiting for I/O, %.3f seconds writing in background\n"),
+                    ((double)obj->_fileOutputStream->writtenByteCount / (1024.0 * 1024.0)),
+                    obj->_fileOutputStream->stallSeconds, obj->_fileOutputStream->writeSeconds);
+        }
+
+        FileOutputStream_close(&obj->_fileOutputStream);
+    }
+
     if (obj->inputSampleType != NULL) {
         Memory_free(&obj->inputSampleType);
     }
@@ -619,4 +947,188 @@ void AudioFileWriter_close(AudioFileWriter **objPtr) {
     }
 
     Memory_free(objPtr);
+
+    return succeeded;
+}
+
+/**
+ * 读取大端序的 32 位无符号整数
+ */
+static uint32_t _readUint32Be(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * 写入大端序的 32 位无符号整数
+ */
+static void _writeUint32Be(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)(value >> 24);
+    p[1] = (uint8_t)(value >> 16);
+    p[2] = (uint8_t)(value >> 8);
+    p[3] = (uint8_t)value;
+}
+
+/**
+ * 读取 MP4 文件中指定位置的 box 头
+ *
+ * @param   file            文件
+ * @param   offset          box 的起始位置
+ * @param   endOffset       box 所在范围的结束位置 (size 为 0 时 box 延伸到此处)
+ * @param   boxSizeOut      用于存储 box 的总字节数
+ * @param   boxTypeOut      用于存储 box 的类型 (4 个字符)
+ * @param   headerSizeOut   用于存储 box 头的字节数 (8 或 16)
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+static bool _readMp4BoxHeader(FILE *file, int64_t offset, int64_t endOffset,
+        int64_t *boxSizeOut, char boxTypeOut[4], int *headerSizeOut) {
+    uint8_t header[16];
+
+    if ((_fseeki64(file, offset, SEEK_SET) != 0) || (fread(header, 1, 8, file) != 8)) {
+        return false;
+    }
+
+    int64_t boxSize = _readUint32Be(header);
+    int headerSize = 8;
+    if (boxSize == 1) {
+        // 64 位的 largesize
+        if (fread(header + 8, 1, 8, file) != 8) {
+            return false;
+        }
+        boxSize = ((int64_t)_readUint32Be(header + 8) << 32) | _readUint32Be(header + 12);
+        headerSize = 16;
+    } else if (boxSize == 0) {
+        boxSize = endOffset - offset;
+    }
+
+    if ((boxSize < headerSize) || ((offset + boxSize) > endOffset)) {
+        return false;
+    }
+
+    *boxSizeOut = boxSize;
+    memcpy(boxTypeOut, header + 4, 4);
+    *headerSizeOut = headerSize;
+
+    return true;
+}
+
+bool AudioFileWriter_addMp4UserData(const TCHAR *filename, const char *boxType, const void *data, int dataSize) {
+    bool succeeded = false;
+    uint8_t *newBoxes = NULL;
+
+    FILE *file = _tfopen(filename, _T("r+b"));
+    if (file == NULL) {
+        MSG_ERROR(_T("Failed to open \"%s\" for adding user data.\n"), filename);
+        return false;
+    }
+
+    if (_fseeki64(file, 0, SEEK_END) != 0) {
+        goto end;
+    }
+    int64_t fileSize = _ftelli64(file);
+
+    // 查找顶层的 moov box
+    int64_t moovOffset = -1;
+    int64_t moovSize = 0;
+    int moovHeaderSize = 0;
+    for (int64_t offset = 0; offset < fileSize; ) {
+        int64_t boxSize;
+        char type[4];
+        int headerSize;
+        if (!_readMp4BoxHeader(file, offset, fileSize, &boxSize, type, &headerSize)) {
+            MSG_ERROR(_T("Failed to parse the MP4 file \"%s\".\n"), filename);
+            goto end;
+        }
+
+        if (memcmp(type, "moov", 4) == 0) {
+            moovOffset = offset;
+            moovSize = boxSize;
+            moovHeaderSize = headerSize;
+        }
+
+        offset += boxSize;
+    }
+
+    // moov 需要位于文件末尾，才能直接在其末尾追加内容
+    if ((moovOffset < 0) || ((moovOffset + moovSize) != fileSize) || (moovHeaderSize != 8)) {
+        MSG_ERROR(_T("The moov box of \"%s\" is not at the end of the file.\n"), filename);
+        goto end;
+    }
+
+    // 查找 moov 的最后一个子 box
+    int64_t lastChildOffset = -1;
+    int lastChildHeaderSize = 0;
+    char lastChildType[4] = { 0 };
+    for (int64_t offset = moovOffset + moovHeaderSize; offset < fileSize; ) {
+        int64_t boxSize;
+        int headerSize;
+        if (!_readMp4BoxHeader(file, offset, fileSize, &boxSize, lastChildType, &headerSize)) {
+            MSG_ERROR(_T("Failed to parse the MP4 file \"%s\".\n"), filename);
+            goto end;
+        }
+
+        lastChildOffset = offset;
+        lastChildHeaderSize = headerSize;
+        offset += boxSize;
+    }
+
+    bool appendToUdta = (lastChildOffset >= 0) && (memcmp(lastChildType, "udta", 4) == 0) && (lastChildHeaderSize == 8);
+
+    // 生成要追加的内容: [udta 头] + box 头 + box 内容
+    int boxSize = 8 + dataSize;
+    int newBoxesSize = appendToUdta ? boxSize : (8 + boxSize);
+    if ((moovSize + newBoxesSize) > UINT32_MAX) {
+        goto end;
+    }
+
+    newBoxes = MEMORY_ALLOC_ARRAY(uint8_t, newBoxesSize);
+    if (newBoxes == NULL) {
+        goto end;
+    }
+
+    uint8_t *p = newBoxes;
+    if (!appendToUdta) {
+        _writeUint32Be(p, (uint32_t)newBoxesSize);
+        memcpy(p + 4, "udta", 4);
+        p += 8;
+    }
+    _writeUint32Be(p, (uint32_t)boxSize);
+    memcpy(p + 4, boxType, 4);
+    memcpy(p + 8, data, dataSize);
+
+    if ((_fseeki64(file, fileSize, SEEK_SET) != 0) || (fwrite(newBoxes, 1, newBoxesSize, file) != newBoxesSize)) {
+        goto end;
+    }
+
+    // 更新 udta 和 moov 的大小
+    uint8_t sizeBuffer[4];
+    if (appendToUdta) {
+        uint8_t udtaHeader[4];
+        if ((_fseeki64(file, lastChildOffset, SEEK_SET) != 0) || (fread(udtaHeader, 1, 4, file) != 4)) {
+            goto end;
+        }
+        _writeUint32Be(sizeBuffer, _readUint32Be(udtaHeader) + (uint32_t)newBoxesSize);
+        if ((_fseeki64(file, lastChildOffset, SEEK_SET) != 0) || (fwrite(sizeBuffer, 1, 4, file) != 4)) {
+            goto end;
+        }
+    }
+    _writeUint32Be(sizeBuffer, (uint32_t)(moovSize + newBoxesSize));
+    if ((_fseeki64(file, moovOffset, SEEK_SET) != 0) || (fwrite(sizeBuffer, 1, 4, file) != 4)) {
+        goto end;
+    }
+
+    succeeded = true;
+
+end:
+    if (!succeeded) {
+        MSG_ERROR(_T("Failed to add user data to \"%s\".\n"), filename);
+    }
+
+    if (newBoxes != NULL) {
+        Memory_free(&newBoxes);
+    }
+
+    fclose(file);
+
+    return succeeded;
 }
@@ -31,11 +31,63 @@
 #include "libswscale/swscale.h"
 #include "libswresample/swresample.h"
 #include "AudioFileCommon.h"
+#include "FileOutputStream.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * 编码器设置 (各项为 -1 或 NULL 时使用编码器的默认值)
+ */
+typedef struct {
+    /** FLAC 压缩级别 (0 ~ 12, 越小编码越快、文件越大) */
+    int                     flacCompressionLevel;
+
+    /** MP3 编码算法质量 (0 ~ 9, 越大编码越快、质量越差，不影响比特率) */
+    int                     mp3Quality;
+
+    /** AAC 编码器的量化方式 ("twoloop", "fast") */
+    const char              *aacCoder;
+} AudioEncoderSettings;
+
+/** 单个文件中音频流的最大数量 */
+#define AUDIO_FILE_WRITER_MAX_STREAM_COUNT      16
+
+/**
+ * AudioFileWriter 中单个音频流的上下文数据 (仅内部使用)
+ */
+typedef struct {
+    /** 音频流 */
+    AVStream                *_audioStream;
+
+    /** 编码器 */
+    const AVCodec           *_audioEncoder;
+    /** 编码器的 context */
+    AVCodecContext          *_audioEncoderContext;
+
+    /** 输入样本值格式与编码器所需的格式相同 (不使用重采样器) */
+    bool                    _passthrough;
+
+    /** 直接引用调用者的数据送入编码器 (_passthrough 为 true 且编码器不会在送入 frame 后保留其引用时) */
+    bool                    _zeroCopy;
+
+    /** 重采样器的 context (_passthrough 为 true 时为 NULL) */
+    SwrContext              *_resamplerContext;
+
+    /** 每次送入编码器的每声道样本数 (编码器的帧大小) */
+    int                     _bufferFrameSampleCountPerChannel;
+    /** 引用调用者数据的 frame (不分配缓冲区，仅 _zeroCopy 为 true 时使用) */
+    AVFrame                 *_inputFrame;
+    /** 用于存储重采样 (仅调整采样格式) 或复制后样本值的缓冲 frame, 不足一帧的样本值暂存在其中 */
+    AVFrame                 *_bufferFrame;
+    /** _bufferFrame 中已暂存的每声道样本数 */
+    int                     _bufferedSampleCountPerChannel;
+
+    /** 总的每声道已写入采样数 */
+    int                     _totalWrittenSampleCount;
+} AudioFileWriterStream;
+
 /**
  * AudioFileWriter 的上下文数据
  *
@@ -53,38 +105,74 @@ typedef struct {
     /** 输入样本值的样本类型 */
     AudioSampleType         *inputSampleType;
 
+    /** 音频流的数量 */
+    int                     streamCount;
+
     // 以下部分为 private 成员，仅内部使用
 
     /** 输出容器格式的 context */
     AVFormatContext         *_outputFormatContext;
 
+    /** 通过 FileOutputStream 写入文件时的输出流 (此时 _outputFormatContext->pb 为自定义的 IO context) */
+    FileOutputStream        *_fileOutputStream;
+
     /** 是否已调用 avformat_write_header() 成功写入头信息 */
     bool                    _headerWritten;
 
-    /** 音频流 */
-    AVStream                *_audioStream;
+    /** 写入 frame 时使用的临时 packet (各音频流共用) */
+    AVPacket                *_tempPacket;
 
-    /** 编码器 */
-    const AVCodec           *_audioEncoder;
-    /** 编码器的 context */
-    AVCodecContext          *_audioEncoderContext;
+    /** 各音频流 */
+    AudioFileWriterStream   _streams[AUDIO_FILE_WRITER_MAX_STREAM_COUNT];
+} AudioFileWriter;
 
-    /** 写入 frame 时使用的临时 packet */
-    AVPacket                *_tempPacket;
+/**
+ * 设置之后打开的音频文件所使用的编码器设置
+ *
+ * 设置只对相应格式的编码器有效 (AAC 的量化方式只对 FFmpeg 内置的 AAC 编码器有效)
+ *
+ * @param   settings            编码器设置，默认各项均使用编码器的默认值
+ */
+void AudioFileWriter_setEncoderSettings(const AudioEncoderSettings *settings);
 
-    /** 重采样器的 context */
-    SwrContext              *_resamplerContext;
+/**
+ * 设置之后打开的音频文件的写入方式
+ *
+ * blockSize 为 0 时使用 FFmpeg 默认的文件写入方式 (默认值)，否则通过 FileOutputStream 在后台线程中写入，
+ * 并以 blockSize 作为 AVIOContext 的 buffer 大小。流式输出总是使用 FFmpeg 默认的写入方式
+ *
+ * @param   config              写入方式配置
+ */
+void AudioFileWriter_setFileOutputConfig(const FileOutputStreamConfig *config);
 
-    /** _bufferFrame 和 _bufferFrameResampled 所能容纳的每声道样本数 */
-    int                     _bufferFrameSampleCountPerChannel;
-    /** 用于存储原始样本值的缓冲 frame */
-    AVFrame                 *_bufferFrame;
-    /** 用于存储重采样 (仅调整采样格式) 后样本值的缓冲 frame */
-    AVFrame                 *_bufferFrameResampled;
+/**
+ * 设置文件名表示标准输出时实际写入的文件描述符
+ *
+ * 调用者可先用 _dup() 复制标准输出，再将标准输出重定向到标准错误，使输出信息不会混入写入的音频数据中
+ *
+ * @param   fd                  文件描述符，默认为 1 (标准输出)
+ */
+void AudioFileWriter_setStandardOutput(int fd);
 
-    /** 总的每声道已写入采样数 */
-    int                     _totalWrittenSampleCount;
-} AudioFileWriter;
+/**
+ * 检查文件名是否表示标准输出 ("-", "pipe:" 或 "pipe:1")
+ *
+ * @param   filename            文件名
+ *
+ * @return  表示标准输出时返回 true, 否则返回 false
+ */
+bool AudioFileWriter_isStandardOutput(const TCHAR *filename);
+
+/**
+ * 检查文件名是否表示不可回写的流式输出 (标准输出、"pipe:" 开头的管道或 "\\.\pipe\" 开头的命名管道)
+ *
+ * 写入流式输出时不会回写文件头，MP4 等需要回写的格式将以分片 (fragmented) 方式写入
+ *
+ * @param   filename            文件名
+ *
+ * @return  表示流式输出时返回 true, 否则返回 false
+ */
+bool AudioFileWriter_isStreamingOutput(const TCHAR *filename);
 
 /**
  * 打开要写入的音频文件，并返回所创建的 AudioFileWriter 对象
@@ -99,6 +187,24 @@ typedef struct {
 AudioFileWriter *AudioFileWriter_open(const TCHAR *filename,
         const AudioFileFormat *fileFormat, const AudioSampleType *inputSampleType);
 
+/**
+ * 打开要写入的音频文件，文件中包含多个音频流，并返回所创建的 AudioFileWriter 对象
+ *
+ * 各音频流使用各自的编码器，编码后的 packet 由同一个 muxer 交错写入。第一个音频流为默认音频流
+ *
+ * @param   filename                要打开文件的文件名 (如果不存在，则会创建一个新的文件)
+ * @param   fileFormat              要生成音频文件的格式
+ * @param   inputSampleType         输入样本值的样本类型 (各音频流相同)
+ * @param   streamCount             音频流的数量 (1 ~ AUDIO_FILE_WRITER_MAX_STREAM_COUNT)
+ * @param   streamTitles            各音频流的标题，为 NULL 时不设置
+ *
+ * @return  成功时，返回指向已分配和初始化的 AudioFileWriter 对象的指针；
+ *          失败时，返回 NULL
+ */
+AudioFileWriter *AudioFileWriter_openStreams(const TCHAR *filename,
+        const AudioFileFormat *fileFormat, const AudioSampleType *inputSampleType,
+        int streamCount, const TCHAR * const *streamTitles);
+
 /**
  * 写入样本值
  *
@@ -106,17 +212,70 @@ AudioFileWriter *AudioFileWriter_open(const TCHAR *filename,
  * @param   sampleValues            指向存储有要写入样本值的数组的指针 (数据类型和存储方式由 sampleValueFormat 确定)
  * @param   sampleCountPerChannel   要写入样本值的数量 (单个声道)
  *
+ * 样本值按编码器的帧大小送入编码器，不足一帧的部分暂存在内部，与之后写入的样本值合并为完整的帧，
+ * 最后不足一帧的部分在 AudioFileWriter_close() 时送入编码器，因此每次写入的样本数不必是帧大小的整数倍
+ *
+ * 完整的帧直接从 sampleValues 重采样 (仅调整采样格式) 到编码器的 frame 中；格式相同且编码器不会保留 frame
+ * 的引用时直接引用 sampleValues 中的数据送入编码器，不进行复制。本函数返回后不再引用 sampleValues,
+ * 调用者可以立即重用或释放其所指向的内存
+ *
  * @return  成功时，返回实际写入样本值的数量 (单个声道)；
  *          失败时，返回小于 0 的错误码
  */
 int AudioFileWriter_write(AudioFileWriter *obj, void *sampleValues, int sampleCountPerChannel);
 
+/**
+ * 向指定的音频流写入样本值
+ *
+ * 为使各音频流的 packet 在文件中交错存放，应轮流向各音频流写入较短的部分，而不是依次写入各音频流的全部样本值
+ *
+ * @param   obj                     指向 AudioFileWriter 对象的指针
+ * @param   streamIndex             音频流的序号
+ * @param   sampleValues            指向存储有要写入样本值的数组的指针 (要求同 AudioFileWriter_write())
+ * @param   sampleCountPerChannel   要写入样本值的数量 (单个声道)
+ *
+ * @return  成功时，返回实际写入样本值的数量 (单个声道)；
+ *          失败时，返回小于 0 的错误码
+ */
+int AudioFileWriter_writeStream(AudioFileWriter *obj, int streamIndex, void *sampleValues, int sampleCountPerChannel);
+
+/**
+ * 获取指定音频流每次送入编码器的每声道样本数 (编码器的帧大小)
+ *
+ * 每次写入的样本数为该值的整数倍时，样本值不需要暂存到内部的 frame 中
+ *
+ * @param   obj                     指向 AudioFileWriter 对象的指针
+ * @param   streamIndex             音频流的序号
+ *
+ * @return  返回每声道样本数，音频流的序号无效时返回 1
+ */
+int AudioFileWriter_getFrameSampleCount(const AudioFileWriter *obj, int streamIndex);
+
 /**
  * 关闭已打开的音频文件
  *
+ * 送入剩余的样本值并 flush 编码器，写入尾部信息后关闭文件
+ *
  * @param   objPtr          指向 AudioFileWriter 对象的指针的指针
+ *
+ * @return  所有数据都成功写入文件时返回 true, 否则返回 false
+ */
+bool AudioFileWriter_close(AudioFileWriter **objPtr);
+
+/**
+ * 在已写入完成的 MP4 文件的 moov box 中添加一个 udta 子 box
+ *
+ * 要求 moov box 位于文件末尾 (FFmpeg 未指定 faststart 时的默认布局)，如 moov 的最后一个子 box 为 udta,
+ * 则添加到其中，否则在 moov 的末尾添加一个新的 udta box
+ *
+ * @param   filename        MP4 文件的文件名
+ * @param   boxType         要添加 box 的类型 (4 个字符)
+ * @param   data            box 的内容
+ * @param   dataSize        box 的内容的字节数
+ *
+ * @return  成功时返回 true, 失败时返回 false
  */
-void AudioFileWriter_close(AudioFileWriter **objPtr);
+bool AudioFileWriter_addMp4UserData(const TCHAR *filename, const char *boxType, const void *data, int dataSize);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,519 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <Windows.h>
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFile.h"
+#include "BatchScheduler.h"
+
+/** 每个工作线程的任务队列的初始容量 */
+#define BATCH_TASK_QUEUE_INITIAL_CAPACITY       64
+
+/**
+ * 正在处理的输入文件
+ */
+typedef struct {
+    /** 在输入文件列表中的序号 */
+    int                         fileIndex;
+
+    /** 输入音频数据 */
+    AudioDataSource             *audioDataSource;
+
+    /** 分离结果 (各分段直接写入其中对应的位置) */
+    SpleeterProcessorResult     *result;
+
+    /** 分段数量 */
+    int                         regionCount;
+
+    /** 尚未完成的分段数量 */
+    volatile LONG               remainingRegionCount;
+
+    /** 是否有分段处理失败 */
+    volatile LONG               failed;
+
+    /** 开始处理第一个分段的时间，尚未开始时为 0 */
+    double                      splitBeginTime;
+
+    /** 分离结果缓存的缓存键 */
+    ResultCacheKey              cacheKey;
+
+    /** 是否已计算缓存键 (未使用缓存时为 false) */
+    bool                        cacheKeyComputed;
+} BatchFileJob;
+
+/**
+ * 分段任务
+ */
+typedef struct {
+    BatchFileJob    *fileJob;
+    int             regionIndex;
+} BatchRegionTask;
+
+/**
+ * 单个工作线程的任务队列 (环形缓冲区)
+ *
+ * 所属的工作线程从队首取出任务 (先处理较早读取的文件，使其尽快完成并写入)，其他线程从队尾窃取任务
+ */
+typedef struct {
+    BatchRegionTask     *tasks;
+    int                 capacity;
+    int                 head;
+    int                 count;
+    CRITICAL_SECTION    lock;
+} BatchTaskQueue;
+
+/**
+ * 调度器运行时的状态
+ */
+typedef struct {
+    const BatchSchedulerConfig  *config;
+    const InputFileList         *inputFileList;
+    FileProcessingStat          *stats;
+
+    /** 各工作线程的任务队列 */
+    BatchTaskQueue              *queues;
+
+    /** 下一个文件的分段任务放入的队列序号 */
+    int                         nextQueueIndex;
+
+    /** 以下成员由 stateLock 保护 */
+    CRITICAL_SECTION            stateLock;
+
+    /** 所有队列中的任务总数 */
+    int                         pendingTaskCount;
+
+    /** 已读取但尚未写入完成的文件数量 */
+    int                         inFlightFileCount;
+
+    /** 是否已读取完所有输入文件 */
+    bool                        readerFinished;
+
+    /** 有新的任务，或有文件处理完成 */
+    CONDITION_VARIABLE          stateChanged;
+} BatchSchedulerState;
+
+/**
+ * 工作线程的参数
+ */
+typedef struct {
+    BatchSchedulerState     *state;
+    int                     workerIndex;
+} BatchWorkerContext;
+
+static void _queueInit(BatchTaskQueue *queue) {
+    queue->capacity = BATCH_TASK_QUEUE_INITIAL_CAPACITY;
+    queue->tasks = MEMORY_ALLOC_ARRAY(BatchRegionTask, queue->capacity);
+    queue->head = 0;
+    queue->count = 0;
+    InitializeCriticalSection(&queue->lock);
+}
+
+static void _queueDestroy(BatchTaskQueue *queue) {
+    DeleteCriticalSection(&queue->lock);
+    Memory_free(&queue->tasks);
+}
+
+static void _queuePush(BatchTaskQueue *queue, const BatchRegionTask *task) {
+    EnterCriticalSection(&queue->lock);
+
+    if (queue->count >= queue->capacity) {
+        // 扩容时将环形缓冲区中的任务按顺序复制到新的数组中
+        int newCapacity = queue->capacity * 2;
+        BatchRegionTask *newTasks = MEMORY_ALLOC_ARRAY(BatchRegionTask, newCapacity);
+        for (int i = 0; i < queue->count; i++) {
+            newTasks[i] = queue->tasks[(queue->head + i) % queue->capacity];
+        }
+
+        Memory_free(&queue->tasks);
+        queue->tasks = newTasks;
+        queue->capacity = newCapacity;
+        queue->head = 0;
+    }
+
+    queue->tasks[(queue->head + queue->count) % queue->capacity] = *task;
+    queue->count++;
+
+    LeaveCriticalSection(&queue->lock);
+}
+
+/**
+ * 从队首取出任务 (所属的工作线程使用)
+ */
+static bool _queuePopFront(BatchTaskQueue *queue, BatchRegionTask *taskOut) {
+    bool found = false;
+
+    EnterCriticalSection(&queue->lock);
+
+    if (queue->count > 0) {
+        *taskOut = queue->tasks[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        found = true;
+    }
+
+    LeaveCriticalSection(&queue->lock);
+
+    return found;
+}
+
+/**
+ * 从队尾窃取任务 (其他工作线程使用)
+ */
+static bool _queueStealBack(BatchTaskQueue *queue, BatchRegionTask *taskOut) {
+    bool found = false;
+
+    EnterCriticalSection(&queue->lock);
+
+    if (queue->count > 0) {
+        queue->count--;
+        *taskOut = queue->tasks[(queue->head + queue->count) % queue->capacity];
+        found = true;
+    }
+
+    LeaveCriticalSection(&queue->lock);
+
+    return found;
+}
+
+/**
+ * 取出一个分段任务，优先从自己的队列中取，否则从任务最多的其他队列中窃取
+ */
+static bool _tryTakeTask(BatchSchedulerState *state, int workerIndex, BatchRegionTask *taskOut) {
+    int workerCount = state->config->workerCount;
+
+    if (_queuePopFront(&state->queues[workerIndex], taskOut)) {
+        return true;
+    }
+
+    // 队列长度只用于选择窃取对象，不加锁读取即可
+    int victimIndex = -1;
+    int victimCount = 0;
+    for (int i = 1; i < workerCount; i++) {
+        int index = (workerIndex + i) % workerCount;
+        int count = *(volatile int *)&state->queues[index].count;
+        if (count > victimCount) {
+            victimIndex = index;
+            victimCount = count;
+        }
+    }
+
+    if ((victimIndex >= 0) && _queueStealBack(&state->queues[victimIndex], taskOut)) {
+        return true;
+    }
+
+    // 选择的队列已被取空时，依次尝试其他队列
+    for (int i = 1; i < workerCount; i++) {
+        int index = (workerIndex + i) % workerCount;
+        if (_queueStealBack(&state->queues[index], taskOut)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * 等待并取出一个分段任务
+ *
+ * @return  取到任务时返回 true, 所有文件都已处理完成时返回 false
+ */
+static bool _takeTask(BatchSchedulerState *state, int workerIndex, BatchRegionTask *taskOut) {
+    while (true) {
+        if (_tryTakeTask(state, workerIndex, taskOut)) {
+            EnterCriticalSection(&state->stateLock);
+            state->pendingTaskCount--;
+            LeaveCriticalSection(&state->stateLock);
+
+            return true;
+        }
+
+        EnterCriticalSection(&state->stateLock);
+
+        while ((state->pendingTaskCount == 0) && !(state->readerFinished && (state->inFlightFileCount == 0))) {
+            SleepConditionVariableCS(&state->stateChanged, &state->stateLock, INFINITE);
+        }
+
+        bool allFinished = (state->pendingTaskCount == 0) && state->readerFinished && (state->inFlightFileCount == 0);
+
+        LeaveCriticalSection(&state->stateLock);
+
+        if (allFinished) {
+            return false;
+        }
+    }
+}
+
+static void _freeFileJob(BatchFileJob **fileJobPtr) {
+    BatchFileJob *fileJob = *fileJobPtr;
+
+    if (fileJob->result != NULL) {
+        SpleeterProcessorResult_free(&fileJob->result);
+    }
+    if (fileJob->audioDataSource != NULL) {
+        AudioDataSource_free(&fileJob->audioDataSource);
+    }
+
+    Memory_free(fileJobPtr);
+}
+
+/**
+ * 文件的所有分段都已完成，写入输出文件 (在完成最后一个分段的工作线程中执行)
+ */
+static void _finishFileJob(BatchSchedulerState *state, BatchFileJob *fileJob) {
+    const TCHAR *inputFileFullPath = state->inputFileList->filePaths[fileJob->fileIndex];
+    FileProcessingStat *stat = &state->stats[fileJob->fileIndex];
+
+    stat->splitSeconds = Common_getTimeInSeconds() - fileJob->splitBeginTime;
+
+    if (fileJob->failed) {
+        MSG_ERROR(_T("Failed to split input file \"%s\".\n"), inputFileFullPath);
+    } else {
+        if (fileJob->cacheKeyComputed) {
+            ResultCache_store(state->config->resultCache, &fileJob->cacheKey, fileJob->result);
+        }
+
+        double writeBeginTime = Common_getTimeInSeconds();
+        stat->succeeded = TrackOutput_writeFiles(state->config->outputConfig, inputFileFullPath, fileJob->audioDataSource, fileJob->result);
+        stat->writeSeconds = Common_getTimeInSeconds() - writeBeginTime;
+    }
+
+    MSG_INFO(_T("Finished [%d/%d]: %s\n"), (fileJob->fileIndex + 1), state->inputFileList->fileCount, inputFileFullPath);
+
+    _freeFileJob(&fileJob);
+
+    EnterCriticalSection(&state->stateLock);
+    state->inFlightFileCount--;
+    LeaveCriticalSection(&state->stateLock);
+
+    // 唤醒等待空闲文件槽位的读取线程，以及等待结束的工作线程
+    WakeAllConditionVariable(&state->stateChanged);
+}
+
+static unsigned __stdcall _workerThreadProc(void *arg) {
+    BatchWorkerContext *context = (BatchWorkerContext *)arg;
+    BatchSchedulerState *state = context->state;
+
+    // 多个文件同时处理，不输出单个文件的进度
+    Common_setProgressMuted(true);
+
+    BatchRegionTask task;
+    while (_takeTask(state, context->workerIndex, &task)) {
+        BatchFileJob *fileJob = task.fileJob;
+
+        if (!fileJob->failed) {
+            SpleeterProcessorRegion region;
+            SpleeterProcessor_getRegion(fileJob->audioDataSource->sampleCountPerChannel, task.regionIndex, &region);
+
+            if (SpleeterProcessor_processRegion(state->config->model, fileJob->audioDataSource, &region, fileJob->result) != 0) {
+                InterlockedExchange(&fileJob->failed, 1);
+            }
+        }
+
+        if (InterlockedDecrement(&fileJob->remainingRegionCount) == 0) {
+            _finishFileJob(state, fileJob);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * 将读取完成的文件拆分为分段任务，全部放入同一个工作线程的队列中 (由其他空闲的工作线程窃取)
+ */
+static void _submitFileJob(BatchSchedulerState *state, BatchFileJob *fileJob) {
+    BatchTaskQueue *queue = &state->queues[state->nextQueueIndex];
+    state->nextQueueIndex = (state->nextQueueIndex + 1) % state->config->workerCount;
+
+    fileJob->splitBeginTime = Common_getTimeInSeconds();
+
+    for (int i = 0; i < fileJob->regionCount; i++) {
+        BatchRegionTask task = {
+            .fileJob = fileJob,
+            .regionIndex = i
+        };
+        _queuePush(queue, &task);
+    }
+
+    EnterCriticalSection(&state->stateLock);
+    state->pendingTaskCount += fileJob->regionCount;
+    LeaveCriticalSection(&state->stateLock);
+
+    WakeAllConditionVariable(&state->stateChanged);
+}
+
+/**
+ * 依次读取所有输入文件并提交分段任务 (在调用线程中执行)
+ *
+ * 同时处于处理中的文件数量不超过工作线程数量加 1，以限制内存占用
+ */
+static void _readAllFiles(BatchSchedulerState *state) {
+    const InputFileList *inputFileList = state->inputFileList;
+    int maxInFlightFileCount = state->config->workerCount + 1;
+
+    for (int i = 0; i < inputFileList->fileCount; i++) {
+        const TCHAR *inputFileFullPath = inputFileList->filePaths[i];
+        FileProcessingStat *stat = &state->stats[i];
+
+        EnterCriticalSection(&state->stateLock);
+        while (state->inFlightFileCount >= maxInFlightFileCount) {
+            SleepConditionVariableCS(&state->stateChanged, &state->stateLock, INFINITE);
+        }
+        LeaveCriticalSection(&state->stateLock);
+
+        MSG_INFO(_T("Reading [%d/%d]: %s\n"), (i + 1), inputFileList->fileCount, inputFileFullPath);
+
+        double readBeginTime = Common_getTimeInSeconds();
+        AudioDataSource *audioDataSource = PcmCache_readAll(state->config->pcmCache, inputFileFullPath, &state->config->outputConfig->sampleType);
+        stat->readSeconds = Common_getTimeInSeconds() - readBeginTime;
+
+        if (audioDataSource == NULL) {
+            MSG_ERROR(_T("Failed to read input file \"%s\".\n"), inputFileFullPath);
+            continue;
+        }
+
+        stat->audioSeconds = (double)audioDataSource->sampleCountPerChannel / (double)audioDataSource->sampleRate;
+
+        BatchFileJob *fileJob = MEMORY_ALLOC_STRUCT(BatchFileJob);
+        fileJob->fileIndex = i;
+        fileJob->audioDataSource = audioDataSource;
+        fileJob->regionCount = SpleeterProcessor_getRegionCount(audioDataSource->sampleCountPerChannel);
+        fileJob->remainingRegionCount = fileJob->regionCount;
+
+        if (fileJob->regionCount <= 0) {
+            MSG_ERROR(_T("Failed to split input file \"%s\".\n"), inputFileFullPath);
+            _freeFileJob(&fileJob);
+            continue;
+        }
+
+        // 命中缓存时直接在读取线程中写入输出文件，不产生分段任务
+        if (state->config->resultCache != NULL) {
+            fileJob->cacheKeyComputed = ResultCache_computeKey(&fileJob->cacheKey, state->config->model->modelName, audioDataSource);
+
+            if (fileJob->cacheKeyComputed) {
+                fileJob->result = ResultCache_load(state->config->resultCache, &fileJob->cacheKey, state->config->model->modelInfo);
+            }
+
+            if (fileJob->result != NULL) {
+                double writeBeginTime = Common_getTimeInSeconds();
+                stat->succeeded = TrackOutput_writeFiles(state->config->outputConfig, inputFileFullPath, audioDataSource, fileJob->result);
+                stat->writeSeconds = Common_getTimeInSeconds() - writeBeginTime;
+
+                MSG_INFO(_T("Finished [%d/%d] (cached): %s\n"), (i + 1), inputFileList->fileCount, inputFileFullPath);
+
+                _freeFileJob(&fileJob);
+                continue;
+            }
+        }
+
+        fileJob->result = SpleeterProcessorResult_alloc(state->config->model->modelInfo, audioDataSource->sampleCountPerChannel);
+
+        EnterCriticalSection(&state->stateLock);
+        state->inFlightFileCount++;
+        LeaveCriticalSection(&state->stateLock);
+
+        _submitFileJob(state, fileJob);
+    }
+
+    EnterCriticalSection(&state->stateLock);
+    state->readerFinished = true;
+    LeaveCriticalSection(&state->stateLock);
+
+    WakeAllConditionVariable(&state->stateChanged);
+}
+
+bool BatchScheduler_run(const BatchSchedulerConfig *config, const InputFileList *inputFileList, FileProcessingStat *stats) {
+    bool succeeded = false;
+
+    int workerCount = config->workerCount;
+
+    BatchSchedulerState state = {
+        .config = config,
+        .inputFileList = inputFileList,
+        .stats = stats
+    };
+
+    InitializeCriticalSection(&state.stateLock);
+    InitializeConditionVariable(&state.stateChanged);
+
+    state.queues = MEMORY_ALLOC_ARRAY(BatchTaskQueue, workerCount);
+    for (int i = 0; i < workerCount; i++) {
+        _queueInit(&state.queues[i]);
+    }
+
+    BatchWorkerContext *workerContexts = MEMORY_ALLOC_ARRAY(BatchWorkerContext, workerCount);
+    HANDLE *workerThreads = MEMORY_ALLOC_ARRAY(HANDLE, workerCount);
+    int startedWorkerCount = 0;
+
+    for (int i = 0; i < workerCount; i++) {
+        workerContexts[i].state = &state;
+        workerContexts[i].workerIndex = i;
+
+        workerThreads[i] = (HANDLE)_beginthreadex(NULL, 0, _workerThreadProc, &workerContexts[i], 0, NULL);
+        if (workerThreads[i] == NULL) {
+            MSG_ERROR(_T("Failed to start worker thread.\n"));
+            break;
+        }
+
+        startedWorkerCount++;
+    }
+
+    // 读取线程的进度输出与工作线程的输出会交错，因此同样不输出
+    Common_setProgressMuted(true);
+
+    if (startedWorkerCount > 0) {
+        _readAllFiles(&state);
+    } else {
+        // 没有可用的工作线程，不读取任何文件
+        EnterCriticalSection(&state.stateLock);
+        state.readerFinished = true;
+        LeaveCriticalSection(&state.stateLock);
+    }
+
+    for (int i = 0; i < startedWorkerCount; i++) {
+        WaitForSingleObject(workerThreads[i], INFINITE);
+        CloseHandle(workerThreads[i]);
+    }
+
+    Common_setProgressMuted(false);
+
+    succeeded = (startedWorkerCount == workerCount);
+
+    Memory_free(&workerThreads);
+    Memory_free(&workerContexts);
+
+    for (int i = 0; i < workerCount; i++) {
+        _queueDestroy(&state.queues[i]);
+    }
+    Memory_free(&state.queues);
+
+    DeleteCriticalSection(&state.stateLock);
+
+    return succeeded;
+}
@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _BATCH_SCHEDULER_H_
+#define _BATCH_SCHEDULER_H_
+
+#include "Common.h"
+#include "InputFileList.h"
+#include "PcmCache.h"
+#include "ResultCache.h"
+#include "SpleeterProcessor.h"
+#include "TrackOutput.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 单个输入文件的处理统计信息
+ */
+typedef struct {
+    /** 音频时长 (以秒为单位) */
+    double      audioSeconds;
+
+    /** 读取 (解码) 耗时 */
+    double      readSeconds;
+
+    /** 分离耗时 (从开始处理第一个分段到最后一个分段处理完成) */
+    double      splitSeconds;
+
+    /** 写入 (编码) 耗时 */
+    double      writeSeconds;
+
+    /** 是否处理成功 */
+    bool        succeeded;
+} FileProcessingStat;
+
+/**
+ * 批量处理调度器的配置
+ */
+typedef struct {
+    /** 已加载的模型 (所有文件共用) */
+    SpleeterModel               *model;
+
+    /** 输出配置 */
+    const TrackOutputConfig     *outputConfig;
+
+    /** 工作线程数量 (即同时处理的分段数量) */
+    int                         workerCount;
+
+    /** 分离结果缓存，为 NULL 时不使用缓存 */
+    ResultCache                 *resultCache;
+
+    /** 解码后 PCM 数据的缓存，为 NULL 时不使用缓存 */
+    PcmCache                    *pcmCache;
+} BatchSchedulerConfig;
+
+/**
+ * 使用跨文件的分段调度批量处理输入文件
+ *
+ * 每个输入文件在读取完成后被拆分为多个分段 (与 SpleeterProcessor_splitWithModel() 的分段方式相同)，
+ * 分段任务被放入各工作线程的任务队列中，空闲的工作线程会从其他线程的队列中窃取任务，
+ * 因此长文件的分段也能被所有工作线程分担。某个文件的所有分段完成后，由完成最后一个分段的工作线程写入该文件的输出文件
+ *
+ * @param   config          调度器配置
+ * @param   inputFileList   输入文件列表
+ * @param   stats           各输入文件的处理统计信息 (数组长度与 inputFileList->fileCount 相同)
+ *
+ * @return  所有工作线程都正常启动并结束时返回 true, 否则返回 false (各文件是否处理成功见 stats)
+ */
+bool BatchScheduler_run(const BatchSchedulerConfig *config, const InputFileList *inputFileList, FileProcessingStat *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _BATCH_SCHEDULER_H_
@@ -29,6 +29,7 @@
 #include <string.h>
 #include <math.h>
 #include <time.h>
+#include <Windows.h>
 #include "Common.h"
 
 bool g_verboseMode = false;
@@ -37,15 +38,29 @@ bool g_debugMode = false;
 
 static const double _MIN_CHANGE = 1.0;
 
-static void _processProgress(double basePercentage, double currentStagePercentage, int stageProgress, int stageTotal,
+static __declspec(thread) bool _progressMuted = false;
+
+static __declspec(thread) ProgressCallback _progressCallback = NULL;
+
+static __declspec(thread) void *_progressCallbackUserData = NULL;
+
+static void _processProgress(Stage stage, double basePercentage, double currentStagePercentage, int stageProgress, int stageTotal,
         const char *printProgressFormat) {
-    static double lastProgress = 0.0;
+    // 各线程分别记录上次输出的进度 (服务模式下多个任务同时在不同线程中处理)
+    static __declspec(thread) double lastProgress = 0.0;
 
     double progress = basePercentage + ((double)stageProgress / (double)stageTotal) * currentStagePercentage;
 
     if ((stageProgress == 0)
             || (stageProgress == stageTotal)
             || (fabs(progress - lastProgress) >= _MIN_CHANGE)) {
+        if (_progressCallback != NULL) {
+            _progressCallback(_progressCallbackUserData, stage, progress, stageProgress, stageTotal);
+
+            lastProgress = progress;
+            return;
+        }
+
         printf("[%6.2f%%] ", progress);
 
         /*
@@ -65,10 +80,14 @@ static void _processProgress(double basePercentage, double currentStagePercentag
 }
 
 #define PROCESS_PROGRESS(basePercentage, currentStagePercentage, printProgressFormat)       do {                    \
-    _processProgress(basePercentage, currentStagePercentage, stageProgress, stageTotal, printProgressFormat);       \
+    _processProgress(stage, basePercentage, currentStagePercentage, stageProgress, stageTotal, printProgressFormat); \
 } while (0)
 
 void Common_updateProgress(Stage stage, int stageProgress, int stageTotal) {
+    if (_progressMuted) {
+        return;
+    }
+
     switch (stage) {
         case STAGE_AUDIO_FILE_READER:
             PROCESS_PROGRESS(0.0,   2.0,    "Reading audio samples, %d/%d");
@@ -90,3 +109,61 @@ void Common_updateProgress(Stage stage, int stageProgress, int stageTotal) {
             break;
     }
 }
+
+void Common_setProgressMuted(bool muted) {
+    _progressMuted = muted;
+}
+
+void Common_setProgressCallback(ProgressCallback callback, void *userData) {
+    _progressCallback = callback;
+    _progressCallbackUserData = userData;
+}
+
+double Common_getTimeInSeconds(void) {
+    static LARGE_INTEGER frequency = { 0 };
+
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+double Common_parseDecimal(const TCHAR *str, const TCHAR **endPtr) {
+    double mantissa = 0.0;
+    int digitCount = 0;
+    int fractionDigitCount = 0;
+    bool hasDecimalPoint = false;
+
+    const TCHAR *p = str;
+    for (; ; p++) {
+        if ((*p >= _T('0')) && (*p <= _T('9'))) {
+            mantissa = (mantissa * 10.0) + (double)(*p - _T('0'));
+            digitCount++;
+            if (hasDecimalPoint) {
+                fractionDigitCount++;
+            }
+        } else if ((*p == _T('.')) && !hasDecimalPoint) {
+            hasDecimalPoint = true;
+        } else {
+            break;
+        }
+    }
+
+    if (digitCount == 0) {
+        if (endPtr != NULL) {
+            *endPtr = str;
+        }
+        return 0.0;
+    }
+
+    if (endPtr != NULL) {
+        *endPtr = p;
+    }
+
+    // 最后一次性除以 10 的幂，避免逐位累加小数部分带来的误差
+    return (fractionDigitCount > 0) ? (mantissa / pow(10.0, fractionDigitCount)) : mantissa;
+}
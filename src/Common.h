@@ -84,6 +84,55 @@ typedef enum {
 
 void Common_updateProgress(Stage stage, int stageProgress, int stageTotal);
 
+/**
+ * 设置当前线程是否输出处理进度
+ *
+ * 用于批量处理时在后台线程中预读下一个文件，避免其进度信息与当前文件的进度信息交错输出
+ *
+ * @param   muted           为 true 时，当前线程中调用的 Common_updateProgress() 不产生任何输出
+ */
+void Common_setProgressMuted(bool muted);
+
+/**
+ * 处理进度回调函数
+ *
+ * @param   userData            调用 Common_setProgressCallback() 时传入的用户数据
+ * @param   stage               当前所处的阶段
+ * @param   progress            总体进度 (0.0 至 100.0)
+ * @param   stageProgress       当前阶段的进度
+ * @param   stageTotal          当前阶段的总量
+ */
+typedef void (*ProgressCallback)(void *userData, Stage stage, double progress, int stageProgress, int stageTotal);
+
+/**
+ * 设置当前线程的处理进度回调函数
+ *
+ * 设置后，当前线程中调用的 Common_updateProgress() 不再向标准输出打印进度，而是调用该回调函数
+ *
+ * @param   callback        回调函数，为 NULL 时恢复为向标准输出打印进度
+ * @param   userData        传递给回调函数的用户数据
+ */
+void Common_setProgressCallback(ProgressCallback callback, void *userData);
+
+/**
+ * 获取高精度计时器的当前时间
+ *
+ * @return  以秒为单位的当前时间 (仅用于计算时间间隔)
+ */
+double Common_getTimeInSeconds(void);
+
+/**
+ * 解析非负十进制数 (由数字和最多一个小数点组成，如 "12", "0.5", ".5")
+ *
+ * 不使用 _tcstod()，小数点固定为 '.'，不受 setlocale() 所设置的区域影响
+ *
+ * @param   str             要解析的文本
+ * @param   endPtr          用于存放解析结束位置的指针，没有可解析的数字时为 str (可为 NULL)
+ *
+ * @return  返回所解析的数值，没有可解析的数字时返回 0.0
+ */
+double Common_parseDecimal(const TCHAR *str, const TCHAR **endPtr);
+
 #ifdef __cplusplus
 }
 #endif
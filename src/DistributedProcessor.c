@@ -0,0 +1,530 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <Windows.h>
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFileCommon.h"
+#include "SocketEndpoint.h"
+#include "DistributedProcessor.h"
+
+/** 请求的标识 ("SPRQ") */
+#define DISTRIBUTED_REQUEST_MAGIC           0x51525053
+
+/** 响应的标识 ("SPRS") */
+#define DISTRIBUTED_RESPONSE_MAGIC          0x53525053
+
+/** 协议版本 */
+#define DISTRIBUTED_PROTOCOL_VERSION        1
+
+/** 请求中模型名称的最大长度 (UTF-8，包括结尾的 '\0') */
+#define DISTRIBUTED_MODEL_NAME_MAX_SIZE     64
+
+/** 等待工作端响应的超时时间 (以毫秒为单位)，超时后认为该连接已失败 */
+#define DISTRIBUTED_RESPONSE_TIMEOUT        (10 * 60 * 1000)
+
+/**
+ * 分段请求，其后为送入模型的波形的样本值 (32 位浮点数，声道交错存储，共 waveformLength * channelCount 个)
+ */
+typedef struct {
+    uint32_t    magic;
+    uint32_t    version;
+    char        modelName[DISTRIBUTED_MODEL_NAME_MAX_SIZE];
+    int32_t     channelCount;
+    int32_t     waveformLength;
+    int32_t     useStart;
+    int32_t     useLength;
+} DistributedRegionRequest;
+
+/**
+ * 分段响应，status 为 0 时其后依次为各音轨有效部分的样本值 (每个音轨 useLength * 声道数 个 32 位浮点数)
+ */
+typedef struct {
+    uint32_t    magic;
+    int32_t     status;
+    int32_t     trackCount;
+    int32_t     useLength;
+} DistributedRegionResponse;
+
+/**
+ * 工作端的一个连接
+ */
+typedef struct {
+    SOCKET          socket;
+    SpleeterModel   *model;
+    const char      *modelNameUtf8;
+} DistributedWorkerConnection;
+
+/**
+ * 协调端正在处理的音频
+ */
+typedef struct {
+    const DistributedCoordinatorConfig  *config;
+    AudioDataSource                     *audioDataSource;
+    SpleeterProcessorResult             *result;
+    int                                 regionCount;
+
+    /** 以下成员由 lock 保护 */
+    CRITICAL_SECTION                    lock;
+
+    /** 等待处理的分段序号 (栈，栈顶为序号最小的分段) */
+    int                                 *pendingRegionIndexes;
+    int                                 pendingRegionCount;
+
+    /** 已完成的分段数量 */
+    int                                 completedRegionCount;
+
+    /** 仍然可用的连接数量 */
+    int                                 liveConnectionCount;
+
+    /** 有分段完成、分段被放回队列或连接失败 */
+    CONDITION_VARIABLE                  changed;
+} DistributedJob;
+
+/**
+ * 协调端的一个连接
+ */
+typedef struct {
+    DistributedJob      *job;
+    const TCHAR         *endpoint;
+} DistributedCoordinatorConnection;
+
+bool DistributedProcessor_parseWorkerEndpointList(DistributedCoordinatorConfig *config, TCHAR *endpointList) {
+    TCHAR *p = endpointList;
+
+    while (*p != _T('\0')) {
+        TCHAR *separator = _tcschr(p, _T(';'));
+        if (separator != NULL) {
+            *separator = _T('\0');
+        }
+
+        if (_tcsclen(p) > 0) {
+            if (config->workerEndpointCount >= DISTRIBUTED_WORKER_ENDPOINT_MAX_COUNT) {
+                MSG_ERROR(_T("Too many worker endpoints (max %d).\n"), DISTRIBUTED_WORKER_ENDPOINT_MAX_COUNT);
+                return false;
+            }
+
+            config->workerEndpoints[config->workerEndpointCount++] = p;
+        }
+
+        if (separator == NULL) {
+            break;
+        }
+        p = separator + 1;
+    }
+
+    return (config->workerEndpointCount > 0);
+}
+
+//////////////////////////////////////////////////////////////// 工作端 ////////////////////////////////////////////////////////////////
+
+/**
+ * 处理一个分段请求
+ *
+ * @return  可以继续处理同一连接上的下一个请求时返回 true, 连接已断开或协议错误时返回 false
+ */
+static bool _handleRegionRequest(DistributedWorkerConnection *connection) {
+    DistributedRegionRequest request;
+    if (!SocketEndpoint_receiveAll(connection->socket, &request, sizeof(request))) {
+        // 协调端已关闭连接
+        return false;
+    }
+
+    request.modelName[DISTRIBUTED_MODEL_NAME_MAX_SIZE - 1] = '\0';
+
+    if ((request.magic != DISTRIBUTED_REQUEST_MAGIC) || (request.version != DISTRIBUTED_PROTOCOL_VERSION)
+            || (request.channelCount != SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)
+            || (request.waveformLength <= 0) || (request.useStart < 0) || (request.useLength <= 0)
+            || ((request.useStart + request.useLength) > request.waveformLength)) {
+        MSG_WARNING(_T("Received an invalid region request, closing the connection.\n"));
+        return false;
+    }
+
+    SpleeterModelAudioSampleValue_t *waveform = MEMORY_ALLOC_ARRAY(SpleeterModelAudioSampleValue_t,
+            ((int64_t)request.waveformLength * request.channelCount));
+    if (!SocketEndpoint_receiveAll(connection->socket, waveform,
+            ((int64_t)request.waveformLength * request.channelCount * sizeof(SpleeterModelAudioSampleValue_t)))) {
+        Memory_free(&waveform);
+        return false;
+    }
+
+    DistributedRegionResponse response = {
+        .magic = DISTRIBUTED_RESPONSE_MAGIC,
+        .status = 0,
+        .trackCount = 0,
+        .useLength = request.useLength
+    };
+
+    SpleeterProcessorResult *result = NULL;
+
+    // 模型不一致时不能混用结果，返回错误
+    if (strcmp(request.modelName, connection->modelNameUtf8) != 0) {
+        MSG_WARNING(_T("Requested model \"") _T(A_STR_FMT) _T("\" is different from the loaded model \"") _T(A_STR_FMT) _T("\".\n"),
+                request.modelName, connection->modelNameUtf8);
+        response.status = -1;
+    } else {
+        AudioDataSource *audioDataSource = AudioDataSource_alloc();
+        audioDataSource->sampleRate = SPLEETER_MODEL_AUDIO_SAMPLE_RATE;
+        audioDataSource->channelCount = request.channelCount;
+        audioDataSource->sampleCountPerChannel = request.waveformLength;
+        audioDataSource->sampleValues = waveform;
+
+        // 收到的波形即为整个分段，有效部分从 useStart 开始
+        SpleeterProcessorRegion region = {
+            .offset = request.useStart,
+            .length = request.useLength,
+            .waveformOffset = 0,
+            .waveformLength = request.waveformLength
+        };
+
+        result = SpleeterProcessorResult_alloc(connection->model->modelInfo, request.waveformLength);
+        if (SpleeterProcessor_processRegion(connection->model, audioDataSource, &region, result) != 0) {
+            response.status = -1;
+        } else {
+            response.trackCount = result->trackCount;
+        }
+
+        // 样本值数组的所有权已转移给 audioDataSource
+        AudioDataSource_free(&audioDataSource);
+        waveform = NULL;
+    }
+
+    bool succeeded = SocketEndpoint_sendAll(connection->socket, &response, sizeof(response));
+
+    for (int i = 0; succeeded && (i < response.trackCount); i++) {
+        const SpleeterModelAudioSampleValue_t *trackSampleValues = result->trackList[i].audioDataSource->sampleValues
+                + ((int64_t)request.useStart * request.channelCount);
+        succeeded = SocketEndpoint_sendAll(connection->socket, trackSampleValues,
+                ((int64_t)request.useLength * request.channelCount * sizeof(SpleeterModelAudioSampleValue_t)));
+    }
+
+    if (result != NULL) {
+        SpleeterProcessorResult_free(&result);
+    }
+    if (waveform != NULL) {
+        Memory_free(&waveform);
+    }
+
+    return succeeded;
+}
+
+static unsigned __stdcall _workerConnectionThreadProc(void *arg) {
+    DistributedWorkerConnection *connection = (DistributedWorkerConnection *)arg;
+
+    // 工作端同时处理多个连接，不输出进度
+    Common_setProgressMuted(true);
+
+    int regionCount = 0;
+    while (_handleRegionRequest(connection)) {
+        regionCount++;
+    }
+
+    MSG_INFO(_T("Connection closed after %d regions\n"), regionCount);
+
+    shutdown(connection->socket, SD_BOTH);
+    closesocket(connection->socket);
+    Memory_free(&connection);
+
+    return 0;
+}
+
+bool DistributedProcessor_runWorker(const DistributedWorkerConfig *config) {
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        MSG_ERROR(_T("Failed to initialize Winsock.\n"));
+        return false;
+    }
+
+    SpleeterModel *model = SpleeterModel_load(config->modelName);
+    if (model == NULL) {
+        return false;
+    }
+
+    char *modelNameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(config->modelName);
+
+    SOCKET listenSocket = SocketEndpoint_listen(config->endpoint, true);
+    if (listenSocket == INVALID_SOCKET) {
+        return false;
+    }
+
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("Worker listening on %s (model %s)\n"), config->endpoint, config->modelName);
+
+    while (true) {
+        SOCKET clientSocket = accept(listenSocket, NULL, NULL);
+        if (clientSocket == INVALID_SOCKET) {
+            MSG_WARNING(_T("Failed to accept connection (error %d).\n"), WSAGetLastError());
+            continue;
+        }
+
+        BOOL noDelay = TRUE;
+        setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, (const char *)&noDelay, sizeof(noDelay));
+
+        DistributedWorkerConnection *connection = MEMORY_ALLOC_STRUCT(DistributedWorkerConnection);
+        connection->socket = clientSocket;
+        connection->model = model;
+        connection->modelNameUtf8 = modelNameUtf8;
+
+        HANDLE threadHandle = (HANDLE)_beginthreadex(NULL, 0, _workerConnectionThreadProc, connection, 0, NULL);
+        if (threadHandle == NULL) {
+            MSG_WARNING(_T("Failed to start connection thread.\n"));
+            closesocket(clientSocket);
+            Memory_free(&connection);
+            continue;
+        }
+        CloseHandle(threadHandle);
+
+        MSG_INFO(_T("Accepted a coordinator connection\n"));
+    }
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////// 协调端 ////////////////////////////////////////////////////////////////
+
+/**
+ * 将一个分段发送给工作端处理，并将返回的各音轨样本值写入结果中
+ *
+ * @return  成功时返回 true, 连接失败或工作端返回错误时返回 false
+ */
+static bool _processRemoteRegion(SOCKET socket, DistributedJob *job, int regionIndex) {
+    const AudioDataSource *audioDataSource = job->audioDataSource;
+
+    SpleeterProcessorRegion region;
+    SpleeterProcessor_getRegion(audioDataSource->sampleCountPerChannel, regionIndex, &region);
+
+    DistributedRegionRequest request = {
+        .magic = DISTRIBUTED_REQUEST_MAGIC,
+        .version = DISTRIBUTED_PROTOCOL_VERSION,
+        .channelCount = audioDataSource->channelCount,
+        .waveformLength = region.waveformLength,
+        .useStart = region.offset - region.waveformOffset,
+        .useLength = region.length
+    };
+
+    char *modelNameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(job->config->modelName);
+    strncpy(request.modelName, modelNameUtf8, (DISTRIBUTED_MODEL_NAME_MAX_SIZE - 1));
+    Memory_free(&modelNameUtf8);
+
+    // 直接发送输入音频中的波形，不复制
+    if (!SocketEndpoint_sendAll(socket, &request, sizeof(request))
+            || !SocketEndpoint_sendAll(socket, (audioDataSource->sampleValues + ((int64_t)region.waveformOffset * audioDataSource->channelCount)),
+                ((int64_t)region.waveformLength * audioDataSource->channelCount * sizeof(SpleeterModelAudioSampleValue_t)))) {
+        return false;
+    }
+
+    DistributedRegionResponse response;
+    if (!SocketEndpoint_receiveAll(socket, &response, sizeof(response))) {
+        return false;
+    }
+
+    if ((response.magic != DISTRIBUTED_RESPONSE_MAGIC) || (response.status != 0)
+            || (response.trackCount != job->result->trackCount) || (response.useLength != region.length)) {
+        return false;
+    }
+
+    // 直接接收到结果中对应的位置 (失败时该分段会被重新处理并覆盖)
+    for (int i = 0; i < response.trackCount; i++) {
+        SpleeterModelAudioSampleValue_t *trackSampleValues = job->result->trackList[i].audioDataSource->sampleValues
+                + ((int64_t)region.offset * audioDataSource->channelCount);
+        if (!SocketEndpoint_receiveAll(socket, trackSampleValues,
+                ((int64_t)region.length * audioDataSource->channelCount * sizeof(SpleeterModelAudioSampleValue_t)))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static unsigned __stdcall _coordinatorConnectionThreadProc(void *arg) {
+    DistributedCoordinatorConnection *connection = (DistributedCoordinatorConnection *)arg;
+    DistributedJob *job = connection->job;
+
+    SOCKET socket = SocketEndpoint_connect(connection->endpoint);
+    if (socket != INVALID_SOCKET) {
+        DWORD timeout = DISTRIBUTED_RESPONSE_TIMEOUT;
+        setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+        setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, (const char *)&timeout, sizeof(timeout));
+    }
+
+    while (socket != INVALID_SOCKET) {
+        EnterCriticalSection(&job->lock);
+
+        // 没有等待处理的分段，但其他连接上仍有正在处理的分段时继续等待 (这些分段可能会被放回队列)
+        while ((job->pendingRegionCount == 0) && (job->completedRegionCount < job->regionCount)) {
+            SleepConditionVariableCS(&job->changed, &job->lock, INFINITE);
+        }
+
+        if (job->pendingRegionCount == 0) {
+            LeaveCriticalSection(&job->lock);
+            break;
+        }
+
+        int regionIndex = job->pendingRegionIndexes[--job->pendingRegionCount];
+
+        LeaveCriticalSection(&job->lock);
+
+        bool succeeded = _processRemoteRegion(socket, job, regionIndex);
+
+        EnterCriticalSection(&job->lock);
+        if (succeeded) {
+            job->completedRegionCount++;
+        } else {
+            // 放回队列，由其他连接处理
+            job->pendingRegionIndexes[job->pendingRegionCount++] = regionIndex;
+        }
+        LeaveCriticalSection(&job->lock);
+
+        WakeAllConditionVariable(&job->changed);
+
+        if (!succeeded) {
+            MSG_WARNING(_T("Worker \"%s\" failed, region %d has been re-queued.\n"), connection->endpoint, regionIndex);
+
+            closesocket(socket);
+            socket = INVALID_SOCKET;
+        }
+    }
+
+    if (socket != INVALID_SOCKET) {
+        shutdown(socket, SD_BOTH);
+        closesocket(socket);
+    }
+
+    EnterCriticalSection(&job->lock);
+    job->liveConnectionCount--;
+    LeaveCriticalSection(&job->lock);
+
+    WakeAllConditionVariable(&job->changed);
+
+    return 0;
+}
+
+int DistributedProcessor_split(const DistributedCoordinatorConfig *config, AudioDataSource *audioDataSource,
+        SpleeterProcessorResult **resultOut) {
+    if ((audioDataSource->sampleRate != SPLEETER_MODEL_AUDIO_SAMPLE_RATE)
+            || (audioDataSource->channelCount != SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)
+            || (audioDataSource->sampleCountPerChannel <= 0)) {
+        MSG_ERROR(_T("The input audio does not match the model.\n"));
+        return -1;
+    }
+
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        MSG_ERROR(_T("Failed to initialize Winsock.\n"));
+        return -1;
+    }
+
+    DistributedJob job = {
+        .config = config,
+        .audioDataSource = audioDataSource,
+        .regionCount = SpleeterProcessor_getRegionCount(audioDataSource->sampleCountPerChannel)
+    };
+
+    InitializeCriticalSection(&job.lock);
+    InitializeConditionVariable(&job.changed);
+
+    job.result = SpleeterProcessorResult_alloc(config->modelInfo, audioDataSource->sampleCountPerChannel);
+
+    // 倒序入栈，使序号小的分段先被处理
+    job.pendingRegionIndexes = MEMORY_ALLOC_ARRAY(int, job.regionCount);
+    for (int i = 0; i < job.regionCount; i++) {
+        job.pendingRegionIndexes[i] = job.regionCount - 1 - i;
+    }
+    job.pendingRegionCount = job.regionCount;
+
+    DistributedCoordinatorConnection *connections = MEMORY_ALLOC_ARRAY(DistributedCoordinatorConnection, config->workerEndpointCount);
+    HANDLE *threadHandles = MEMORY_ALLOC_ARRAY(HANDLE, config->workerEndpointCount);
+    int threadCount = 0;
+
+    for (int i = 0; i < config->workerEndpointCount; i++) {
+        connections[i].job = &job;
+        connections[i].endpoint = config->workerEndpoints[i];
+
+        EnterCriticalSection(&job.lock);
+        job.liveConnectionCount++;
+        LeaveCriticalSection(&job.lock);
+
+        threadHandles[threadCount] = (HANDLE)_beginthreadex(NULL, 0, _coordinatorConnectionThreadProc, &connections[i], 0, NULL);
+        if (threadHandles[threadCount] == NULL) {
+            MSG_WARNING(_T("Failed to start connection thread for \"%s\".\n"), config->workerEndpoints[i]);
+
+            EnterCriticalSection(&job.lock);
+            job.liveConnectionCount--;
+            LeaveCriticalSection(&job.lock);
+            continue;
+        }
+
+        threadCount++;
+    }
+
+    // 等待所有分段完成，或所有连接都已失败
+    EnterCriticalSection(&job.lock);
+    while ((job.completedRegionCount < job.regionCount) && (job.liveConnectionCount > 0)) {
+        int completedRegionCount = job.completedRegionCount;
+
+        LeaveCriticalSection(&job.lock);
+        Common_updateProgress(STAGE_SPLEETER_PROCESSOR_PROCESS_SEGMENT, completedRegionCount, job.regionCount);
+        EnterCriticalSection(&job.lock);
+
+        if ((job.completedRegionCount == completedRegionCount) && (job.liveConnectionCount > 0)) {
+            SleepConditionVariableCS(&job.changed, &job.lock, INFINITE);
+        }
+    }
+    bool succeeded = (job.completedRegionCount == job.regionCount);
+    LeaveCriticalSection(&job.lock);
+
+    // 所有连接都已失败时，唤醒可能仍在等待的线程 (此时不会再有分段完成)
+    WakeAllConditionVariable(&job.changed);
+
+    for (int i = 0; i < threadCount; i++) {
+        WaitForSingleObject(threadHandles[i], INFINITE);
+        CloseHandle(threadHandles[i]);
+    }
+
+    Memory_free(&threadHandles);
+    Memory_free(&connections);
+    Memory_free(&job.pendingRegionIndexes);
+    DeleteCriticalSection(&job.lock);
+
+    WSACleanup();
+
+    if (!succeeded) {
+        MSG_ERROR(_T("All workers failed, %d of %d regions were not processed.\n"),
+                (job.regionCount - job.completedRegionCount), job.regionCount);
+        SpleeterProcessorResult_free(&job.result);
+        return -1;
+    }
+
+    Common_updateProgress(STAGE_SPLEETER_PROCESSOR_PROCESS_SEGMENT, job.regionCount, job.regionCount);
+
+    *resultOut = job.result;
+    return 0;
+}
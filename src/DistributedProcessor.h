@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _DISTRIBUTED_PROCESSOR_H_
+#define _DISTRIBUTED_PROCESSOR_H_
+
+#include "Common.h"
+#include "AudioFile.h"
+#include "SpleeterProcessor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+分布式分段处理
+
+协调端 (coordinator) 负责解码、划分分段和编码，将每个分段送入模型的波形 (包含前后扩展部分) 发送给工作端 (worker)，
+工作端使用常驻内存的模型处理后只返回分段有效部分的各音轨样本值，由协调端拼接为完整的音轨。
+
+每个工作端端点对应协调端的一个连接，同一连接上依次处理多个分段。同一端点可以重复指定，以建立多个连接同时处理。
+某个连接失败 (工作端退出、网络断开、超时等) 时，正在处理的分段会被重新放回队列，由其他连接处理。
+
+通信使用二进制格式 (小端序)，请求和响应的结构见 DistributedProcessor.c
+*/
+
+/** 默认的工作端端点 (仅监听本机回环地址，需要其他主机连接时应指定为 0.0.0.0:<port> 等) */
+#define DISTRIBUTED_DEFAULT_WORKER_ENDPOINT     _T("127.0.0.1:7451")
+
+/** 协调端最多可连接的工作端端点数量 */
+#define DISTRIBUTED_WORKER_ENDPOINT_MAX_COUNT   32
+
+/**
+ * 工作端配置
+ */
+typedef struct {
+    /** 监听的端点 (格式见 SocketEndpoint.h) */
+    const TCHAR     *endpoint;
+
+    /** 使用的模型名称 (启动时加载，之后一直保留在内存中) */
+    const TCHAR     *modelName;
+} DistributedWorkerConfig;
+
+/**
+ * 协调端配置
+ */
+typedef struct {
+    /** 各工作端的端点 */
+    const TCHAR                 *workerEndpoints[DISTRIBUTED_WORKER_ENDPOINT_MAX_COUNT];
+
+    /** 工作端端点数量 */
+    int                         workerEndpointCount;
+
+    /** 使用的模型名称 (须与工作端加载的模型相同) */
+    const TCHAR                 *modelName;
+
+    /** 模型信息 */
+    const SpleeterModelInfo     *modelInfo;
+} DistributedCoordinatorConfig;
+
+/**
+ * 解析以分号分隔的工作端端点列表，添加到协调端配置中
+ *
+ * @param   config          协调端配置
+ * @param   endpointList    端点列表字符串 (如 "192.168.1.10:7451;192.168.1.11:7451")，会被原地修改，
+ *                          在 config 使用期间须保持有效
+ *
+ * @return  成功时返回 true, 失败 (端点数量超出上限等) 时返回 false
+ */
+bool DistributedProcessor_parseWorkerEndpointList(DistributedCoordinatorConfig *config, TCHAR *endpointList);
+
+/**
+ * 运行工作端
+ *
+ * 启动后将一直运行，接受协调端的连接并处理其发送的分段
+ *
+ * @param   config          工作端配置
+ *
+ * @return  启动失败时返回 false, 否则不会返回
+ */
+bool DistributedProcessor_runWorker(const DistributedWorkerConfig *config);
+
+/**
+ * 使用工作端对音频进行分离
+ *
+ * @param   config              协调端配置
+ * @param   audioDataSource     输入音频数据源
+ * @param   resultOut           分离结果
+ *
+ * @return  成功时返回 0, 失败 (所有连接都已失败等) 时返回小于 0 的错误码
+ */
+int DistributedProcessor_split(const DistributedCoordinatorConfig *config, AudioDataSource *audioDataSource,
+        SpleeterProcessorResult **resultOut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DISTRIBUTED_PROCESSOR_H_
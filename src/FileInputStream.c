@@ -0,0 +1,321 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <Windows.h>
+#include "libavformat/avio.h"
+#include "libavutil/error.h"
+#include "Common.h"
+#include "Memory.h"
+#include "FileInputStream.h"
+
+/**
+ * 从文件的指定位置读取数据 (不改变文件指针，可与其他线程的读取同时进行)
+ *
+ * @return  成功时返回读取的字节数 (到达文件末尾时为 0)，失败时返回 -1
+ */
+static int _readAt(HANDLE file, int64_t offset, uint8_t *buf, int size) {
+    OVERLAPPED overlapped = { 0 };
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD readSize = 0;
+    if (!ReadFile(file, buf, (DWORD)size, &readSize, &overlapped)) {
+        if (GetLastError() == ERROR_HANDLE_EOF) {
+            return 0;
+        }
+        return -1;
+    }
+
+    return (int)readSize;
+}
+
+static unsigned __stdcall _readAheadThreadProc(void *arg) {
+    FileInputStream *obj = (FileInputStream *)arg;
+
+    EnterCriticalSection(&obj->_lock);
+
+    while (!obj->_stopping) {
+        if ((obj->_aheadBlockOffset < 0) || obj->_aheadBlockReady) {
+            SleepConditionVariableCS(&obj->_changed, &obj->_lock, INFINITE);
+            continue;
+        }
+
+        int64_t offset = obj->_aheadBlockOffset;
+        uint8_t *block = obj->_aheadBlock;
+
+        LeaveCriticalSection(&obj->_lock);
+        int readSize = _readAt(obj->_file, offset, block, obj->_config.blockSize);
+        EnterCriticalSection(&obj->_lock);
+
+        obj->_aheadBlockLength = readSize;
+        obj->_aheadBlockReady = true;
+        if (readSize > 0) {
+            obj->readByteCount += readSize;
+        }
+
+        WakeAllConditionVariable(&obj->_changed);
+    }
+
+    LeaveCriticalSection(&obj->_lock);
+
+    return 0;
+}
+
+/**
+ * 使包含 position 的块成为当前块，并请求预读其后的块
+ *
+ * @return  成功时返回 true, 读取失败时返回 false
+ */
+static bool _loadBlock(FileInputStream *obj, int64_t position) {
+    double waitBeginTime = Common_getTimeInSeconds();
+
+    EnterCriticalSection(&obj->_lock);
+
+    if (obj->_aheadBlockOffset != position) {
+        // 首次读取或定位之后，预读的块不是所需的块。等待正在进行的预读结束后，改为读取所需的块
+        while ((obj->_aheadBlockOffset >= 0) && !obj->_aheadBlockReady) {
+            SleepConditionVariableCS(&obj->_changed, &obj->_lock, INFINITE);
+        }
+
+        obj->_aheadBlockOffset = position;
+        obj->_aheadBlockReady = false;
+        WakeAllConditionVariable(&obj->_changed);
+    }
+
+    while (!obj->_aheadBlockReady) {
+        SleepConditionVariableCS(&obj->_changed, &obj->_lock, INFINITE);
+    }
+
+    // 交换 buffer, 预读完成的块成为当前块
+    uint8_t *block = obj->_currentBlock;
+    obj->_currentBlock = obj->_aheadBlock;
+    obj->_aheadBlock = block;
+
+    obj->_currentBlockOffset = obj->_aheadBlockOffset;
+    obj->_currentBlockLength = obj->_aheadBlockLength;
+
+    // 请求预读下一个块
+    int64_t nextBlockOffset = obj->_currentBlockOffset + obj->_currentBlockLength;
+    if ((obj->_currentBlockLength > 0) && (nextBlockOffset < obj->fileSize)) {
+        obj->_aheadBlockOffset = nextBlockOffset;
+        obj->_aheadBlockReady = false;
+        WakeAllConditionVariable(&obj->_changed);
+    } else {
+        obj->_aheadBlockOffset = -1;
+    }
+
+    LeaveCriticalSection(&obj->_lock);
+
+    obj->ioWaitSeconds += Common_getTimeInSeconds() - waitBeginTime;
+
+    return (obj->_currentBlockLength > 0);
+}
+
+FileInputStream *FileInputStream_open(const TCHAR *filename, const FileInputStreamConfig *config) {
+    FileInputStream *obj = MEMORY_ALLOC_STRUCT(FileInputStream);
+    obj->_config = *config;
+    obj->_file = INVALID_HANDLE_VALUE;
+    obj->_aheadBlockOffset = -1;
+
+    if (obj->_config.blockSize <= 0) {
+        obj->_config.blockSize = FILE_INPUT_STREAM_DEFAULT_BLOCK_SIZE;
+    }
+
+    obj->_file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (obj->_file == INVALID_HANDLE_VALUE) {
+        MSG_ERROR(_T("Failed to open input file \"%s\" (error %lu).\n"), filename, GetLastError());
+        goto err;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(obj->_file, &fileSize)) {
+        MSG_ERROR(_T("Failed to get the size of input file \"%s\".\n"), filename);
+        goto err;
+    }
+    obj->fileSize = fileSize.QuadPart;
+
+    // 空文件无法映射，使用普通方式读取
+    if (obj->_config.memoryMapped && (obj->fileSize > 0)) {
+        HANDLE mapping = CreateFileMapping(obj->_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+            obj->_mappedView = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+
+        if (obj->_mappedView == NULL) {
+            MSG_WARNING(_T("Failed to map input file \"%s\", reading it instead.\n"), filename);
+        }
+    }
+
+    if ((obj->_mappedView == NULL) && obj->_config.readAhead) {
+        obj->_currentBlock = (uint8_t *)Memory_alloc(obj->_config.blockSize);
+        obj->_aheadBlock = (uint8_t *)Memory_alloc(obj->_config.blockSize);
+
+        InitializeCriticalSection(&obj->_lock);
+        InitializeConditionVariable(&obj->_changed);
+
+        obj->_readAheadThread = (HANDLE)_beginthreadex(NULL, 0, _readAheadThreadProc, obj, 0, NULL);
+        if (obj->_readAheadThread == NULL) {
+            MSG_ERROR(_T("Failed to start read-ahead thread.\n"));
+            DeleteCriticalSection(&obj->_lock);
+            goto err;
+        }
+    }
+
+    return obj;
+
+err:
+    FileInputStream_close(&obj);
+
+    return NULL;
+}
+
+int FileInputStream_read(void *opaque, uint8_t *buf, int bufSize) {
+    FileInputStream *obj = (FileInputStream *)opaque;
+
+    if (obj->_position >= obj->fileSize) {
+        return AVERROR_EOF;
+    }
+
+    int64_t remainingSize = obj->fileSize - obj->_position;
+    int readSize = (remainingSize < bufSize) ? (int)remainingSize : bufSize;
+
+    if (obj->_mappedView != NULL) {
+        // 复制时可能发生缺页，将复制时间计为等待 I/O 的时间
+        double waitBeginTime = Common_getTimeInSeconds();
+        memcpy(buf, (obj->_mappedView + obj->_position), readSize);
+        obj->ioWaitSeconds += Common_getTimeInSeconds() - waitBeginTime;
+
+        obj->readByteCount += readSize;
+    } else if (obj->_readAheadThread != NULL) {
+        if ((obj->_position < obj->_currentBlockOffset)
+                || (obj->_position >= (obj->_currentBlockOffset + obj->_currentBlockLength))) {
+            if (!_loadBlock(obj, obj->_position)) {
+                return AVERROR(EIO);
+            }
+        }
+
+        int64_t blockRemainingSize = (obj->_currentBlockOffset + obj->_currentBlockLength) - obj->_position;
+        if (readSize > blockRemainingSize) {
+            readSize = (int)blockRemainingSize;
+        }
+
+        memcpy(buf, (obj->_currentBlock + (obj->_position - obj->_currentBlockOffset)), readSize);
+    } else {
+        double waitBeginTime = Common_getTimeInSeconds();
+        readSize = _readAt(obj->_file, obj->_position, buf, readSize);
+        obj->ioWaitSeconds += Common_getTimeInSeconds() - waitBeginTime;
+
+        if (readSize < 0) {
+            return AVERROR(EIO);
+        } else if (readSize == 0) {
+            return AVERROR_EOF;
+        }
+
+        obj->readByteCount += readSize;
+    }
+
+    obj->_position += readSize;
+
+    return readSize;
+}
+
+int64_t FileInputStream_seek(void *opaque, int64_t offset, int whence) {
+    FileInputStream *obj = (FileInputStream *)opaque;
+
+    int64_t newPosition;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return obj->fileSize;
+
+        case SEEK_SET:
+            newPosition = offset;
+            break;
+
+        case SEEK_CUR:
+            newPosition = obj->_position + offset;
+            break;
+
+        case SEEK_END:
+            newPosition = obj->fileSize + offset;
+            break;
+
+        default:
+            return AVERROR(EINVAL);
+    }
+
+    if ((newPosition < 0) || (newPosition > obj->fileSize)) {
+        return AVERROR(EINVAL);
+    }
+
+    // 预读的块在下次读取时按需更换
+    obj->_position = newPosition;
+
+    return newPosition;
+}
+
+void FileInputStream_close(FileInputStream **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return;
+    }
+
+    FileInputStream *obj = *objPtr;
+
+    if (obj->_readAheadThread != NULL) {
+        EnterCriticalSection(&obj->_lock);
+        obj->_stopping = true;
+        WakeAllConditionVariable(&obj->_changed);
+        LeaveCriticalSection(&obj->_lock);
+
+        WaitForSingleObject(obj->_readAheadThread, INFINITE);
+        CloseHandle(obj->_readAheadThread);
+        obj->_readAheadThread = NULL;
+
+        DeleteCriticalSection(&obj->_lock);
+    }
+
+    if (obj->_currentBlock != NULL) {
+        Memory_free(&obj->_currentBlock);
+    }
+
+    if (obj->_aheadBlock != NULL) {
+        Memory_free(&obj->_aheadBlock);
+    }
+
+    if (obj->_mappedView != NULL) {
+        UnmapViewOfFile(obj->_mappedView);
+        obj->_mappedView = NULL;
+    }
+
+    if (obj->_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(obj->_file);
+        obj->_file = INVALID_HANDLE_VALUE;
+    }
+
+    Memory_free(objPtr);
+}
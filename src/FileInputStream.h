@@ -0,0 +1,157 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _FILE_INPUT_STREAM_H_
+#define _FILE_INPUT_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Windows.h>
+#include "Common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 默认的读取块大小 (以字节为单位) */
+#define FILE_INPUT_STREAM_DEFAULT_BLOCK_SIZE        (1024 * 1024)
+
+/**
+ * 输入文件的读取方式配置
+ */
+typedef struct {
+    /** 每次读取的块大小 (以字节为单位)，同时用作 AVIOContext 的 buffer 大小，为 0 时使用 FFmpeg 默认的文件读取方式 */
+    int         blockSize;
+
+    /** 将整个文件映射到内存中读取 (此时忽略 readAhead) */
+    bool        memoryMapped;
+
+    /** 使用后台线程预读下一个块 */
+    bool        readAhead;
+} FileInputStreamConfig;
+
+/**
+ * 用于 AVIOContext 的输入文件读取
+ *
+ * 按配置以大块读取文件、将文件映射到内存，或在后台线程中预读下一个块，并统计等待 I/O 的时间
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 public 成员，只读
+
+    /** 文件大小 (以字节为单位) */
+    int64_t             fileSize;
+
+    /** 从文件读取的总字节数 (包括预读) */
+    int64_t             readByteCount;
+
+    /** 读取时等待 I/O 的总时间 (以秒为单位) */
+    double              ioWaitSeconds;
+
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 读取方式配置 */
+    FileInputStreamConfig   _config;
+
+    /** 文件句柄 */
+    HANDLE              _file;
+
+    /** 内存映射方式时的映射视图 */
+    const uint8_t       *_mappedView;
+
+    /** 当前读取位置 */
+    int64_t             _position;
+
+    /** 当前块的 buffer (预读方式时使用) */
+    uint8_t             *_currentBlock;
+    /** 当前块在文件中的位置 */
+    int64_t             _currentBlockOffset;
+    /** 当前块的有效长度 */
+    int                 _currentBlockLength;
+
+    /** 预读块的 buffer */
+    uint8_t             *_aheadBlock;
+    /** 预读块在文件中的位置，没有预读时为 -1 */
+    int64_t             _aheadBlockOffset;
+    /** 预读块的有效长度，读取失败时为 -1 */
+    int                 _aheadBlockLength;
+    /** 预读块是否已读取完成 */
+    bool                _aheadBlockReady;
+
+    /** 预读线程是否应退出 */
+    bool                _stopping;
+
+    /** 保护预读状态 */
+    CRITICAL_SECTION    _lock;
+    /** 预读状态发生变化 */
+    CONDITION_VARIABLE  _changed;
+    /** 预读线程 */
+    HANDLE              _readAheadThread;
+} FileInputStream;
+
+/**
+ * 打开输入文件
+ *
+ * @param   filename        文件名
+ * @param   config          读取方式配置
+ *
+ * @return  成功时返回指向 FileInputStream 结构体的指针，失败时返回 NULL
+ */
+FileInputStream *FileInputStream_open(const TCHAR *filename, const FileInputStreamConfig *config);
+
+/**
+ * 从当前位置读取数据 (用作 AVIOContext 的 read_packet 回调)
+ *
+ * @param   opaque          指向 FileInputStream 结构体的指针
+ * @param   buf             目标 buffer
+ * @param   bufSize         目标 buffer 的大小
+ *
+ * @return  成功时返回读取的字节数，到达文件末尾时返回 AVERROR_EOF, 失败时返回其他小于 0 的错误码
+ */
+int FileInputStream_read(void *opaque, uint8_t *buf, int bufSize);
+
+/**
+ * 改变当前位置 (用作 AVIOContext 的 seek 回调)
+ *
+ * @param   opaque          指向 FileInputStream 结构体的指针
+ * @param   offset          偏移量
+ * @param   whence          SEEK_SET, SEEK_CUR, SEEK_END 或 AVSEEK_SIZE
+ *
+ * @return  成功时返回新的位置 (AVSEEK_SIZE 时返回文件大小)，失败时返回小于 0 的错误码
+ */
+int64_t FileInputStream_seek(void *opaque, int64_t offset, int whence);
+
+/**
+ * 关闭输入文件
+ *
+ * @param   objPtr          指向 FileInputStream 结构体的指针的指针
+ */
+void FileInputStream_close(FileInputStream **objPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _FILE_INPUT_STREAM_H_
@@ -0,0 +1,274 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <process.h>
+#include <Windows.h>
+#include "libavformat/avio.h"
+#include "libavutil/error.h"
+#include "Common.h"
+#include "Memory.h"
+#include "FileOutputStream.h"
+
+/**
+ * 在文件的指定位置写入数据 (不依赖文件指针)
+ *
+ * @return  全部写入成功时返回 true, 否则返回 false
+ */
+static bool _writeAt(HANDLE file, int64_t offset, const uint8_t *buf, int size) {
+    OVERLAPPED overlapped = { 0 };
+    overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+    DWORD writtenSize = 0;
+    if (!WriteFile(file, buf, (DWORD)size, &writtenSize, &overlapped)) {
+        return false;
+    }
+
+    return (writtenSize == (DWORD)size);
+}
+
+static unsigned __stdcall _writerThreadProc(void *arg) {
+    FileOutputStream *obj = (FileOutputStream *)arg;
+
+    EnterCriticalSection(&obj->_lock);
+
+    while (true) {
+        if (obj->_queuedBlockCount == 0) {
+            if (obj->_stopping) {
+                break;
+            }
+
+            SleepConditionVariableCS(&obj->_changed, &obj->_lock, INFINITE);
+            continue;
+        }
+
+        // 队列中的块按写入的顺序写入文件，使回写文件头等覆盖写入的结果正确
+        const FileOutputStreamBlock *block = &obj->_blocks[obj->_queueHead];
+        bool toWrite = !obj->_failed;
+
+        LeaveCriticalSection(&obj->_lock);
+        double writeBeginTime = Common_getTimeInSeconds();
+        bool written = toWrite && _writeAt(obj->_file, block->offset, block->data, block->length);
+        DWORD lastError = written ? 0 : GetLastError();
+        double writeSeconds = Common_getTimeInSeconds() - writeBeginTime;
+        EnterCriticalSection(&obj->_lock);
+
+        obj->writeSeconds += writeSeconds;
+        if (written) {
+            obj->writtenByteCount += block->length;
+        } else if (toWrite) {
+            MSG_ERROR(_T("Failed to write output file (error %lu).\n"), lastError);
+            obj->_failed = true;
+        }
+
+        obj->_queueHead = (obj->_queueHead + 1) % obj->_config.blockCount;
+        obj->_queuedBlockCount--;
+
+        WakeAllConditionVariable(&obj->_changed);
+    }
+
+    LeaveCriticalSection(&obj->_lock);
+
+    return 0;
+}
+
+FileOutputStream *FileOutputStream_open(const TCHAR *filename, const FileOutputStreamConfig *config) {
+    FileOutputStream *obj = MEMORY_ALLOC_STRUCT(FileOutputStream);
+    obj->_config = *config;
+    obj->_file = INVALID_HANDLE_VALUE;
+
+    if (obj->_config.blockSize <= 0) {
+        obj->_config.blockSize = FILE_OUTPUT_STREAM_DEFAULT_BLOCK_SIZE;
+    }
+    if (obj->_config.blockCount <= 0) {
+        obj->_config.blockCount = FILE_OUTPUT_STREAM_DEFAULT_BLOCK_COUNT;
+    }
+
+    obj->_file = CreateFile(filename, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (obj->_file == INVALID_HANDLE_VALUE) {
+        MSG_ERROR(_T("Failed to create output file \"%s\" (error %lu).\n"), filename, GetLastError());
+        goto err;
+    }
+
+    obj->_blocks = MEMORY_ALLOC_ARRAY(FileOutputStreamBlock, obj->_config.blockCount);
+    for (int i = 0; i < obj->_config.blockCount; i++) {
+        obj->_blocks[i].data = (uint8_t *)Memory_alloc(obj->_config.blockSize);
+    }
+
+    InitializeCriticalSection(&obj->_lock);
+    InitializeConditionVariable(&obj->_changed);
+
+    obj->_writerThread = (HANDLE)_beginthreadex(NULL, 0, _writerThreadProc, obj, 0, NULL);
+    if (obj->_writerThread == NULL) {
+        MSG_ERROR(_T("Failed to start output writing thread.\n"));
+        DeleteCriticalSection(&obj->_lock);
+        goto err;
+    }
+
+    return obj;
+
+err:
+    FileOutputStream_close(&obj);
+
+    return NULL;
+}
+
+int FileOutputStream_write(void *opaque, uint8_t *buf, int bufSize) {
+    FileOutputStream *obj = (FileOutputStream *)opaque;
+
+    int totalWrittenSize = 0;
+    while (totalWrittenSize < bufSize) {
+        int blockLength = min(obj->_config.blockSize, (bufSize - totalWrittenSize));
+
+        // 等待空闲的块 (只有后台线程的写入跟不上时才需要等待)
+        EnterCriticalSection(&obj->_lock);
+        if ((obj->_queuedBlockCount == obj->_config.blockCount) && !obj->_failed) {
+            double waitBeginTime = Common_getTimeInSeconds();
+            while ((obj->_queuedBlockCount == obj->_config.blockCount) && !obj->_failed) {
+                SleepConditionVariableCS(&obj->_changed, &obj->_lock, INFINITE);
+            }
+            obj->stallSeconds += Common_getTimeInSeconds() - waitBeginTime;
+        }
+        bool failed = obj->_failed;
+        FileOutputStreamBlock *block = &obj->_blocks[(obj->_queueHead + obj->_queuedBlockCount) % obj->_config.blockCount];
+        LeaveCriticalSection(&obj->_lock);
+
+        if (failed) {
+            return AVERROR(EIO);
+        }
+
+        // 空闲的块在加入队列之前不会被后台线程访问，在锁外复制数据
+        memcpy(block->data, (buf + totalWrittenSize), blockLength);
+        block->offset = obj->_position;
+        block->length = blockLength;
+
+        EnterCriticalSection(&obj->_lock);
+        obj->_queuedBlockCount++;
+        WakeAllConditionVariable(&obj->_changed);
+        LeaveCriticalSection(&obj->_lock);
+
+        obj->_position += blockLength;
+        if (obj->_position > obj->_size) {
+            obj->_size = obj->_position;
+        }
+
+        totalWrittenSize += blockLength;
+    }
+
+    return totalWrittenSize;
+}
+
+int64_t FileOutputStream_seek(void *opaque, int64_t offset, int whence) {
+    FileOutputStream *obj = (FileOutputStream *)opaque;
+
+    int64_t newPosition;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return obj->_size;
+
+        case SEEK_SET:
+            newPosition = offset;
+            break;
+
+        case SEEK_CUR:
+            newPosition = obj->_position + offset;
+            break;
+
+        case SEEK_END:
+            newPosition = obj->_size + offset;
+            break;
+
+        default:
+            return AVERROR(EINVAL);
+    }
+
+    if (newPosition < 0) {
+        return AVERROR(EINVAL);
+    }
+
+    // 已在队列中的块保留各自的位置，之后写入的块使用新的位置
+    obj->_position = newPosition;
+
+    return newPosition;
+}
+
+bool FileOutputStream_flush(FileOutputStream *obj) {
+    if (obj->_writerThread == NULL) {
+        return !obj->_failed;
+    }
+
+    double waitBeginTime = Common_getTimeInSeconds();
+
+    EnterCriticalSection(&obj->_lock);
+    while (obj->_queuedBlockCount > 0) {
+        SleepConditionVariableCS(&obj->_changed, &obj->_lock, INFINITE);
+    }
+    bool failed = obj->_failed;
+    LeaveCriticalSection(&obj->_lock);
+
+    obj->stallSeconds += Common_getTimeInSeconds() - waitBeginTime;
+
+    return !failed;
+}
+
+void FileOutputStream_close(FileOutputStream **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return;
+    }
+
+    FileOutputStream *obj = *objPtr;
+
+    if (obj->_writerThread != NULL) {
+        // 后台线程写完队列中所有的块后退出
+        EnterCriticalSection(&obj->_lock);
+        obj->_stopping = true;
+        WakeAllConditionVariable(&obj->_changed);
+        LeaveCriticalSection(&obj->_lock);
+
+        WaitForSingleObject(obj->_writerThread, INFINITE);
+        CloseHandle(obj->_writerThread);
+        obj->_writerThread = NULL;
+
+        DeleteCriticalSection(&obj->_lock);
+    }
+
+    if (obj->_blocks != NULL) {
+        for (int i = 0; i < obj->_config.blockCount; i++) {
+            if (obj->_blocks[i].data != NULL) {
+                Memory_free(&obj->_blocks[i].data);
+            }
+        }
+        Memory_free(&obj->_blocks);
+    }
+
+    if (obj->_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(obj->_file);
+        obj->_file = INVALID_HANDLE_VALUE;
+    }
+
+    Memory_free(objPtr);
+}
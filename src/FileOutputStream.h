@@ -0,0 +1,180 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _FILE_OUTPUT_STREAM_H_
+#define _FILE_OUTPUT_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <Windows.h>
+#include "Common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 默认的写入块大小 (以字节为单位) */
+#define FILE_OUTPUT_STREAM_DEFAULT_BLOCK_SIZE       (1024 * 1024)
+
+/** 默认的可等待写入的块数量 */
+#define FILE_OUTPUT_STREAM_DEFAULT_BLOCK_COUNT      8
+
+/**
+ * 输出文件的写入方式配置
+ */
+typedef struct {
+    /** 每个块的大小 (以字节为单位)，同时用作 AVIOContext 的 buffer 大小，为 0 时使用 FFmpeg 默认的文件写入方式 */
+    int         blockSize;
+
+    /** 可等待后台线程写入的块数量，全部块都在等待写入时，写入数据的线程才需要等待 */
+    int         blockCount;
+} FileOutputStreamConfig;
+
+/**
+ * 等待写入的块
+ */
+typedef struct {
+    /** 块的数据 */
+    uint8_t     *data;
+
+    /** 块在文件中的位置 */
+    int64_t     offset;
+
+    /** 块的有效长度 */
+    int         length;
+} FileOutputStreamBlock;
+
+/**
+ * 用于 AVIOContext 的输出文件写入
+ *
+ * 写入的数据先复制到块中排队，由后台线程按顺序写入文件，使编码线程不必等待存储设备，并统计写入的字节数和等待的时间
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 public 成员，只读
+
+    /** 写入文件的总字节数 */
+    int64_t                 writtenByteCount;
+
+    /** 写入数据的线程等待空闲块 (以及等待全部写入完成) 的总时间 (以秒为单位) */
+    double                  stallSeconds;
+
+    /** 后台线程写入文件的总时间 (以秒为单位) */
+    double                  writeSeconds;
+
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 写入方式配置 */
+    FileOutputStreamConfig  _config;
+
+    /** 文件句柄 */
+    HANDLE                  _file;
+
+    /** 当前写入位置 */
+    int64_t                 _position;
+
+    /** 已写入数据的末尾位置 (即文件大小) */
+    int64_t                 _size;
+
+    /** 所有块 (循环队列) */
+    FileOutputStreamBlock   *_blocks;
+
+    /** 队列中第一个等待写入的块的序号 */
+    int                     _queueHead;
+
+    /** 等待写入 (包括正在写入) 的块数量 */
+    int                     _queuedBlockCount;
+
+    /** 是否有写入失败 (之后的块不再写入) */
+    bool                    _failed;
+
+    /** 后台线程是否应在写完所有块后退出 */
+    bool                    _stopping;
+
+    /** 保护队列状态 */
+    CRITICAL_SECTION        _lock;
+    /** 队列状态发生变化 */
+    CONDITION_VARIABLE      _changed;
+    /** 后台写入线程 */
+    HANDLE                  _writerThread;
+} FileOutputStream;
+
+/**
+ * 创建输出文件 (已存在时覆盖)，并启动后台写入线程
+ *
+ * @param   filename        文件名
+ * @param   config          写入方式配置
+ *
+ * @return  成功时返回指向 FileOutputStream 结构体的指针，失败时返回 NULL
+ */
+FileOutputStream *FileOutputStream_open(const TCHAR *filename, const FileOutputStreamConfig *config);
+
+/**
+ * 在当前位置写入数据 (用作 AVIOContext 的 write_packet 回调)
+ *
+ * 数据复制到空闲的块中即返回，只有所有块都在等待写入时才需要等待
+ *
+ * @param   opaque          指向 FileOutputStream 结构体的指针
+ * @param   buf             要写入的数据
+ * @param   bufSize         要写入数据的字节数
+ *
+ * @return  成功时返回写入的字节数，之前的写入已失败时返回小于 0 的错误码
+ */
+int FileOutputStream_write(void *opaque, uint8_t *buf, int bufSize);
+
+/**
+ * 改变当前位置 (用作 AVIOContext 的 seek 回调)
+ *
+ * 定位到已写入的位置之前 (如回写文件头) 时，之后写入的块在文件中的位置随之改变，仍按写入的顺序写入文件
+ *
+ * @param   opaque          指向 FileOutputStream 结构体的指针
+ * @param   offset          偏移量
+ * @param   whence          SEEK_SET, SEEK_CUR, SEEK_END 或 AVSEEK_SIZE
+ *
+ * @return  成功时返回新的位置 (AVSEEK_SIZE 时返回文件大小)，失败时返回小于 0 的错误码
+ */
+int64_t FileOutputStream_seek(void *opaque, int64_t offset, int whence);
+
+/**
+ * 等待所有块写入完成
+ *
+ * @param   obj             指向 FileOutputStream 结构体的指针
+ *
+ * @return  所有数据都写入成功时返回 true, 否则返回 false
+ */
+bool FileOutputStream_flush(FileOutputStream *obj);
+
+/**
+ * 等待所有块写入完成后关闭输出文件
+ *
+ * @param   objPtr          指向 FileOutputStream 结构体的指针的指针
+ */
+void FileOutputStream_close(FileOutputStream **objPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _FILE_OUTPUT_STREAM_H_
@@ -0,0 +1,271 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Windows.h>
+#include <Shlwapi.h>
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFileReader.h"
+#include "InputFileList.h"
+
+#pragma comment(lib, "shlwapi.lib")
+
+/** 列表文件中单行的最大长度 (以字节为单位) */
+#define LIST_FILE_LINE_MAX_SIZE     (FILE_PATH_MAX_SIZE * 4)
+
+static int _compareFilePaths(const void *a, const void *b) {
+    return _tcsicmp(*(const TCHAR **)a, *(const TCHAR **)b);
+}
+
+InputFileList *InputFileList_alloc(void) {
+    InputFileList *obj = MEMORY_ALLOC_STRUCT(InputFileList);
+
+    return obj;
+}
+
+void InputFileList_free(InputFileList **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return;
+    }
+
+    InputFileList *obj = *objPtr;
+
+    for (int i = 0; i < obj->fileCount; i++) {
+        Memory_free(&obj->filePaths[i]);
+    }
+
+    if (obj->filePaths != NULL) {
+        Memory_free(&obj->filePaths);
+    }
+
+    Memory_free(objPtr);
+}
+
+/**
+ * 将路径添加到列表末尾
+ */
+static bool _appendPath(InputFileList *obj, const TCHAR *path) {
+    // 按需扩大 filePaths 数组
+    if (obj->fileCount >= obj->_capacity) {
+        int newCapacity = (obj->_capacity == 0) ? 16 : (obj->_capacity * 2);
+
+        obj->filePaths = (TCHAR **)Memory_realloc(obj->filePaths, MEMORY_ARRAY_SIZE(TCHAR *, newCapacity));
+        obj->_capacity = newCapacity;
+    }
+
+    obj->filePaths[obj->fileCount++] = _tcsdup(path);
+
+    return true;
+}
+
+bool InputFileList_addFile(InputFileList *obj, const TCHAR *filePath) {
+    TCHAR fileFullPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+
+    DWORD fullPathLength = GetFullPathName(filePath, FILE_PATH_MAX_SIZE, fileFullPath, NULL);
+    if ((fullPathLength == 0) || (fullPathLength >= FILE_PATH_MAX_SIZE)) {
+        MSG_ERROR(_T("Failed to get the full path of input file \"%s\".\n"), filePath);
+        return false;
+    }
+
+    return _appendPath(obj, fileFullPath);
+}
+
+bool InputFileList_addDirectory(InputFileList *obj, const TCHAR *dirPath, const TCHAR *pattern, bool recursive) {
+    TCHAR searchPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    if (PathCombine(searchPath, dirPath, _T("*")) == NULL) {
+        MSG_ERROR(_T("The directory path \"%s\" is too long.\n"), dirPath);
+        return false;
+    }
+
+    WIN32_FIND_DATA findData;
+    HANDLE findHandle = FindFirstFile(searchPath, &findData);
+    if (findHandle == INVALID_HANDLE_VALUE) {
+        MSG_ERROR(_T("Failed to list the directory \"%s\".\n"), dirPath);
+        return false;
+    }
+
+    // 记录本目录中的文件在列表中的起始位置，用于排序
+    int firstFileIndex = obj->fileCount;
+
+    // 子目录在本目录的文件都添加完成后再处理，使列表顺序与目录结构一致
+    TCHAR **subDirPaths = NULL;
+    int subDirCount = 0;
+
+    bool succeeded = true;
+
+    do {
+        if ((_tcscmp(findData.cFileName, _T(".")) == 0) || (_tcscmp(findData.cFileName, _T("..")) == 0)) {
+            continue;
+        }
+
+        TCHAR entryPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (PathCombine(entryPath, dirPath, findData.cFileName) == NULL) {
+            MSG_ERROR(_T("The path of \"%s\" in directory \"%s\" is too long.\n"), findData.cFileName, dirPath);
+            succeeded = false;
+            break;
+        }
+
+        if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+            if (recursive) {
+                subDirPaths = (TCHAR **)Memory_realloc(subDirPaths, MEMORY_ARRAY_SIZE(TCHAR *, (subDirCount + 1)));
+                subDirPaths[subDirCount++] = _tcsdup(entryPath);
+            }
+            continue;
+        }
+
+        if (!PathMatchSpec(findData.cFileName, pattern)) {
+            continue;
+        }
+
+        if (!InputFileList_addFile(obj, entryPath)) {
+            succeeded = false;
+            break;
+        }
+    } while (FindNextFile(findHandle, &findData));
+
+    FindClose(findHandle);
+
+    if (succeeded && ((obj->fileCount - firstFileIndex) > 1)) {
+        qsort(&obj->filePaths[firstFileIndex], (obj->fileCount - firstFileIndex), sizeof(TCHAR *), _compareFilePaths);
+    }
+
+    if (subDirCount > 1) {
+        qsort(subDirPaths, subDirCount, sizeof(TCHAR *), _compareFilePaths);
+    }
+
+    for (int i = 0; i < subDirCount; i++) {
+        if (succeeded && !InputFileList_addDirectory(obj, subDirPaths[i], pattern, recursive)) {
+            succeeded = false;
+        }
+
+        Memory_free(&subDirPaths[i]);
+    }
+
+    if (subDirPaths != NULL) {
+        Memory_free(&subDirPaths);
+    }
+
+    return succeeded;
+}
+
+bool InputFileList_addFromListFile(InputFileList *obj, const TCHAR *listFilePath, const TCHAR *pattern, bool recursive) {
+    // 列表中的相对路径相对于列表文件所在的目录，而不是当前目录
+    TCHAR listDirPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    DWORD fullPathLength = GetFullPathName(listFilePath, FILE_PATH_MAX_SIZE, listDirPath, NULL);
+    if ((fullPathLength == 0) || (fullPathLength >= FILE_PATH_MAX_SIZE)) {
+        MSG_ERROR(_T("Failed to get the full path of the input list file \"%s\".\n"), listFilePath);
+        return false;
+    }
+    PathRemoveFileSpec(listDirPath);
+
+    FILE *fp = _tfopen(listFilePath, _T("rb"));
+    if (fp == NULL) {
+        MSG_ERROR(_T("Failed to open the input list file \"%s\".\n"), listFilePath);
+        return false;
+    }
+
+    bool succeeded = true;
+
+    char lineBuffer[LIST_FILE_LINE_MAX_SIZE] = { '\0' };
+    int lineNumber = 0;
+    while (fgets(lineBuffer, sizeof(lineBuffer), fp) != NULL) {
+        lineNumber++;
+
+        char *line = lineBuffer;
+
+        // 跳过 UTF-8 BOM
+        if ((lineNumber == 1) && (memcmp(line, "\xEF\xBB\xBF", 3) == 0)) {
+            line += 3;
+        }
+
+        // 去除首尾的空白字符 (包括 "\r\n")
+        while ((*line == ' ') || (*line == '\t')) {
+            line++;
+        }
+        size_t lineLength = strlen(line);
+        while ((lineLength > 0) && ((line[lineLength - 1] == '\r') || (line[lineLength - 1] == '\n')
+                || (line[lineLength - 1] == ' ') || (line[lineLength - 1] == '\t'))) {
+            line[--lineLength] = '\0';
+        }
+
+        // 忽略空行和注释行
+        if ((lineLength == 0) || (line[0] == '#')) {
+            continue;
+        }
+
+        TCHAR path[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (MultiByteToWideChar(CP_UTF8, 0, line, -1, path, FILE_PATH_MAX_SIZE) == 0) {
+            MSG_ERROR(_T("The path at line %d of the input list file \"%s\" is invalid or too long.\n"), lineNumber, listFilePath);
+            succeeded = false;
+            break;
+        }
+
+        if (PathIsRelative(path)) {
+            TCHAR relativePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+            _tcscpy(relativePath, path);
+            if (PathCombine(path, listDirPath, relativePath) == NULL) {
+                MSG_ERROR(_T("The path at line %d of the input list file \"%s\" is too long.\n"), lineNumber, listFilePath);
+                succeeded = false;
+                break;
+            }
+        }
+
+        // 列表文件中不支持嵌套的 "@" 列表文件
+        DWORD fileAttributes = GetFileAttributes(path);
+        if ((fileAttributes != INVALID_FILE_ATTRIBUTES) && ((fileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)) {
+            succeeded = InputFileList_addDirectory(obj, path, pattern, recursive);
+        } else {
+            succeeded = InputFileList_addFile(obj, path);
+        }
+        if (!succeeded) {
+            break;
+        }
+    }
+
+    fclose(fp);
+
+    return succeeded;
+}
+
+bool InputFileList_addArgument(InputFileList *obj, const TCHAR *argument, const TCHAR *pattern, bool recursive) {
+    if (argument[0] == _T('@')) {
+        return InputFileList_addFromListFile(obj, argument + 1, pattern, recursive);
+    }
+
+    // 标准输入原样添加，不转换为完整路径
+    if (AudioFileReader_isStandardInput(argument)) {
+        return _appendPath(obj, argument);
+    }
+
+    DWORD fileAttributes = GetFileAttributes(argument);
+    if ((fileAttributes != INVALID_FILE_ATTRIBUTES) && ((fileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)) {
+        return InputFileList_addDirectory(obj, argument, pattern, recursive);
+    }
+
+    return InputFileList_addFile(obj, argument);
+}
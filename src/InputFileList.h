@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _INPUT_FILE_LIST_H_
+#define _INPUT_FILE_LIST_H_
+
+#include "Common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 在目录中查找输入文件时默认使用的文件名匹配模式 (以分号分隔，格式同 PathMatchSpec()) */
+#define INPUT_FILE_LIST_DEFAULT_PATTERN     _T("*.mp3;*.m4a;*.aac;*.flac;*.wav;*.ogg;*.opus;*.wma;*.ape;*.aiff;*.aif")
+
+/**
+ * 输入文件列表
+ */
+typedef struct {
+    /** 输入文件完整路径的数组 */
+    TCHAR       **filePaths;
+
+    /** 输入文件数量 */
+    int         fileCount;
+
+    /** filePaths 数组所能容纳的元素数量 */
+    int         _capacity;
+} InputFileList;
+
+/**
+ * 分配内存空间，创建一个空的 InputFileList 结构体
+ *
+ * @return  返回所创建的 InputFileList 结构体
+ */
+InputFileList *InputFileList_alloc(void);
+
+/**
+ * 释放 InputFileList 结构体和其中的文件路径所占用的内存空间
+ *
+ * @param   objPtr          指向 InputFileList 结构体的指针的指针
+ */
+void InputFileList_free(InputFileList **objPtr);
+
+/**
+ * 添加一个输入文件
+ *
+ * @param   obj             指向 InputFileList 结构体的指针
+ * @param   filePath        输入文件路径 (可为相对路径，会被转换为完整路径)
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool InputFileList_addFile(InputFileList *obj, const TCHAR *filePath);
+
+/**
+ * 添加目录中所有与匹配模式相符的文件
+ *
+ * @param   obj             指向 InputFileList 结构体的指针
+ * @param   dirPath         目录路径
+ * @param   pattern         文件名匹配模式 (如 "*.mp3;*.flac")
+ * @param   recursive       是否递归查找子目录
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool InputFileList_addDirectory(InputFileList *obj, const TCHAR *dirPath, const TCHAR *pattern, bool recursive);
+
+/**
+ * 添加列表文件中列出的所有输入文件或目录
+ *
+ * 列表文件为 UTF-8 编码的文本文件，每行一个路径，忽略空行和以 '#' 开头的行。
+ * 相对路径相对于列表文件所在的目录
+ *
+ * @param   obj             指向 InputFileList 结构体的指针
+ * @param   listFilePath    列表文件路径
+ * @param   pattern         列表中包含目录时使用的文件名匹配模式
+ * @param   recursive       列表中包含目录时是否递归查找子目录
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool InputFileList_addFromListFile(InputFileList *obj, const TCHAR *listFilePath, const TCHAR *pattern, bool recursive);
+
+/**
+ * 根据命令行参数添加输入文件
+ *
+ * 参数以 '@' 开头时作为列表文件处理，参数为目录时添加目录中的文件，否则作为单个输入文件处理。
+ * 表示标准输入的参数 ("-" 或 "pipe:" 开头) 原样添加
+ *
+ * @param   obj             指向 InputFileList 结构体的指针
+ * @param   argument        命令行参数
+ * @param   pattern         在目录中查找文件时使用的文件名匹配模式
+ * @param   recursive       在目录中查找文件时是否递归查找子目录
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool InputFileList_addArgument(InputFileList *obj, const TCHAR *argument, const TCHAR *pattern, bool recursive);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _INPUT_FILE_LIST_H_
@@ -0,0 +1,317 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libavutil/channel_layout.h"
+#include "libswresample/swresample.h"
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFile.h"
+#include "SpleeterProcessor.h"
+#include "LibSpleeter.h"
+
+/**
+ * 已加载的模型
+ */
+struct LibSpleeterModel {
+    SpleeterModel   *model;
+};
+
+/**
+ * 调用 SpleeterProcessor 时的回调上下文
+ */
+typedef struct {
+    LibSpleeterSegmentCallback  callback;
+    void                        *userData;
+    bool                        aborted;
+} LibSpleeterCallbackContext;
+
+static bool _onSegment(void *userData, const SpleeterProcessorSegment *segment) {
+    LibSpleeterCallbackContext *context = (LibSpleeterCallbackContext *)userData;
+
+    LibSpleeterSegment librarySegment = {
+        .frameOffset = segment->offset,
+        .frameCount = segment->length,
+        .stemCount = segment->trackCount
+    };
+    for (int i = 0; i < segment->trackCount; i++) {
+        librarySegment.stemSamples[i] = segment->trackSampleValues[i];
+    }
+
+    if (context->callback(context->userData, &librarySegment) != 0) {
+        context->aborted = true;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * 使用已准备好的 44100 Hz 双声道音频数据源进行分离，并转换结果
+ */
+static LibSpleeterStatus _split(LibSpleeterModel *model, AudioDataSource *audioDataSource,
+        LibSpleeterSegmentCallback callback, void *userData, LibSpleeterResult **resultOut) {
+    LibSpleeterCallbackContext context = {
+        .callback = callback,
+        .userData = userData,
+        .aborted = false
+    };
+
+    SpleeterProcessorResult *processorResult = NULL;
+    int ret = SpleeterProcessor_splitWithCallback(model->model, audioDataSource,
+            ((callback != NULL) ? _onSegment : NULL), &context,
+            ((resultOut != NULL) ? &processorResult : NULL));
+    if (ret != 0) {
+        return (context.aborted ? LIBSPLEETER_ERROR_ABORTED : LIBSPLEETER_ERROR_PROCESS);
+    }
+
+    if (resultOut == NULL) {
+        return LIBSPLEETER_OK;
+    }
+
+    LibSpleeterResult *result = MEMORY_ALLOC_STRUCT(LibSpleeterResult);
+    result->sampleRate = SPLEETER_MODEL_AUDIO_SAMPLE_RATE;
+    result->channelCount = SPLEETER_MODEL_AUDIO_CHANNEL_COUNT;
+    result->stemCount = processorResult->trackCount;
+
+    for (int i = 0; i < processorResult->trackCount; i++) {
+        AudioDataSource *trackAudioDataSource = processorResult->trackList[i].audioDataSource;
+
+        result->stems[i].name = model->model->modelInfo->trackNames[i];
+        result->stems[i].samples = trackAudioDataSource->sampleValues;
+        result->stems[i].frameCount = trackAudioDataSource->sampleCountPerChannel;
+
+        // 样本值的所有权已转移给 result
+        trackAudioDataSource->sampleValues = NULL;
+    }
+
+    SpleeterProcessorResult_free(&processorResult);
+
+    *resultOut = result;
+
+    return LIBSPLEETER_OK;
+}
+
+/**
+ * 将任意采样率和声道数的 PCM 数据转换为 44100 Hz 双声道
+ *
+ * @return  成功时返回新分配的样本值 buffer, 失败时返回 NULL
+ */
+static float *_convertPcm(const float *samples, int frameCount, int sampleRate, int channelCount, int *convertedFrameCountOut) {
+    SwrContext *resamplerContext = NULL;
+    float *convertedSamples = NULL;
+    bool succeeded = false;
+
+    AVChannelLayout inputChannelLayout = { 0 };
+    av_channel_layout_default(&inputChannelLayout, channelCount);
+
+    AVChannelLayout outputChannelLayout = (AVChannelLayout)AV_CHANNEL_LAYOUT_STEREO;
+
+    swr_alloc_set_opts2(
+        &resamplerContext,
+        &outputChannelLayout, AV_SAMPLE_FMT_FLT, SPLEETER_MODEL_AUDIO_SAMPLE_RATE,
+        &inputChannelLayout, AV_SAMPLE_FMT_FLT, sampleRate,
+        0, NULL
+    );
+    if ((resamplerContext == NULL) || (swr_init(resamplerContext) < 0)) {
+        MSG_ERROR(_T("Failed to initialize the resampler\n"));
+        goto clean_up;
+    }
+
+    int convertedCapacity = swr_get_out_samples(resamplerContext, frameCount) + SPLEETER_MODEL_AUDIO_SAMPLE_RATE;
+    convertedSamples = MEMORY_ALLOC_ARRAY(float, ((size_t)convertedCapacity * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT));
+
+    const uint8_t *inputData[1] = { (const uint8_t *)samples };
+    uint8_t *outputData[1] = { (uint8_t *)convertedSamples };
+
+    int convertedFrameCount = swr_convert(resamplerContext, outputData, convertedCapacity, inputData, frameCount);
+    if (convertedFrameCount < 0) {
+        MSG_ERROR(_T("swr_convert() failed\n"));
+        goto clean_up;
+    }
+
+    // 取出重采样器中剩余的样本
+    outputData[0] = (uint8_t *)(convertedSamples + ((size_t)convertedFrameCount * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT));
+    int flushedFrameCount = swr_convert(resamplerContext, outputData, (convertedCapacity - convertedFrameCount), NULL, 0);
+    if (flushedFrameCount < 0) {
+        MSG_ERROR(_T("swr_convert() failed\n"));
+        goto clean_up;
+    }
+
+    *convertedFrameCountOut = convertedFrameCount + flushedFrameCount;
+    succeeded = true;
+
+clean_up:
+    if (resamplerContext != NULL) {
+        swr_free(&resamplerContext);
+    }
+
+    av_channel_layout_uninit(&inputChannelLayout);
+
+    if (!succeeded && (convertedSamples != NULL)) {
+        Memory_free(&convertedSamples);
+    }
+
+    return convertedSamples;
+}
+
+LIBSPLEETER_API int LibSpleeter_getApiVersion(void) {
+    return LIBSPLEETER_API_VERSION;
+}
+
+LIBSPLEETER_API LibSpleeterStatus LibSpleeter_loadModel(const wchar_t *modelName, LibSpleeterModel **modelOut) {
+    if ((modelName == NULL) || (modelOut == NULL)) {
+        return LIBSPLEETER_ERROR_INVALID_ARGUMENT;
+    }
+
+    // 作为库使用时不输出进度信息
+    Common_setProgressMuted(true);
+    SpleeterModel *model = SpleeterModel_load(modelName);
+    Common_setProgressMuted(false);
+
+    if (model == NULL) {
+        return LIBSPLEETER_ERROR_LOAD_MODEL;
+    }
+
+    LibSpleeterModel *obj = MEMORY_ALLOC_STRUCT(LibSpleeterModel);
+    obj->model = model;
+
+    *modelOut = obj;
+
+    return LIBSPLEETER_OK;
+}
+
+LIBSPLEETER_API void LibSpleeter_freeModel(LibSpleeterModel **modelPtr) {
+    if ((modelPtr == NULL) || (*modelPtr == NULL)) {
+        return;
+    }
+
+    SpleeterModel_free(&(*modelPtr)->model);
+
+    Memory_free(modelPtr);
+}
+
+LIBSPLEETER_API int LibSpleeter_getStemCount(const LibSpleeterModel *model) {
+    if (model == NULL) {
+        return 0;
+    }
+
+    return model->model->modelInfo->outputCount;
+}
+
+LIBSPLEETER_API const wchar_t *LibSpleeter_getStemName(const LibSpleeterModel *model, int index) {
+    if ((model == NULL) || (index < 0) || (index >= model->model->modelInfo->outputCount)) {
+        return NULL;
+    }
+
+    return model->model->modelInfo->trackNames[index];
+}
+
+LIBSPLEETER_API LibSpleeterStatus LibSpleeter_splitPcm(LibSpleeterModel *model,
+        const float *samples, int frameCount, int sampleRate, int channelCount,
+        LibSpleeterSegmentCallback callback, void *userData, LibSpleeterResult **resultOut) {
+    if ((model == NULL) || (samples == NULL) || (frameCount <= 0) || (sampleRate <= 0) || (channelCount <= 0)) {
+        return LIBSPLEETER_ERROR_INVALID_ARGUMENT;
+    }
+
+    // 处理过程中只读取输入数据，因此格式相同时可直接使用调用者的内存
+    AudioDataSource audioDataSource = {
+        .filenameUtf8 = NULL,
+        .sampleRate = SPLEETER_MODEL_AUDIO_SAMPLE_RATE,
+        .sampleValues = (AudioSampleValue_t *)samples,
+        .sampleCountPerChannel = frameCount,
+        .channelCount = SPLEETER_MODEL_AUDIO_CHANNEL_COUNT
+    };
+
+    float *convertedSamples = NULL;
+    if ((sampleRate != SPLEETER_MODEL_AUDIO_SAMPLE_RATE) || (channelCount != SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)) {
+        int convertedFrameCount = 0;
+        convertedSamples = _convertPcm(samples, frameCount, sampleRate, channelCount, &convertedFrameCount);
+        if (convertedSamples == NULL) {
+            return LIBSPLEETER_ERROR_DECODE;
+        }
+
+        audioDataSource.sampleValues = convertedSamples;
+        audioDataSource.sampleCountPerChannel = convertedFrameCount;
+    }
+
+    Common_setProgressMuted(true);
+    LibSpleeterStatus status = _split(model, &audioDataSource, callback, userData, resultOut);
+    Common_setProgressMuted(false);
+
+    if (convertedSamples != NULL) {
+        Memory_free(&convertedSamples);
+    }
+
+    return status;
+}
+
+LIBSPLEETER_API LibSpleeterStatus LibSpleeter_splitEncoded(LibSpleeterModel *model,
+        const void *data, size_t size,
+        LibSpleeterSegmentCallback callback, void *userData, LibSpleeterResult **resultOut) {
+    if ((model == NULL) || (data == NULL) || (size == 0)) {
+        return LIBSPLEETER_ERROR_INVALID_ARGUMENT;
+    }
+
+    const AudioSampleType sampleType = {
+        .sampleRate = SPLEETER_MODEL_AUDIO_SAMPLE_RATE,
+        .channelCount = SPLEETER_MODEL_AUDIO_CHANNEL_COUNT,
+        .sampleValueFormat = AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED
+    };
+
+    Common_setProgressMuted(true);
+
+    LibSpleeterStatus status;
+
+    AudioDataSource *audioDataSource = AudioFile_readAllFromMemory(data, size, &sampleType);
+    if (audioDataSource == NULL) {
+        status = LIBSPLEETER_ERROR_DECODE;
+    } else {
+        status = _split(model, audioDataSource, callback, userData, resultOut);
+        AudioDataSource_free(&audioDataSource);
+    }
+
+    Common_setProgressMuted(false);
+
+    return status;
+}
+
+LIBSPLEETER_API void LibSpleeter_freeResult(LibSpleeterResult **resultPtr) {
+    if ((resultPtr == NULL) || (*resultPtr == NULL)) {
+        return;
+    }
+
+    LibSpleeterResult *result = *resultPtr;
+
+    for (int i = 0; i < result->stemCount; i++) {
+        if (result->stems[i].samples != NULL) {
+            Memory_free(&result->stems[i].samples);
+        }
+    }
+
+    Memory_free(resultPtr);
+}
@@ -0,0 +1,231 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _LIB_SPLEETER_H_
+#define _LIB_SPLEETER_H_
+
+/*
+libspleeter 对外提供的 C 接口
+
+此头文件是 libspleeter.dll 的公开接口，不依赖程序内部的其他头文件，也不依赖 ffmpeg 和 TensorFlow 的头文件。
+所有结构体只在末尾追加新成员，已有函数的签名不会改变；有不兼容的修改时 LIBSPLEETER_API_VERSION 会增加。
+
+所有音频数据均为声道交错存储的 32 位浮点数 (float) 样本值。分离结果固定为 44100 Hz 双声道。
+已加载的模型可被多个线程同时使用。
+*/
+
+#include <stddef.h>
+#include <wchar.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef LIBSPLEETER_EXPORTS
+#define LIBSPLEETER_API     __declspec(dllexport)
+#else
+#define LIBSPLEETER_API     __declspec(dllimport)
+#endif
+
+/** 接口版本 */
+#define LIBSPLEETER_API_VERSION         1
+
+/** 分离结果的采样率 */
+#define LIBSPLEETER_SAMPLE_RATE         44100
+
+/** 分离结果的声道数 */
+#define LIBSPLEETER_CHANNEL_COUNT       2
+
+/** 最大音轨数量 */
+#define LIBSPLEETER_MAX_STEM_COUNT      5
+
+/**
+ * 状态码
+ */
+typedef enum {
+    /** 成功 */
+    LIBSPLEETER_OK                          = 0,
+    /** 参数错误 */
+    LIBSPLEETER_ERROR_INVALID_ARGUMENT      = -1,
+    /** 模型加载失败 */
+    LIBSPLEETER_ERROR_LOAD_MODEL            = -2,
+    /** 音频解码或格式转换失败 */
+    LIBSPLEETER_ERROR_DECODE                = -3,
+    /** 分离处理失败 */
+    LIBSPLEETER_ERROR_PROCESS               = -4,
+    /** 分段回调函数中止了处理 */
+    LIBSPLEETER_ERROR_ABORTED               = -5
+} LibSpleeterStatus;
+
+/**
+ * 已加载的模型 (不透明结构体，以保证接口的二进制兼容性)
+ */
+typedef struct LibSpleeterModel LibSpleeterModel;
+
+/**
+ * 单个音轨的完整分离结果
+ */
+typedef struct {
+    /** 音轨名称 (vocals, accompaniment, drums 等)，在 DLL 卸载前一直有效 */
+    const wchar_t   *name;
+
+    /** 样本值 (声道交错存储) */
+    float           *samples;
+
+    /** 每声道样本数 */
+    int             frameCount;
+} LibSpleeterStem;
+
+/**
+ * 完整的分离结果
+ */
+typedef struct {
+    /** 采样率 (固定为 LIBSPLEETER_SAMPLE_RATE) */
+    int                 sampleRate;
+
+    /** 声道数 (固定为 LIBSPLEETER_CHANNEL_COUNT) */
+    int                 channelCount;
+
+    /** 音轨数量 */
+    int                 stemCount;
+
+    /** 音轨列表 */
+    LibSpleeterStem     stems[LIBSPLEETER_MAX_STEM_COUNT];
+} LibSpleeterResult;
+
+/**
+ * 单个分段的分离结果
+ */
+typedef struct {
+    /** 分段在整个音频中的起始位置 (每声道样本数) */
+    int             frameOffset;
+
+    /** 分段的长度 (每声道样本数) */
+    int             frameCount;
+
+    /** 音轨数量 */
+    int             stemCount;
+
+    /** 各音轨在该分段中的样本值 (声道交错存储)，仅在回调函数执行期间有效 */
+    const float     *stemSamples[LIBSPLEETER_MAX_STEM_COUNT];
+} LibSpleeterSegment;
+
+/**
+ * 分段回调函数
+ *
+ * 分段按顺序回调，各分段首尾相接。回调函数在调用分离函数的线程中执行
+ *
+ * @param   userData        调用分离函数时传入的用户数据
+ * @param   segment         分段结果
+ *
+ * @return  返回 0 继续处理，返回非 0 值中止处理
+ */
+typedef int (*LibSpleeterSegmentCallback)(void *userData, const LibSpleeterSegment *segment);
+
+/**
+ * 获取 DLL 实现的接口版本
+ *
+ * @return  接口版本，调用者可与编译时的 LIBSPLEETER_API_VERSION 比较
+ */
+LIBSPLEETER_API int LibSpleeter_getApiVersion(void);
+
+/**
+ * 加载模型
+ *
+ * @param   modelName       模型名称 (DLL 所在目录的 models 子目录中的目录名，如 "2stems", "4stems", "5stems-22khz")，
+ *                          也可以是模型目录的完整路径
+ * @param   modelOut        用于返回已加载的模型
+ *
+ * @return  状态码
+ */
+LIBSPLEETER_API LibSpleeterStatus LibSpleeter_loadModel(const wchar_t *modelName, LibSpleeterModel **modelOut);
+
+/**
+ * 释放已加载的模型
+ *
+ * @param   modelPtr        指向已加载模型的指针的指针，释放后被设置为 NULL
+ */
+LIBSPLEETER_API void LibSpleeter_freeModel(LibSpleeterModel **modelPtr);
+
+/**
+ * 获取模型输出的音轨数量
+ */
+LIBSPLEETER_API int LibSpleeter_getStemCount(const LibSpleeterModel *model);
+
+/**
+ * 获取模型输出的指定音轨的名称
+ *
+ * @return  音轨名称，index 超出范围时返回 NULL
+ */
+LIBSPLEETER_API const wchar_t *LibSpleeter_getStemName(const LibSpleeterModel *model, int index);
+
+/**
+ * 分离内存中的 PCM 音频数据
+ *
+ * 采样率和声道数与 LIBSPLEETER_SAMPLE_RATE, LIBSPLEETER_CHANNEL_COUNT 相同时直接使用输入数据，不进行复制；
+ * 否则先转换为 44100 Hz 双声道
+ *
+ * @param   model           已加载的模型
+ * @param   samples         样本值 (声道交错存储)
+ * @param   frameCount      每声道样本数
+ * @param   sampleRate      采样率
+ * @param   channelCount    声道数
+ * @param   callback        分段回调函数，可为 NULL
+ * @param   userData        传递给回调函数的用户数据
+ * @param   resultOut       用于返回完整的分离结果，为 NULL 时仅通过回调函数返回结果 (不保存完整的音轨)
+ *
+ * @return  状态码
+ */
+LIBSPLEETER_API LibSpleeterStatus LibSpleeter_splitPcm(LibSpleeterModel *model,
+        const float *samples, int frameCount, int sampleRate, int channelCount,
+        LibSpleeterSegmentCallback callback, void *userData, LibSpleeterResult **resultOut);
+
+/**
+ * 分离内存中的已编码音频数据 (完整的音频文件内容，支持 ffmpeg 可解码的所有格式)
+ *
+ * @param   model           已加载的模型
+ * @param   data            已编码音频数据
+ * @param   size            已编码音频数据的大小 (以字节为单位)
+ * @param   callback        分段回调函数，可为 NULL
+ * @param   userData        传递给回调函数的用户数据
+ * @param   resultOut       用于返回完整的分离结果，为 NULL 时仅通过回调函数返回结果
+ *
+ * @return  状态码
+ */
+LIBSPLEETER_API LibSpleeterStatus LibSpleeter_splitEncoded(LibSpleeterModel *model,
+        const void *data, size_t size,
+        LibSpleeterSegmentCallback callback, void *userData, LibSpleeterResult **resultOut);
+
+/**
+ * 释放分离结果
+ *
+ * @param   resultPtr       指向分离结果的指针的指针，释放后被设置为 NULL
+ */
+LIBSPLEETER_API void LibSpleeter_freeResult(LibSpleeterResult **resultPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _LIB_SPLEETER_H_
@@ -30,12 +30,64 @@
 #include <io.h>
 #include <Shlwapi.h>
 #include <intrin.h>
+#include <process.h>
 #include "../version.h"
 #include "getopt.h"
 #include "Common.h"
 #include "CrashReporter.h"
 #include "AudioFileReader.h"
+#include "AudioFileWriter.h"
+#include "BatchScheduler.h"
+#include "DistributedProcessor.h"
+#include "InputFileList.h"
+#include "PcmCache.h"
+#include "ResultCache.h"
+#include "Server.h"
 #include "SpleeterProcessor.h"
+#include "TrackOutput.h"
+
+/** --workers 所能指定的最大数量 */
+#define OPTION_WORKER_COUNT_MAX         64
+
+/** --queue-size 所能指定的最大数量 */
+#define OPTION_QUEUE_SIZE_MAX           1024
+
+/** --jobs 所能指定的最大数量 */
+#define OPTION_JOB_COUNT_MAX            64
+
+/** --decode-threads 所能指定的最大数量 */
+#define OPTION_DECODE_THREAD_COUNT_MAX  64
+
+/** --encode-threads 所能指定的最大数量 */
+#define OPTION_ENCODE_THREAD_COUNT_MAX  64
+
+/**
+ * 没有对应短选项的长选项的 val 值 (从 0x100 开始，避免与短选项字符冲突)
+ */
+enum {
+    LONG_OPTION_PATTERN = 0x100,
+    LONG_OPTION_LISTEN,
+    LONG_OPTION_WORKERS,
+    LONG_OPTION_QUEUE_SIZE,
+    LONG_OPTION_JOBS,
+    LONG_OPTION_CACHE_DIR,
+    LONG_OPTION_CACHE_SIZE,
+    LONG_OPTION_PCM_CACHE_DIR,
+    LONG_OPTION_REMOTE_WORKERS,
+    LONG_OPTION_DECODE_THREADS,
+    LONG_OPTION_IO_BLOCK_SIZE,
+    LONG_OPTION_INPUT_FORMAT,
+    LONG_OPTION_START,
+    LONG_OPTION_DURATION,
+    LONG_OPTION_RESAMPLE_QUALITY,
+    LONG_OPTION_ENCODE_THREADS,
+    LONG_OPTION_FLAC_LEVEL,
+    LONG_OPTION_MP3_QUALITY,
+    LONG_OPTION_AAC_CODER,
+    LONG_OPTION_SINGLE_FILE,
+    LONG_OPTION_RAW_OUTPUT,
+    LONG_OPTION_OUTPUT_FORMAT
+};
 
 /**
  * 显示帮助文本
@@ -44,7 +96,10 @@ static void _displayHelp(int argc, TCHAR *argv[]) {
     MSG_INFO(_T("%s %s\n"), _T(PROGRAM_NAME), _T(PROGRAM_VERSION));
     MSG_INFO(_T("\n"));
 
-    MSG_INFO(_T("Usage: %s [options] <input_file_path>\n"), argv[0]);
+    MSG_INFO(_T("Usage: %s [options] <input_file_path> [<input_file_path> ...]\n"), argv[0]);
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("Each input can be a file, a directory, or @list.txt (a UTF-8 text file with one path per line).\n"));
+    MSG_INFO(_T("When multiple files are given, the model is loaded only once and reused for all files.\n"));
     MSG_INFO(_T("\n"));
 
     MSG_INFO(_T("Options:\n"));
@@ -59,8 +114,25 @@ static void _displayHelp(int argc, TCHAR *argv[]) {
     MSG_INFO(_T("                            $(BaseName)                 test\n"));
     MSG_INFO(_T("                            $(Ext)                      mp3\n"));
     MSG_INFO(_T("                            $(TrackName)                vocals,drums,bass,...\n"));
+    MSG_INFO(_T("                        \"-\" or \"pipe:\" writes a single track to the standard output, and a path\n"));
+    MSG_INFO(_T("                        starting with \\\\.\\pipe\\ writes to a named pipe created by the reading program.\n"));
+    MSG_INFO(_T("                        Such outputs are written while separating, as soon as each segment is ready\n"));
+    MSG_INFO(_T("    --output-format     Output container format instead of guessing from the extension, e.g. wav, flac\n"));
+    MSG_INFO(_T("                        Default is wav when the output path has no extension (e.g. \"-\")\n"));
     MSG_INFO(_T("    -b, --bitrate       Output file bitrate (unused for lossless or constant quantizer encoding)\n"));
     MSG_INFO(_T("                            128k, 192000, 256k, ..., default is 256k\n"));
+    MSG_INFO(_T("    --flac-level        FLAC compression level, 0 (fastest) to 12 (smallest), default is 5\n"));
+    MSG_INFO(_T("    --mp3-quality       MP3 encoding algorithm quality, 0 (best) to 9 (fastest), default is the encoder's\n"));
+    MSG_INFO(_T("    --aac-coder         AAC coder of the built-in AAC encoder: twoloop, fast, default is twoloop\n"));
+    MSG_INFO(_T("    --fast-encode       Prefer encoding speed: FLAC level 0, MP3 quality 7 and the fast AAC coder,\n"));
+    MSG_INFO(_T("                        unless specified by the options above\n"));
+    MSG_INFO(_T("    --single-file       Write all output tracks as audio streams of one file:\n"));
+    MSG_INFO(_T("                            mka (FLAC), mp4 (AAC), stem.mp4 (NI Stems, the input as the first stream\n"));
+    MSG_INFO(_T("                            followed by 4 output tracks)\n"));
+    MSG_INFO(_T("                        Default output path is $(DirPath)\\$(BaseName).stems.mka, .stems.mp4 or .stem.mp4\n"));
+    MSG_INFO(_T("    --raw-output        Write the separated samples directly without encoding:\n"));
+    MSG_INFO(_T("                            f32 (raw interleaved float32), npy (NumPy float32 array), wav (32-bit float)\n"));
+    MSG_INFO(_T("                        When -o is not specified, the extension is replaced with .f32, .npy or .wav\n"));
     MSG_INFO(_T("    -t, --tracks        Output track list (comma separated track names)\n"));
     MSG_INFO(_T("                        Default value is empty to output all tracks\n"));
     MSG_INFO(_T("                        Available track names:\n"));
@@ -70,7 +142,55 @@ static void _displayHelp(int argc, TCHAR *argv[]) {
     MSG_INFO(_T("                            vocals,drums                Output vocals and drums tracks\n"));
     MSG_INFO(_T("                            mixed=vocals+drums          Mix vocals and drums as \"mixed\" track\n"));
     MSG_INFO(_T("                            vocals,acc=input-vocals     Output vocals and accompaniment for 4stems model\n"));
+    MSG_INFO(_T("                            karaoke=input-0.8*vocals    Keep 20%% of vocals in the accompaniment\n"));
+    MSG_INFO(_T("                        A source track may be prefixed with a gain, e.g. 0.5*drums\n"));
+    MSG_INFO(_T("    --pattern           Semicolon separated wildcard patterns used to find input files in directories\n"));
+    MSG_INFO(_T("                        Default is *.mp3;*.m4a;*.aac;*.flac;*.wav;*.ogg;*.opus;*.wma;*.ape;*.aiff;*.aif\n"));
+    MSG_INFO(_T("    --recursive         Also find input files in subdirectories of the specified directories\n"));
+    MSG_INFO(_T("    --input-format      Input container format instead of probing, with optional sample rate and channels\n"));
+    MSG_INFO(_T("                        for raw PCM: <format>[:<sample rate>[:<channels>]], e.g. s16le:48000:2, f32le, mp3\n"));
+    MSG_INFO(_T("    --fast-open         Probe only the audio stream with a small probe size and analyze duration\n"));
+    MSG_INFO(_T("                        Falls back to full probing when the audio parameters cannot be determined\n"));
+    MSG_INFO(_T("    --start             Only separate the part from the specified time, in seconds or [hh:]mm:ss[.xxx]\n"));
+    MSG_INFO(_T("    --duration          Only separate the part of the specified duration, in seconds or [hh:]mm:ss[.xxx]\n"));
+    MSG_INFO(_T("                        Only the specified part and 5 seconds of context around it are decoded\n"));
+    MSG_INFO(_T("    --jobs              Number of segments separated at the same time, 1 to 64, default is 1\n"));
+    MSG_INFO(_T("                        When greater than 1, segments of all input files are shared by the workers,\n"));
+    MSG_INFO(_T("                        so that a long file does not keep one worker busy while the others are idle\n"));
+    MSG_INFO(_T("    --decode-threads    Number of threads decoding one input file, 1 to 64, default is 1\n"));
+    MSG_INFO(_T("                        Long seekable files (at least 1 minute per thread) are split into ranges\n"));
+    MSG_INFO(_T("                        which are decoded at the same time\n"));
+    MSG_INFO(_T("    --encode-threads    Number of threads encoding the output tracks at the same time,\n"));
+    MSG_INFO(_T("                        default is 0 (one thread per track, up to the number of processors)\n"));
+    MSG_INFO(_T("    --resample-quality  Quality of the built-in AVX2 resampler used for inputs not at 44.1kHz\n"));
+    MSG_INFO(_T("                            low, medium, high, swr (use libswresample), default is medium\n"));
+    MSG_INFO(_T("    --io-block-size     Read input files in blocks of this size instead of using FFmpeg's file reading\n"));
+    MSG_INFO(_T("                            256K, 4M, ..., default is empty (1M when --io-mmap or --io-read-ahead is used)\n"));
+    MSG_INFO(_T("    --io-mmap           Read input files through memory mapping\n"));
+    MSG_INFO(_T("    --io-read-ahead     Read the next block of input files in a background thread\n"));
+    MSG_INFO(_T("                        With --verbose, the time spent waiting for input I/O is displayed\n"));
+    MSG_INFO(_T("    --io-write-behind   Write output files from a background thread through 8 queued 1M blocks,\n"));
+    MSG_INFO(_T("                        so that encoding does not wait for slow storage\n"));
+    MSG_INFO(_T("                        With --verbose, the bytes written and the time spent waiting are displayed\n"));
+    MSG_INFO(_T("    --cache-dir         Directory of the separation result cache, default is empty (no cache)\n"));
+    MSG_INFO(_T("                        Results are found by the content of the decoded audio, so a renamed\n"));
+    MSG_INFO(_T("                        copy of a processed file is written without being separated again\n"));
+    MSG_INFO(_T("    --cache-size        Maximum total size of the cache files, the least recently used are deleted\n"));
+    MSG_INFO(_T("                            500M, 20G, ..., default is 10G\n"));
+    MSG_INFO(_T("    --pcm-cache-dir     Directory of the decoded audio cache, default is empty (no cache)\n"));
+    MSG_INFO(_T("                        When the same file is processed again (e.g. with another model or --tracks),\n"));
+    MSG_INFO(_T("                        the decoded audio is mapped from the cache file instead of decoding again\n"));
     MSG_INFO(_T("    --overwrite         Overwrite when the target output file exists\n"));
+    MSG_INFO(_T("    --server            Run as a local separation server, keeping loaded models in memory\n"));
+    MSG_INFO(_T("    --listen            Server endpoint, a port number, 127.0.0.1:<port> or a Unix socket file path\n"));
+    MSG_INFO(_T("                            Default is 127.0.0.1:7450\n"));
+    MSG_INFO(_T("    --workers           Number of jobs the server processes at the same time, 1 to 64, default is 2\n"));
+    MSG_INFO(_T("    --queue-size        Number of jobs that can wait in the server queue, 1 to 1024, default is 16\n"));
+    MSG_INFO(_T("    --worker            Run as a distributed worker, processing segments sent by coordinators\n"));
+    MSG_INFO(_T("                        --listen specifies the endpoint, default is 127.0.0.1:7451\n"));
+    MSG_INFO(_T("    --remote-workers    Send segments to the specified workers instead of separating locally\n"));
+    MSG_INFO(_T("                            192.168.1.10:7451;192.168.1.11:7451, ...\n"));
+    MSG_INFO(_T("                        Repeat an endpoint to use more connections to the same worker\n"));
     MSG_INFO(_T("    --verbose           Display detailed processing information\n"));
     MSG_INFO(_T("    --debug             Display debug information\n"));
     MSG_INFO(_T("    -h, --help          Display this help and exit\n"));
@@ -92,6 +212,31 @@ static void _displayHelp(int argc, TCHAR *argv[]) {
     MSG_INFO(_T("    - Long option example\n"));
     MSG_INFO(_T("    - Using the model of which upper frequency limit is 22kHz\n"));
     MSG_INFO(_T("    - Splits song.mp3 into 5 tracks\n"));
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("    %s -m 4stems --recursive --pattern *.flac D:\\Music @more_songs.txt\n"), argv[0]);
+    MSG_INFO(_T("    - Batch mode example\n"));
+    MSG_INFO(_T("    - Splits all FLAC files in D:\\Music and its subdirectories, and all files listed in more_songs.txt\n"));
+    MSG_INFO(_T("    - Displays the time used and the throughput of each file and of the whole batch at the end\n"));
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("    ffmpeg -i song.mp3 -f s16le -ar 44100 -ac 2 - | %s -m 2stems --input-format s16le:44100:2 -o song.$(TrackName).wav -\n"), argv[0]);
+    MSG_INFO(_T("    - Standard input example\n"));
+    MSG_INFO(_T("    - Reads raw PCM from the pipe (\"-\" or \"pipe:\"), the output path must be specified with -o\n"));
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("    %s -m 2stems -t vocals -o - song.mp3 | ffplay -\n"), argv[0]);
+    MSG_INFO(_T("    - Standard output example\n"));
+    MSG_INFO(_T("    - Writes the vocals track to the pipe as WAV while separating, messages are written to stderr\n"));
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("    %s -m 4stems --start 1:30 --duration 45 song.mp3\n"), argv[0]);
+    MSG_INFO(_T("    - Time range example\n"));
+    MSG_INFO(_T("    - Splits only the 45 seconds starting at 1:30 of song.mp3 into 4 tracks\n"));
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("    %s --server -m 4stems --listen 7450 --workers 2\n"), argv[0]);
+    MSG_INFO(_T("    - Server mode example\n"));
+    MSG_INFO(_T("    - Loads 4stems model once and accepts jobs on 127.0.0.1:7450, see README for the protocol\n"));
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("    %s -m 4stems --remote-workers 192.168.1.10:7451;192.168.1.11:7451 song.mp3\n"), argv[0]);
+    MSG_INFO(_T("    - Distributed processing example\n"));
+    MSG_INFO(_T("    - Segments are separated by the workers started with --worker -m 4stems --listen 0.0.0.0:7451\n"));
 }
 
 /**
@@ -193,173 +338,58 @@ static bool _checkDllLoading(void) {
 }
 
 /**
- * 在文件路径原有的扩展名前添加额外的扩展名
- *
- * 例如对于 srcFilePath = "dir\file.mp3", extraExtension = "vocals", 返回结果为
- * "dir\file.vocals.mp3"
+ * 解析以秒为单位或 [hh:]mm:ss[.xxx] 格式的时间
  *
- * @param   destFilePathBuffer              目标文件路径缓冲区
- * @param   destFilePathBufferCharCount     destFilePathBuffer 所能容纳的字符数
- * @param   srcFilePath                     原始文件路径
- * @param   extraExtension                  要添加的额外扩展名 (不包含起始位置的 ".")
- *
- * @return  成功时返回 true, 失败时返回 false
+ * @return  成功时返回 true, 格式错误时返回 false
  */
-static bool _addExtraExtensionBeforeOriginalExtension(TCHAR *destFilePathBuffer, size_t destFilePathBufferCharCount,
-        const TCHAR *srcFilePath, const TCHAR *extraExtension) {
-    TCHAR *originalExtension = PathFindExtension(srcFilePath);
-
-    int srcFilePathWithoutExtensionLength = (int)(originalExtension - srcFilePath);
-    if ((srcFilePathWithoutExtensionLength < 0)
-            || (srcFilePathWithoutExtensionLength > (FILE_PATH_MAX_SIZE - 1))) {
-        return false;
-    }
+static bool _parseTime(double *secondsOut, const TCHAR *str) {
+    double seconds = 0.0;
+    int fieldCount = 0;
 
-    TCHAR srcFilePathWithoutExtension[FILE_PATH_MAX_SIZE] = { _T('\0') };
-    _tcsncpy(srcFilePathWithoutExtension, srcFilePath, srcFilePathWithoutExtensionLength);
-    srcFilePathWithoutExtension[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+    const TCHAR *p = str;
+    while (true) {
+        // 不使用 _tcstod()，小数点不受 setlocale() 所设置的区域影响
+        const TCHAR *end = NULL;
+        double value = Common_parseDecimal(p, &end);
+        if (end == p) {
+            return false;
+        }
 
-    int writtenLength = _sntprintf(destFilePathBuffer, destFilePathBufferCharCount, _T("%s.%s%s"),
-            srcFilePathWithoutExtension, extraExtension, originalExtension);
-    if ((writtenLength >= 0) && (writtenLength < destFilePathBufferCharCount)) {
-        return true;
-    } else {
-        return false;
-    }
-}
+        fieldCount++;
+        if (fieldCount > 3) {
+            return false;
+        }
 
-/**
- * 根据输出文件路径格式字符串生成指定轨道对应的输出文件路径
- *
- * @param   dest                    用于存储所生成指定轨道对应的输出文件路径的缓冲区 (大小为 FILE_PATH_MAX_SIZE)
- * @param   src                     输出文件路径格式字符串
- * @param   inputFileFullPath       输入文件完整路径
- * @param   trackName               当前轨道名称
- * @param   outputTrackCount        要输出的所有轨道的数量
- *
- * @return  成功时返回 true, 失败时返回 false
- */
-static bool _convertOutputFilePathFormatString(TCHAR *dest, const TCHAR *src,
-        const TCHAR *inputFileFullPath, const TCHAR *trackName, int outputTrackCount) {
-    TCHAR *destPtr = dest;
-    TCHAR *destEnd = dest + FILE_PATH_MAX_SIZE;
-
-    size_t srcLength = _tcsnlen(src, FILE_PATH_MAX_SIZE);
-    if (srcLength >= FILE_PATH_MAX_SIZE) {
-        MSG_ERROR(_T("The specified output file path format \"%s\" is too long.\n"), src);
-        return false;
-    }
-    const TCHAR *srcEnd = src + srcLength;
-
-    bool containsTrackName = false;
-
-    const TCHAR *srcPtr = src;
-    while (srcPtr < srcEnd) {
-        if ((*srcPtr == _T('$')) && ((srcPtr + 1) < srcEnd) && (*(srcPtr + 1) == _T('('))) {
-            // 遇到了 $(VariableName) 形式变量名的起始部分 "$("
-
-            const TCHAR *variableNameBegin = srcPtr + 2;
-            const TCHAR *variableNameEnd = _tcschr(variableNameBegin, _T(')'));
-            if (variableNameEnd != NULL) {
-                // 查找到了变量名的结束部分 ")"
-
-                // 计算变量名的长度
-                size_t variableNameLength = variableNameEnd - variableNameBegin;
-
-                // 复制变量名到 variableNameBuffer 中，用于后续字符串比较
-                TCHAR variableNameBuffer[FILE_PATH_MAX_SIZE] = { _T('\0') };
-                memcpy(variableNameBuffer, variableNameBegin, variableNameLength * sizeof(TCHAR));
-                variableNameBuffer[FILE_PATH_MAX_SIZE - 1] = _T('\0');
-
-                // 将对应的变量值复制到 variableValueBuffer 中
-                TCHAR variableValueBuffer[FILE_PATH_MAX_SIZE] = { _T('\0') };
-                if (_tcscmp(_T("FullPath"), variableNameBuffer) == 0) {
-                    // 输入文件的完整路径
-                    _tcsncpy(variableValueBuffer, inputFileFullPath, (FILE_PATH_MAX_SIZE - 1));
-                } else if (_tcscmp(_T("DirPath"), variableNameBuffer) == 0) {
-                    // 输入文件所在目录的路径
-                    _tcsncpy(variableValueBuffer, inputFileFullPath, (FILE_PATH_MAX_SIZE - 1));
-                    if (!PathRemoveFileSpec(variableValueBuffer)) {
-                        MSG_ERROR(_T("Failed to call PathRemoveFileSpec()\n"));
-                        return false;
-                    }
-                } else if (_tcscmp(_T("FileName"), variableNameBuffer) == 0) {
-                    TCHAR *inputFileName = PathFindFileName(inputFileFullPath);
-                    if (inputFileName != inputFileFullPath) {
-                        // 输入文件的文件名
-                        _tcsncpy(variableValueBuffer, inputFileName, (FILE_PATH_MAX_SIZE - 1));
-                    } else {
-                        // 查找输入文件路径中的文件名失败
-                        variableValueBuffer[0] = _T('\0');
-                    }
-                } else if (_tcscmp(_T("BaseName"), variableNameBuffer) == 0) {
-                    TCHAR *inputFileName = PathFindFileName(inputFileFullPath);
-                    if (inputFileName != inputFileFullPath) {
-                        // 输入文件的文件名去除扩展名后的结果
-                        _tcsncpy(variableValueBuffer, inputFileName, (FILE_PATH_MAX_SIZE - 1));
-                        TCHAR *fileExtension = PathFindExtension(variableValueBuffer);
-                        if (*fileExtension == '.') {
-                            *fileExtension = _T('\0');
-                        }
-                    } else {
-                        // 查找输入文件路径中的文件名失败
-                        variableValueBuffer[0] = _T('\0');
-                    }
-                } else if (_tcscmp(_T("Ext"), variableNameBuffer) == 0) {
-                    TCHAR *inputFileExtension = PathFindExtension(inputFileFullPath);
-                    if (*inputFileExtension == '.') {
-                        // 输入文件的扩展名
-                        _tcsncpy(variableValueBuffer, inputFileExtension + 1, (FILE_PATH_MAX_SIZE - 1));
-                    } else {
-                        // 查找输入文件路径中的扩展名失败
-                        variableValueBuffer[0] = _T('\0');
-                    }
-                } else if (_tcscmp(_T("TrackName"), variableNameBuffer) == 0) {
-                    // 轨道名称
-                    _tcsncpy(variableValueBuffer, trackName, (FILE_PATH_MAX_SIZE - 1));
-
-                    containsTrackName = true;
-                } else {
-                    // 不合法的变量名
-                    MSG_ERROR(_T("Unrecognized variable name \"%s\"\n"),
-                            variableNameBuffer);
-                    return false;
-                }
+        seconds = (seconds * 60.0) + value;
 
-                variableValueBuffer[FILE_PATH_MAX_SIZE - 1] = _T('\0');
-                size_t variableValueLength = _tcsclen(variableValueBuffer);
-                if ((destPtr + variableValueLength) >= destEnd) {
-                    // 变量值的长度超过 FILE_PATH_MAX_SIZE 的限制
-                    MSG_ERROR(_T("The variable value \"%s\" is too long\n"), variableValueBuffer);
-                    return false;
-                }
-                memcpy(destPtr, variableValueBuffer, variableValueLength * sizeof(TCHAR));
-                destPtr += variableValueLength;
-                srcPtr += 2 + variableNameLength + 1;   // 跳过已处理完的 $(VariableName) 形式的变量名
-                continue;
-            }
+        if (*end == _T('\0')) {
+            break;
         }
-
-        if ((destPtr + 1) >= destEnd) {
-            // dest 缓冲区已满
-            MSG_ERROR(_T("The concatenating output file path is already too long.\n"));
+        if (*end != _T(':')) {
             return false;
         }
-        *(destPtr++) = *(srcPtr++);
-    }
 
-    if ((outputTrackCount > 1) && !containsTrackName) {
-        // 输出文件名格式字符串中不包含轨道名称
-        MSG_ERROR(_T("The output file path format must contain a \"$(TrackName)\" when output multiple tracks.\n"));
-        return false;
+        p = end + 1;
     }
 
-    if ((destPtr + 1) >= destEnd) {
-        // dest 缓冲区已满
-        MSG_ERROR(_T("The concatenating output file path is already too long.\n"));
+    *secondsOut = seconds;
+
+    return true;
+}
+
+/**
+ * 解析指定范围内的整数
+ *
+ * @return  成功时返回 true, 格式错误或超出范围时返回 false
+ */
+static bool _parseIntInRange(int *valueOut, const TCHAR *str, int minValue, int maxValue) {
+    TCHAR *end = NULL;
+    long value = _tcstol(str, &end, 10);
+    if ((end == str) || (*end != _T('\0')) || (value < minValue) || (value > maxValue)) {
         return false;
     }
-    *(destPtr++) = _T('\0');
+
+    *valueOut = (int)value;
 
     return true;
 }
@@ -372,6 +402,11 @@ static bool _convertOutputFilePathFormatString(TCHAR *dest, const TCHAR *src,
  * @return  如果文件存在且可读，返回 true, 否则返回 false
  */
 static bool _checkInputFilePath(const TCHAR *inputFilePath) {
+    // 标准输入无需检查
+    if (AudioFileReader_isStandardInput(inputFilePath)) {
+        return true;
+    }
+
     // 检查指定的输入文件是否存在
     if (_taccess(inputFilePath, 0) == -1) {
         MSG_ERROR(_T("The specified input file \"%s\" does not exist.\n"), inputFilePath);
@@ -388,267 +423,270 @@ static bool _checkInputFilePath(const TCHAR *inputFilePath) {
 }
 
 /**
- * 获取输出文件路径
+ * 检查指定输入文件对应的所有输出文件路径，并显示这些路径
  *
- * @param   outputFilePathBuffer    用于存储输出文件路径的缓冲区
- * @param   outputFilePathFormat    输出文件路径格式字符串 (为空时将直接在 inputFileFullPath 的原有扩展名前添加 outputTrackName)
- * @param   outputTrackCount        输出轨道的总数量
- * @param   outputTrackName         当前输出轨道名称
- * @param   inputFileFullPath       输入音频文件的完整路径
+ * @param   config                  输出配置
+ * @param   inputFileFullPath       输入文件的完整路径
  *
- * @return  成功时返回 true, 失败时返回 false
+ * @return  所有输出文件路径都可用时返回 true, 否则返回 false
  */
-static bool _getOutputFilePath(TCHAR *outputFilePathBuffer, const TCHAR *outputFilePathFormat,
-        int outputTrackCount, const TCHAR *outputTrackName, const TCHAR *inputFileFullPath) {
-    if (_tcsclen(outputFilePathFormat) == 0) {
-        // 检查 inputFileFullPath 加上 trackName 后是否超长
-        if (!_addExtraExtensionBeforeOriginalExtension(outputFilePathBuffer, FILE_PATH_MAX_SIZE,
-                inputFileFullPath, outputTrackName)) {
-            MSG_ERROR(_T("The output file path for track \"%s\" is too long.\n"), outputTrackName);
-            return false;
-        }
-        outputFilePathBuffer[FILE_PATH_MAX_SIZE - 1] = _T('\0');
-    } else {
-        if (!_convertOutputFilePathFormatString(outputFilePathBuffer, outputFilePathFormat,
-                inputFileFullPath, outputTrackName, outputTrackCount)) {
+static bool _checkOutputFilePaths(const TrackOutputConfig *config, const TCHAR *inputFileFullPath) {
+    int outputTrackCount = TrackOutput_getTrackCount(config);
+
+    MSG_INFO(_T("Output file(s):\n"));
+
+    if (config->container != TRACK_OUTPUT_CONTAINER_NONE) {
+        // 所有输出轨道写入单个文件
+        TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (!TrackOutput_getContainerFilePath(outputFilePath, config, inputFileFullPath)) {
             return false;
         }
-    }
 
-    return true;
-}
+        MSG_INFO(_T("%s\n\n"), outputFilePath);
 
-/**
- * 检查指定的输出文件路径是否可用
- *
- * @param   outputFilePath      要检查的输出文件路径
- * @param   overwriteFlag       当指定路径的输出文件已存在时，是否允许覆盖
- *
- * @return  如果指定路径的文件已存在，或不可覆盖，或不可写入，则返回 false, 否则返回 true
- */
-static bool _checkOutputFilePath(const TCHAR *outputFilePath, int overwriteFlag) {
-    // 如果 outputFilePath 存在
-    if (_taccess(outputFilePath, 0) != -1) {
-        // 如果未指定 --overwrite 选项
-        if (!overwriteFlag) {
-            MSG_ERROR(_T("The output file \"%s\" has already existed. Add --overwrite option to ignore.\n"), outputFilePath);
+        return TrackOutput_checkFilePath(outputFilePath, config->overwriteFlag);
+    }
+
+    for (int i = 0; i < outputTrackCount; i++) {
+        TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (!TrackOutput_getTrackFilePath(outputFilePath, config, TrackOutput_getTrackName(config, i), inputFileFullPath)) {
             return false;
         }
 
-        // 如果 outputFilePath 不可写入
-        if (_taccess(outputFilePath, 2) == -1) {
-            MSG_ERROR(_T("The output file \"%s\" cannot be written.\n"), outputFilePath);
+        MSG_INFO(_T("%s\n"), outputFilePath);
+
+        if (!TrackOutput_checkFilePath(outputFilePath, config->overwriteFlag)) {
             return false;
         }
     }
+    MSG_INFO(_T("\n"));
 
     return true;
 }
 
 /**
- * 尝试解析比特率数值
+ * 后台预读任务
  *
- * @param   parsedResultBitrate     指向用于存储解析结果的变量的指针
- * @param   optionValue             要解析的文本 (可为纯数字，也可包含 'k' 或 'K' 单位后缀)
- *
- * @return  解析成功时返回 true, 失败时返回 false
+ * 批量处理时，在当前文件进行分离的同时，在后台线程中读取下一个文件
  */
-static bool _tryParseBitrate(int *parsedResultBitrate, const TCHAR *optionValue) {
-    if (parsedResultBitrate == NULL) {
-        return false;
-    }
+typedef struct {
+    /** 要读取的输入文件的完整路径 */
+    const TCHAR             *inputFileFullPath;
 
-    TCHAR optionValueBuffer[10] = { _T('\0') };
-    _tcsncpy(optionValueBuffer, optionValue, (10 - 1));
-    optionValueBuffer[10 - 1] = _T('\0');
+    /** 输出样本类型 */
+    const AudioSampleType   *sampleType;
 
-    size_t optionValueLength = _tcsclen(optionValueBuffer);
+    /** 解码后 PCM 数据的缓存，可为 NULL */
+    PcmCache                *pcmCache;
 
-    int multiplier;
-    if ((optionValueBuffer[optionValueLength - 1] == 'k')
-            || (optionValueBuffer[optionValueLength - 1] == 'K')) {
-        multiplier = 1000;
-    } else {
-        multiplier = 1;
-    }
+    /** 读取结果，失败时为 NULL */
+    AudioDataSource         *audioDataSource;
 
-    unsigned long parsedValue = _tcstoul(optionValueBuffer, NULL, 10);
-    if (parsedValue >= 0) {
-        *parsedResultBitrate = parsedValue * multiplier;
-        return true;
-    } else {
-        return false;
-    }
-}
+    /** 读取耗时 */
+    double                  readSeconds;
 
-/** TrackList 中 TrackItem 的最大数量 */
-#define TRACK_ITEM_MAX_COUNT        10
+    /** 后台线程的句柄 */
+    HANDLE                  threadHandle;
+} PrefetchTask;
 
-/** TrackItem 中 SourceTrackItem 的最大数量 */
-#define SOURCE_TRACK_MAX_COUNT      10
+static unsigned __stdcall _prefetchThreadProc(void *arg) {
+    PrefetchTask *task = (PrefetchTask *)arg;
 
-/** trackName 字符数组的大小 */
-#define TRACK_NAME_MAX_SIZE         100
+    // 避免与前台正在处理的文件的进度信息交错输出
+    Common_setProgressMuted(true);
 
-/**
- * 源轨道条目
- */
-typedef struct {
-    /** 是否是减去该轨道 (即在混音时该轨道是否需要反相) */
-    bool    toSubtract;
+    double beginTime = Common_getTimeInSeconds();
+    task->audioDataSource = PcmCache_readAll(task->pcmCache, task->inputFileFullPath, task->sampleType);
+    task->readSeconds = Common_getTimeInSeconds() - beginTime;
 
-    /** 轨道名称 (vocals, drums, ...) */
-    TCHAR   trackName[TRACK_NAME_MAX_SIZE];
-} SourceTrackItem;
+    return 0;
+}
 
 /**
- * 轨道条目
+ * 启动后台预读任务
+ *
+ * @return  成功时返回 true, 失败时返回 false (此时应改为在前台读取)
  */
-typedef struct {
-    /** 轨道名称 (当源轨道条目列表不为空时，为最终输出的轨道名称；否则为 Spleeter 模型中的轨道名称) */
-    TCHAR               trackName[TRACK_NAME_MAX_SIZE];
-
-    /** 源轨道条目列表 */
-    SourceTrackItem     sourceTrackItems[SOURCE_TRACK_MAX_COUNT];
+static bool _startPrefetchTask(PrefetchTask *task, PcmCache *pcmCache, const TCHAR *inputFileFullPath, const AudioSampleType *sampleType) {
+    memset(task, 0, sizeof(PrefetchTask));
+    task->inputFileFullPath = inputFileFullPath;
+    task->sampleType = sampleType;
+    task->pcmCache = pcmCache;
+
+    task->threadHandle = (HANDLE)_beginthreadex(NULL, 0, _prefetchThreadProc, task, 0, NULL);
+    if (task->threadHandle == NULL) {
+        MSG_WARNING(_T("Failed to start the prefetch thread, the next file will be read later.\n"));
+        return false;
+    }
 
-    /** 源轨道条目数量 */
-    int                 sourceTrackItemCount;
-} TrackItem;
+    return true;
+}
 
 /**
- * 轨道列表
+ * 等待后台预读任务完成
  */
-typedef struct {
-    /** 轨道条目列表 */
-    TrackItem   trackItems[TRACK_ITEM_MAX_COUNT];
-
-    /** 轨道条目数量 */
-    int         trackItemCount;
-} TrackList;
+static void _waitPrefetchTask(PrefetchTask *task) {
+    if (task->threadHandle != NULL) {
+        WaitForSingleObject(task->threadHandle, INFINITE);
+        CloseHandle(task->threadHandle);
+        task->threadHandle = NULL;
+    }
+}
 
 /**
- * 尝试解析轨道名称
- *
- * 合法的轨道名称长度为 1 至 (TRACK_NAME_MAX_SIZE - 1) 个字符，仅可包含字母、数字和下划线
+ * 分离输入音频，每完成一个分段即写入流式输出 (不使用分离结果缓存)
  *
- * @param   parsedTrackName     用于存放解析结果的字符数组
- * @param   str                 要解析的文本
+ * @return  成功时返回 true, 失败时返回 false
  */
-static size_t _tryParseTrackName(TCHAR parsedTrackName[TRACK_NAME_MAX_SIZE], const TCHAR *str) {
-    size_t trackNameLength = _tcsspn(str, _T("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_"));
-    if ((trackNameLength > 0) && (trackNameLength < TRACK_NAME_MAX_SIZE)) {
-        _tcsncpy(parsedTrackName, str, trackNameLength);
-        parsedTrackName[trackNameLength] = _T('\0');
+static bool _splitToStream(SpleeterModel *model, const TrackOutputConfig *outputConfig,
+        const TCHAR *inputFileFullPath, AudioDataSource *audioDataSource) {
+    TrackOutputStream *stream = TrackOutput_openStream(outputConfig, inputFileFullPath, audioDataSource);
+    if (stream == NULL) {
+        return false;
+    }
 
-        return trackNameLength;
-    } else {
-        return 0;
+    int splitResult = SpleeterProcessor_splitWithCallback(model, audioDataSource, TrackOutput_writeSegment, stream, NULL);
+
+    bool closed = TrackOutput_closeStream(&stream);
+
+    if (splitResult != 0) {
+        MSG_ERROR(_T("Failed to split input file \"%s\".\n"), inputFileFullPath);
+        return false;
     }
+
+    if (!closed) {
+        MSG_ERROR(_T("Failed to write output files for input file \"%s\".\n"), inputFileFullPath);
+        return false;
+    }
+
+    return true;
 }
 
 /**
- * 尝试解析轨道列表表达式
- *
- * @param   parsedTrackList     用于存放解析结果的结构体
- * @param   optionValue         要解析的文本
- *
- * @return  解析成功时返回 true, 失败时返回 false
+ * 逐个处理输入文件 (在当前文件分离的同时，在后台预读下一个文件)
  */
-static bool _tryParseTrackList(TrackList *parsedTrackList, const TCHAR *optionValue) {
-    memset(parsedTrackList, 0, sizeof(TrackList));
-
-    const TCHAR *p = optionValue;
-    const TCHAR *pEnd = p + _tcsclen(p);
-    while (p < pEnd) {
-        if (parsedTrackList->trackItemCount >= TRACK_ITEM_MAX_COUNT) {
-            return false;
+static void _processFilesSequentially(SpleeterModel *model, const DistributedCoordinatorConfig *coordinatorConfig,
+        ResultCache *resultCache, PcmCache *pcmCache, const TrackOutputConfig *outputConfig,
+        const InputFileList *inputFileList, FileProcessingStat *stats) {
+    PrefetchTask prefetchTask = { 0 };
+    bool prefetchStarted = false;
+
+    for (int i = 0; i < inputFileList->fileCount; i++) {
+        const TCHAR *inputFileFullPath = inputFileList->filePaths[i];
+        FileProcessingStat *stat = &stats[i];
+
+        if (inputFileList->fileCount > 1) {
+            MSG_INFO(_T("\n"));
+            MSG_INFO(_T("Processing [%d/%d]: %s\n"), (i + 1), inputFileList->fileCount, inputFileFullPath);
         }
-        TrackItem *trackItem = &parsedTrackList->trackItems[parsedTrackList->trackItemCount];
 
-        size_t trackNameLength = _tryParseTrackName(trackItem->trackName, p);
-        if (trackNameLength == 0) {
-            return false;
+        // 读取音频文件 (如果已在后台预读，则等待预读完成)
+
+        AudioDataSource *audioDataSourceStereo = NULL;
+        if (prefetchStarted) {
+            _waitPrefetchTask(&prefetchTask);
+            prefetchStarted = false;
+
+            audioDataSourceStereo = prefetchTask.audioDataSource;
+            stat->readSeconds = prefetchTask.readSeconds;
+
+            if (audioDataSourceStereo != NULL) {
+                Common_updateProgress(STAGE_AUDIO_FILE_READER,
+                        audioDataSourceStereo->sampleCountPerChannel, audioDataSourceStereo->sampleCountPerChannel);
+            }
+        } else {
+            double readBeginTime = Common_getTimeInSeconds();
+            audioDataSourceStereo = PcmCache_readAll(pcmCache, inputFileFullPath, &outputConfig->sampleType);
+            stat->readSeconds = Common_getTimeInSeconds() - readBeginTime;
         }
-        parsedTrackList->trackItemCount++;
-        p += trackNameLength;
-        if (p >= pEnd) {
-            break;
+
+        // 在当前文件分离的同时，在后台预读下一个文件
+        if ((i + 1) < inputFileList->fileCount) {
+            prefetchStarted = _startPrefetchTask(&prefetchTask, pcmCache, inputFileList->filePaths[i + 1], &outputConfig->sampleType);
         }
 
-        if (*p == _T(',')) {
-            p++;    // skip ','
+        if (audioDataSourceStereo == NULL) {
+            MSG_ERROR(_T("Failed to read input file \"%s\".\n"), inputFileFullPath);
             continue;
         }
 
-        if (*p == _T('=')) {
-            p++;    // skip '='
-            if (p >= pEnd) {
-                return false;
-            }
+        stat->audioSeconds = (double)audioDataSourceStereo->sampleCountPerChannel / (double)audioDataSourceStereo->sampleRate;
 
-            while (p < pEnd) {
-                if (trackItem->sourceTrackItemCount >= SOURCE_TRACK_MAX_COUNT) {
-                    return false;
-                }
-                SourceTrackItem *sourceTrackItem = &trackItem->sourceTrackItems[trackItem->sourceTrackItemCount];
-
-                if (*p == _T('-')) {
-                    sourceTrackItem->toSubtract = true;
-                    p++;
-                } else {
-                    if (*p == _T('+')) {
-                        p++;
-                    }
-                    sourceTrackItem->toSubtract = false;
-                }
-                if (p >= pEnd) {
-                    return false;
-                }
+        // 使用 Spleeter 进行处理 (指定了工作端时由工作端处理各分段)
 
-                size_t sourceTrackNameLength = _tryParseTrackName(sourceTrackItem->trackName, p);
-                if (sourceTrackNameLength == 0) {
-                    return false;
-                }
-                trackItem->sourceTrackItemCount++;
-                p += sourceTrackNameLength;
-                if (p >= pEnd) {
-                    break;
-                }
+        double splitBeginTime = Common_getTimeInSeconds();
 
-                if (*p == _T(',')) {
-                    p++;
-                    break;
-                }
-            }
+        if ((coordinatorConfig == NULL) && TrackOutput_isStreamingOutput(outputConfig)) {
+            // 流式输出时，每完成一个分段即写入，写入的耗时计入分离耗时
+            stat->succeeded = _splitToStream(model, outputConfig, inputFileFullPath, audioDataSourceStereo);
+            stat->splitSeconds = Common_getTimeInSeconds() - splitBeginTime;
+
+            AudioDataSource_free(&audioDataSourceStereo);
+            continue;
         }
+
+        SpleeterProcessorResult *result = NULL;
+        int splitResult = (coordinatorConfig != NULL)
+                ? DistributedProcessor_split(coordinatorConfig, audioDataSourceStereo, &result)
+                : ResultCache_splitWithModel(resultCache, model, audioDataSourceStereo, &result, NULL);
+        if ((splitResult != 0) || (result == NULL)) {
+            MSG_ERROR(_T("Failed to split input file \"%s\".\n"), inputFileFullPath);
+            AudioDataSource_free(&audioDataSourceStereo);
+            continue;
+        }
+        stat->splitSeconds = Common_getTimeInSeconds() - splitBeginTime;
+
+        // 写入输出文件
+
+        double writeBeginTime = Common_getTimeInSeconds();
+        stat->succeeded = TrackOutput_writeFiles(outputConfig, inputFileFullPath, audioDataSourceStereo, result);
+        stat->writeSeconds = Common_getTimeInSeconds() - writeBeginTime;
+
+        SpleeterProcessorResult_free(&result);
+        AudioDataSource_free(&audioDataSourceStereo);
     }
 
-    return true;
+    if (prefetchStarted) {
+        _waitPrefetchTask(&prefetchTask);
+        if (prefetchTask.audioDataSource != NULL) {
+            AudioDataSource_free(&prefetchTask.audioDataSource);
+        }
+    }
 }
 
 /**
- * 检查已选择的 Spleeter 模型中是否包含指定名称的输出轨道
- *
- * @param   modelInfo       指向 SpleeterModelInfo 结构体的指针
- * @param   trackName       要检查的轨道名称
- *
- * @return  如果包含则返回 true, 否则返回 false
+ * 显示批量处理的统计信息
  */
-static bool _checkSpleeterModelTrackName(const SpleeterModelInfo *modelInfo, const TCHAR *trackName) {
-    bool foundTrackName = false;
-    for (int i = 0; i < modelInfo->outputCount; i++) {
-        if (_tcscmp(trackName, modelInfo->trackNames[i]) == 0) {
-            foundTrackName = true;
-            break;
-        }
-    }
+static void _displayBatchSummary(const InputFileList *inputFileList, const FileProcessingStat *stats, double elapsedSeconds) {
+    int succeededCount = 0;
+    double totalAudioSeconds = 0.0;
 
-    if (!foundTrackName) {
-        MSG_ERROR(_T("Specified track name \"%s\" does not exist in %s model.\n"), trackName, modelInfo->basicName);
-        return false;
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("Summary:\n"));
+    MSG_INFO(_T("%5s  %10s  %8s  %8s  %8s  %8s  %-6s  %s\n"),
+            _T("#"), _T("Duration"), _T("Read"), _T("Split"), _T("Write"), _T("Speed"), _T("Result"), _T("File"));
+
+    for (int i = 0; i < inputFileList->fileCount; i++) {
+        const FileProcessingStat *stat = &stats[i];
+
+        double processingSeconds = stat->readSeconds + stat->splitSeconds + stat->writeSeconds;
+        double speed = (processingSeconds > 0.0) ? (stat->audioSeconds / processingSeconds) : 0.0;
+
+        MSG_INFO(_T("%5d  %9.1fs  %7.2fs  %7.2fs  %7.2fs  %7.1fx  %-6s  %s\n"),
+                (i + 1), stat->audioSeconds, stat->readSeconds, stat->splitSeconds, stat->writeSeconds, speed,
+                (stat->succeeded ? _T("OK") : _T("FAILED")), inputFileList->filePaths[i]);
+
+        if (stat->succeeded) {
+            succeededCount++;
+            totalAudioSeconds += stat->audioSeconds;
+        }
     }
 
-    return true;
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("Files: %d, succeeded: %d, failed: %d\n"),
+            inputFileList->fileCount, succeededCount, (inputFileList->fileCount - succeededCount));
+    MSG_INFO(_T("Total audio duration: %.1f seconds, elapsed time: %.1f seconds, throughput: %.1fx realtime\n"),
+            totalAudioSeconds, elapsedSeconds, ((elapsedSeconds > 0.0) ? (totalAudioSeconds / elapsedSeconds) : 0.0));
 }
 
 int _tmain(int argc, TCHAR *argv[]) {
@@ -689,15 +727,54 @@ int _tmain(int argc, TCHAR *argv[]) {
     MSG_INFO(_T("\n"));
 #endif
 
-    TCHAR inputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
     TCHAR outputFilePathFormat[FILE_PATH_MAX_SIZE] = { _T('\0') };
     TCHAR modelName[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    TCHAR inputFilePattern[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    TCHAR serverEndpoint[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    TCHAR cacheDirPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    TCHAR pcmCacheDirPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    TCHAR remoteWorkerList[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    TCHAR inputFormat[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    TCHAR outputFormat[FILE_PATH_MAX_SIZE] = { _T('\0') };
+
+    int64_t cacheMaxSize = RESULT_CACHE_DEFAULT_MAX_SIZE;
+
+    int serverWorkerCount = SERVER_DEFAULT_WORKER_COUNT;
+    int serverQueueCapacity = SERVER_DEFAULT_QUEUE_CAPACITY;
+
+    int jobCount = 1;
+
+    int decodeThreadCount = 1;
+
+    int encodeThreadCount = 0;
+
+    TrackOutputContainer outputContainer = TRACK_OUTPUT_CONTAINER_NONE;
+    RawFileFormat rawOutputFormat = RAW_FILE_FORMAT_NONE;
+
+    AudioEncoderSettings encoderSettings = {
+        .flacCompressionLevel = -1,
+        .mp3Quality = -1,
+        .aacCoder = NULL
+    };
+
+    double timeRangeStartSeconds = 0.0;
+    double timeRangeDurationSeconds = 0.0;
+
+    int64_t ioBlockSize = 0;
 
     int outputFileBitrate = -1;
 
     TrackList trackList = { 0 };
 
     static int overwriteFlag = 0;
+    static int recursiveFlag = 0;
+    static int serverFlag = 0;
+    static int workerFlag = 0;
+    static int fastOpenFlag = 0;
+    static int fastEncodeFlag = 0;
+    static int ioMmapFlag = 0;
+    static int ioReadAheadFlag = 0;
+    static int ioWriteBehindFlag = 0;
     static int verboseFlag = 0;
     static int debugFlag = 0;
     static int helpFlag = 0;
@@ -713,6 +790,36 @@ int _tmain(int argc, TCHAR *argv[]) {
             {_T("output"),      ARG_REQ,    0,              _T('o')},
             {_T("bitrate"),     ARG_REQ,    0,              _T('b')},
             {_T("tracks"),      ARG_REQ,    0,              _T('t')},
+            {_T("single-file"), ARG_REQ,    0,              LONG_OPTION_SINGLE_FILE},
+            {_T("raw-output"),  ARG_REQ,    0,              LONG_OPTION_RAW_OUTPUT},
+            {_T("output-format"),   ARG_REQ,    0,          LONG_OPTION_OUTPUT_FORMAT},
+            {_T("flac-level"),  ARG_REQ,    0,              LONG_OPTION_FLAC_LEVEL},
+            {_T("mp3-quality"), ARG_REQ,    0,              LONG_OPTION_MP3_QUALITY},
+            {_T("aac-coder"),   ARG_REQ,    0,              LONG_OPTION_AAC_CODER},
+            {_T("fast-encode"), ARG_NONE,   &fastEncodeFlag,    1},
+            {_T("pattern"),     ARG_REQ,    0,              LONG_OPTION_PATTERN},
+            {_T("recursive"),   ARG_NONE,   &recursiveFlag, 1},
+            {_T("input-format"),    ARG_REQ,    0,          LONG_OPTION_INPUT_FORMAT},
+            {_T("start"),       ARG_REQ,    0,              LONG_OPTION_START},
+            {_T("duration"),    ARG_REQ,    0,              LONG_OPTION_DURATION},
+            {_T("jobs"),        ARG_REQ,    0,              LONG_OPTION_JOBS},
+            {_T("decode-threads"),  ARG_REQ,    0,          LONG_OPTION_DECODE_THREADS},
+            {_T("encode-threads"),  ARG_REQ,    0,          LONG_OPTION_ENCODE_THREADS},
+            {_T("resample-quality"),    ARG_REQ,    0,      LONG_OPTION_RESAMPLE_QUALITY},
+            {_T("io-block-size"),   ARG_REQ,    0,          LONG_OPTION_IO_BLOCK_SIZE},
+            {_T("fast-open"),   ARG_NONE,   &fastOpenFlag,  1},
+            {_T("io-mmap"),     ARG_NONE,   &ioMmapFlag,    1},
+            {_T("io-read-ahead"),   ARG_NONE,   &ioReadAheadFlag,   1},
+            {_T("io-write-behind"), ARG_NONE,   &ioWriteBehindFlag, 1},
+            {_T("cache-dir"),   ARG_REQ,    0,              LONG_OPTION_CACHE_DIR},
+            {_T("cache-size"),  ARG_REQ,    0,              LONG_OPTION_CACHE_SIZE},
+            {_T("pcm-cache-dir"),   ARG_REQ,    0,          LONG_OPTION_PCM_CACHE_DIR},
+            {_T("server"),      ARG_NONE,   &serverFlag,    1},
+            {_T("listen"),      ARG_REQ,    0,              LONG_OPTION_LISTEN},
+            {_T("workers"),     ARG_REQ,    0,              LONG_OPTION_WORKERS},
+            {_T("queue-size"),  ARG_REQ,    0,              LONG_OPTION_QUEUE_SIZE},
+            {_T("worker"),      ARG_NONE,   &workerFlag,    1},
+            {_T("remote-workers"),  ARG_REQ,    0,          LONG_OPTION_REMOTE_WORKERS},
             {_T("overwrite"),   ARG_NONE,   &overwriteFlag, 1},
             {_T("verbose"),     ARG_NONE,   &verboseFlag,   1},
             {_T("debug"),       ARG_NONE,   &debugFlag,     1},
@@ -738,6 +845,14 @@ int _tmain(int argc, TCHAR *argv[]) {
                 // 如果选项设置了 flag, 则此处什么也不做
                 if (longOptions[longOptionIndex].flag != 0) {
                     // --overwrite
+                    // --fast-encode
+                    // --recursive
+                    // --server
+                    // --worker
+                    // --fast-open
+                    // --io-mmap
+                    // --io-read-ahead
+                    // --io-write-behind
                     // --verbose
                     // --debug
                     break;
@@ -773,7 +888,7 @@ int _tmain(int argc, TCHAR *argv[]) {
             case _T('b'):
                 // -b, --bitrate
                 if (optarg != NULL) {
-                    if (!_tryParseBitrate(&outputFileBitrate, optarg)) {
+                    if (!TrackOutput_parseBitrate(&outputFileBitrate, optarg)) {
                         MSG_ERROR(_T("Failed to parse the specified bitrate \"%s\".\n"), optarg);
                         return EXIT_FAILURE;
                     }
@@ -783,13 +898,243 @@ int _tmain(int argc, TCHAR *argv[]) {
             case _T('t'):
                 // -t, --tracks
                 if (optarg != NULL) {
-                    if (!_tryParseTrackList(&trackList, optarg)) {
+                    if (!TrackOutput_parseTrackList(&trackList, optarg)) {
                         MSG_ERROR(_T("Failed to parse the specified track list \"%s\".\n"), optarg);
                         return EXIT_FAILURE;
                     }
                 }
                 break;
 
+            case LONG_OPTION_PATTERN:
+                // --pattern
+                if (optarg != NULL) {
+                    _tcsncpy(inputFilePattern, optarg, (FILE_PATH_MAX_SIZE - 1));
+                    inputFilePattern[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+                }
+                break;
+
+            case LONG_OPTION_INPUT_FORMAT:
+                // --input-format
+                if (optarg != NULL) {
+                    _tcsncpy(inputFormat, optarg, (FILE_PATH_MAX_SIZE - 1));
+                    inputFormat[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+                }
+                break;
+
+            case LONG_OPTION_START:
+                // --start
+                if (optarg != NULL) {
+                    if (!_parseTime(&timeRangeStartSeconds, optarg)) {
+                        MSG_ERROR(_T("The specified start time \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_DURATION:
+                // --duration
+                if (optarg != NULL) {
+                    if (!_parseTime(&timeRangeDurationSeconds, optarg) || (timeRangeDurationSeconds <= 0.0)) {
+                        MSG_ERROR(_T("The specified duration \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_JOBS:
+                // --jobs
+                if (optarg != NULL) {
+                    if (!_parseIntInRange(&jobCount, optarg, 1, OPTION_JOB_COUNT_MAX)) {
+                        MSG_ERROR(_T("The specified job count \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_DECODE_THREADS:
+                // --decode-threads
+                if (optarg != NULL) {
+                    if (!_parseIntInRange(&decodeThreadCount, optarg, 1, OPTION_DECODE_THREAD_COUNT_MAX)) {
+                        MSG_ERROR(_T("The specified decode thread count \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_SINGLE_FILE:
+                // --single-file
+                if (optarg != NULL) {
+                    if (_tcsicmp(optarg, _T("mka")) == 0) {
+                        outputContainer = TRACK_OUTPUT_CONTAINER_MKA;
+                    } else if (_tcsicmp(optarg, _T("mp4")) == 0) {
+                        outputContainer = TRACK_OUTPUT_CONTAINER_MP4;
+                    } else if (_tcsicmp(optarg, _T("stem.mp4")) == 0) {
+                        outputContainer = TRACK_OUTPUT_CONTAINER_NI_STEMS;
+                    } else {
+                        MSG_ERROR(_T("The specified single file format \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_RAW_OUTPUT:
+                // --raw-output
+                if (optarg != NULL) {
+                    if (_tcsicmp(optarg, _T("f32")) == 0) {
+                        rawOutputFormat = RAW_FILE_FORMAT_F32;
+                    } else if (_tcsicmp(optarg, _T("npy")) == 0) {
+                        rawOutputFormat = RAW_FILE_FORMAT_NPY;
+                    } else if (_tcsicmp(optarg, _T("wav")) == 0) {
+                        rawOutputFormat = RAW_FILE_FORMAT_WAV;
+                    } else {
+                        MSG_ERROR(_T("The specified raw output format \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_OUTPUT_FORMAT:
+                // --output-format
+                if (optarg != NULL) {
+                    _tcsncpy(outputFormat, optarg, (FILE_PATH_MAX_SIZE - 1));
+                    outputFormat[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+                }
+                break;
+
+            case LONG_OPTION_FLAC_LEVEL:
+                // --flac-level
+                if (optarg != NULL) {
+                    if (!_parseIntInRange(&encoderSettings.flacCompressionLevel, optarg, 0, 12)) {
+                        MSG_ERROR(_T("The specified FLAC compression level \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_MP3_QUALITY:
+                // --mp3-quality
+                if (optarg != NULL) {
+                    if (!_parseIntInRange(&encoderSettings.mp3Quality, optarg, 0, 9)) {
+                        MSG_ERROR(_T("The specified MP3 quality \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_AAC_CODER:
+                // --aac-coder
+                if (optarg != NULL) {
+                    if (_tcsicmp(optarg, _T("twoloop")) == 0) {
+                        encoderSettings.aacCoder = "twoloop";
+                    } else if (_tcsicmp(optarg, _T("fast")) == 0) {
+                        encoderSettings.aacCoder = "fast";
+                    } else {
+                        MSG_ERROR(_T("The specified AAC coder \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_ENCODE_THREADS:
+                // --encode-threads
+                if (optarg != NULL) {
+                    if (!_parseIntInRange(&encodeThreadCount, optarg, 0, OPTION_ENCODE_THREAD_COUNT_MAX)) {
+                        MSG_ERROR(_T("The specified encode thread count \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_RESAMPLE_QUALITY:
+                // --resample-quality
+                if (optarg != NULL) {
+                    if (_tcsicmp(optarg, _T("low")) == 0) {
+                        AudioFileReader_setResamplerQuality(POLYPHASE_RESAMPLER_QUALITY_LOW);
+                    } else if (_tcsicmp(optarg, _T("medium")) == 0) {
+                        AudioFileReader_setResamplerQuality(POLYPHASE_RESAMPLER_QUALITY_MEDIUM);
+                    } else if (_tcsicmp(optarg, _T("high")) == 0) {
+                        AudioFileReader_setResamplerQuality(POLYPHASE_RESAMPLER_QUALITY_HIGH);
+                    } else if (_tcsicmp(optarg, _T("swr")) == 0) {
+                        AudioFileReader_setResamplerQuality(POLYPHASE_RESAMPLER_QUALITY_NONE);
+                    } else {
+                        MSG_ERROR(_T("The specified resample quality \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_IO_BLOCK_SIZE:
+                // --io-block-size
+                if (optarg != NULL) {
+                    if (!ResultCache_parseSize(&ioBlockSize, optarg) || (ioBlockSize < 4096) || (ioBlockSize > (256 * 1024 * 1024))) {
+                        MSG_ERROR(_T("The specified I/O block size \"%s\" is invalid (4K to 256M).\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_CACHE_DIR:
+                // --cache-dir
+                if (optarg != NULL) {
+                    _tcsncpy(cacheDirPath, optarg, (FILE_PATH_MAX_SIZE - 1));
+                    cacheDirPath[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+                }
+                break;
+
+            case LONG_OPTION_CACHE_SIZE:
+                // --cache-size
+                if (optarg != NULL) {
+                    if (!ResultCache_parseSize(&cacheMaxSize, optarg)) {
+                        MSG_ERROR(_T("Failed to parse the specified cache size \"%s\".\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_PCM_CACHE_DIR:
+                // --pcm-cache-dir
+                if (optarg != NULL) {
+                    _tcsncpy(pcmCacheDirPath, optarg, (FILE_PATH_MAX_SIZE - 1));
+                    pcmCacheDirPath[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+                }
+                break;
+
+            case LONG_OPTION_LISTEN:
+                // --listen
+                if (optarg != NULL) {
+                    _tcsncpy(serverEndpoint, optarg, (FILE_PATH_MAX_SIZE - 1));
+                    serverEndpoint[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+                }
+                break;
+
+            case LONG_OPTION_WORKERS:
+                // --workers
+                if (optarg != NULL) {
+                    if (!_parseIntInRange(&serverWorkerCount, optarg, 1, OPTION_WORKER_COUNT_MAX)) {
+                        MSG_ERROR(_T("The specified worker count \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_QUEUE_SIZE:
+                // --queue-size
+                if (optarg != NULL) {
+                    if (!_parseIntInRange(&serverQueueCapacity, optarg, 1, OPTION_QUEUE_SIZE_MAX)) {
+                        MSG_ERROR(_T("The specified queue size \"%s\" is invalid.\n"), optarg);
+                        return EXIT_FAILURE;
+                    }
+                }
+                break;
+
+            case LONG_OPTION_REMOTE_WORKERS:
+                // --remote-workers
+                if (optarg != NULL) {
+                    _tcsncpy(remoteWorkerList, optarg, (FILE_PATH_MAX_SIZE - 1));
+                    remoteWorkerList[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+                }
+                break;
+
             case _T('h'):
                 // -h, --help
                 helpFlag = 1;
@@ -837,31 +1182,10 @@ int _tmain(int argc, TCHAR *argv[]) {
         return EXIT_SUCCESS;
     }
 
-    if (optind < argc) {
-        // 除了 longOptions 中配置的选项外，还有其他参数未处理
-
-        // 期望只剩余一个输入文件路径的参数未处理
-        if ((optind + 1) != argc) {
-            MSG_ERROR(_T("Specified more than one input file path.\n"));
-            return EXIT_FAILURE;
-        }
-
-        TCHAR *nonOptionArgumentValue = argv[optind];
-
-        // 检查输入文件路径的长度
-        if (_tcsclen(nonOptionArgumentValue) > (FILE_PATH_MAX_SIZE - 1)) {
-            MSG_ERROR(_T("The specified input file path \"%s\" is too long (%d > %d characters).\n"),
-                    nonOptionArgumentValue, (int)_tcsclen(nonOptionArgumentValue), (int)(FILE_PATH_MAX_SIZE - 1));
-            return EXIT_FAILURE;
-        }
-
-        _tcsncpy(inputFilePath, nonOptionArgumentValue, (FILE_PATH_MAX_SIZE - 1));
-        inputFilePath[FILE_PATH_MAX_SIZE - 1] = _T('\0');
-    } else {
-        // 未指定输入文件路径
-
-        MSG_ERROR(_T("Not specified the input file path.\n"));
-        return EXIT_FAILURE;
+    // 如果未指定在目录中查找输入文件时使用的匹配模式，则使用默认值
+    if (_tcsclen(inputFilePattern) == 0) {
+        _tcsncpy(inputFilePattern, INPUT_FILE_LIST_DEFAULT_PATTERN, (FILE_PATH_MAX_SIZE - 1));
+        inputFilePattern[FILE_PATH_MAX_SIZE - 1] = _T('\0');
     }
 
     ////////////////////////////////////////////////// 检查 CPU 特性和 DLL 加载 //////////////////////////////////////////////////
@@ -886,12 +1210,6 @@ int _tmain(int argc, TCHAR *argv[]) {
 
     ////////////////////////////////////////////////// 检查命令行参数 //////////////////////////////////////////////////
 
-    // 检查是否已指定输入文件路径
-    if (_tcsclen(inputFilePath) == 0) {
-        MSG_ERROR(_T("Not specified the input file path.\n"));
-        return EXIT_FAILURE;
-    }
-
     // 如果未指定 modelName, 则使用默认值
     if (_tcsclen(modelName) == 0) {
         _tcsncpy(modelName, _T("2stems"), (FILE_PATH_MAX_SIZE - 1));
@@ -905,234 +1223,393 @@ int _tmain(int argc, TCHAR *argv[]) {
         return EXIT_FAILURE;
     }
 
-    // 如果未指定输出文件路径格式字符串，则使用默认值
-    if (_tcsclen(outputFilePathFormat) == 0) {
-        _tcsncpy(outputFilePathFormat, _T(""), (FILE_PATH_MAX_SIZE - 1));
-        outputFilePathFormat[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+    AudioFile_setDecodeThreadCount(decodeThreadCount);
+
+    // 只分离部分时间范围时，前后各多解码一个分段扩展长度的样本值作为模型的上下文
+    if ((timeRangeStartSeconds > 0.0) || (timeRangeDurationSeconds > 0.0)) {
+        if (serverFlag || workerFlag) {
+            MSG_ERROR(_T("--start and --duration cannot be used in server or worker mode.\n"));
+            return EXIT_FAILURE;
+        }
+
+        if (_tcsclen(pcmCacheDirPath) > 0) {
+            MSG_ERROR(_T("--start and --duration cannot be used together with --pcm-cache-dir.\n"));
+            return EXIT_FAILURE;
+        }
+
+        int sliceLength = 0;
+        int extendLength = 0;
+        int lastSegmentMinLength = 0;
+        SpleeterProcessor_getSliceParameters(&sliceLength, &extendLength, &lastSegmentMinLength);
+
+        AudioFile_setTimeRange(timeRangeStartSeconds, timeRangeDurationSeconds, extendLength);
     }
 
-    // 如果未指定输出文件的 bitrate, 则使用默认值
-    if (outputFileBitrate < 0) {
-        outputFileBitrate = 256000;
+    if (_tcsclen(inputFormat) > 0) {
+        if (!AudioFileReader_setInputFormat(inputFormat)) {
+            MSG_ERROR(_T("The specified input format \"%s\" is invalid.\n"), inputFormat);
+            return EXIT_FAILURE;
+        }
     }
 
-    ////////////////////////////////////////////////// 检查输入文件 //////////////////////////////////////////////////
+    AudioFileReader_setFastOpen(fastOpenFlag != 0);
 
-    if (!_checkInputFilePath(inputFilePath)) {
-        return EXIT_FAILURE;
+    // --fast-encode 只设置未单独指定的项
+    if (fastEncodeFlag) {
+        if (encoderSettings.flacCompressionLevel < 0) {
+            encoderSettings.flacCompressionLevel = 0;
+        }
+        if (encoderSettings.mp3Quality < 0) {
+            encoderSettings.mp3Quality = 7;
+        }
+        if (encoderSettings.aacCoder == NULL) {
+            encoderSettings.aacCoder = "fast";
+        }
+    }
+    AudioFileWriter_setEncoderSettings(&encoderSettings);
+
+    // 指定了输入文件的读取方式时，通过自定义的 AVIOContext 读取
+    if ((ioBlockSize > 0) || ioMmapFlag || ioReadAheadFlag) {
+        const FileInputStreamConfig fileInputConfig = {
+            .blockSize = (ioBlockSize > 0) ? (int)ioBlockSize : FILE_INPUT_STREAM_DEFAULT_BLOCK_SIZE,
+            .memoryMapped = (ioMmapFlag != 0),
+            .readAhead = (ioReadAheadFlag != 0)
+        };
+        AudioFileReader_setFileInputConfig(&fileInputConfig);
     }
 
-    TCHAR inputFileFullPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    // 指定了在后台写入输出文件时，通过自定义的 AVIOContext 写入
+    if (ioWriteBehindFlag) {
+        const FileOutputStreamConfig fileOutputConfig = {
+            .blockSize = FILE_OUTPUT_STREAM_DEFAULT_BLOCK_SIZE,
+            .blockCount = FILE_OUTPUT_STREAM_DEFAULT_BLOCK_COUNT
+        };
+        AudioFileWriter_setFileOutputConfig(&fileOutputConfig);
+    }
 
-    if (GetFullPathName(inputFilePath, FILE_PATH_MAX_SIZE, inputFileFullPath, NULL) >= FILE_PATH_MAX_SIZE) {
-        MSG_ERROR(_T("Failed to get the full path of input file \"%s\".\n"), inputFilePath);
-        return EXIT_FAILURE;
+    // 打开分离结果缓存 (服务模式和批量处理共用)
+    ResultCache *resultCache = NULL;
+    if (_tcsclen(cacheDirPath) > 0) {
+        resultCache = ResultCache_open(cacheDirPath, cacheMaxSize);
+        if (resultCache == NULL) {
+            return EXIT_FAILURE;
+        }
     }
 
-    MSG_INFO(_T("Input file:\n"));
-    MSG_INFO(_T("%s\n"), inputFileFullPath);
-    MSG_INFO(_T("\n"));
+    PcmCache *pcmCache = NULL;
+    if (_tcsclen(pcmCacheDirPath) > 0) {
+        pcmCache = PcmCache_open(pcmCacheDirPath);
+        if (pcmCache == NULL) {
+            return EXIT_FAILURE;
+        }
+    }
 
-    ////////////////////////////////////////////////// 检查轨道名称和输出文件路径 //////////////////////////////////////////////////
+    if (serverFlag) {
+        ////////////////////////////////////////////////// 服务模式 //////////////////////////////////////////////////
 
-    MSG_INFO(_T("Output file(s):\n"));
-    if (trackList.trackItemCount == 0) {
-        // 未指定 track list, 正常输出
+        if (optind < argc) {
+            MSG_ERROR(_T("Input file paths cannot be specified in server mode.\n"));
+            return EXIT_FAILURE;
+        }
 
-        for (int i = 0; i < modelInfo->outputCount; i++) {
-            TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
-            if (!_getOutputFilePath(outputFilePath, outputFilePathFormat,
-                    modelInfo->outputCount, modelInfo->trackNames[i], inputFileFullPath)) {
-                return EXIT_FAILURE;
-            }
+        // 如果未指定服务端点，则使用默认值
+        if (_tcsclen(serverEndpoint) == 0) {
+            _tcsncpy(serverEndpoint, SERVER_DEFAULT_ENDPOINT, (FILE_PATH_MAX_SIZE - 1));
+            serverEndpoint[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+        }
 
-            MSG_INFO(_T("%s\n"), outputFilePath);
+        const ServerConfig serverConfig = {
+            .endpoint = serverEndpoint,
+            .defaultModelName = modelName,
+            .workerCount = serverWorkerCount,
+            .queueCapacity = serverQueueCapacity,
+            .resultCache = resultCache,
+            .pcmCache = pcmCache
+        };
 
-            if (!_checkOutputFilePath(outputFilePath, overwriteFlag)) {
-                return EXIT_FAILURE;
-            }
+        if (!Server_run(&serverConfig)) {
+            return EXIT_FAILURE;
         }
-    } else {
-        // 指定了 track list
 
-        for (int i = 0; i < trackList.trackItemCount; i++) {
-            TrackItem *trackItem = &trackList.trackItems[i];
+        return EXIT_SUCCESS;
+    }
 
-            if (trackItem->sourceTrackItemCount == 0) {
-                // 该 TrackItem 仅选择了一条已知的轨道，不涉及轨道更名或运算
+    if (workerFlag) {
+        ////////////////////////////////////////////////// 分布式工作端模式 //////////////////////////////////////////////////
 
-                // 检查轨道名称是否存在
-                if (!_checkSpleeterModelTrackName(modelInfo, trackItem->trackName)) {
-                    return EXIT_FAILURE;
-                }
-            } else {
-                // 该 TrackItem 指定了 source track list, 涉及轨道更名或运算
-
-                // 检查源轨道名称是否存在
-                for (int j = 0; j < trackItem->sourceTrackItemCount; j++) {
-                    SourceTrackItem *sourceTrackItem = &trackItem->sourceTrackItems[j];
-                    if (_tcscmp(sourceTrackItem->trackName, _T("input")) == 0) {
-                        continue;
-                    }
-                    if (!_checkSpleeterModelTrackName(modelInfo, sourceTrackItem->trackName)) {
-                        return EXIT_FAILURE;
-                    }
-                }
-            }
+        if (optind < argc) {
+            MSG_ERROR(_T("Input file paths cannot be specified in worker mode.\n"));
+            return EXIT_FAILURE;
+        }
 
-            TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
-            if (!_getOutputFilePath(outputFilePath, outputFilePathFormat,
-                    trackList.trackItemCount, trackItem->trackName, inputFileFullPath)) {
-                return EXIT_FAILURE;
-            }
+        // 如果未指定工作端端点，则使用默认值
+        if (_tcsclen(serverEndpoint) == 0) {
+            _tcsncpy(serverEndpoint, DISTRIBUTED_DEFAULT_WORKER_ENDPOINT, (FILE_PATH_MAX_SIZE - 1));
+            serverEndpoint[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+        }
 
-            MSG_INFO(_T("%s\n"), outputFilePath);
+        const DistributedWorkerConfig workerConfig = {
+            .endpoint = serverEndpoint,
+            .modelName = modelName
+        };
 
-            if (!_checkOutputFilePath(outputFilePath, overwriteFlag)) {
-                return EXIT_FAILURE;
-            }
+        if (!DistributedProcessor_runWorker(&workerConfig)) {
+            return EXIT_FAILURE;
         }
-    }
-    MSG_INFO(_T("\n"));
 
-    ////////////////////////////////////////////////// 开始处理 //////////////////////////////////////////////////
+        return EXIT_SUCCESS;
+    }
 
-    const AudioSampleType spleeterSampleType = {
-        .sampleRate = SPLEETER_MODEL_AUDIO_SAMPLE_RATE,
-        .channelCount = SPLEETER_MODEL_AUDIO_CHANNEL_COUNT,
-        .sampleValueFormat = AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED
+    // 指定了工作端时，作为协调端运行
+    DistributedCoordinatorConfig coordinatorConfig = {
+        .workerEndpointCount = 0,
+        .modelName = modelName,
+        .modelInfo = modelInfo
     };
+    bool coordinatorMode = false;
+    if (_tcsclen(remoteWorkerList) > 0) {
+        if (!DistributedProcessor_parseWorkerEndpointList(&coordinatorConfig, remoteWorkerList)) {
+            MSG_ERROR(_T("The specified worker list is invalid.\n"));
+            return EXIT_FAILURE;
+        }
 
-    const AudioFileFormat outputAudioFileFormat = {
-        .formatName = NULL,
-        .bitRate = outputFileBitrate
-    };
+        if (jobCount > 1) {
+            MSG_ERROR(_T("--jobs cannot be used together with --remote-workers.\n"));
+            return EXIT_FAILURE;
+        }
 
-    // 读取音频文件
+        if (resultCache != NULL) {
+            MSG_ERROR(_T("--cache-dir cannot be used together with --remote-workers.\n"));
+            return EXIT_FAILURE;
+        }
 
-    AudioDataSource *audioDataSourceStereo = AudioFile_readAll(inputFileFullPath, &spleeterSampleType);
+        coordinatorMode = true;
+    }
 
-    // 使用 Spleeter 进行处理
+    if (optind >= argc) {
+        // 未指定输入文件路径
 
-    SpleeterProcessorResult *result = NULL;
-    if (SpleeterProcessor_split(modelName, audioDataSourceStereo, &result) != 0) {
+        MSG_ERROR(_T("Not specified the input file path.\n"));
         return EXIT_FAILURE;
     }
-    if (result == NULL) {
+
+    // 除了 longOptions 中配置的选项外，剩余的参数均为输入文件路径、目录路径或 "@" 开头的列表文件路径
+    InputFileList *inputFileList = InputFileList_alloc();
+    for (int i = optind; i < argc; i++) {
+        TCHAR *nonOptionArgumentValue = argv[i];
+
+        // 检查输入文件路径的长度
+        if (_tcsclen(nonOptionArgumentValue) > (FILE_PATH_MAX_SIZE - 1)) {
+            MSG_ERROR(_T("The specified input file path \"%s\" is too long (%d > %d characters).\n"),
+                    nonOptionArgumentValue, (int)_tcsclen(nonOptionArgumentValue), (int)(FILE_PATH_MAX_SIZE - 1));
+            return EXIT_FAILURE;
+        }
+
+        if (!InputFileList_addArgument(inputFileList, nonOptionArgumentValue, inputFilePattern, (recursiveFlag != 0))) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (inputFileList->fileCount == 0) {
+        MSG_ERROR(_T("No input file was found in the specified path(s).\n"));
         return EXIT_FAILURE;
     }
 
-    if (trackList.trackItemCount == 0) {
-        // 未指定 track list, 正常输出
+    // 标准输入只能读取一次，且无法根据输入文件路径生成输出文件路径
+    int standardInputCount = 0;
+    for (int i = 0; i < inputFileList->fileCount; i++) {
+        if (AudioFileReader_isStandardInput(inputFileList->filePaths[i])) {
+            standardInputCount++;
+        }
+    }
+    if (standardInputCount > 1) {
+        MSG_ERROR(_T("The standard input can only be specified once.\n"));
+        return EXIT_FAILURE;
+    }
+    if ((standardInputCount > 0) && (_tcsclen(outputFilePathFormat) == 0)) {
+        MSG_ERROR(_T("The output file path must be specified with -o when reading from the standard input.\n"));
+        return EXIT_FAILURE;
+    }
 
-        for (int i = 0; i < result->trackCount; i++) {
-            SpleeterProcessorResultTrack *track = &result->trackList[i];
+    // 如果未指定输出文件路径格式字符串，则使用默认值
+    if (_tcsclen(outputFilePathFormat) == 0) {
+        _tcsncpy(outputFilePathFormat, _T(""), (FILE_PATH_MAX_SIZE - 1));
+        outputFilePathFormat[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+    }
 
-            TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
-            if (!_getOutputFilePath(outputFilePath, outputFilePathFormat,
-                    result->trackCount, track->trackName, inputFileFullPath)) {
-                return EXIT_FAILURE;
-            }
+    // 如果未指定输出文件的 bitrate, 则使用默认值
+    if (outputFileBitrate < 0) {
+        outputFileBitrate = 256000;
+    }
 
-            if (!_checkOutputFilePath(outputFilePath, overwriteFlag)) {
-                return EXIT_FAILURE;
-            }
+    // 检查轨道名称
+    if (!TrackOutput_checkTrackList(modelInfo, &trackList)) {
+        return EXIT_FAILURE;
+    }
 
-            if (!AudioFile_writeAll(outputFilePath, &outputAudioFileFormat, &spleeterSampleType,
-                    (void *)track->audioDataSource->sampleValues, track->audioDataSource->sampleCountPerChannel)) {
-                MSG_ERROR(_T("Failed to write output file \"%s\".\n"), outputFilePath);
-                return EXIT_FAILURE;
-            }
+    // 标准输出和管道没有扩展名，未指定输出格式时使用 WAV 格式
+    if ((_tcsclen(outputFormat) == 0) && AudioFileWriter_isStreamingOutput(outputFilePathFormat)
+            && (*PathFindExtension(outputFilePathFormat) == _T('\0'))) {
+        _tcscpy(outputFormat, _T("wav"));
+    }
 
-            Common_updateProgress(STAGE_AUDIO_FILE_WRITER, (i + 1), result->trackCount);
+    // 检查所指定的输出格式是否存在
+    char *outputFormatNameUtf8 = NULL;
+    if (_tcsclen(outputFormat) > 0) {
+        outputFormatNameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(outputFormat);
+        if ((outputFormatNameUtf8 == NULL) || (av_guess_format(outputFormatNameUtf8, NULL, NULL) == NULL)) {
+            MSG_ERROR(_T("The specified output format \"%s\" is invalid.\n"), outputFormat);
+            return EXIT_FAILURE;
         }
-    } else {
-        // 指定了 track list
+    }
 
-        for (int i = 0; i < trackList.trackItemCount; i++) {
-            TrackItem *trackItem = &trackList.trackItems[i];
+    const TrackOutputConfig outputConfig = {
+        .modelInfo = modelInfo,
+        .outputFilePathFormat = outputFilePathFormat,
+        .trackList = &trackList,
+        .overwriteFlag = overwriteFlag,
+        .outputAudioFileFormat = {
+            .formatName = outputFormatNameUtf8,
+            .bitRate = outputFileBitrate
+        },
+        .sampleType = {
+            .sampleRate = SPLEETER_MODEL_AUDIO_SAMPLE_RATE,
+            .channelCount = SPLEETER_MODEL_AUDIO_CHANNEL_COUNT,
+            .sampleValueFormat = AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED
+        },
+        .encodeThreadCount = encodeThreadCount,
+        .container = outputContainer,
+        .rawFormat = rawOutputFormat
+    };
 
-            if (trackItem->sourceTrackItemCount == 0) {
-                // 该 TrackItem 仅选择了一条已知的轨道，不涉及轨道更名或运算
+    if ((outputContainer != TRACK_OUTPUT_CONTAINER_NONE) && (rawOutputFormat != RAW_FILE_FORMAT_NONE)) {
+        MSG_ERROR(_T("--single-file and --raw-output cannot be used together.\n"));
+        return EXIT_FAILURE;
+    }
 
-                SpleeterProcessorResultTrack *track = SpleeterProcessorResult_getTrack(result, trackItem->trackName);
-                if (track == NULL) {
-                    MSG_ERROR(_T("Track \"%s\" does not exist.\n"), trackItem->trackName);
-                    return EXIT_FAILURE;
-                }
+    if ((outputContainer == TRACK_OUTPUT_CONTAINER_NI_STEMS)
+            && (TrackOutput_getTrackCount(&outputConfig) != TRACK_OUTPUT_NI_STEMS_TRACK_COUNT)) {
+        MSG_ERROR(_T("The NI Stems format requires exactly %d output tracks, use --tracks to select or mix them.\n"),
+                TRACK_OUTPUT_NI_STEMS_TRACK_COUNT);
+        return EXIT_FAILURE;
+    }
 
-                TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
-                if (!_getOutputFilePath(outputFilePath, outputFilePathFormat,
-                        trackList.trackItemCount, track->trackName, inputFileFullPath)) {
-                    return EXIT_FAILURE;
-                }
+    if (TrackOutput_isStreamingOutput(&outputConfig)) {
+        // 流式输出不能回写文件
+        if ((outputContainer == TRACK_OUTPUT_CONTAINER_NI_STEMS) || (rawOutputFormat != RAW_FILE_FORMAT_NONE)) {
+            MSG_ERROR(_T("The NI Stems format and --raw-output cannot be written to a pipe.\n"));
+            return EXIT_FAILURE;
+        }
+    }
 
-                if (!_checkOutputFilePath(outputFilePath, overwriteFlag)) {
-                    return EXIT_FAILURE;
-                }
+    if (AudioFileWriter_isStandardOutput(outputFilePathFormat)) {
+        if (inputFileList->fileCount > 1) {
+            MSG_ERROR(_T("Only one input file can be processed when writing to the standard output.\n"));
+            return EXIT_FAILURE;
+        }
 
-                if (!AudioFile_writeAll(outputFilePath, &outputAudioFileFormat, &spleeterSampleType,
-                        (void *)track->audioDataSource->sampleValues, track->audioDataSource->sampleCountPerChannel)) {
-                    MSG_ERROR(_T("Failed to write output file \"%s\".\n"), outputFilePath);
-                    return EXIT_FAILURE;
-                }
+        // 音频数据写入原来的标准输出，输出信息和进度改为写入标准错误，避免混入音频数据中
+        fflush(stdout);
+        int standardOutputFd = _dup(_fileno(stdout));
+        if ((standardOutputFd == -1) || (_dup2(_fileno(stderr), _fileno(stdout)) == -1)) {
+            MSG_ERROR(_T("Failed to redirect the standard output.\n"));
+            return EXIT_FAILURE;
+        }
+        AudioFileWriter_setStandardOutput(standardOutputFd);
+    }
 
-                Common_updateProgress(STAGE_AUDIO_FILE_WRITER, (i + 1), trackList.trackItemCount);
-            } else {
-                // 该 TrackItem 指定了 source track list, 涉及轨道更名或运算
+    ////////////////////////////////////////////////// 检查输入文件和输出文件路径 //////////////////////////////////////////////////
 
-                TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
-                if (!_getOutputFilePath(outputFilePath, outputFilePathFormat,
-                        trackList.trackItemCount, trackItem->trackName, inputFileFullPath)) {
-                    return EXIT_FAILURE;
-                }
+    for (int i = 0; i < inputFileList->fileCount; i++) {
+        const TCHAR *inputFileFullPath = inputFileList->filePaths[i];
 
-                if (!_checkOutputFilePath(outputFilePath, overwriteFlag)) {
-                    return EXIT_FAILURE;
-                }
+        if (!_checkInputFilePath(inputFileFullPath)) {
+            return EXIT_FAILURE;
+        }
 
-                AudioDataSource *audioDataSourceComputed = NULL;
-                for (int j = 0; j < trackItem->sourceTrackItemCount; j++) {
-                    SourceTrackItem *sourceTrackItem = &trackItem->sourceTrackItems[j];
+        if (inputFileList->fileCount > 1) {
+            MSG_INFO(_T("Input file [%d/%d]:\n"), (i + 1), inputFileList->fileCount);
+        } else {
+            MSG_INFO(_T("Input file:\n"));
+        }
+        MSG_INFO(_T("%s\n"), inputFileFullPath);
+        MSG_INFO(_T("\n"));
 
-                    AudioDataSource *sourceTrackAudioDataSource = NULL;
-                    if (_tcscmp(sourceTrackItem->trackName, _T("input")) == 0) {
-                        sourceTrackAudioDataSource = audioDataSourceStereo;
-                    } else {
-                        SpleeterProcessorResultTrack *sourceTrack = SpleeterProcessorResult_getTrack(result, sourceTrackItem->trackName);
-                        if (sourceTrack == NULL) {
-                            MSG_ERROR(_T("Track \"%s\" does not exist.\n"), sourceTrackItem->trackName);
-                            return EXIT_FAILURE;
-                        }
+        if (!_checkOutputFilePaths(&outputConfig, inputFileFullPath)) {
+            return EXIT_FAILURE;
+        }
+    }
 
-                        sourceTrackAudioDataSource = sourceTrack->audioDataSource;
-                    }
+    ////////////////////////////////////////////////// 开始处理 //////////////////////////////////////////////////
 
-                    if (audioDataSourceComputed == NULL) {
-                        audioDataSourceComputed = AudioDataSource_createEmpty(sourceTrackAudioDataSource);
-                    }
+    double batchBeginTime = Common_getTimeInSeconds();
 
-                    if (sourceTrackItem->toSubtract) {
-                        AudioDataSource_subSamples(audioDataSourceComputed, sourceTrackAudioDataSource);
-                    } else {
-                        AudioDataSource_addSamples(audioDataSourceComputed, sourceTrackAudioDataSource);
-                    }
-                }
+    // 加载 Spleeter 模型 (所有输入文件共用，作为协调端运行时由工作端加载)
 
-                if (!AudioFile_writeAll(outputFilePath, &outputAudioFileFormat, &spleeterSampleType,
-                        (void *)audioDataSourceComputed->sampleValues, audioDataSourceComputed->sampleCountPerChannel)) {
-                    MSG_ERROR(_T("Failed to write output file \"%s\".\n"), outputFilePath);
-                    return EXIT_FAILURE;
-                }
+    SpleeterModel *model = NULL;
+    if (!coordinatorMode) {
+        model = SpleeterModel_load(modelName);
+        if (model == NULL) {
+            return EXIT_FAILURE;
+        }
+    }
 
-                Common_updateProgress(STAGE_AUDIO_FILE_WRITER, (i + 1), trackList.trackItemCount);
+    FileProcessingStat *stats = MEMORY_ALLOC_ARRAY(FileProcessingStat, inputFileList->fileCount);
 
-                AudioDataSource_free(&audioDataSourceComputed);
-            }
+    if (jobCount > 1) {
+        // 多个工作线程同时处理所有输入文件的分段
+
+        const BatchSchedulerConfig schedulerConfig = {
+            .model = model,
+            .outputConfig = &outputConfig,
+            .workerCount = jobCount,
+            .resultCache = resultCache,
+            .pcmCache = pcmCache
+        };
+
+        if (!BatchScheduler_run(&schedulerConfig, inputFileList, stats)) {
+            MSG_WARNING(_T("Not all worker threads were started.\n"));
+        }
+    } else {
+        _processFilesSequentially(model, (coordinatorMode ? &coordinatorConfig : NULL),
+                resultCache, pcmCache, &outputConfig, inputFileList, stats);
+    }
+
+    if (model != NULL) {
+        SpleeterModel_free(&model);
+    }
+
+    double batchElapsedSeconds = Common_getTimeInSeconds() - batchBeginTime;
+
+    int failedCount = 0;
+    for (int i = 0; i < inputFileList->fileCount; i++) {
+        if (!stats[i].succeeded) {
+            failedCount++;
         }
     }
 
-    SpleeterProcessorResult_free(&result);
+    if (inputFileList->fileCount > 1) {
+        _displayBatchSummary(inputFileList, stats, batchElapsedSeconds);
+    }
+
+    if (resultCache != NULL) {
+        MSG_INFO(_T("\n"));
+        MSG_INFO(_T("Result cache: %ld hits, %ld misses\n"), resultCache->hitCount, resultCache->missCount);
+        ResultCache_close(&resultCache);
+    }
+
+    if (pcmCache != NULL) {
+        MSG_INFO(_T("\n"));
+        MSG_INFO(_T("PCM cache: %ld hits, %ld misses\n"), pcmCache->hitCount, pcmCache->missCount);
+        PcmCache_close(&pcmCache);
+    }
+
+    Memory_free(&stats);
+    InputFileList_free(&inputFileList);
+
+    if (failedCount > 0) {
+        return EXIT_FAILURE;
+    }
 
     MSG_INFO(_T("\n"));
     MSG_INFO(_T("Completed.\n"));
@@ -0,0 +1,343 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <Windows.h>
+#include <Shlwapi.h>
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFileCommon.h"
+#include "Sha256.h"
+#include "PcmCache.h"
+
+#pragma comment(lib, "shlwapi.lib")
+
+/** 缓存文件的扩展名 */
+#define PCM_CACHE_FILE_EXTENSION        _T(".pcm")
+
+/** 缓存文件头中的标识 */
+#define PCM_CACHE_FILE_MAGIC            "SPLPCM01"
+
+/** 样本值在缓存文件中的起始位置 (页对齐，使映射后的样本值数组满足 SIMD 对齐要求) */
+#define PCM_CACHE_DATA_OFFSET           4096
+
+/** 单次 ReadFile() / WriteFile() 处理的最大字节数 */
+#define PCM_CACHE_IO_CHUNK_SIZE         (16 * 1024 * 1024)
+
+/**
+ * 缓存文件头 (位于文件开头，其后填充至 PCM_CACHE_DATA_OFFSET)
+ */
+typedef struct {
+    char        magic[8];
+    uint8_t     contentHash[SHA256_HASH_SIZE];
+    int64_t     sourceFileSize;
+    uint64_t    sourceLastWriteTime;
+    int32_t     sampleRate;
+    int32_t     channelCount;
+    int64_t     sampleCountPerChannel;
+} PcmCacheFileHeader;
+
+/**
+ * 输入文件的标识
+ */
+typedef struct {
+    /** 文件大小 */
+    int64_t     fileSize;
+
+    /** 修改时间 */
+    uint64_t    lastWriteTime;
+
+    /** 缓存文件的完整路径 (由完整路径、大小、修改时间和输出样本类型计算得到) */
+    TCHAR       cacheFilePath[FILE_PATH_MAX_SIZE];
+} PcmCacheFileIdentity;
+
+static bool _getFileIdentity(const PcmCache *obj, const TCHAR *filename, const AudioSampleType *outputSampleType,
+        PcmCacheFileIdentity *identityOut) {
+    TCHAR fullPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    if (GetFullPathName(filename, FILE_PATH_MAX_SIZE, fullPath, NULL) == 0) {
+        return false;
+    }
+
+    // 路径不区分大小写
+    CharLowerBuff(fullPath, (DWORD)_tcsclen(fullPath));
+
+    WIN32_FILE_ATTRIBUTE_DATA attributeData;
+    if (!GetFileAttributesEx(fullPath, GetFileExInfoStandard, &attributeData)) {
+        return false;
+    }
+
+    identityOut->fileSize = ((int64_t)attributeData.nFileSizeHigh << 32) | attributeData.nFileSizeLow;
+    identityOut->lastWriteTime = ((uint64_t)attributeData.ftLastWriteTime.dwHighDateTime << 32) | attributeData.ftLastWriteTime.dwLowDateTime;
+
+    Sha256 sha256;
+    if (!Sha256_begin(&sha256)) {
+        return false;
+    }
+
+    int32_t sampleType[2] = { outputSampleType->sampleRate, outputSampleType->channelCount };
+
+    uint8_t identityHash[SHA256_HASH_SIZE];
+    bool succeeded = Sha256_update(&sha256, PCM_CACHE_FILE_MAGIC, strlen(PCM_CACHE_FILE_MAGIC))
+            && Sha256_update(&sha256, fullPath, (_tcsclen(fullPath) * sizeof(TCHAR)))
+            && Sha256_update(&sha256, &identityOut->fileSize, sizeof(identityOut->fileSize))
+            && Sha256_update(&sha256, &identityOut->lastWriteTime, sizeof(identityOut->lastWriteTime))
+            && Sha256_update(&sha256, sampleType, sizeof(sampleType));
+    if (!Sha256_finish(&sha256, (succeeded ? identityHash : NULL)) || !succeeded) {
+        return false;
+    }
+
+    TCHAR fileName[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    Sha256_toHex(identityHash, fileName);
+    _tcscat(fileName, PCM_CACHE_FILE_EXTENSION);
+
+    return (PathCombine(identityOut->cacheFilePath, obj->_dirPath, fileName) != NULL);
+}
+
+/**
+ * 计算输入文件内容的 SHA-256 哈希值 (用于发现修改时间未变化的修改)
+ */
+static bool _computeContentHash(const TCHAR *filename, uint8_t hashOut[SHA256_HASH_SIZE]) {
+    HANDLE file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    Sha256 sha256;
+    if (!Sha256_begin(&sha256)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    uint8_t *buffer = MEMORY_ALLOC_ARRAY(uint8_t, PCM_CACHE_IO_CHUNK_SIZE);
+    bool succeeded = true;
+
+    while (true) {
+        DWORD readSize = 0;
+        if (!ReadFile(file, buffer, PCM_CACHE_IO_CHUNK_SIZE, &readSize, NULL)) {
+            succeeded = false;
+            break;
+        }
+        if (readSize == 0) {
+            break;
+        }
+
+        if (!Sha256_update(&sha256, buffer, readSize)) {
+            succeeded = false;
+            break;
+        }
+    }
+
+    Memory_free(&buffer);
+    CloseHandle(file);
+
+    if (!Sha256_finish(&sha256, (succeeded ? hashOut : NULL))) {
+        return false;
+    }
+
+    return succeeded;
+}
+
+static void _unmapSampleValues(AudioSampleValue_t *sampleValues, void *deallocatorArg) {
+    UnmapViewOfFile(deallocatorArg);
+}
+
+/**
+ * 映射缓存文件，校验通过时返回以映射的样本值创建的 AudioDataSource
+ */
+static AudioDataSource *_mapCacheFile(const PcmCacheFileIdentity *identity, const uint8_t contentHash[SHA256_HASH_SIZE],
+        const AudioSampleType *outputSampleType) {
+    HANDLE file = CreateFile(identity->cacheFilePath, GENERIC_READ, (FILE_SHARE_READ | FILE_SHARE_DELETE), NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    LARGE_INTEGER cacheFileSize;
+    if (!GetFileSizeEx(file, &cacheFileSize) || (cacheFileSize.QuadPart < PCM_CACHE_DATA_OFFSET)) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // 使用写时复制映射，即使样本值被修改也不会写回缓存文件
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return NULL;
+    }
+
+    uint8_t *view = (uint8_t *)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == NULL) {
+        return NULL;
+    }
+
+    const PcmCacheFileHeader *header = (const PcmCacheFileHeader *)view;
+
+    int64_t dataSize = header->sampleCountPerChannel * header->channelCount * (int64_t)sizeof(AudioSampleValue_t);
+
+    if ((memcmp(header->magic, PCM_CACHE_FILE_MAGIC, sizeof(header->magic)) != 0)
+            || (memcmp(header->contentHash, contentHash, SHA256_HASH_SIZE) != 0)
+            || (header->sourceFileSize != identity->fileSize)
+            || (header->sourceLastWriteTime != identity->lastWriteTime)
+            || (header->sampleRate != outputSampleType->sampleRate)
+            || (header->channelCount != outputSampleType->channelCount)
+            || (header->sampleCountPerChannel <= 0) || (header->sampleCountPerChannel > INT_MAX)
+            || (cacheFileSize.QuadPart != (PCM_CACHE_DATA_OFFSET + dataSize))) {
+        UnmapViewOfFile(view);
+        return NULL;
+    }
+
+    AudioDataSource *audioDataSource = AudioDataSource_alloc();
+    audioDataSource->sampleRate = header->sampleRate;
+    audioDataSource->channelCount = header->channelCount;
+    audioDataSource->sampleCountPerChannel = (int)header->sampleCountPerChannel;
+    audioDataSource->sampleValues = (AudioSampleValue_t *)(view + PCM_CACHE_DATA_OFFSET);
+    audioDataSource->_sampleValuesDeallocator = _unmapSampleValues;
+    audioDataSource->_sampleValuesDeallocatorArg = view;
+
+    return audioDataSource;
+}
+
+static bool _writeCacheFile(const PcmCacheFileIdentity *identity, const uint8_t contentHash[SHA256_HASH_SIZE],
+        const AudioDataSource *audioDataSource) {
+    // 先写入临时文件，完成后再重命名，避免其他进程映射到不完整的缓存文件
+    TCHAR tempFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    _sntprintf(tempFilePath, (FILE_PATH_MAX_SIZE - 1), _T("%s.%lu-%lu.tmp"), identity->cacheFilePath,
+            GetCurrentProcessId(), GetCurrentThreadId());
+
+    HANDLE file = CreateFile(tempFilePath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    uint8_t *headerBuffer = MEMORY_ALLOC_ARRAY(uint8_t, PCM_CACHE_DATA_OFFSET);
+    PcmCacheFileHeader *header = (PcmCacheFileHeader *)headerBuffer;
+    memcpy(header->magic, PCM_CACHE_FILE_MAGIC, sizeof(header->magic));
+    memcpy(header->contentHash, contentHash, SHA256_HASH_SIZE);
+    header->sourceFileSize = identity->fileSize;
+    header->sourceLastWriteTime = identity->lastWriteTime;
+    header->sampleRate = audioDataSource->sampleRate;
+    header->channelCount = audioDataSource->channelCount;
+    header->sampleCountPerChannel = audioDataSource->sampleCountPerChannel;
+
+    DWORD writtenSize = 0;
+    bool succeeded = WriteFile(file, headerBuffer, PCM_CACHE_DATA_OFFSET, &writtenSize, NULL) && (writtenSize == PCM_CACHE_DATA_OFFSET);
+
+    Memory_free(&headerBuffer);
+
+    const uint8_t *p = (const uint8_t *)audioDataSource->sampleValues;
+    int64_t remainingSize = (int64_t)audioDataSource->sampleCountPerChannel * audioDataSource->channelCount * sizeof(AudioSampleValue_t);
+    while (succeeded && (remainingSize > 0)) {
+        DWORD chunkSize = (DWORD)min(remainingSize, PCM_CACHE_IO_CHUNK_SIZE);
+        succeeded = WriteFile(file, p, chunkSize, &writtenSize, NULL) && (writtenSize == chunkSize);
+
+        p += chunkSize;
+        remainingSize -= chunkSize;
+    }
+
+    CloseHandle(file);
+
+    if (succeeded) {
+        succeeded = MoveFileEx(tempFilePath, identity->cacheFilePath, MOVEFILE_REPLACE_EXISTING);
+    }
+
+    if (!succeeded) {
+        DeleteFile(tempFilePath);
+    }
+
+    return succeeded;
+}
+
+PcmCache *PcmCache_open(const TCHAR *dirPath) {
+    PcmCache *obj = MEMORY_ALLOC_STRUCT(PcmCache);
+
+    if (GetFullPathName(dirPath, FILE_PATH_MAX_SIZE, obj->_dirPath, NULL) == 0) {
+        MSG_ERROR(_T("Failed to get the full path of cache directory \"%s\".\n"), dirPath);
+        Memory_free(&obj);
+        return NULL;
+    }
+
+    if (!CreateDirectory(obj->_dirPath, NULL) && (GetLastError() != ERROR_ALREADY_EXISTS)) {
+        MSG_ERROR(_T("Failed to create cache directory \"%s\".\n"), obj->_dirPath);
+        Memory_free(&obj);
+        return NULL;
+    }
+
+    obj->hitCount = 0;
+    obj->missCount = 0;
+
+    return obj;
+}
+
+void PcmCache_close(PcmCache **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return;
+    }
+
+    Memory_free(objPtr);
+}
+
+AudioDataSource *PcmCache_readAll(PcmCache *obj, const TCHAR *filename, const AudioSampleType *outputSampleType) {
+    // 标准输入无法确定标识，不使用缓存
+    if ((obj == NULL) || (outputSampleType->sampleValueFormat != AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED)
+            || AudioFileReader_isStandardInput(filename)) {
+        return AudioFile_readAll(filename, outputSampleType);
+    }
+
+    PcmCacheFileIdentity identity;
+    uint8_t contentHash[SHA256_HASH_SIZE];
+    if (!_getFileIdentity(obj, filename, outputSampleType, &identity)
+            || !_computeContentHash(filename, contentHash)) {
+        // 无法确定输入文件的标识，直接解码
+        return AudioFile_readAll(filename, outputSampleType);
+    }
+
+    AudioDataSource *audioDataSource = _mapCacheFile(&identity, contentHash, outputSampleType);
+    if (audioDataSource != NULL) {
+        audioDataSource->filenameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(filename);
+
+        InterlockedIncrement(&obj->hitCount);
+        MSG_DEBUG(_T("PCM cache hit: %s\n"), identity.cacheFilePath);
+
+        Common_updateProgress(STAGE_AUDIO_FILE_READER, audioDataSource->sampleCountPerChannel, audioDataSource->sampleCountPerChannel);
+
+        return audioDataSource;
+    }
+
+    InterlockedIncrement(&obj->missCount);
+    MSG_DEBUG(_T("PCM cache miss: %s\n"), identity.cacheFilePath);
+
+    audioDataSource = AudioFile_readAll(filename, outputSampleType);
+
+    // 保存失败不影响本次读取的结果
+    if ((audioDataSource != NULL) && !_writeCacheFile(&identity, contentHash, audioDataSource)) {
+        MSG_WARNING(_T("Failed to write cache file \"%s\".\n"), identity.cacheFilePath);
+    }
+
+    return audioDataSource;
+}
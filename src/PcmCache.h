@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _PCM_CACHE_H_
+#define _PCM_CACHE_H_
+
+#include <Windows.h>
+#include "Common.h"
+#include "AudioFile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 解码后 PCM 数据的磁盘缓存
+ *
+ * 以输入文件的完整路径、大小和修改时间查找缓存文件，并校验输入文件内容的 SHA-256 哈希值。
+ * 缓存文件中的样本值以 32 位浮点数原样保存 (从 4096 字节处开始，页对齐)，命中时直接映射到内存中使用，无需解码和重采样。
+ * 可被多个线程同时使用
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 public 成员，只读
+
+    /** 命中次数 */
+    volatile LONG       hitCount;
+
+    /** 未命中次数 */
+    volatile LONG       missCount;
+
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 缓存目录的完整路径 */
+    TCHAR               _dirPath[FILE_PATH_MAX_SIZE];
+} PcmCache;
+
+/**
+ * 打开缓存目录 (不存在时创建)
+ *
+ * @param   dirPath         缓存目录路径
+ *
+ * @return  成功时返回指向 PcmCache 结构体的指针，失败时返回 NULL
+ */
+PcmCache *PcmCache_open(const TCHAR *dirPath);
+
+/**
+ * 关闭缓存，释放 PcmCache 结构体所占用的内存空间 (不删除缓存文件)
+ *
+ * @param   objPtr          指向 PcmCache 结构体的指针的指针
+ */
+void PcmCache_close(PcmCache **objPtr);
+
+/**
+ * 读取音频文件的所有样本值，优先使用缓存
+ *
+ * 命中时返回的 AudioDataSource 中的样本值数组为缓存文件的内存映射 (写时复制)，
+ * 同样使用 AudioDataSource_free() 释放。未命中时解码输入文件，并将结果保存到缓存中
+ *
+ * @param   obj                 指向 PcmCache 结构体的指针，为 NULL 时等同于 AudioFile_readAll()
+ * @param   filename            要读取音频文件的文件名
+ * @param   outputSampleType    输出样本类型 (仅缓存 AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED 格式)
+ *
+ * @return  成功时返回包含样本值的 AudioDataSource 对象，失败时返回 NULL
+ */
+AudioDataSource *PcmCache_readAll(PcmCache *obj, const TCHAR *filename, const AudioSampleType *outputSampleType);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _PCM_CACHE_H_
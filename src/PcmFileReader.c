@@ -0,0 +1,492 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <emmintrin.h>
+#include <Windows.h>
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFileCommon.h"
+#include "PcmFileReader.h"
+
+/**
+ * PCM 样本值的编码
+ */
+typedef enum {
+    PCM_SAMPLE_ENCODING_INT16,
+    PCM_SAMPLE_ENCODING_INT24,
+    PCM_SAMPLE_ENCODING_INT32,
+    PCM_SAMPLE_ENCODING_FLOAT32
+} PcmSampleEncoding;
+
+/**
+ * 从文件头中解析出的 PCM 数据信息
+ */
+typedef struct {
+    /** 文件格式名称 (仅用于显示) */
+    const TCHAR         *formatName;
+
+    /** 样本值编码 */
+    PcmSampleEncoding   encoding;
+
+    /** 样本值是否为大端序 */
+    bool                bigEndian;
+
+    /** 采样率 */
+    int                 sampleRate;
+
+    /** 声道数 */
+    int                 channelCount;
+
+    /** 单个样本值的大小 (以字节为单位) */
+    int                 sampleSize;
+
+    /** 样本值数据在文件中的起始位置 */
+    int64_t             dataOffset;
+
+    /** 样本值数据的大小 (以字节为单位) */
+    int64_t             dataSize;
+} PcmFileInfo;
+
+static uint16_t _readLe16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t _readLe32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t _readLe64(const uint8_t *p) {
+    return (uint64_t)_readLe32(p) | ((uint64_t)_readLe32(p + 4) << 32);
+}
+
+static uint16_t _readBe16(const uint8_t *p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t _readBe32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * 根据样本值格式和位数确定样本值编码
+ */
+static bool _getSampleEncoding(bool isFloat, int bitsPerSample, PcmSampleEncoding *encodingOut) {
+    if (isFloat) {
+        if (bitsPerSample != 32) {
+            return false;
+        }
+        *encodingOut = PCM_SAMPLE_ENCODING_FLOAT32;
+        return true;
+    }
+
+    switch (bitsPerSample) {
+        case 16:
+            *encodingOut = PCM_SAMPLE_ENCODING_INT16;
+            return true;
+
+        case 24:
+            *encodingOut = PCM_SAMPLE_ENCODING_INT24;
+            return true;
+
+        case 32:
+            *encodingOut = PCM_SAMPLE_ENCODING_INT32;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * 解析 WAV 或 RF64 文件头
+ */
+static bool _parseWav(const uint8_t *view, int64_t fileSize, PcmFileInfo *info) {
+    if ((fileSize < 12) || (memcmp(view + 8, "WAVE", 4) != 0)) {
+        return false;
+    }
+
+    bool isRf64 = (memcmp(view, "RF64", 4) == 0);
+    if (!isRf64 && (memcmp(view, "RIFF", 4) != 0)) {
+        return false;
+    }
+
+    info->formatName = isRf64 ? _T("RF64") : _T("WAV");
+    info->bigEndian = false;
+
+    bool fmtFound = false;
+    int bitsPerSample = 0;
+    int blockAlign = 0;
+    int64_t ds64DataSize = -1;
+
+    int64_t position = 12;
+    while ((position + 8) <= fileSize) {
+        const uint8_t *chunkId = view + position;
+        uint32_t chunkSize = _readLe32(view + position + 4);
+        int64_t bodyPosition = position + 8;
+        const uint8_t *body = view + bodyPosition;
+
+        if (memcmp(chunkId, "ds64", 4) == 0) {
+            if ((chunkSize < 24) || ((bodyPosition + 24) > fileSize)) {
+                return false;
+            }
+            ds64DataSize = (int64_t)_readLe64(body + 8);
+        } else if (memcmp(chunkId, "fmt ", 4) == 0) {
+            if ((chunkSize < 16) || ((bodyPosition + chunkSize) > fileSize)) {
+                return false;
+            }
+
+            uint16_t formatTag = _readLe16(body);
+            info->channelCount = _readLe16(body + 2);
+            info->sampleRate = (int)_readLe32(body + 4);
+            blockAlign = _readLe16(body + 12);
+            bitsPerSample = _readLe16(body + 14);
+
+            // WAVE_FORMAT_EXTENSIBLE, 实际格式位于 SubFormat GUID 的前 2 个字节
+            if (formatTag == 0xFFFE) {
+                if (chunkSize < 40) {
+                    return false;
+                }
+
+                // 有效位数与容器位数不同时，由解码器处理
+                if (_readLe16(body + 18) != bitsPerSample) {
+                    return false;
+                }
+
+                formatTag = _readLe16(body + 24);
+            }
+
+            // 1: WAVE_FORMAT_PCM, 3: WAVE_FORMAT_IEEE_FLOAT
+            if ((formatTag != 1) && (formatTag != 3)) {
+                return false;
+            }
+            if (!_getSampleEncoding((formatTag == 3), bitsPerSample, &info->encoding)) {
+                return false;
+            }
+
+            fmtFound = true;
+        } else if (memcmp(chunkId, "data", 4) == 0) {
+            if (!fmtFound) {
+                return false;
+            }
+
+            info->dataOffset = bodyPosition;
+
+            if (isRf64 && (chunkSize == 0xFFFFFFFF) && (ds64DataSize >= 0)) {
+                info->dataSize = ds64DataSize;
+            } else if ((chunkSize == 0) || (chunkSize == 0xFFFFFFFF)) {
+                // 流式写入的文件可能未填写大小，读取到文件末尾
+                info->dataSize = fileSize - bodyPosition;
+            } else {
+                info->dataSize = chunkSize;
+            }
+
+            info->sampleSize = bitsPerSample / 8;
+
+            return (blockAlign == (info->sampleSize * info->channelCount));
+        }
+
+        // 块的大小为奇数时，其后有 1 字节的填充
+        position = bodyPosition + chunkSize + (chunkSize & 1);
+    }
+
+    return false;
+}
+
+/**
+ * 将 80 位扩展精度浮点数 (大端序) 转换为整数，用于 AIFF 文件中的采样率
+ */
+static int _readExtendedAsInt(const uint8_t *p) {
+    int exponent = _readBe16(p) & 0x7FFF;
+    uint64_t mantissa = ((uint64_t)_readBe32(p + 2) << 32) | _readBe32(p + 6);
+
+    if ((exponent == 0) || (exponent == 0x7FFF)) {
+        return 0;
+    }
+
+    return (int)floor(ldexp((double)mantissa, (exponent - 16383 - 63)) + 0.5);
+}
+
+/**
+ * 解析 AIFF 或 AIFF-C 文件头
+ */
+static bool _parseAiff(const uint8_t *view, int64_t fileSize, PcmFileInfo *info) {
+    if ((fileSize < 12) || (memcmp(view, "FORM", 4) != 0)) {
+        return false;
+    }
+
+    bool isAifc = (memcmp(view + 8, "AIFC", 4) == 0);
+    if (!isAifc && (memcmp(view + 8, "AIFF", 4) != 0)) {
+        return false;
+    }
+
+    info->formatName = isAifc ? _T("AIFF-C") : _T("AIFF");
+
+    bool commFound = false;
+    bool ssndFound = false;
+    int bitsPerSample = 0;
+
+    int64_t position = 12;
+    while (((position + 8) <= fileSize) && !(commFound && ssndFound)) {
+        const uint8_t *chunkId = view + position;
+        uint32_t chunkSize = _readBe32(view + position + 4);
+        int64_t bodyPosition = position + 8;
+        const uint8_t *body = view + bodyPosition;
+
+        if (memcmp(chunkId, "COMM", 4) == 0) {
+            if ((chunkSize < 18) || ((bodyPosition + chunkSize) > fileSize)) {
+                return false;
+            }
+
+            info->channelCount = _readBe16(body);
+            bitsPerSample = _readBe16(body + 6);
+            info->sampleRate = _readExtendedAsInt(body + 8);
+
+            // AIFF 为大端序整数，AIFF-C 由压缩类型决定
+            bool isFloat = false;
+            info->bigEndian = true;
+            if (isAifc) {
+                if (chunkSize < 22) {
+                    return false;
+                }
+
+                const uint8_t *compressionType = body + 18;
+                if (memcmp(compressionType, "NONE", 4) == 0) {
+                    // 大端序整数
+                } else if (memcmp(compressionType, "sowt", 4) == 0) {
+                    info->bigEndian = false;
+                } else if ((memcmp(compressionType, "fl32", 4) == 0) || (memcmp(compressionType, "FL32", 4) == 0)) {
+                    isFloat = true;
+                } else {
+                    return false;
+                }
+            }
+
+            if (!_getSampleEncoding(isFloat, bitsPerSample, &info->encoding)) {
+                return false;
+            }
+
+            commFound = true;
+        } else if (memcmp(chunkId, "SSND", 4) == 0) {
+            if ((chunkSize < 8) || ((bodyPosition + 8) > fileSize)) {
+                return false;
+            }
+
+            uint32_t dataOffsetInChunk = _readBe32(body);
+            info->dataOffset = bodyPosition + 8 + dataOffsetInChunk;
+            info->dataSize = (int64_t)chunkSize - 8 - dataOffsetInChunk;
+            if (info->dataSize < 0) {
+                return false;
+            }
+
+            ssndFound = true;
+        }
+
+        position = bodyPosition + chunkSize + (chunkSize & 1);
+    }
+
+    info->sampleSize = bitsPerSample / 8;
+
+    return (commFound && ssndFound);
+}
+
+/**
+ * 将 16 位整数 (小端序) 样本值转换为 32 位浮点数，使用 SSE2 每次转换 8 个样本值
+ */
+static void _convertInt16LeToFloat(const uint8_t *src, float *dest, int64_t sampleCount) {
+    const float scale = 1.0f / 32768.0f;
+    const __m128 scaleVector = _mm_set1_ps(scale);
+
+    int64_t i = 0;
+    for (; (i + 8) <= sampleCount; i += 8) {
+        __m128i values = _mm_loadu_si128((const __m128i *)(src + (i * 2)));
+
+        // 将每个 16 位整数放在 32 位的高半部分，再算术右移，得到符号扩展的 32 位整数
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+
+        _mm_storeu_ps((dest + i), _mm_mul_ps(_mm_cvtepi32_ps(low), scaleVector));
+        _mm_storeu_ps((dest + i + 4), _mm_mul_ps(_mm_cvtepi32_ps(high), scaleVector));
+    }
+
+    for (; i < sampleCount; i++) {
+        dest[i] = (float)(int16_t)_readLe16(src + (i * 2)) * scale;
+    }
+}
+
+/**
+ * 将 PCM 样本值转换为 32 位浮点数 (转换方式与 libswresample 相同，结果一致)
+ */
+static void _convertToFloat(const PcmFileInfo *info, const uint8_t *src, float *dest, int64_t sampleCount) {
+    const float int32Scale = 1.0f / 2147483648.0f;
+
+    switch (info->encoding) {
+        case PCM_SAMPLE_ENCODING_INT16:
+            if (!info->bigEndian) {
+                _convertInt16LeToFloat(src, dest, sampleCount);
+            } else {
+                for (int64_t i = 0; i < sampleCount; i++) {
+                    dest[i] = (float)(int16_t)_readBe16(src + (i * 2)) * (1.0f / 32768.0f);
+                }
+            }
+            break;
+
+        case PCM_SAMPLE_ENCODING_INT24:
+            // 与解码器相同，先扩展为 32 位整数
+            for (int64_t i = 0; i < sampleCount; i++) {
+                const uint8_t *p = src + (i * 3);
+                uint32_t value = info->bigEndian
+                        ? (((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8))
+                        : (((uint32_t)p[2] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[0] << 8));
+                dest[i] = (float)(int32_t)value * int32Scale;
+            }
+            break;
+
+        case PCM_SAMPLE_ENCODING_INT32:
+            for (int64_t i = 0; i < sampleCount; i++) {
+                uint32_t value = info->bigEndian ? _readBe32(src + (i * 4)) : _readLe32(src + (i * 4));
+                dest[i] = (float)(int32_t)value * int32Scale;
+            }
+            break;
+
+        case PCM_SAMPLE_ENCODING_FLOAT32:
+            if (!info->bigEndian) {
+                memcpy(dest, src, (size_t)sampleCount * sizeof(float));
+            } else {
+                for (int64_t i = 0; i < sampleCount; i++) {
+                    uint32_t value = _readBe32(src + (i * 4));
+                    memcpy(&dest[i], &value, sizeof(float));
+                }
+            }
+            break;
+    }
+}
+
+static void _unmapSampleValues(AudioSampleValue_t *sampleValues, void *deallocatorArg) {
+    UnmapViewOfFile(deallocatorArg);
+}
+
+AudioDataSource *PcmFileReader_readAll(const TCHAR *filename, const AudioSampleType *outputSampleType) {
+    AudioDataSource *audioDataSource = NULL;
+    uint8_t *view = NULL;
+
+    if ((filename == NULL) || (outputSampleType == NULL)
+            || (outputSampleType->sampleValueFormat != AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED)
+            || AudioFileReader_isStandardInput(filename)) {
+        return NULL;
+    }
+
+    HANDLE file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart < 12)) {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // 使用写时复制映射，直接使用映射的样本值时，即使样本值被修改也不会写回文件
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return NULL;
+    }
+
+    view = (uint8_t *)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == NULL) {
+        return NULL;
+    }
+
+    PcmFileInfo info = { 0 };
+    if (!_parseWav(view, fileSize.QuadPart, &info) && !_parseAiff(view, fileSize.QuadPart, &info)) {
+        goto end;
+    }
+
+    // 需要重采样或混音时，由解码器处理
+    if ((info.sampleRate != outputSampleType->sampleRate) || (info.channelCount != outputSampleType->channelCount)) {
+        MSG_DEBUG(_T("PCM file needs resampling or remixing (%d Hz, %d channels)\n"), info.sampleRate, info.channelCount);
+        goto end;
+    }
+
+    // 文件被截断时，只读取实际存在的部分 (与解码器相同)
+    if ((info.dataOffset > fileSize.QuadPart) || (info.dataSize <= 0)) {
+        goto end;
+    }
+    if (info.dataSize > (fileSize.QuadPart - info.dataOffset)) {
+        info.dataSize = fileSize.QuadPart - info.dataOffset;
+    }
+
+    int frameSize = info.sampleSize * info.channelCount;
+    int64_t sampleCountPerChannel = info.dataSize / frameSize;
+    if ((sampleCountPerChannel <= 0) || ((sampleCountPerChannel * info.channelCount) > INT_MAX)) {
+        goto end;
+    }
+
+    int64_t sampleCount = sampleCountPerChannel * info.channelCount;
+    const uint8_t *data = view + info.dataOffset;
+
+    audioDataSource = AudioDataSource_alloc();
+    audioDataSource->filenameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(filename);
+    audioDataSource->sampleRate = info.sampleRate;
+    audioDataSource->channelCount = info.channelCount;
+    audioDataSource->sampleCountPerChannel = (int)sampleCountPerChannel;
+
+    bool zeroCopy = (info.encoding == PCM_SAMPLE_ENCODING_FLOAT32) && !info.bigEndian
+            && ((info.dataOffset % sizeof(AudioSampleValue_t)) == 0);
+
+    if (g_verboseMode) {
+        MSG_INFO(_T("Reading %s file directly: %d-bit %s, %d Hz, %d channels, %d samples per channel%s\n"),
+                info.formatName, (info.sampleSize * 8), ((info.encoding == PCM_SAMPLE_ENCODING_FLOAT32) ? _T("float") : _T("integer")),
+                info.sampleRate, info.channelCount, (int)sampleCountPerChannel, (zeroCopy ? _T(" (mapped)") : _T("")));
+    }
+
+    if (zeroCopy) {
+        // 已是所需格式，直接使用映射的内存
+        audioDataSource->sampleValues = (AudioSampleValue_t *)data;
+        audioDataSource->_sampleValuesDeallocator = _unmapSampleValues;
+        audioDataSource->_sampleValuesDeallocatorArg = view;
+        view = NULL;
+    } else {
+        audioDataSource->sampleValues = (AudioSampleValue_t *)MEMORY_ALLOC_ARRAY(AudioSampleValue_t, sampleCount);
+        _convertToFloat(&info, data, audioDataSource->sampleValues, sampleCount);
+    }
+
+    Common_updateProgress(STAGE_AUDIO_FILE_READER, sampleCountPerChannel, sampleCountPerChannel);
+
+end:
+    if (view != NULL) {
+        UnmapViewOfFile(view);
+    }
+
+    return audioDataSource;
+}
@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _PCM_FILE_READER_H_
+#define _PCM_FILE_READER_H_
+
+#include "Common.h"
+#include "AudioFile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 未压缩 PCM 文件 (WAV, RF64, AIFF, AIFF-C) 的快速读取
+ *
+ * 将文件映射到内存中，解析文件头后直接转换样本值，不经过 libavformat / libavcodec / libswresample。
+ * 只处理采样率和声道数都与输出样本类型相同的文件 (无需重采样和混音)，此时转换结果与解码器的结果相同。
+ * 已是 32 位浮点数 (小端序) 的文件直接使用映射的内存 (写时复制)，不复制样本值
+ */
+
+/**
+ * 以快速方式读取 PCM 文件的所有样本值
+ *
+ * @param   filename            要读取音频文件的文件名
+ * @param   outputSampleType    输出样本类型 (只支持 AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED)
+ *
+ * @return  成功时返回包含样本值的 AudioDataSource 对象；
+ *          文件不是可快速读取的 PCM 文件或读取失败时返回 NULL, 此时应使用解码器读取
+ */
+AudioDataSource *PcmFileReader_readAll(const TCHAR *filename, const AudioSampleType *outputSampleType);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _PCM_FILE_READER_H_
@@ -0,0 +1,362 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <intrin.h>
+#include <immintrin.h>
+#include "Common.h"
+#include "Memory.h"
+#include "PolyphaseResampler.h"
+
+/** 相位数 (约分后的插值倍数) 的上限，超出时系数表过大，不使用多相重采样器 */
+#define POLYPHASE_RESAMPLER_MAX_INTERPOLATION       1024
+
+/** 系数个数需要对齐到的倍数 (两个 AVX 寄存器的 float 个数) */
+#define POLYPHASE_RESAMPLER_TAP_ALIGNMENT           16
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**
+ * 各质量等级的滤波器参数
+ */
+typedef struct {
+    /** 每相位的系数个数 (以输出采样率计) */
+    int         tapCount;
+    /** 截止频率与较低采样率的 Nyquist 频率之比 */
+    double      cutoff;
+    /** Kaiser 窗的 beta 参数 */
+    double      kaiserBeta;
+} PolyphaseResamplerFilterParameters;
+
+static const PolyphaseResamplerFilterParameters FILTER_PARAMETERS[] = {
+    [POLYPHASE_RESAMPLER_QUALITY_LOW]       = { 16, 0.90, 6.0 },
+    [POLYPHASE_RESAMPLER_QUALITY_MEDIUM]    = { 32, 0.95, 8.0 },
+    [POLYPHASE_RESAMPLER_QUALITY_HIGH]      = { 64, 0.97, 10.0 }
+};
+
+/**
+ * 检查处理器和操作系统是否支持 AVX2 (结果只检查一次)
+ */
+static bool _isAvx2Supported(void) {
+    // -1 表示尚未检查 (多个线程同时检查时结果相同，无需同步)
+    static volatile int s_supported = -1;
+
+    if (s_supported >= 0) {
+        return (s_supported != 0);
+    }
+
+    int cpuInfo[4] = { 0 };
+    __cpuid(cpuInfo, 1);
+    uint32_t ecx = cpuInfo[2];
+
+    // 需要 OSXSAVE 和 AVX, 且操作系统保存了 YMM 寄存器的状态
+    bool supported = (((ecx >> 27) & 0x1) && ((ecx >> 28) & 0x1) && ((_xgetbv(0) & 0x6) == 0x6));
+
+    if (supported) {
+        __cpuidex(cpuInfo, 7, 0);
+        uint32_t ebx = cpuInfo[1];
+        supported = ((ebx >> 5) & 0x1);
+    }
+
+    s_supported = (supported ? 1 : 0);
+
+    return supported;
+}
+
+/**
+ * 计算最大公约数
+ */
+static int _gcd(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+/**
+ * 第一类零阶修正 Bessel 函数 (用于 Kaiser 窗)
+ */
+static double _besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+
+    for (int k = 1; k < 64; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < (sum * 1e-12)) {
+            break;
+        }
+    }
+
+    return sum;
+}
+
+/**
+ * 计算各相位的滤波器系数
+ *
+ * 第 p 个相位用于输出位置为输入位置 i + p / L 的样本，第 k 个系数与输入样本 i - (tapCount / 2 - 1) + k 相乘
+ */
+static void _computeCoefficients(PolyphaseResampler *obj, const PolyphaseResamplerFilterParameters *parameters) {
+    int interpolation = obj->_interpolation;
+    int tapCount = obj->_tapCount;
+    int channelCount = obj->channelCount;
+    int halfTapCount = tapCount / 2;
+
+    // 截止频率 (以输入采样率为单位的周期数)，降采样时按输出采样率的 Nyquist 频率计算
+    double ratio = (double)obj->_interpolation / (double)obj->_decimation;
+    double cutoff = 0.5 * parameters->cutoff * ((ratio < 1.0) ? ratio : 1.0);
+
+    double windowNormalizer = _besselI0(parameters->kaiserBeta);
+
+    double *phaseCoefficients = (double *)MEMORY_ALLOC_ARRAY(double, tapCount);
+
+    for (int p = 0; p < interpolation; p++) {
+        double sum = 0.0;
+
+        for (int k = 0; k < tapCount; k++) {
+            double distance = ((double)p / interpolation) + (halfTapCount - 1 - k);
+
+            double sinc = (distance == 0.0) ? 1.0 : (sin(2.0 * M_PI * cutoff * distance) / (2.0 * M_PI * cutoff * distance));
+
+            double windowPosition = distance / halfTapCount;
+            double window = (fabs(windowPosition) >= 1.0) ? 0.0
+                    : (_besselI0(parameters->kaiserBeta * sqrt(1.0 - (windowPosition * windowPosition))) / windowNormalizer);
+
+            phaseCoefficients[k] = sinc * window;
+            sum += phaseCoefficients[k];
+        }
+
+        // 每个相位的直流增益归一化为 1
+        float *dest = obj->_coefficients + ((size_t)p * tapCount * channelCount);
+        for (int k = 0; k < tapCount; k++) {
+            for (int c = 0; c < channelCount; c++) {
+                dest[(k * channelCount) + c] = (float)(phaseCoefficients[k] / sum);
+            }
+        }
+    }
+
+    Memory_free(&phaseCoefficients);
+}
+
+PolyphaseResampler *PolyphaseResampler_create(int inputSampleRate, int outputSampleRate, int channelCount, PolyphaseResamplerQuality quality) {
+    if ((quality <= POLYPHASE_RESAMPLER_QUALITY_NONE) || (quality > POLYPHASE_RESAMPLER_QUALITY_HIGH)) {
+        return NULL;
+    }
+
+    if ((inputSampleRate <= 0) || (outputSampleRate <= 0) || (inputSampleRate == outputSampleRate)) {
+        return NULL;
+    }
+
+    if ((channelCount != 1) && (channelCount != 2)) {
+        return NULL;
+    }
+
+    if (!_isAvx2Supported()) {
+        MSG_DEBUG(_T("AVX2 is not supported, the polyphase resampler is not used\n"));
+        return NULL;
+    }
+
+    int gcd = _gcd(inputSampleRate, outputSampleRate);
+    int interpolation = outputSampleRate / gcd;
+    int decimation = inputSampleRate / gcd;
+    if (interpolation > POLYPHASE_RESAMPLER_MAX_INTERPOLATION) {
+        MSG_DEBUG(_T("resampling ratio %d/%d is not supported by the polyphase resampler\n"), interpolation, decimation);
+        return NULL;
+    }
+
+    const PolyphaseResamplerFilterParameters *parameters = &FILTER_PARAMETERS[quality];
+
+    // 降采样时滤波器按输入样本计的长度随比例增加，使过渡带宽度 (相对于输出采样率) 保持不变
+    int tapCount = parameters->tapCount;
+    if (decimation > interpolation) {
+        tapCount = (int)ceil((double)tapCount * decimation / interpolation);
+    }
+    tapCount = ((tapCount + (POLYPHASE_RESAMPLER_TAP_ALIGNMENT - 1)) / POLYPHASE_RESAMPLER_TAP_ALIGNMENT) * POLYPHASE_RESAMPLER_TAP_ALIGNMENT;
+
+    PolyphaseResampler *obj = MEMORY_ALLOC_STRUCT(PolyphaseResampler);
+
+    obj->inputSampleRate = inputSampleRate;
+    obj->outputSampleRate = outputSampleRate;
+    obj->channelCount = channelCount;
+
+    obj->_interpolation = interpolation;
+    obj->_decimation = decimation;
+    obj->_tapCount = tapCount;
+
+    obj->_coefficients = (float *)MEMORY_ALLOC_ARRAY(float, ((size_t)interpolation * tapCount * channelCount));
+    _computeCoefficients(obj, parameters);
+
+    obj->_inputCapacity = tapCount * 4;
+    obj->_inputBuffer = (float *)MEMORY_ALLOC_ARRAY(float, ((size_t)obj->_inputCapacity * channelCount));
+
+    PolyphaseResampler_reset(obj);
+
+    MSG_DEBUG(_T("polyphase resampler: %d Hz -> %d Hz, L = %d, M = %d, %d taps\n"),
+            inputSampleRate, outputSampleRate, interpolation, decimation, tapCount);
+
+    return obj;
+}
+
+void PolyphaseResampler_reset(PolyphaseResampler *obj) {
+    // 开头补充 (tapCount / 2 - 1) 个零值作为第一个输出样本之前的历史样本值，使输出没有延迟
+    int historyLength = (obj->_tapCount / 2) - 1;
+    memset(obj->_inputBuffer, 0, MEMORY_ARRAY_SIZE(float, ((size_t)historyLength * obj->channelCount)));
+
+    obj->_inputLength = historyLength;
+    obj->_inputPosition = historyLength;
+    obj->_phase = 0;
+
+    obj->_inputTotal = 0;
+    obj->_outputTotal = 0;
+    obj->_flushing = false;
+}
+
+float *PolyphaseResampler_getInputBuffer(PolyphaseResampler *obj, int sampleCountPerChannel) {
+    int channelCount = obj->channelCount;
+
+    // 丢弃之后不再需要的样本值
+    int discardLength = obj->_inputPosition - ((obj->_tapCount / 2) - 1);
+    if (discardLength > obj->_inputLength) {
+        discardLength = obj->_inputLength;
+    }
+    if (discardLength > 0) {
+        memmove(obj->_inputBuffer, (obj->_inputBuffer + ((size_t)discardLength * channelCount)),
+                MEMORY_ARRAY_SIZE(float, ((size_t)(obj->_inputLength - discardLength) * channelCount)));
+        obj->_inputLength -= discardLength;
+        obj->_inputPosition -= discardLength;
+    }
+
+    int requiredCapacity = obj->_inputLength + sampleCountPerChannel;
+    if (requiredCapacity > obj->_inputCapacity) {
+        obj->_inputCapacity = requiredCapacity;
+        obj->_inputBuffer = (float *)Memory_realloc(obj->_inputBuffer,
+                MEMORY_ARRAY_SIZE(float, ((size_t)obj->_inputCapacity * channelCount)));
+    }
+
+    return (obj->_inputBuffer + ((size_t)obj->_inputLength * channelCount));
+}
+
+void PolyphaseResampler_commitInput(PolyphaseResampler *obj, int sampleCountPerChannel) {
+    obj->_inputLength += sampleCountPerChannel;
+    obj->_inputTotal += sampleCountPerChannel;
+}
+
+void PolyphaseResampler_flush(PolyphaseResampler *obj) {
+    if (obj->_flushing) {
+        return;
+    }
+
+    // 末尾补充 tapCount / 2 个零值，使最后一个输入样本之前的所有输出位置都可以计算
+    int paddingLength = obj->_tapCount / 2;
+    float *padding = PolyphaseResampler_getInputBuffer(obj, paddingLength);
+    memset(padding, 0, MEMORY_ARRAY_SIZE(float, ((size_t)paddingLength * obj->channelCount)));
+    obj->_inputLength += paddingLength;
+
+    obj->_flushing = true;
+}
+
+int PolyphaseResampler_process(PolyphaseResampler *obj, float *destBuffer, int destBufferSampleCountPerChannel) {
+    int channelCount = obj->channelCount;
+    int tapCount = obj->_tapCount;
+    int halfTapCount = tapCount / 2;
+    int valueCount = tapCount * channelCount;
+    int interpolation = obj->_interpolation;
+    int decimation = obj->_decimation;
+
+    // 冲刷后的输出样本数为 ceil(输入样本数 * L / M)
+    int64_t outputLimit = INT64_MAX;
+    if (obj->_flushing) {
+        outputLimit = ((obj->_inputTotal * interpolation) + (decimation - 1)) / decimation;
+    }
+
+    int inputPosition = obj->_inputPosition;
+    int phase = obj->_phase;
+
+    int outputCount = 0;
+    while ((outputCount < destBufferSampleCountPerChannel) && ((obj->_outputTotal + outputCount) < outputLimit)
+            && ((inputPosition + halfTapCount) < obj->_inputLength)) {
+        const float *x = obj->_inputBuffer + ((size_t)(inputPosition - (halfTapCount - 1)) * channelCount);
+        const float *h = obj->_coefficients + ((size_t)phase * valueCount);
+
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        for (int j = 0; j < valueCount; j += POLYPHASE_RESAMPLER_TAP_ALIGNMENT) {
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(x + j), _mm256_loadu_ps(h + j)));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(x + j + 8), _mm256_loadu_ps(h + j + 8)));
+        }
+
+        // 交错存储时偶数位置为左声道，奇数位置为右声道
+        __m256 acc = _mm256_add_ps(acc0, acc1);
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+
+        float *out = destBuffer + ((size_t)outputCount * channelCount);
+        if (channelCount == 2) {
+            _mm_storel_pi((__m64 *)out, sum);
+        } else {
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+            out[0] = _mm_cvtss_f32(sum);
+        }
+
+        outputCount++;
+
+        phase += decimation;
+        inputPosition += phase / interpolation;
+        phase %= interpolation;
+    }
+
+    obj->_inputPosition = inputPosition;
+    obj->_phase = phase;
+    obj->_outputTotal += outputCount;
+
+    return outputCount;
+}
+
+void PolyphaseResampler_free(PolyphaseResampler **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return;
+    }
+
+    PolyphaseResampler *obj = *objPtr;
+
+    if (obj->_inputBuffer != NULL) {
+        Memory_free(&obj->_inputBuffer);
+    }
+
+    if (obj->_coefficients != NULL) {
+        Memory_free(&obj->_coefficients);
+    }
+
+    Memory_free(objPtr);
+}
@@ -0,0 +1,173 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _POLYPHASE_RESAMPLER_H_
+#define _POLYPHASE_RESAMPLER_H_
+
+#include "Common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 多相 (polyphase) FIR 重采样器
+ *
+ * 将 32 位浮点数交错存储的样本值从输入采样率转换为输出采样率，用于替代 libswresample 进行常见的
+ * 48kHz, 88.2kHz, 96kHz 等到 44.1kHz 的转换。滤波器为 Kaiser 窗的 sinc 函数，按转换比例 L/M
+ * 预先计算 L 个相位的系数，内层的点积使用 AVX2 指令计算。
+ * 处理器不支持 AVX2, 转换比例过于复杂或声道数不为 1 或 2 时无法创建，此时应使用 libswresample
+ */
+
+/**
+ * 重采样质量 (滤波器长度和通带宽度)
+ */
+typedef enum {
+    /** 不使用多相重采样器，由 libswresample 重采样 */
+    POLYPHASE_RESAMPLER_QUALITY_NONE = 0,
+
+    /** 低质量，每相位 16 个系数 (以输出采样率计) */
+    POLYPHASE_RESAMPLER_QUALITY_LOW,
+
+    /** 中等质量，每相位 32 个系数 (以输出采样率计)，与 libswresample 的默认滤波器长度相同 */
+    POLYPHASE_RESAMPLER_QUALITY_MEDIUM,
+
+    /** 高质量，每相位 64 个系数 (以输出采样率计) */
+    POLYPHASE_RESAMPLER_QUALITY_HIGH
+} PolyphaseResamplerQuality;
+
+/**
+ * 多相重采样器的上下文数据
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 public 成员，只读
+
+    /** 输入采样率 */
+    int             inputSampleRate;
+
+    /** 输出采样率 */
+    int             outputSampleRate;
+
+    /** 声道数 */
+    int             channelCount;
+
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 插值倍数 L (相位数) */
+    int             _interpolation;
+    /** 抽取倍数 M (每个输出样本在输入中前进 M / L 个样本) */
+    int             _decimation;
+    /** 每相位的系数个数 (以输入样本计，为 16 的倍数) */
+    int             _tapCount;
+    /** 各相位的系数，每个系数按声道数重复存储，以便与交错存储的样本值直接相乘 */
+    float           *_coefficients;
+
+    /** 输入样本值 buffer (交错存储，开头保留滤波器所需的历史样本值) */
+    float           *_inputBuffer;
+    /** 输入样本值 buffer 的容量 (每声道样本数) */
+    int             _inputCapacity;
+    /** 输入样本值 buffer 中的每声道样本数 */
+    int             _inputLength;
+    /** 下一个输出样本在输入 buffer 中对应位置的整数部分 */
+    int             _inputPosition;
+    /** 下一个输出样本对应位置的小数部分 (以 1 / L 为单位) */
+    int             _phase;
+
+    /** 已提交的输入样本数 (每声道，不包括冲刷时补充的零值) */
+    int64_t         _inputTotal;
+    /** 已输出的样本数 (每声道) */
+    int64_t         _outputTotal;
+    /** 已冲刷 (输入已结束) */
+    bool            _flushing;
+} PolyphaseResampler;
+
+/**
+ * 创建多相重采样器
+ *
+ * @param   inputSampleRate     输入采样率
+ * @param   outputSampleRate    输出采样率
+ * @param   channelCount        声道数 (1 或 2)
+ * @param   quality             重采样质量
+ *
+ * @return  成功时返回所创建的 PolyphaseResampler 结构体，不支持的参数或处理器时返回 NULL
+ */
+PolyphaseResampler *PolyphaseResampler_create(int inputSampleRate, int outputSampleRate, int channelCount, PolyphaseResamplerQuality quality);
+
+/**
+ * 获取用于写入输入样本值的 buffer
+ *
+ * @param   obj                     指向 PolyphaseResampler 结构体的指针
+ * @param   sampleCountPerChannel   要写入的最大每声道样本数
+ *
+ * @return  可写入 sampleCountPerChannel 个样本 (每声道) 的 buffer, 写入后调用 PolyphaseResampler_commitInput()
+ */
+float *PolyphaseResampler_getInputBuffer(PolyphaseResampler *obj, int sampleCountPerChannel);
+
+/**
+ * 提交已写入输入 buffer 中的样本值
+ *
+ * @param   obj                     指向 PolyphaseResampler 结构体的指针
+ * @param   sampleCountPerChannel   实际写入的每声道样本数
+ */
+void PolyphaseResampler_commitInput(PolyphaseResampler *obj, int sampleCountPerChannel);
+
+/**
+ * 输入已结束，使之后的 PolyphaseResampler_process() 输出所有剩余的样本值
+ *
+ * @param   obj                     指向 PolyphaseResampler 结构体的指针
+ */
+void PolyphaseResampler_flush(PolyphaseResampler *obj);
+
+/**
+ * 使用已提交的输入样本值计算尽可能多的输出样本值
+ *
+ * @param   obj                     指向 PolyphaseResampler 结构体的指针
+ * @param   destBuffer              存储输出样本值的 buffer (交错存储)
+ * @param   destBufferSampleCountPerChannel     buffer 的容量 (每声道样本数)
+ *
+ * @return  输出的每声道样本数，需要更多输入 (或冲刷后已全部输出) 时返回 0
+ */
+int PolyphaseResampler_process(PolyphaseResampler *obj, float *destBuffer, int destBufferSampleCountPerChannel);
+
+/**
+ * 清空所有输入样本值和状态 (用于定位之后)
+ *
+ * @param   obj                     指向 PolyphaseResampler 结构体的指针
+ */
+void PolyphaseResampler_reset(PolyphaseResampler *obj);
+
+/**
+ * 释放多相重采样器
+ *
+ * @param   objPtr                  指向 PolyphaseResampler 结构体的指针的指针
+ */
+void PolyphaseResampler_free(PolyphaseResampler **objPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _POLYPHASE_RESAMPLER_H_
@@ -0,0 +1,243 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Windows.h>
+#include "Common.h"
+#include "Memory.h"
+#include "RawFileWriter.h"
+
+/** 单次 WriteFile() 处理的最大字节数 */
+#define RAW_FILE_IO_CHUNK_SIZE          (16 * 1024 * 1024)
+
+/** 文件头的最大字节数 */
+#define RAW_FILE_HEADER_MAX_SIZE        128
+
+/** .npy 文件头的对齐字节数 (使数据部分对齐) */
+#define NPY_HEADER_ALIGNMENT            64
+
+/** WAVE_FORMAT_IEEE_FLOAT */
+#define WAV_FORMAT_IEEE_FLOAT           3
+
+/**
+ * 写入小端序的 16 位无符号整数
+ */
+static uint8_t *_putUint16Le(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+
+    return p + 2;
+}
+
+/**
+ * 写入小端序的 32 位无符号整数
+ */
+static uint8_t *_putUint32Le(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+
+    return p + 4;
+}
+
+/**
+ * 生成 .npy 文件头 (版本 1.0)
+ *
+ * @return  文件头的字节数
+ */
+static int _getNpyHeader(uint8_t *buffer, int sampleCountPerChannel, int channelCount) {
+    char dict[RAW_FILE_HEADER_MAX_SIZE] = { '\0' };
+    int dictLength = snprintf(dict, sizeof(dict), "{'descr': '<f4', 'fortran_order': False, 'shape': (%d, %d), }",
+            sampleCountPerChannel, channelCount);
+
+    // magic (6) + 版本 (2) + 头长度 (2) + dict，以空格填充并以换行符结束，使总长度对齐
+    int headerSize = 10 + dictLength + 1;
+    headerSize = (headerSize + NPY_HEADER_ALIGNMENT - 1) / NPY_HEADER_ALIGNMENT * NPY_HEADER_ALIGNMENT;
+
+    uint8_t *p = buffer;
+    memcpy(p, "\x93NUMPY\x01\x00", 8);
+    p = _putUint16Le(p + 8, (uint16_t)(headerSize - 10));
+    memcpy(p, dict, dictLength);
+    memset(p + dictLength, ' ', headerSize - 10 - dictLength - 1);
+    buffer[headerSize - 1] = '\n';
+
+    return headerSize;
+}
+
+/**
+ * 生成 32 位浮点数 WAV 文件头 (RIFF, fmt, fact, data)
+ *
+ * @return  文件头的字节数
+ */
+static int _getWavHeader(uint8_t *buffer, const AudioSampleType *sampleType, int sampleCountPerChannel, uint32_t dataSize) {
+    uint16_t blockAlign = (uint16_t)(sampleType->channelCount * sizeof(float));
+
+    uint8_t *p = buffer;
+    memcpy(p, "RIFF", 4);
+    p = _putUint32Le(p + 4, 4 + (8 + 18) + (8 + 4) + 8 + dataSize);
+    memcpy(p, "WAVE", 4);
+    p += 4;
+
+    memcpy(p, "fmt ", 4);
+    p = _putUint32Le(p + 4, 18);
+    p = _putUint16Le(p, WAV_FORMAT_IEEE_FLOAT);
+    p = _putUint16Le(p, (uint16_t)sampleType->channelCount);
+    p = _putUint32Le(p, (uint32_t)sampleType->sampleRate);
+    p = _putUint32Le(p, (uint32_t)sampleType->sampleRate * blockAlign);
+    p = _putUint16Le(p, blockAlign);
+    p = _putUint16Le(p, 32);
+    p = _putUint16Le(p, 0);
+
+    // 非 PCM 格式需要 fact chunk
+    memcpy(p, "fact", 4);
+    p = _putUint32Le(p + 4, 4);
+    p = _putUint32Le(p, (uint32_t)sampleCountPerChannel);
+
+    memcpy(p, "data", 4);
+    p = _putUint32Le(p + 4, dataSize);
+
+    return (int)(p - buffer);
+}
+
+const TCHAR *RawFileWriter_getExtension(RawFileFormat format) {
+    switch (format) {
+        case RAW_FILE_FORMAT_F32:
+            return _T(".f32");
+        case RAW_FILE_FORMAT_NPY:
+            return _T(".npy");
+        case RAW_FILE_FORMAT_WAV:
+            return _T(".wav");
+        default:
+            return _T("");
+    }
+}
+
+RawFileWriter *RawFileWriter_open(const TCHAR *filename, RawFileFormat format, const AudioSampleType *sampleType,
+        int sampleCountPerChannel) {
+    if (sampleType->sampleValueFormat != AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED) {
+        MSG_ERROR(_T("Only 32-bit float samples can be written directly.\n"));
+        return NULL;
+    }
+
+    int64_t dataSize = (int64_t)sampleCountPerChannel * sampleType->channelCount * sizeof(float);
+
+    uint8_t header[RAW_FILE_HEADER_MAX_SIZE] = { 0 };
+    int headerSize = 0;
+    if (format == RAW_FILE_FORMAT_NPY) {
+        headerSize = _getNpyHeader(header, sampleCountPerChannel, sampleType->channelCount);
+    } else if (format == RAW_FILE_FORMAT_WAV) {
+        if (dataSize > (UINT32_MAX - RAW_FILE_HEADER_MAX_SIZE)) {
+            MSG_ERROR(_T("The output is too large for a WAV file.\n"));
+            return NULL;
+        }
+        headerSize = _getWavHeader(header, sampleType, sampleCountPerChannel, (uint32_t)dataSize);
+    }
+
+    RawFileWriter *obj = MEMORY_ALLOC_STRUCT(RawFileWriter);
+    _tcsncpy(obj->_filename, filename, (FILE_PATH_MAX_SIZE - 1));
+    obj->_filename[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+    obj->_bytesPerSample = sampleType->channelCount * sizeof(float);
+
+    obj->_file = CreateFile(filename, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (obj->_file == INVALID_HANDLE_VALUE) {
+        MSG_ERROR(_T("Failed to create output file \"%s\".\n"), filename);
+        Memory_free(&obj);
+        return NULL;
+    }
+
+    // 预先设置文件大小，减少写入过程中的空间分配
+    LARGE_INTEGER fileSize = { .QuadPart = headerSize + dataSize };
+    LARGE_INTEGER zero = { .QuadPart = 0 };
+    bool succeeded = SetFilePointerEx(obj->_file, fileSize, NULL, FILE_BEGIN) && SetEndOfFile(obj->_file)
+            && SetFilePointerEx(obj->_file, zero, NULL, FILE_BEGIN);
+
+    DWORD writtenSize = 0;
+    if (succeeded && (headerSize > 0)) {
+        succeeded = WriteFile(obj->_file, header, headerSize, &writtenSize, NULL) && (writtenSize == headerSize);
+    }
+
+    if (!succeeded) {
+        obj->_failed = true;
+        RawFileWriter_close(&obj);
+        return NULL;
+    }
+
+    return obj;
+}
+
+bool RawFileWriter_write(RawFileWriter *obj, const void *sampleValues, int sampleCountPerChannel) {
+    // 样本值在内存中已是小端序的交错 float32，直接顺序写入
+    const uint8_t *p = (const uint8_t *)sampleValues;
+    int64_t remainingSize = (int64_t)sampleCountPerChannel * obj->_bytesPerSample;
+    while (!obj->_failed && (remainingSize > 0)) {
+        DWORD chunkSize = (DWORD)min(remainingSize, RAW_FILE_IO_CHUNK_SIZE);
+        DWORD writtenSize = 0;
+        if (!WriteFile(obj->_file, p, chunkSize, &writtenSize, NULL) || (writtenSize != chunkSize)) {
+            obj->_failed = true;
+        }
+
+        p += chunkSize;
+        remainingSize -= chunkSize;
+    }
+
+    return !obj->_failed;
+}
+
+void RawFileWriter_close(RawFileWriter **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return;
+    }
+
+    RawFileWriter *obj = *objPtr;
+
+    if (obj->_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(obj->_file);
+        obj->_file = INVALID_HANDLE_VALUE;
+    }
+
+    if (obj->_failed) {
+        MSG_ERROR(_T("Failed to write output file \"%s\".\n"), obj->_filename);
+        DeleteFile(obj->_filename);
+    }
+
+    Memory_free(objPtr);
+}
+
+bool RawFileWriter_writeAll(const TCHAR *filename, RawFileFormat format, const AudioSampleType *sampleType,
+        const void *sampleValues, int sampleCountPerChannel) {
+    RawFileWriter *obj = RawFileWriter_open(filename, format, sampleType, sampleCountPerChannel);
+    if (obj == NULL) {
+        return false;
+    }
+
+    bool succeeded = RawFileWriter_write(obj, sampleValues, sampleCountPerChannel);
+
+    RawFileWriter_close(&obj);
+
+    return succeeded;
+}
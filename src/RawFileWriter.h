@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _RAW_FILE_WRITER_H_
+#define _RAW_FILE_WRITER_H_
+
+#include <Windows.h>
+#include "Common.h"
+#include "AudioFileCommon.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 不经过编码器直接写入样本值的输出文件格式
+ */
+typedef enum {
+    /** 不使用 (通过编码器写入) */
+    RAW_FILE_FORMAT_NONE = 0,
+
+    /** 无文件头的 32 位浮点数 (小端序，交错) */
+    RAW_FILE_FORMAT_F32,
+
+    /** NumPy 的 .npy 格式，float32 类型，shape 为 (每声道样本数, 声道数) */
+    RAW_FILE_FORMAT_NPY,
+
+    /** 32 位浮点数的 WAV 格式 (WAVE_FORMAT_IEEE_FLOAT) */
+    RAW_FILE_FORMAT_WAV
+} RawFileFormat;
+
+/**
+ * RawFileWriter 的上下文数据
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 文件名 */
+    TCHAR               _filename[FILE_PATH_MAX_SIZE];
+
+    /** 文件句柄 */
+    HANDLE              _file;
+
+    /** 每声道样本值对应的字节数 */
+    int                 _bytesPerSample;
+
+    /** 是否有写入失败 (关闭时删除文件) */
+    bool                _failed;
+} RawFileWriter;
+
+/**
+ * 获取输出文件格式对应的扩展名
+ *
+ * @param   format                  输出文件格式
+ *
+ * @return  扩展名 (包含起始位置的 ".")
+ */
+const TCHAR *RawFileWriter_getExtension(RawFileFormat format);
+
+/**
+ * 创建一个文件并写入文件头，之后通过 RawFileWriter_write() 写入样本值
+ *
+ * 文件头中的样本数和文件大小按 sampleCountPerChannel 预先设置
+ *
+ * @param   filename                要创建文件的文件名
+ * @param   format                  输出文件格式
+ * @param   sampleType              样本值的样本类型 (样本值格式须为 AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED)
+ * @param   sampleCountPerChannel   之后要写入的样本值的总数量 (单个声道)
+ *
+ * @return  成功时返回所创建的 RawFileWriter 对象，失败时返回 NULL
+ */
+RawFileWriter *RawFileWriter_open(const TCHAR *filename, RawFileFormat format, const AudioSampleType *sampleType,
+        int sampleCountPerChannel);
+
+/**
+ * 顺序写入样本值
+ *
+ * @param   obj                     指向 RawFileWriter 对象的指针
+ * @param   sampleValues            存储有要写入样本值的数组
+ * @param   sampleCountPerChannel   样本值的数量 (单个声道)
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool RawFileWriter_write(RawFileWriter *obj, const void *sampleValues, int sampleCountPerChannel);
+
+/**
+ * 关闭文件 (有写入失败时删除文件)
+ *
+ * @param   objPtr          指向 RawFileWriter 对象的指针的指针
+ */
+void RawFileWriter_close(RawFileWriter **objPtr);
+
+/**
+ * 创建一个文件，并不经过编码器直接写入指定的样本值
+ *
+ * 预先设置文件大小后以大块顺序写入
+ *
+ * @param   filename                要创建文件的文件名
+ * @param   format                  输出文件格式
+ * @param   sampleType              样本值的样本类型 (样本值格式须为 AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED)
+ * @param   sampleValues            存储有要写入样本值的数组
+ * @param   sampleCountPerChannel   样本值的数量 (单个声道)
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool RawFileWriter_writeAll(const TCHAR *filename, RawFileFormat format, const AudioSampleType *sampleType,
+        const void *sampleValues, int sampleCountPerChannel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _RAW_FILE_WRITER_H_
@@ -0,0 +1,477 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <Windows.h>
+#include <Shlwapi.h>
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFileCommon.h"
+#include "Sha256.h"
+#include "ResultCache.h"
+
+#pragma comment(lib, "shlwapi.lib")
+
+/** 缓存文件的扩展名 */
+#define RESULT_CACHE_FILE_EXTENSION         _T(".stems")
+
+/** 缓存文件头中的标识 */
+#define RESULT_CACHE_FILE_MAGIC             "SPLTRC01"
+
+/** 单次 ReadFile() / WriteFile() 处理的最大字节数 */
+#define RESULT_CACHE_IO_CHUNK_SIZE          (64 * 1024 * 1024)
+
+/**
+ * 缓存文件头，其后依次为各音轨的样本值 (32 位浮点数，声道交错存储)
+ */
+typedef struct {
+    char        magic[8];
+    uint8_t     keyHash[RESULT_CACHE_KEY_SIZE];
+    int32_t     sampleRate;
+    int32_t     channelCount;
+    int32_t     trackCount;
+    int32_t     reserved;
+    int64_t     sampleCountPerChannel;
+} ResultCacheFileHeader;
+
+/**
+ * 缓存目录中的一个缓存文件 (淘汰时使用)
+ */
+typedef struct {
+    TCHAR       fileName[FILE_PATH_MAX_SIZE];
+    int64_t     size;
+    uint64_t    lastWriteTime;
+} ResultCacheEntry;
+
+static bool _getFilePath(const ResultCache *obj, const ResultCacheKey *key, TCHAR *filePath) {
+    TCHAR fileName[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    _sntprintf(fileName, (FILE_PATH_MAX_SIZE - 1), _T("%s%s"), key->hex, RESULT_CACHE_FILE_EXTENSION);
+
+    return (PathCombine(filePath, obj->_dirPath, fileName) != NULL);
+}
+
+static bool _readExactly(HANDLE file, void *buffer, int64_t size) {
+    uint8_t *p = (uint8_t *)buffer;
+
+    while (size > 0) {
+        DWORD chunkSize = (DWORD)min(size, RESULT_CACHE_IO_CHUNK_SIZE);
+        DWORD readSize = 0;
+        if (!ReadFile(file, p, chunkSize, &readSize, NULL) || (readSize != chunkSize)) {
+            return false;
+        }
+
+        p += readSize;
+        size -= readSize;
+    }
+
+    return true;
+}
+
+static bool _writeExactly(HANDLE file, const void *buffer, int64_t size) {
+    const uint8_t *p = (const uint8_t *)buffer;
+
+    while (size > 0) {
+        DWORD chunkSize = (DWORD)min(size, RESULT_CACHE_IO_CHUNK_SIZE);
+        DWORD writtenSize = 0;
+        if (!WriteFile(file, p, chunkSize, &writtenSize, NULL) || (writtenSize != chunkSize)) {
+            return false;
+        }
+
+        p += writtenSize;
+        size -= writtenSize;
+    }
+
+    return true;
+}
+
+static int _compareEntryByLastWriteTime(const void *a, const void *b) {
+    const ResultCacheEntry *entryA = (const ResultCacheEntry *)a;
+    const ResultCacheEntry *entryB = (const ResultCacheEntry *)b;
+
+    if (entryA->lastWriteTime < entryB->lastWriteTime) {
+        return -1;
+    } else if (entryA->lastWriteTime > entryB->lastWriteTime) {
+        return 1;
+    } else {
+        return 0;
+    }
+}
+
+/**
+ * 缓存文件的总大小超出上限时，按修改时间从旧到新删除缓存文件
+ */
+static void _evict(ResultCache *obj) {
+    ResultCacheEntry *entries = NULL;
+    int entryCount = 0;
+    int entryCapacity = 0;
+    int64_t totalSize = 0;
+
+    EnterCriticalSection(&obj->_evictLock);
+
+    TCHAR searchPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    if (PathCombine(searchPath, obj->_dirPath, _T("*") RESULT_CACHE_FILE_EXTENSION) == NULL) {
+        goto end;
+    }
+
+    WIN32_FIND_DATA findData;
+    HANDLE findHandle = FindFirstFile(searchPath, &findData);
+    if (findHandle == INVALID_HANDLE_VALUE) {
+        goto end;
+    }
+
+    do {
+        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            continue;
+        }
+
+        if (entryCount >= entryCapacity) {
+            entryCapacity = (entryCapacity == 0) ? 64 : (entryCapacity * 2);
+            entries = Memory_realloc(entries, MEMORY_ARRAY_SIZE(ResultCacheEntry, entryCapacity));
+        }
+
+        ResultCacheEntry *entry = &entries[entryCount++];
+        _tcsncpy(entry->fileName, findData.cFileName, (FILE_PATH_MAX_SIZE - 1));
+        entry->fileName[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+        entry->size = ((int64_t)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
+        entry->lastWriteTime = ((uint64_t)findData.ftLastWriteTime.dwHighDateTime << 32) | findData.ftLastWriteTime.dwLowDateTime;
+
+        totalSize += entry->size;
+    } while (FindNextFile(findHandle, &findData));
+
+    FindClose(findHandle);
+
+    if (totalSize <= obj->_maxSize) {
+        goto end;
+    }
+
+    qsort(entries, entryCount, sizeof(ResultCacheEntry), _compareEntryByLastWriteTime);
+
+    for (int i = 0; (i < entryCount) && (totalSize > obj->_maxSize); i++) {
+        TCHAR filePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (PathCombine(filePath, obj->_dirPath, entries[i].fileName) == NULL) {
+            continue;
+        }
+
+        // 正在被其他进程读取的文件无法删除，跳过即可
+        if (DeleteFile(filePath)) {
+            MSG_DEBUG(_T("Evicted cache file \"%s\"\n"), filePath);
+            totalSize -= entries[i].size;
+        }
+    }
+
+end:
+    LeaveCriticalSection(&obj->_evictLock);
+
+    if (entries != NULL) {
+        Memory_free(&entries);
+    }
+}
+
+ResultCache *ResultCache_open(const TCHAR *dirPath, int64_t maxSize) {
+    ResultCache *obj = MEMORY_ALLOC_STRUCT(ResultCache);
+
+    if (GetFullPathName(dirPath, FILE_PATH_MAX_SIZE, obj->_dirPath, NULL) == 0) {
+        MSG_ERROR(_T("Failed to get the full path of cache directory \"%s\".\n"), dirPath);
+        Memory_free(&obj);
+        return NULL;
+    }
+
+    if (!CreateDirectory(obj->_dirPath, NULL) && (GetLastError() != ERROR_ALREADY_EXISTS)) {
+        MSG_ERROR(_T("Failed to create cache directory \"%s\".\n"), obj->_dirPath);
+        Memory_free(&obj);
+        return NULL;
+    }
+
+    obj->_maxSize = maxSize;
+    obj->hitCount = 0;
+    obj->missCount = 0;
+    InitializeCriticalSection(&obj->_evictLock);
+
+    return obj;
+}
+
+void ResultCache_close(ResultCache **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return;
+    }
+
+    DeleteCriticalSection(&(*objPtr)->_evictLock);
+
+    Memory_free(objPtr);
+}
+
+bool ResultCache_parseSize(int64_t *parsedResultSize, const TCHAR *optionValue) {
+    // 不使用 _tcstod()，小数点不受 setlocale() 所设置的区域影响
+    const TCHAR *endPtr = NULL;
+    double value = Common_parseDecimal(optionValue, &endPtr);
+    if ((endPtr == optionValue) || (value <= 0.0)) {
+        return false;
+    }
+
+    double multiplier;
+    switch (*endPtr) {
+        case _T('\0'):
+            multiplier = 1.0;
+            break;
+
+        case _T('k'):
+        case _T('K'):
+            multiplier = 1024.0;
+            break;
+
+        case _T('m'):
+        case _T('M'):
+            multiplier = 1024.0 * 1024.0;
+            break;
+
+        case _T('g'):
+        case _T('G'):
+            multiplier = 1024.0 * 1024.0 * 1024.0;
+            break;
+
+        default:
+            return false;
+    }
+
+    if ((*endPtr != _T('\0')) && (*(endPtr + 1) != _T('\0'))) {
+        return false;
+    }
+
+    *parsedResultSize = (int64_t)(value * multiplier);
+    return true;
+}
+
+bool ResultCache_computeKey(ResultCacheKey *keyOut, const TCHAR *modelName, const AudioDataSource *audioDataSource) {
+    Sha256 sha256;
+    if (!Sha256_begin(&sha256)) {
+        return false;
+    }
+
+    // 模型名称 (包括 "-22khz" 等变体后缀，以 '\0' 结尾)
+    char *modelNameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(modelName);
+    if (modelNameUtf8 == NULL) {
+        Sha256_finish(&sha256, NULL);
+        return false;
+    }
+
+    // 分段参数和音频格式
+    int32_t parameters[6] = { 0 };
+    SpleeterProcessor_getSliceParameters(&parameters[0], &parameters[1], &parameters[2]);
+    parameters[3] = audioDataSource->sampleRate;
+    parameters[4] = audioDataSource->channelCount;
+    parameters[5] = audioDataSource->sampleCountPerChannel;
+
+    int64_t sampleValuesSize = (int64_t)audioDataSource->sampleCountPerChannel * audioDataSource->channelCount * sizeof(AudioSampleValue_t);
+
+    bool succeeded = Sha256_update(&sha256, RESULT_CACHE_FILE_MAGIC, strlen(RESULT_CACHE_FILE_MAGIC))
+            && Sha256_update(&sha256, modelNameUtf8, (strlen(modelNameUtf8) + 1))
+            && Sha256_update(&sha256, parameters, sizeof(parameters))
+            && Sha256_update(&sha256, audioDataSource->sampleValues, sampleValuesSize);
+
+    Memory_free(&modelNameUtf8);
+
+    if (!Sha256_finish(&sha256, (succeeded ? keyOut->hash : NULL)) || !succeeded) {
+        return false;
+    }
+
+    Sha256_toHex(keyOut->hash, keyOut->hex);
+
+    return true;
+}
+
+SpleeterProcessorResult *ResultCache_load(ResultCache *obj, const ResultCacheKey *key, const SpleeterModelInfo *modelInfo) {
+    SpleeterProcessorResult *result = NULL;
+    HANDLE file = INVALID_HANDLE_VALUE;
+
+    TCHAR filePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    if (!_getFilePath(obj, key, filePath)) {
+        goto miss;
+    }
+
+    // 需要 FILE_WRITE_ATTRIBUTES 以更新修改时间
+    file = CreateFile(filePath, (GENERIC_READ | FILE_WRITE_ATTRIBUTES), FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        goto miss;
+    }
+
+    ResultCacheFileHeader header;
+    if (!_readExactly(file, &header, sizeof(header))) {
+        goto miss;
+    }
+
+    if ((memcmp(header.magic, RESULT_CACHE_FILE_MAGIC, sizeof(header.magic)) != 0)
+            || (memcmp(header.keyHash, key->hash, RESULT_CACHE_KEY_SIZE) != 0)
+            || (header.sampleRate != SPLEETER_MODEL_AUDIO_SAMPLE_RATE)
+            || (header.channelCount != SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)
+            || (header.trackCount != modelInfo->outputCount)
+            || (header.sampleCountPerChannel <= 0) || (header.sampleCountPerChannel > INT_MAX)) {
+        MSG_WARNING(_T("Ignored invalid cache file \"%s\".\n"), filePath);
+        goto miss;
+    }
+
+    result = SpleeterProcessorResult_alloc(modelInfo, (int)header.sampleCountPerChannel);
+
+    int64_t trackSize = header.sampleCountPerChannel * header.channelCount * sizeof(SpleeterModelAudioSampleValue_t);
+    for (int i = 0; i < result->trackCount; i++) {
+        if (!_readExactly(file, result->trackList[i].audioDataSource->sampleValues, trackSize)) {
+            MSG_WARNING(_T("Ignored truncated cache file \"%s\".\n"), filePath);
+            goto miss;
+        }
+    }
+
+    // 更新修改时间，作为 LRU 淘汰的依据
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    SetFileTime(file, NULL, NULL, &now);
+
+    CloseHandle(file);
+
+    InterlockedIncrement(&obj->hitCount);
+    MSG_DEBUG(_T("Result cache hit: %s\n"), key->hex);
+
+    return result;
+
+miss:
+
+    if (result != NULL) {
+        SpleeterProcessorResult_free(&result);
+    }
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+
+    InterlockedIncrement(&obj->missCount);
+    MSG_DEBUG(_T("Result cache miss: %s\n"), key->hex);
+
+    return NULL;
+}
+
+bool ResultCache_store(ResultCache *obj, const ResultCacheKey *key, const SpleeterProcessorResult *result) {
+    bool succeeded = false;
+    HANDLE file = INVALID_HANDLE_VALUE;
+
+    TCHAR filePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    if (!_getFilePath(obj, key, filePath)) {
+        return false;
+    }
+
+    // 先写入临时文件，完成后再重命名，避免其他进程读取到不完整的缓存文件
+    TCHAR tempFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    _sntprintf(tempFilePath, (FILE_PATH_MAX_SIZE - 1), _T("%s.%lu-%lu.tmp"), filePath,
+            GetCurrentProcessId(), GetCurrentThreadId());
+
+    file = CreateFile(tempFilePath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        MSG_WARNING(_T("Failed to create cache file \"%s\".\n"), tempFilePath);
+        return false;
+    }
+
+    const AudioDataSource *firstTrack = result->trackList[0].audioDataSource;
+
+    ResultCacheFileHeader header = { 0 };
+    memcpy(header.magic, RESULT_CACHE_FILE_MAGIC, sizeof(header.magic));
+    memcpy(header.keyHash, key->hash, RESULT_CACHE_KEY_SIZE);
+    header.sampleRate = firstTrack->sampleRate;
+    header.channelCount = firstTrack->channelCount;
+    header.trackCount = result->trackCount;
+    header.sampleCountPerChannel = firstTrack->sampleCountPerChannel;
+
+    if (!_writeExactly(file, &header, sizeof(header))) {
+        goto clean_up;
+    }
+
+    int64_t trackSize = header.sampleCountPerChannel * header.channelCount * sizeof(SpleeterModelAudioSampleValue_t);
+    for (int i = 0; i < result->trackCount; i++) {
+        if (!_writeExactly(file, result->trackList[i].audioDataSource->sampleValues, trackSize)) {
+            goto clean_up;
+        }
+    }
+
+    CloseHandle(file);
+    file = INVALID_HANDLE_VALUE;
+
+    if (!MoveFileEx(tempFilePath, filePath, MOVEFILE_REPLACE_EXISTING)) {
+        goto clean_up;
+    }
+
+    succeeded = true;
+
+clean_up:
+
+    if (file != INVALID_HANDLE_VALUE) {
+        CloseHandle(file);
+    }
+
+    if (!succeeded) {
+        MSG_WARNING(_T("Failed to write cache file \"%s\".\n"), filePath);
+        DeleteFile(tempFilePath);
+        return false;
+    }
+
+    _evict(obj);
+
+    return true;
+}
+
+int ResultCache_splitWithModel(ResultCache *obj, SpleeterModel *model, AudioDataSource *audioDataSource,
+        SpleeterProcessorResult **resultOut, bool *hitOut) {
+    ResultCacheKey key;
+    bool keyComputed = false;
+
+    if (hitOut != NULL) {
+        *hitOut = false;
+    }
+
+    if (obj != NULL) {
+        keyComputed = ResultCache_computeKey(&key, model->modelName, audioDataSource);
+
+        if (keyComputed) {
+            SpleeterProcessorResult *cachedResult = ResultCache_load(obj, &key, model->modelInfo);
+            if (cachedResult != NULL) {
+                Common_updateProgress(STAGE_SPLEETER_PROCESSOR_PROCESS_SEGMENT,
+                        audioDataSource->sampleCountPerChannel, audioDataSource->sampleCountPerChannel);
+
+                if (hitOut != NULL) {
+                    *hitOut = true;
+                }
+                *resultOut = cachedResult;
+                return 0;
+            }
+        }
+    }
+
+    int ret = SpleeterProcessor_splitWithModel(model, audioDataSource, resultOut);
+
+    // 保存失败不影响本次分离的结果
+    if ((ret == 0) && keyComputed) {
+        ResultCache_store(obj, &key, *resultOut);
+    }
+
+    return ret;
+}
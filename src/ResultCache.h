@@ -0,0 +1,166 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _RESULT_CACHE_H_
+#define _RESULT_CACHE_H_
+
+#include <Windows.h>
+#include "Common.h"
+#include "AudioFile.h"
+#include "SpleeterProcessor.h"
+#include "Sha256.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 默认的缓存大小上限 (以字节为单位) */
+#define RESULT_CACHE_DEFAULT_MAX_SIZE       ((int64_t)10 * 1024 * 1024 * 1024)
+
+/** 缓存键 (SHA-256 哈希值) 的长度 (以字节为单位) */
+#define RESULT_CACHE_KEY_SIZE               SHA256_HASH_SIZE
+
+/**
+ * 缓存键
+ *
+ * 由解码后的 PCM 数据、模型名称 (包括变体后缀) 和分段参数计算得到，
+ * 因此同一音频即使文件名不同也会得到相同的缓存键
+ */
+typedef struct {
+    /** SHA-256 哈希值 */
+    uint8_t     hash[RESULT_CACHE_KEY_SIZE];
+
+    /** 十六进制形式的哈希值 (用作缓存文件名) */
+    TCHAR       hex[(RESULT_CACHE_KEY_SIZE * 2) + 1];
+} ResultCacheKey;
+
+/**
+ * 分离结果的磁盘缓存
+ *
+ * 每个分离结果保存为缓存目录中的一个文件，以 32 位浮点数原样保存各音轨的样本值。
+ * 缓存命中时会更新文件的修改时间，超出大小上限时按修改时间从旧到新删除文件 (LRU)。
+ * 可被多个线程同时使用
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 public 成员，只读
+
+    /** 命中次数 */
+    volatile LONG       hitCount;
+
+    /** 未命中次数 */
+    volatile LONG       missCount;
+
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 缓存目录的完整路径 */
+    TCHAR               _dirPath[FILE_PATH_MAX_SIZE];
+
+    /** 缓存大小上限 (以字节为单位) */
+    int64_t             _maxSize;
+
+    /** 保证同一时间只有一个线程在淘汰缓存文件 */
+    CRITICAL_SECTION    _evictLock;
+} ResultCache;
+
+/**
+ * 打开缓存目录 (不存在时创建)
+ *
+ * @param   dirPath         缓存目录路径
+ * @param   maxSize         缓存大小上限 (以字节为单位)
+ *
+ * @return  成功时返回指向 ResultCache 结构体的指针，失败时返回 NULL
+ */
+ResultCache *ResultCache_open(const TCHAR *dirPath, int64_t maxSize);
+
+/**
+ * 关闭缓存，释放 ResultCache 结构体所占用的内存空间 (不删除缓存文件)
+ *
+ * @param   objPtr          指向 ResultCache 结构体的指针的指针
+ */
+void ResultCache_close(ResultCache **objPtr);
+
+/**
+ * 解析缓存大小字符串
+ *
+ * @param   parsedResultSize    解析结果 (以字节为单位)
+ * @param   optionValue         缓存大小字符串，可使用 K, M, G 后缀 (以 1024 为单位)，如 "500M", "10G"
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool ResultCache_parseSize(int64_t *parsedResultSize, const TCHAR *optionValue);
+
+/**
+ * 计算缓存键
+ *
+ * @param   keyOut              计算结果
+ * @param   modelName           模型名称 ("2stems", "5stems-22khz" 等)
+ * @param   audioDataSource     输入音频数据源 (已转换为模型所需的采样率和声道数)
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool ResultCache_computeKey(ResultCacheKey *keyOut, const TCHAR *modelName, const AudioDataSource *audioDataSource);
+
+/**
+ * 从缓存中读取分离结果，并更新命中/未命中次数
+ *
+ * @param   obj             指向 ResultCache 结构体的指针
+ * @param   key             缓存键
+ * @param   modelInfo       模型信息 (用于检查缓存文件中的音轨)
+ *
+ * @return  命中时返回分离结果 (由调用者使用 SpleeterProcessorResult_free() 释放)，未命中时返回 NULL
+ */
+SpleeterProcessorResult *ResultCache_load(ResultCache *obj, const ResultCacheKey *key, const SpleeterModelInfo *modelInfo);
+
+/**
+ * 将分离结果保存到缓存中，保存后如超出大小上限则淘汰最久未使用的缓存文件
+ *
+ * @param   obj             指向 ResultCache 结构体的指针
+ * @param   key             缓存键
+ * @param   result          分离结果
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool ResultCache_store(ResultCache *obj, const ResultCacheKey *key, const SpleeterProcessorResult *result);
+
+/**
+ * 使用缓存进行分离: 命中时直接返回缓存的结果，未命中时使用模型进行分离并将结果保存到缓存中
+ *
+ * @param   obj                 指向 ResultCache 结构体的指针，为 NULL 时不使用缓存
+ * @param   model               已加载的模型
+ * @param   audioDataSource     输入音频数据源
+ * @param   resultOut           分离结果
+ * @param   hitOut              是否命中缓存，可为 NULL
+ *
+ * @return  成功时返回 0, 失败时返回小于 0 的错误码
+ */
+int ResultCache_splitWithModel(ResultCache *obj, SpleeterModel *model, AudioDataSource *audioDataSource,
+        SpleeterProcessorResult **resultOut, bool *hitOut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _RESULT_CACHE_H_
@@ -0,0 +1,171 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <intrin.h>
+#include <immintrin.h>
+#include "Common.h"
+#include "SampleMixer.h"
+
+/**
+ * 加权混合的实现
+ */
+typedef void (*SampleMixerKernel)(float *dest, const float * const *sources, const float *gains, int sourceCount, size_t sampleCount);
+
+/**
+ * 普通的实现，也用于处理 SIMD 实现末尾不足一个寄存器的部分
+ */
+static void _mixScalar(float *dest, const float * const *sources, const float *gains, int sourceCount, size_t sampleCount) {
+    for (size_t i = 0; i < sampleCount; i++) {
+        float acc = gains[0] * sources[0][i];
+        for (int j = 1; j < sourceCount; j++) {
+            acc += gains[j] * sources[j][i];
+        }
+        dest[i] = acc;
+    }
+}
+
+/**
+ * AVX2 实现，每次计算 16 个样本值 (两个寄存器)，累加结果保存在寄存器中
+ */
+static void _mixAvx2(float *dest, const float * const *sources, const float *gains, int sourceCount, size_t sampleCount) {
+    size_t i = 0;
+    for (; (i + 16) <= sampleCount; i += 16) {
+        __m256 gain = _mm256_set1_ps(gains[0]);
+        __m256 acc0 = _mm256_mul_ps(gain, _mm256_loadu_ps(sources[0] + i));
+        __m256 acc1 = _mm256_mul_ps(gain, _mm256_loadu_ps(sources[0] + i + 8));
+        for (int j = 1; j < sourceCount; j++) {
+            gain = _mm256_set1_ps(gains[j]);
+            acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(gain, _mm256_loadu_ps(sources[j] + i)));
+            acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(gain, _mm256_loadu_ps(sources[j] + i + 8)));
+        }
+        _mm256_storeu_ps(dest + i, acc0);
+        _mm256_storeu_ps(dest + i + 8, acc1);
+    }
+
+    if (i < sampleCount) {
+        const float *tailSources[SAMPLE_MIXER_MAX_SOURCE_COUNT];
+        for (int j = 0; j < sourceCount; j++) {
+            tailSources[j] = sources[j] + i;
+        }
+        _mixScalar(dest + i, tailSources, gains, sourceCount, (sampleCount - i));
+    }
+}
+
+/**
+ * AVX-512 实现，每次计算 32 个样本值 (两个寄存器)，末尾部分使用掩码读写
+ */
+static void _mixAvx512(float *dest, const float * const *sources, const float *gains, int sourceCount, size_t sampleCount) {
+    size_t i = 0;
+    for (; (i + 32) <= sampleCount; i += 32) {
+        __m512 gain = _mm512_set1_ps(gains[0]);
+        __m512 acc0 = _mm512_mul_ps(gain, _mm512_loadu_ps(sources[0] + i));
+        __m512 acc1 = _mm512_mul_ps(gain, _mm512_loadu_ps(sources[0] + i + 16));
+        for (int j = 1; j < sourceCount; j++) {
+            gain = _mm512_set1_ps(gains[j]);
+            acc0 = _mm512_add_ps(acc0, _mm512_mul_ps(gain, _mm512_loadu_ps(sources[j] + i)));
+            acc1 = _mm512_add_ps(acc1, _mm512_mul_ps(gain, _mm512_loadu_ps(sources[j] + i + 16)));
+        }
+        _mm512_storeu_ps(dest + i, acc0);
+        _mm512_storeu_ps(dest + i + 16, acc1);
+    }
+
+    for (; i < sampleCount; i += 16) {
+        size_t remaining = sampleCount - i;
+        __mmask16 mask = (remaining >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << remaining) - 1);
+
+        __m512 acc = _mm512_mul_ps(_mm512_set1_ps(gains[0]), _mm512_maskz_loadu_ps(mask, sources[0] + i));
+        for (int j = 1; j < sourceCount; j++) {
+            acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_set1_ps(gains[j]), _mm512_maskz_loadu_ps(mask, sources[j] + i)));
+        }
+        _mm512_mask_storeu_ps(dest + i, mask, acc);
+    }
+}
+
+/**
+ * 检查处理器和操作系统支持的指令集，选择加权混合的实现 (结果只检查一次)
+ *
+ * @param   kernelNameOut   用于返回实现名称，为 NULL 时不返回
+ */
+static SampleMixerKernel _getKernel(const TCHAR **kernelNameOut) {
+    // 多个线程同时检查时结果相同，无需同步
+    static volatile SampleMixerKernel s_kernel = NULL;
+    static const TCHAR * volatile s_kernelName = NULL;
+
+    if (s_kernel == NULL) {
+        SampleMixerKernel kernel = _mixScalar;
+        const TCHAR *kernelName = _T("scalar");
+
+        int cpuInfo[4] = { 0 };
+        __cpuid(cpuInfo, 1);
+        uint32_t ecx = cpuInfo[2];
+
+        // 需要 OSXSAVE 和 AVX, 且操作系统保存了 YMM 寄存器的状态
+        if (((ecx >> 27) & 0x1) && ((ecx >> 28) & 0x1)) {
+            uint64_t xcr0 = _xgetbv(0);
+
+            __cpuidex(cpuInfo, 7, 0);
+            uint32_t ebx = cpuInfo[1];
+
+            if (((xcr0 & 0x6) == 0x6) && ((ebx >> 5) & 0x1)) {
+                kernel = _mixAvx2;
+                kernelName = _T("AVX2");
+
+                // AVX-512F 还需要操作系统保存 opmask 和 ZMM 寄存器的状态
+                if (((xcr0 & 0xE0) == 0xE0) && ((ebx >> 16) & 0x1)) {
+                    kernel = _mixAvx512;
+                    kernelName = _T("AVX-512");
+                }
+            }
+        }
+
+        s_kernelName = kernelName;
+        s_kernel = kernel;
+
+        MSG_DEBUG(_T("sample mixer kernel: %s\n"), kernelName);
+    }
+
+    if (kernelNameOut != NULL) {
+        *kernelNameOut = s_kernelName;
+    }
+
+    return s_kernel;
+}
+
+void SampleMixer_mix(float *dest, const float * const *sources, const float *gains, int sourceCount, size_t sampleCount) {
+    if ((sourceCount <= 0) || (sourceCount > SAMPLE_MIXER_MAX_SOURCE_COUNT)) {
+        return;
+    }
+
+    _getKernel(NULL)(dest, sources, gains, sourceCount, sampleCount);
+}
+
+const TCHAR *SampleMixer_getKernelName(void) {
+    const TCHAR *kernelName = NULL;
+    _getKernel(&kernelName);
+
+    return kernelName;
+}
@@ -0,0 +1,67 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _SAMPLE_MIXER_H_
+#define _SAMPLE_MIXER_H_
+
+#include "Common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 样本值加权混合
+ *
+ * 计算 dest[i] = gains[0] * sources[0][i] + gains[1] * sources[1][i] + ...，各源只读取一次，结果只写入一次。
+ * 根据处理器和操作系统支持的指令集，在运行时选择 AVX-512, AVX2 或普通的实现 (只选择一次)。
+ * 各实现均按相同的顺序先乘后加 (不使用 FMA)，因此计算结果与所选的实现无关
+ */
+
+/** 一次混合的最大源数量 */
+#define SAMPLE_MIXER_MAX_SOURCE_COUNT   16
+
+/**
+ * 计算多个源的加权和
+ *
+ * @param   dest            用于存放结果的数组 (可以与某个源为同一数组，但不能部分重叠)
+ * @param   sources         各源的样本值数组
+ * @param   gains           各源的系数
+ * @param   sourceCount     源的数量 (1 至 SAMPLE_MIXER_MAX_SOURCE_COUNT)
+ * @param   sampleCount     样本值的数量 (包括所有声道)
+ */
+void SampleMixer_mix(float *dest, const float * const *sources, const float *gains, int sourceCount, size_t sampleCount);
+
+/**
+ * 获取运行时选择的实现名称 ("AVX-512", "AVX2" 或 "scalar")
+ *
+ * @return  返回实现名称
+ */
+const TCHAR *SampleMixer_getKernelName(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SAMPLE_MIXER_H_
@@ -0,0 +1,542 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <io.h>
+#include <process.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <Windows.h>
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFile.h"
+#include "AudioFileCommon.h"
+#include "SocketEndpoint.h"
+#include "SpleeterProcessor.h"
+#include "TrackOutput.h"
+#include "Server.h"
+
+/** 同时保留在内存中的模型的最大数量 */
+#define SERVER_MODEL_MAX_COUNT          8
+
+/** 任务请求的最大长度 (以字节为单位) */
+#define SERVER_REQUEST_MAX_SIZE         (FILE_PATH_MAX_SIZE * 4 * 4)
+
+/** 接收任务请求的超时时间 (以毫秒为单位) */
+#define SERVER_REQUEST_TIMEOUT          10000
+
+/** 单个事件行的最大长度 (以字符为单位) */
+#define SERVER_EVENT_MAX_SIZE           (FILE_PATH_MAX_SIZE * 2)
+
+/**
+ * 已加载的模型
+ */
+typedef struct {
+    TCHAR           modelName[FILE_PATH_MAX_SIZE];
+    SpleeterModel   *model;
+} ServerModelItem;
+
+/**
+ * 等待处理的连接
+ */
+typedef struct {
+    SOCKET          socket;
+    int             jobId;
+} ServerQueueItem;
+
+/**
+ * 服务运行时的状态
+ */
+typedef struct {
+    const ServerConfig  *config;
+
+    /** 已加载的模型列表 */
+    ServerModelItem     models[SERVER_MODEL_MAX_COUNT];
+    int                 modelCount;
+    CRITICAL_SECTION    modelLock;
+
+    /** 等待处理的连接队列 (环形缓冲区) */
+    ServerQueueItem     *queueItems;
+    int                 queueHead;
+    int                 queueCount;
+    CRITICAL_SECTION    queueLock;
+    CONDITION_VARIABLE  queueNotEmpty;
+} ServerState;
+
+/**
+ * 任务请求
+ */
+typedef struct {
+    TCHAR           inputFilePath[FILE_PATH_MAX_SIZE];
+    TCHAR           modelName[FILE_PATH_MAX_SIZE];
+    TCHAR           outputFilePathFormat[FILE_PATH_MAX_SIZE];
+    TrackList       trackList;
+    int             bitrate;
+    int             overwriteFlag;
+} ServerJobRequest;
+
+/**
+ * 正在处理的任务的上下文 (用作进度回调函数的 userData)
+ */
+typedef struct {
+    SOCKET          socket;
+    int             jobId;
+} ServerJobContext;
+
+static const char *_getStageName(Stage stage) {
+    switch (stage) {
+        case STAGE_AUDIO_FILE_READER:
+            return "read";
+
+        case STAGE_SPLEETER_PROCESSOR_LOAD_MODEL:
+            return "load_model";
+
+        case STAGE_SPLEETER_PROCESSOR_PROCESS_SEGMENT:
+            return "segment";
+
+        case STAGE_AUDIO_FILE_WRITER:
+            return "write";
+
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * 向客户端发送一个事件行 (自动添加结尾的换行符)
+ */
+static bool _sendEvent(SOCKET socket, const TCHAR *format, ...) {
+    TCHAR buffer[SERVER_EVENT_MAX_SIZE] = { _T('\0') };
+
+    va_list args;
+    va_start(args, format);
+    _vsntprintf(buffer, (SERVER_EVENT_MAX_SIZE - 2), format, args);
+    va_end(args);
+    buffer[SERVER_EVENT_MAX_SIZE - 2] = _T('\0');
+    _tcscat(buffer, _T("\n"));
+
+    char *bufferUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(buffer);
+    bool sent = SocketEndpoint_sendAll(socket, bufferUtf8, (int64_t)strlen(bufferUtf8));
+    Memory_free(&bufferUtf8);
+
+    return sent;
+}
+
+static void _onProgress(void *userData, Stage stage, double progress, int stageProgress, int stageTotal) {
+    ServerJobContext *context = (ServerJobContext *)userData;
+
+    _sendEvent(context->socket, _T("PROGRESS %.2f ") _T(A_STR_FMT) _T(" %d/%d"),
+            progress, _getStageName(stage), stageProgress, stageTotal);
+}
+
+/**
+ * 获取指定名称的模型，如果尚未加载则进行加载
+ *
+ * @return  成功时返回模型，失败时返回 NULL
+ */
+static SpleeterModel *_getModel(ServerState *state, const TCHAR *modelName) {
+    SpleeterModel *model = NULL;
+
+    // 加载模型时持有锁，避免多个工作线程同时加载同一个模型
+    EnterCriticalSection(&state->modelLock);
+
+    for (int i = 0; i < state->modelCount; i++) {
+        if (_tcsicmp(state->models[i].modelName, modelName) == 0) {
+            model = state->models[i].model;
+            goto end;
+        }
+    }
+
+    if (state->modelCount >= SERVER_MODEL_MAX_COUNT) {
+        MSG_ERROR(_T("Too many models have been loaded (max %d).\n"), SERVER_MODEL_MAX_COUNT);
+        goto end;
+    }
+
+    MSG_INFO(_T("Loading model \"%s\"\n"), modelName);
+
+    model = SpleeterModel_load(modelName);
+    if (model == NULL) {
+        goto end;
+    }
+
+    ServerModelItem *item = &state->models[state->modelCount];
+    _tcsncpy(item->modelName, modelName, (FILE_PATH_MAX_SIZE - 1));
+    item->modelName[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+    item->model = model;
+    state->modelCount++;
+
+end:
+    LeaveCriticalSection(&state->modelLock);
+
+    return model;
+}
+
+/**
+ * 将 UTF-8 编码的字符串转换到 TCHAR 缓冲区中
+ */
+static bool _copyUtf8StringToBuffer(TCHAR *buffer, int bufferCharCount, const char *utf8String) {
+    int length = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, utf8String, -1, buffer, bufferCharCount);
+
+    return (length > 0);
+}
+
+/**
+ * 接收并解析任务请求
+ *
+ * @param   errorMessage    解析失败时用于返回错误信息
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+static bool _receiveJobRequest(SOCKET socket, ServerJobRequest *request, const TCHAR **errorMessage) {
+    char *buffer = (char *)MEMORY_ALLOC_ARRAY(char, SERVER_REQUEST_MAX_SIZE);
+    int length = 0;
+    bool succeeded = false;
+
+    memset(request, 0, sizeof(ServerJobRequest));
+    request->bitrate = -1;
+
+    // 接收请求，直到遇到空行
+    char *requestEnd = NULL;
+    while (requestEnd == NULL) {
+        if (length >= (SERVER_REQUEST_MAX_SIZE - 1)) {
+            *errorMessage = _T("Request is too long");
+            goto end;
+        }
+
+        int receivedLength = recv(socket, (buffer + length), (SERVER_REQUEST_MAX_SIZE - 1 - length), 0);
+        if (receivedLength <= 0) {
+            *errorMessage = _T("Incomplete request");
+            goto end;
+        }
+        length += receivedLength;
+        buffer[length] = '\0';
+
+        requestEnd = strstr(buffer, "\n\n");
+        if (requestEnd == NULL) {
+            requestEnd = strstr(buffer, "\r\n\r\n");
+        }
+    }
+    *requestEnd = '\0';
+
+    // 逐行解析 "键=值"
+    char *context = NULL;
+    for (char *line = strtok_s(buffer, "\r\n", &context); line != NULL; line = strtok_s(NULL, "\r\n", &context)) {
+        char *separator = strchr(line, '=');
+        if (separator == NULL) {
+            *errorMessage = _T("Malformed request line");
+            goto end;
+        }
+        *separator = '\0';
+
+        const char *key = line;
+        const char *value = separator + 1;
+
+        TCHAR valueBuffer[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (!_copyUtf8StringToBuffer(valueBuffer, FILE_PATH_MAX_SIZE, value)) {
+            *errorMessage = _T("Request value is too long or not valid UTF-8");
+            goto end;
+        }
+
+        if (strcmp(key, "input") == 0) {
+            _tcscpy(request->inputFilePath, valueBuffer);
+        } else if (strcmp(key, "model") == 0) {
+            _tcscpy(request->modelName, valueBuffer);
+        } else if (strcmp(key, "output") == 0) {
+            _tcscpy(request->outputFilePathFormat, valueBuffer);
+        } else if (strcmp(key, "tracks") == 0) {
+            if (!TrackOutput_parseTrackList(&request->trackList, valueBuffer)) {
+                *errorMessage = _T("Failed to parse the track list");
+                goto end;
+            }
+        } else if (strcmp(key, "bitrate") == 0) {
+            if (!TrackOutput_parseBitrate(&request->bitrate, valueBuffer)) {
+                *errorMessage = _T("Failed to parse the bitrate");
+                goto end;
+            }
+        } else if (strcmp(key, "overwrite") == 0) {
+            request->overwriteFlag = (_tcscmp(valueBuffer, _T("1")) == 0) || (_tcsicmp(valueBuffer, _T("true")) == 0);
+        } else {
+            *errorMessage = _T("Unknown request key");
+            goto end;
+        }
+    }
+
+    if (_tcsclen(request->inputFilePath) == 0) {
+        *errorMessage = _T("Not specified the input file path");
+        goto end;
+    }
+
+    succeeded = true;
+
+end:
+    Memory_free(&buffer);
+
+    return succeeded;
+}
+
+/**
+ * 处理一个任务
+ *
+ * @return  成功时返回 NULL, 失败时返回错误信息
+ */
+static const TCHAR *_processJob(ServerState *state, SOCKET socket, const ServerJobRequest *request) {
+    const TCHAR *errorMessage = NULL;
+
+    AudioDataSource *audioDataSourceStereo = NULL;
+    SpleeterProcessorResult *result = NULL;
+
+    // 检查请求参数
+
+    const TCHAR *modelName = (_tcsclen(request->modelName) > 0) ? request->modelName : state->config->defaultModelName;
+
+    const SpleeterModelInfo *modelInfo = SpleeterProcessor_getModelInfo(modelName);
+    if (modelInfo == NULL) {
+        return _T("Unrecognized model name");
+    }
+
+    if (!TrackOutput_checkTrackList(modelInfo, &request->trackList)) {
+        return _T("Track name does not exist in the model");
+    }
+
+    TCHAR inputFileFullPath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    if ((GetFullPathName(request->inputFilePath, FILE_PATH_MAX_SIZE, inputFileFullPath, NULL) == 0)
+            || (_taccess(inputFileFullPath, 4) == -1)) {
+        return _T("The input file does not exist or cannot be read");
+    }
+
+    const TrackOutputConfig outputConfig = {
+        .modelInfo = modelInfo,
+        .outputFilePathFormat = request->outputFilePathFormat,
+        .trackList = &request->trackList,
+        .overwriteFlag = request->overwriteFlag,
+        .outputAudioFileFormat = {
+            .formatName = NULL,
+            .bitRate = ((request->bitrate >= 0) ? request->bitrate : 256000)
+        },
+        .sampleType = {
+            .sampleRate = SPLEETER_MODEL_AUDIO_SAMPLE_RATE,
+            .channelCount = SPLEETER_MODEL_AUDIO_CHANNEL_COUNT,
+            .sampleValueFormat = AUDIO_SAMPLE_VALUE_FORMAT_FLOAT_INTERLACED
+        }
+    };
+
+    int outputTrackCount = TrackOutput_getTrackCount(&outputConfig);
+    for (int i = 0; i < outputTrackCount; i++) {
+        TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (!TrackOutput_getFilePath(outputFilePath, outputConfig.outputFilePathFormat,
+                outputTrackCount, TrackOutput_getTrackName(&outputConfig, i), inputFileFullPath)
+                || !TrackOutput_checkFilePath(outputFilePath, outputConfig.overwriteFlag)) {
+            return _T("The output file path is not available");
+        }
+    }
+
+    // 获取模型 (首次使用时加载，之后复用)
+
+    SpleeterModel *model = _getModel(state, modelName);
+    if (model == NULL) {
+        return _T("Failed to load the model");
+    }
+
+    // 读取、分离、写入
+
+    audioDataSourceStereo = PcmCache_readAll(state->config->pcmCache, inputFileFullPath, &outputConfig.sampleType);
+    if (audioDataSourceStereo == NULL) {
+        errorMessage = _T("Failed to read the input file");
+        goto end;
+    }
+
+    if ((ResultCache_splitWithModel(state->config->resultCache, model, audioDataSourceStereo, &result, NULL) != 0) || (result == NULL)) {
+        errorMessage = _T("Failed to split the input file");
+        goto end;
+    }
+
+    if (!TrackOutput_writeFiles(&outputConfig, inputFileFullPath, audioDataSourceStereo, result)) {
+        errorMessage = _T("Failed to write the output files");
+        goto end;
+    }
+
+    for (int i = 0; i < outputTrackCount; i++) {
+        TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (TrackOutput_getFilePath(outputFilePath, outputConfig.outputFilePathFormat,
+                outputTrackCount, TrackOutput_getTrackName(&outputConfig, i), inputFileFullPath)) {
+            _sendEvent(socket, _T("OUTPUT %s"), outputFilePath);
+        }
+    }
+
+end:
+    if (result != NULL) {
+        SpleeterProcessorResult_free(&result);
+    }
+
+    if (audioDataSourceStereo != NULL) {
+        AudioDataSource_free(&audioDataSourceStereo);
+    }
+
+    return errorMessage;
+}
+
+/**
+ * 处理一个客户端连接 (接收请求，处理任务，返回事件)
+ */
+static void _handleConnection(ServerState *state, SOCKET socket, int jobId) {
+    DWORD timeout = SERVER_REQUEST_TIMEOUT;
+    setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout));
+
+    ServerJobRequest *request = MEMORY_ALLOC_STRUCT(ServerJobRequest);
+
+    const TCHAR *errorMessage = NULL;
+    if (!_receiveJobRequest(socket, request, &errorMessage)) {
+        _sendEvent(socket, _T("ERROR %s"), errorMessage);
+        Memory_free(&request);
+        return;
+    }
+
+    MSG_INFO(_T("[Job %d] Started: %s\n"), jobId, request->inputFilePath);
+    _sendEvent(socket, _T("STARTED %d"), jobId);
+
+    double beginTime = Common_getTimeInSeconds();
+
+    ServerJobContext context = {
+        .socket = socket,
+        .jobId = jobId
+    };
+    Common_setProgressCallback(_onProgress, &context);
+
+    errorMessage = _processJob(state, socket, request);
+
+    Common_setProgressCallback(NULL, NULL);
+
+    double elapsedSeconds = Common_getTimeInSeconds() - beginTime;
+
+    if (errorMessage == NULL) {
+        MSG_INFO(_T("[Job %d] Done in %.2f seconds\n"), jobId, elapsedSeconds);
+        _sendEvent(socket, _T("DONE %.2f"), elapsedSeconds);
+    } else {
+        MSG_INFO(_T("[Job %d] Failed: %s\n"), jobId, errorMessage);
+        _sendEvent(socket, _T("ERROR %s"), errorMessage);
+    }
+
+    Memory_free(&request);
+}
+
+static unsigned __stdcall _workerThreadProc(void *arg) {
+    ServerState *state = (ServerState *)arg;
+
+    while (true) {
+        EnterCriticalSection(&state->queueLock);
+        while (state->queueCount == 0) {
+            SleepConditionVariableCS(&state->queueNotEmpty, &state->queueLock, INFINITE);
+        }
+        ServerQueueItem item = state->queueItems[state->queueHead];
+        state->queueHead = (state->queueHead + 1) % state->config->queueCapacity;
+        state->queueCount--;
+        LeaveCriticalSection(&state->queueLock);
+
+        _handleConnection(state, item.socket, item.jobId);
+
+        shutdown(item.socket, SD_BOTH);
+        closesocket(item.socket);
+    }
+
+    return 0;
+}
+
+bool Server_run(const ServerConfig *config) {
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        MSG_ERROR(_T("Failed to initialize Winsock.\n"));
+        return false;
+    }
+
+    ServerState *state = MEMORY_ALLOC_STRUCT(ServerState);
+    state->config = config;
+    state->queueItems = MEMORY_ALLOC_ARRAY(ServerQueueItem, config->queueCapacity);
+    InitializeCriticalSection(&state->modelLock);
+    InitializeCriticalSection(&state->queueLock);
+    InitializeConditionVariable(&state->queueNotEmpty);
+
+    // 预先加载默认模型，使第一个任务无需等待模型加载
+    if (_getModel(state, config->defaultModelName) == NULL) {
+        return false;
+    }
+
+    SOCKET listenSocket = SocketEndpoint_listen(config->endpoint, false);
+    if (listenSocket == INVALID_SOCKET) {
+        return false;
+    }
+
+    for (int i = 0; i < config->workerCount; i++) {
+        HANDLE threadHandle = (HANDLE)_beginthreadex(NULL, 0, _workerThreadProc, state, 0, NULL);
+        if (threadHandle == NULL) {
+            MSG_ERROR(_T("Failed to start worker thread.\n"));
+            return false;
+        }
+        CloseHandle(threadHandle);
+    }
+
+    MSG_INFO(_T("\n"));
+    MSG_INFO(_T("Listening on %s (%d workers, queue capacity %d)\n"),
+            config->endpoint, config->workerCount, config->queueCapacity);
+
+    int nextJobId = 1;
+
+    while (true) {
+        SOCKET clientSocket = accept(listenSocket, NULL, NULL);
+        if (clientSocket == INVALID_SOCKET) {
+            MSG_WARNING(_T("Failed to accept connection (error %d).\n"), WSAGetLastError());
+            continue;
+        }
+
+        int jobId = nextJobId++;
+
+        EnterCriticalSection(&state->queueLock);
+        bool queued = false;
+        if (state->queueCount < config->queueCapacity) {
+            int tail = (state->queueHead + state->queueCount) % config->queueCapacity;
+            state->queueItems[tail].socket = clientSocket;
+            state->queueItems[tail].jobId = jobId;
+            state->queueCount++;
+
+            // 在持有锁时发送 QUEUED 事件，保证其先于工作线程发送的 STARTED 事件
+            _sendEvent(clientSocket, _T("QUEUED %d %d"), jobId, state->queueCount);
+            queued = true;
+        }
+        LeaveCriticalSection(&state->queueLock);
+
+        if (!queued) {
+            // 队列已满，拒绝该任务
+            _sendEvent(clientSocket, _T("ERROR Server is busy"));
+            closesocket(clientSocket);
+            continue;
+        }
+
+        WakeConditionVariable(&state->queueNotEmpty);
+    }
+
+    return true;
+}
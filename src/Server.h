@@ -0,0 +1,111 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _SERVER_H_
+#define _SERVER_H_
+
+#include "Common.h"
+#include "PcmCache.h"
+#include "ResultCache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+服务模式的通信协议
+
+客户端连接到服务端后，以 UTF-8 编码发送一个任务请求，每行一个 "键=值"，以一个空行结束:
+
+    input=D:\Music\song.mp3                                 (必需) 输入文件路径
+    model=4stems                                            (可选) 模型名称，默认为启动服务时 -m 指定的模型
+    tracks=vocals,acc=input-vocals                          (可选) 输出轨道列表，格式同 --tracks
+    output=$(DirPath)\$(BaseName).$(TrackName).m4a          (可选) 输出文件路径格式，格式同 --output
+    bitrate=192k                                            (可选) 输出文件比特率，格式同 --bitrate
+    overwrite=1                                             (可选) 当目标输出文件已存在时是否覆盖
+
+服务端随后逐行返回事件，最后以 DONE 或 ERROR 结束并关闭连接:
+
+    QUEUED <jobId> <queuePosition>                          任务已进入队列
+    STARTED <jobId>                                         任务开始处理
+    PROGRESS <percentage> <stage> <stageProgress>/<stageTotal>
+                                                            处理进度，stage 为 read, load_model, segment, write
+    OUTPUT <outputFilePath>                                 已写入的输出文件
+    DONE <elapsedSeconds>                                   任务处理完成
+    ERROR <message>                                         任务处理失败 (详细错误信息输出在服务端的标准错误中)
+*/
+
+/** 默认的服务端点 (仅监听本机回环地址) */
+#define SERVER_DEFAULT_ENDPOINT             _T("127.0.0.1:7450")
+
+/** 默认的工作线程数量 */
+#define SERVER_DEFAULT_WORKER_COUNT         2
+
+/** 默认的任务队列容量 */
+#define SERVER_DEFAULT_QUEUE_CAPACITY       16
+
+/**
+ * 服务配置
+ */
+typedef struct {
+    /**
+     * 服务端点
+     *
+     * 可以是端口号 (如 "7450")，本机地址和端口号 (如 "127.0.0.1:7450", "localhost:7450")，
+     * 或 Unix 域套接字文件的路径 (如 "C:\Temp\spleeter.sock", 需要 Windows 10 1803 及以上版本)
+     */
+    const TCHAR     *endpoint;
+
+    /** 默认使用的模型名称 (启动时即加载，请求中未指定模型时使用) */
+    const TCHAR     *defaultModelName;
+
+    /** 工作线程数量 (即可同时处理的任务数量) */
+    int             workerCount;
+
+    /** 任务队列容量 (所有工作线程都在处理任务时，最多可排队等待的任务数量) */
+    int             queueCapacity;
+
+    /** 分离结果缓存，为 NULL 时不使用缓存 */
+    ResultCache     *resultCache;
+
+    /** 解码后 PCM 数据的缓存，为 NULL 时不使用缓存 */
+    PcmCache        *pcmCache;
+} ServerConfig;
+
+/**
+ * 运行服务
+ *
+ * 服务启动后将一直运行，接受并处理任务请求。已加载的模型会一直保留在内存中，供后续任务复用
+ *
+ * @param   config          服务配置
+ *
+ * @return  启动失败时返回 false, 否则不会返回
+ */
+bool Server_run(const ServerConfig *config);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SERVER_H_
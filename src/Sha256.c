@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <Windows.h>
+#include <bcrypt.h>
+#include "Common.h"
+#include "Sha256.h"
+
+#pragma comment(lib, "bcrypt.lib")
+
+/** 单次 BCryptHashData() 处理的最大字节数 */
+#define SHA256_UPDATE_CHUNK_SIZE        (64 * 1024 * 1024)
+
+bool Sha256_begin(Sha256 *obj) {
+    obj->_algorithmHandle = NULL;
+    obj->_hashHandle = NULL;
+
+    BCRYPT_ALG_HANDLE algorithmHandle = NULL;
+    if (!BCRYPT_SUCCESS(BCryptOpenAlgorithmProvider(&algorithmHandle, BCRYPT_SHA256_ALGORITHM, NULL, 0))) {
+        MSG_ERROR(_T("BCryptOpenAlgorithmProvider() failed\n"));
+        return false;
+    }
+
+    BCRYPT_HASH_HANDLE hashHandle = NULL;
+    if (!BCRYPT_SUCCESS(BCryptCreateHash(algorithmHandle, &hashHandle, NULL, 0, NULL, 0, 0))) {
+        MSG_ERROR(_T("BCryptCreateHash() failed\n"));
+        BCryptCloseAlgorithmProvider(algorithmHandle, 0);
+        return false;
+    }
+
+    obj->_algorithmHandle = algorithmHandle;
+    obj->_hashHandle = hashHandle;
+
+    return true;
+}
+
+bool Sha256_update(Sha256 *obj, const void *data, int64_t size) {
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (size > 0) {
+        ULONG chunkSize = (ULONG)min(size, SHA256_UPDATE_CHUNK_SIZE);
+        if (!BCRYPT_SUCCESS(BCryptHashData((BCRYPT_HASH_HANDLE)obj->_hashHandle, (PUCHAR)p, chunkSize, 0))) {
+            MSG_ERROR(_T("BCryptHashData() failed\n"));
+            return false;
+        }
+
+        p += chunkSize;
+        size -= chunkSize;
+    }
+
+    return true;
+}
+
+bool Sha256_finish(Sha256 *obj, uint8_t hashOut[SHA256_HASH_SIZE]) {
+    bool succeeded = true;
+
+    if ((hashOut != NULL)
+            && !BCRYPT_SUCCESS(BCryptFinishHash((BCRYPT_HASH_HANDLE)obj->_hashHandle, hashOut, SHA256_HASH_SIZE, 0))) {
+        MSG_ERROR(_T("BCryptFinishHash() failed\n"));
+        succeeded = false;
+    }
+
+    if (obj->_hashHandle != NULL) {
+        BCryptDestroyHash((BCRYPT_HASH_HANDLE)obj->_hashHandle);
+        obj->_hashHandle = NULL;
+    }
+    if (obj->_algorithmHandle != NULL) {
+        BCryptCloseAlgorithmProvider((BCRYPT_ALG_HANDLE)obj->_algorithmHandle, 0);
+        obj->_algorithmHandle = NULL;
+    }
+
+    return succeeded;
+}
+
+void Sha256_toHex(const uint8_t hash[SHA256_HASH_SIZE], TCHAR *hexOut) {
+    static const TCHAR hexDigits[] = _T("0123456789abcdef");
+
+    for (int i = 0; i < SHA256_HASH_SIZE; i++) {
+        hexOut[i * 2] = hexDigits[hash[i] >> 4];
+        hexOut[(i * 2) + 1] = hexDigits[hash[i] & 0x0F];
+    }
+    hexOut[SHA256_HASH_SIZE * 2] = _T('\0');
+}
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _SHA256_H_
+#define _SHA256_H_
+
+#include "Common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** SHA-256 哈希值的长度 (以字节为单位) */
+#define SHA256_HASH_SIZE        32
+
+/**
+ * SHA-256 哈希计算的状态 (使用 Windows CNG 实现)
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 算法提供程序的句柄 (BCRYPT_ALG_HANDLE) */
+    void        *_algorithmHandle;
+
+    /** 哈希对象的句柄 (BCRYPT_HASH_HANDLE) */
+    void        *_hashHandle;
+} Sha256;
+
+/**
+ * 开始计算 SHA-256 哈希值
+ *
+ * @param   obj             指向 Sha256 结构体的指针
+ *
+ * @return  成功时返回 true, 失败时返回 false (此时无需调用 Sha256_finish())
+ */
+bool Sha256_begin(Sha256 *obj);
+
+/**
+ * 追加要计算哈希值的数据
+ *
+ * @param   obj             指向 Sha256 结构体的指针
+ * @param   data            数据
+ * @param   size            数据的大小 (以字节为单位，可超过 4 GB)
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool Sha256_update(Sha256 *obj, const void *data, int64_t size);
+
+/**
+ * 结束计算，获取哈希值，并释放相关资源
+ *
+ * @param   obj             指向 Sha256 结构体的指针
+ * @param   hashOut         哈希值，为 NULL 时只释放资源
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool Sha256_finish(Sha256 *obj, uint8_t hashOut[SHA256_HASH_SIZE]);
+
+/**
+ * 将哈希值转换为十六进制字符串
+ *
+ * @param   hash            哈希值
+ * @param   hexOut          十六进制字符串 (长度至少为 SHA256_HASH_SIZE * 2 + 1)
+ */
+void Sha256_toHex(const uint8_t hash[SHA256_HASH_SIZE], TCHAR *hexOut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SHA256_H_
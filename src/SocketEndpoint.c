@@ -0,0 +1,307 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#include <Windows.h>
+#include "Common.h"
+#include "Memory.h"
+#include "AudioFileCommon.h"
+#include "SocketEndpoint.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+/** 单次 send() / recv() 处理的最大字节数 */
+#define SOCKET_ENDPOINT_IO_CHUNK_SIZE       (1024 * 1024)
+
+/** 主机名的最大长度 */
+#define SOCKET_ENDPOINT_HOST_MAX_SIZE       256
+
+/** 端口号字符串的最大长度 */
+#define SOCKET_ENDPOINT_PORT_MAX_SIZE       8
+
+/**
+ * 解析端点字符串
+ *
+ * @return  为 TCP 端点时返回 true, 并输出主机和端口号; 为 Unix 域套接字时返回 false
+ */
+static bool _parseTcpEndpoint(const TCHAR *endpoint, char *hostOut, char *portOut) {
+    size_t length = _tcsclen(endpoint);
+
+    if ((length > 0) && (length < SOCKET_ENDPOINT_PORT_MAX_SIZE) && (_tcsspn(endpoint, _T("0123456789")) == length)) {
+        // 只有端口号，使用本机回环地址
+        strcpy(hostOut, "127.0.0.1");
+        for (size_t i = 0; i <= length; i++) {
+            portOut[i] = (char)endpoint[i];
+        }
+        return true;
+    }
+
+    // 包含路径分隔符的为 Unix 域套接字文件的路径 (如 "C:\Temp\spleeter.sock")
+    if ((_tcschr(endpoint, _T('\\')) != NULL) || (_tcschr(endpoint, _T('/')) != NULL)) {
+        return false;
+    }
+
+    const TCHAR *colon = _tcsrchr(endpoint, _T(':'));
+    if ((colon == NULL) || (colon == endpoint)) {
+        return false;
+    }
+
+    const TCHAR *portString = colon + 1;
+    size_t portLength = _tcsclen(portString);
+    if ((portLength == 0) || (portLength >= SOCKET_ENDPOINT_PORT_MAX_SIZE)
+            || (_tcsspn(portString, _T("0123456789")) != portLength)) {
+        return false;
+    }
+
+    size_t hostLength = colon - endpoint;
+    if (hostLength >= SOCKET_ENDPOINT_HOST_MAX_SIZE) {
+        return false;
+    }
+
+    for (size_t i = 0; i < hostLength; i++) {
+        hostOut[i] = (char)endpoint[i];
+    }
+    hostOut[hostLength] = '\0';
+
+    for (size_t i = 0; i <= portLength; i++) {
+        portOut[i] = (char)portString[i];
+    }
+
+    return true;
+}
+
+/**
+ * 解析 TCP 端点的地址
+ *
+ * @return  成功时返回地址列表 (由调用者使用 freeaddrinfo() 释放)，失败时返回 NULL
+ */
+static struct addrinfo *_resolveTcpEndpoint(const TCHAR *endpoint, const char *host, const char *port, bool passive) {
+    struct addrinfo hints = { 0 };
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    hints.ai_flags = (passive ? AI_PASSIVE : 0);
+
+    struct addrinfo *addressList = NULL;
+    int ret = getaddrinfo(host, port, &hints, &addressList);
+    if ((ret != 0) || (addressList == NULL)) {
+        MSG_ERROR(_T("Failed to resolve the address of \"%s\" (error %d).\n"), endpoint, ret);
+        return NULL;
+    }
+
+    int portNumber = atoi(port);
+    if ((portNumber <= 0) || (portNumber > 65535)) {
+        MSG_ERROR(_T("Invalid port number in endpoint \"%s\".\n"), endpoint);
+        freeaddrinfo(addressList);
+        return NULL;
+    }
+
+    return addressList;
+}
+
+static bool _fillUnixAddress(const TCHAR *endpoint, struct sockaddr_un *address) {
+    char *endpointUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(endpoint);
+
+    memset(address, 0, sizeof(struct sockaddr_un));
+    address->sun_family = AF_UNIX;
+
+    if (strlen(endpointUtf8) >= sizeof(address->sun_path)) {
+        MSG_ERROR(_T("The socket file path \"%s\" is too long.\n"), endpoint);
+        Memory_free(&endpointUtf8);
+        return false;
+    }
+
+    strcpy(address->sun_path, endpointUtf8);
+    Memory_free(&endpointUtf8);
+
+    return true;
+}
+
+SOCKET SocketEndpoint_listen(const TCHAR *endpoint, bool allowRemote) {
+    SOCKET listenSocket = INVALID_SOCKET;
+
+    char host[SOCKET_ENDPOINT_HOST_MAX_SIZE] = { '\0' };
+    char port[SOCKET_ENDPOINT_PORT_MAX_SIZE] = { '\0' };
+
+    if (_parseTcpEndpoint(endpoint, host, port)) {
+        // TCP 端口
+
+        struct addrinfo *addressList = _resolveTcpEndpoint(endpoint, host, port, true);
+        if (addressList == NULL) {
+            return INVALID_SOCKET;
+        }
+
+        const struct sockaddr_in *address = (const struct sockaddr_in *)addressList->ai_addr;
+        if (!allowRemote && ((ntohl(address->sin_addr.s_addr) >> 24) != 127)) {
+            MSG_ERROR(_T("Only the loopback address can be used in endpoint \"%s\".\n"), endpoint);
+            freeaddrinfo(addressList);
+            return INVALID_SOCKET;
+        }
+
+        listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (listenSocket == INVALID_SOCKET) {
+            MSG_ERROR(_T("Failed to create socket (error %d).\n"), WSAGetLastError());
+            freeaddrinfo(addressList);
+            return INVALID_SOCKET;
+        }
+
+        // 不允许其他进程绑定同一端口
+        BOOL exclusive = TRUE;
+        setsockopt(listenSocket, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, (const char *)&exclusive, sizeof(exclusive));
+
+        int bindResult = bind(listenSocket, addressList->ai_addr, (int)addressList->ai_addrlen);
+        freeaddrinfo(addressList);
+
+        if (bindResult == SOCKET_ERROR) {
+            MSG_ERROR(_T("Failed to bind to \"%s\" (error %d).\n"), endpoint, WSAGetLastError());
+            closesocket(listenSocket);
+            return INVALID_SOCKET;
+        }
+    } else {
+        // Unix 域套接字
+
+        struct sockaddr_un address;
+        if (!_fillUnixAddress(endpoint, &address)) {
+            return INVALID_SOCKET;
+        }
+
+        listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenSocket == INVALID_SOCKET) {
+            MSG_ERROR(_T("Failed to create Unix domain socket (error %d). Windows 10 1803 or later is required.\n"),
+                    WSAGetLastError());
+            return INVALID_SOCKET;
+        }
+
+        // 删除之前遗留的套接字文件
+        DeleteFile(endpoint);
+
+        if (bind(listenSocket, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR) {
+            MSG_ERROR(_T("Failed to bind to \"%s\" (error %d).\n"), endpoint, WSAGetLastError());
+            closesocket(listenSocket);
+            return INVALID_SOCKET;
+        }
+    }
+
+    if (listen(listenSocket, SOMAXCONN) == SOCKET_ERROR) {
+        MSG_ERROR(_T("Failed to listen on \"%s\" (error %d).\n"), endpoint, WSAGetLastError());
+        closesocket(listenSocket);
+        return INVALID_SOCKET;
+    }
+
+    return listenSocket;
+}
+
+SOCKET SocketEndpoint_connect(const TCHAR *endpoint) {
+    SOCKET connectSocket = INVALID_SOCKET;
+
+    char host[SOCKET_ENDPOINT_HOST_MAX_SIZE] = { '\0' };
+    char port[SOCKET_ENDPOINT_PORT_MAX_SIZE] = { '\0' };
+
+    if (_parseTcpEndpoint(endpoint, host, port)) {
+        struct addrinfo *addressList = _resolveTcpEndpoint(endpoint, host, port, false);
+        if (addressList == NULL) {
+            return INVALID_SOCKET;
+        }
+
+        for (struct addrinfo *address = addressList; address != NULL; address = address->ai_next) {
+            connectSocket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (connectSocket == INVALID_SOCKET) {
+                continue;
+            }
+
+            if (connect(connectSocket, address->ai_addr, (int)address->ai_addrlen) != SOCKET_ERROR) {
+                break;
+            }
+
+            closesocket(connectSocket);
+            connectSocket = INVALID_SOCKET;
+        }
+
+        freeaddrinfo(addressList);
+
+        if (connectSocket != INVALID_SOCKET) {
+            // 请求和响应都是整块发送的，禁用 Nagle 算法以减少延迟
+            BOOL noDelay = TRUE;
+            setsockopt(connectSocket, IPPROTO_TCP, TCP_NODELAY, (const char *)&noDelay, sizeof(noDelay));
+        }
+    } else {
+        struct sockaddr_un address;
+        if (!_fillUnixAddress(endpoint, &address)) {
+            return INVALID_SOCKET;
+        }
+
+        connectSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if ((connectSocket != INVALID_SOCKET)
+                && (connect(connectSocket, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR)) {
+            closesocket(connectSocket);
+            connectSocket = INVALID_SOCKET;
+        }
+    }
+
+    if (connectSocket == INVALID_SOCKET) {
+        MSG_WARNING(_T("Failed to connect to \"%s\" (error %d).\n"), endpoint, WSAGetLastError());
+    }
+
+    return connectSocket;
+}
+
+bool SocketEndpoint_sendAll(SOCKET socket, const void *data, int64_t size) {
+    const char *p = (const char *)data;
+
+    while (size > 0) {
+        int chunkSize = (int)min(size, SOCKET_ENDPOINT_IO_CHUNK_SIZE);
+        int sentSize = send(socket, p, chunkSize, 0);
+        if ((sentSize == SOCKET_ERROR) || (sentSize == 0)) {
+            return false;
+        }
+
+        p += sentSize;
+        size -= sentSize;
+    }
+
+    return true;
+}
+
+bool SocketEndpoint_receiveAll(SOCKET socket, void *buffer, int64_t size) {
+    char *p = (char *)buffer;
+
+    while (size > 0) {
+        int chunkSize = (int)min(size, SOCKET_ENDPOINT_IO_CHUNK_SIZE);
+        int receivedSize = recv(socket, p, chunkSize, 0);
+        if ((receivedSize == SOCKET_ERROR) || (receivedSize == 0)) {
+            return false;
+        }
+
+        p += receivedSize;
+        size -= receivedSize;
+    }
+
+    return true;
+}
@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _SOCKET_ENDPOINT_H_
+#define _SOCKET_ENDPOINT_H_
+
+#include <winsock2.h>
+#include "Common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+端点字符串的格式
+
+    7450                        本机回环地址 127.0.0.1 上的 TCP 端口
+    127.0.0.1:7450              指定地址 (或主机名) 上的 TCP 端口，仅支持 IPv4
+    localhost:7450
+    0.0.0.0:7451
+    C:\Temp\spleeter.sock       Unix 域套接字文件的路径 (需要 Windows 10 1803 及以上版本)
+*/
+
+/**
+ * 根据端点创建监听套接字
+ *
+ * 调用前需要已经调用 WSAStartup()
+ *
+ * @param   endpoint        端点
+ * @param   allowRemote     是否允许监听非回环地址 (即允许其他主机连接)
+ *
+ * @return  成功时返回套接字，失败时返回 INVALID_SOCKET
+ */
+SOCKET SocketEndpoint_listen(const TCHAR *endpoint, bool allowRemote);
+
+/**
+ * 连接到端点
+ *
+ * 调用前需要已经调用 WSAStartup()
+ *
+ * @param   endpoint        端点
+ *
+ * @return  成功时返回套接字，失败时返回 INVALID_SOCKET
+ */
+SOCKET SocketEndpoint_connect(const TCHAR *endpoint);
+
+/**
+ * 发送数据，直到全部发送完成
+ *
+ * @return  成功时返回 true, 失败 (连接断开等) 时返回 false
+ */
+bool SocketEndpoint_sendAll(SOCKET socket, const void *data, int64_t size);
+
+/**
+ * 接收指定大小的数据，直到全部接收完成
+ *
+ * @return  成功时返回 true, 失败 (连接断开、超时等) 时返回 false
+ */
+bool SocketEndpoint_receiveAll(SOCKET socket, void *buffer, int64_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SOCKET_ENDPOINT_H_
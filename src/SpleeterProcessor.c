@@ -31,6 +31,7 @@
 #include <assert.h>
 #include "tensorflow/c/c_api.h"
 #include "Common.h"
+#include "Memory.h"
 #include "AudioFileCommon.h"
 #include "AudioFileWriter.h"
 #include "SpleeterProcessor.h"
@@ -60,9 +61,16 @@ static void _noOpDeallocator(void *data, size_t a, void *b) {
 }
 
 static bool _getModelFolderPath(const TCHAR *modelName, char **out_modelFolderPath_utf8, char **out_savedModelFileName) {
-    // 获取程序可执行文件的完整路径
+    // 获取当前模块的句柄 (作为库使用时为 DLL 本身，而不是调用它的可执行文件)
+    HMODULE currentModule = NULL;
+    if (!GetModuleHandleEx((GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT),
+            (LPCTSTR)&_getModelFolderPath, &currentModule)) {
+        currentModule = NULL;
+    }
+
+    // 获取程序可执行文件 (或 DLL) 的完整路径
     TCHAR programFolderPath[FILE_PATH_MAX_SIZE] = { 0 };
-    if (GetModuleFileName(NULL, programFolderPath, FILE_PATH_MAX_SIZE) == 0) {
+    if (GetModuleFileName(currentModule, programFolderPath, FILE_PATH_MAX_SIZE) == 0) {
         MSG_ERROR(_T("GetModuleFileName() failed\n"));
         return false;
     }
@@ -178,22 +186,17 @@ const SpleeterModelInfo *SpleeterProcessor_getModelInfo(const TCHAR *modelName)
     return NULL;
 }
 
-int SpleeterProcessor_split(const TCHAR *modelName, AudioDataSource *audioDataSource, SpleeterProcessorResult **resultOut) {
-    SpleeterProcessorResult *result = NULL;
+SpleeterModel *SpleeterModel_load(const TCHAR *modelName) {
+    SpleeterModel *obj = NULL;
 
     char *modelFolderPath_utf8 = NULL;
     char *savedModelFileName_utf8 = NULL;
 
-    SpleeterModelAudioSampleValue_t *outputSampleValuesBufferList[SPLEETER_MODEL_MAX_OUTPUT_COUNT] = { 0 };
-
     TF_Status *status = NULL;
-    TF_Graph *graph = NULL;
-    TF_SessionOptions *sessionOptions = NULL;
     TF_Buffer *runOptions = NULL;
     TF_Buffer *metaGraphDef = NULL;
-    TF_Session *session = NULL;
 
-    //////////////////////////////// Check Input ////////////////////////////////
+    bool succeeded = false;
 
     const SpleeterModelInfo *modelInfo = SpleeterProcessor_getModelInfo(modelName);
     if (modelInfo == NULL) {
@@ -205,39 +208,9 @@ int SpleeterProcessor_split(const TCHAR *modelName, AudioDataSource *audioDataSo
         goto clean_up;
     }
 
-    if (audioDataSource->channelCount != SPLEETER_MODEL_AUDIO_CHANNEL_COUNT) {
-        MSG_ERROR(_T("wrong channel count: %d\n"), audioDataSource->channelCount);
-        goto clean_up;
-    }
-
-    if (audioDataSource->sampleRate != SPLEETER_MODEL_AUDIO_SAMPLE_RATE) {
-        MSG_ERROR(_T("wrong sample rate: %d\n"), audioDataSource->sampleRate);
-        goto clean_up;
-    }
-
-    if (audioDataSource->sampleValues == NULL) {
-        MSG_ERROR(_T("audioDataSource->sampleValues is NULL\n"));
-        goto clean_up;
-    }
-
-    if (audioDataSource->sampleCountPerChannel <= 0) {
-        MSG_ERROR(_T("audioDataSource->sampleCountPerChannel is less than or equal to 0\n"));
-        goto clean_up;
-    }
-
-    //////////////////////////////// Prepare Input ////////////////////////////////
-
-    SpleeterModelAudioSampleValue_t *intputSampleValuesInterlaced = audioDataSource->sampleValues;
-    int inputSampleCountPerChannel = audioDataSource->sampleCountPerChannel;
-
-    //////////////////////////////// Allocate Buffers ////////////////////////////////
-
-    for (int i = 0; i < modelInfo->outputCount; i++) {
-        outputSampleValuesBufferList[i] = MEMORY_ALLOC_ARRAY(SpleeterModelAudioSampleValue_t,
-                (inputSampleCountPerChannel * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT));
-    }
-
-    //////////////////////////////// Load Session ////////////////////////////////
+    obj = MEMORY_ALLOC_STRUCT(SpleeterModel);
+    obj->modelName = _tcsdup(modelName);
+    obj->modelInfo = modelInfo;
 
     Common_updateProgress(STAGE_SPLEETER_PROCESSOR_LOAD_MODEL, 0, 1);
 
@@ -283,20 +256,20 @@ int SpleeterProcessor_split(const TCHAR *modelName, AudioDataSource *audioDataSo
 
     status = TF_NewStatus();
 
-    graph = TF_NewGraph();
-    sessionOptions = TF_NewSessionOptions();
+    obj->_graph = TF_NewGraph();
+    obj->_sessionOptions = TF_NewSessionOptions();
 
     runOptions = TF_NewBuffer();
     metaGraphDef = TF_NewBuffer();
 
     const char *tags[] = { "serve" };
 
-    session = TF_LoadSessionFromSavedModel(
-        sessionOptions,         // session_options
+    obj->_session = TF_LoadSessionFromSavedModel(
+        obj->_sessionOptions,   // session_options
         runOptions,             // run_options
         modelFolderPath_utf8,   // export_dir
         tags, 1,                // tags, tags_len
-        graph,                  // graph
+        obj->_graph,            // graph
         metaGraphDef,           // meta_graph_def
         status                  // status
     );
@@ -306,168 +279,408 @@ int SpleeterProcessor_split(const TCHAR *modelName, AudioDataSource *audioDataSo
         goto clean_up;
     }
 
+    //////////////////////////////// Input & Output ////////////////////////////////
+
+    obj->_input.oper = TF_GraphOperationByName(obj->_graph, "input_waveform");
+    obj->_input.index = 0;
+    if (obj->_input.oper == NULL) {
+        MSG_ERROR(_T("Cannot find input tensor by name \"input_waveform\".\n"));
+        goto clean_up;
+    }
+
+    for (int i = 0; i < modelInfo->outputCount; i++) {
+        obj->_outputs[i].oper = TF_GraphOperationByName(obj->_graph, modelInfo->outputNames[i]);
+        obj->_outputs[i].index = 0;
+        if (obj->_outputs[i].oper == NULL) {
+            MSG_ERROR(_T("Cannot find output tensor by name \"") _T(A_STR_FMT) _T("\".\n"), modelInfo->outputNames[i]);
+            goto clean_up;
+        }
+    }
+
     Common_updateProgress(STAGE_SPLEETER_PROCESSOR_LOAD_MODEL, 1, 1);
 
-    //////////////////////////////// Segmented Processing ////////////////////////////////
+    succeeded = true;
+
+clean_up:
+
+    if (runOptions != NULL) {
+        TF_DeleteBuffer(runOptions);
+    }
+    if (metaGraphDef != NULL) {
+        TF_DeleteBuffer(metaGraphDef);
+    }
+
+    if (status != NULL) {
+        TF_DeleteStatus(status);
+    }
+
+    if (savedModelFileName_utf8 != NULL) {
+        Memory_free(&savedModelFileName_utf8);
+    }
+    if (modelFolderPath_utf8 != NULL) {
+        Memory_free(&modelFolderPath_utf8);
+    }
+
+    if (!succeeded && (obj != NULL)) {
+        SpleeterModel_free(&obj);
+    }
+
+    return obj;
+}
+
+void SpleeterModel_free(SpleeterModel **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return;
+    }
 
-    int segmentCount = (inputSampleCountPerChannel + (SLICE_LENGTH - 1)) / SLICE_LENGTH;
+    SpleeterModel *obj = *objPtr;
 
-    if (segmentCount >= 2) {
-        int lastSegmentLength = inputSampleCountPerChannel - (SLICE_LENGTH * (segmentCount - 1));
+    TF_Status *status = TF_NewStatus();
+
+    if (obj->_session != NULL) {
+        TF_CloseSession(obj->_session, status);
+        if (TF_GetCode(status) != TF_OK) {
+            MSG_ERROR(_T("TF_CloseSession() failed: ") _T(A_STR_FMT) _T("\n"), TF_Message(status));
+        }
 
-        if (lastSegmentLength < LAST_SEGMENT_MIN_LENGTH) {
-            segmentCount--;
+        TF_DeleteSession(obj->_session, status);
+        if (TF_GetCode(status) != TF_OK) {
+            MSG_ERROR(_T("TF_DeleteSession() failed: ") _T(A_STR_FMT) _T("\n"), TF_Message(status));
         }
     }
 
-    for (int segmentIndex = 0; segmentIndex < segmentCount; segmentIndex++) {
-        int currentOffset = SLICE_LENGTH * segmentIndex;
+    TF_DeleteStatus(status);
+
+    if (obj->_sessionOptions != NULL) {
+        TF_DeleteSessionOptions(obj->_sessionOptions);
+    }
+    if (obj->_graph != NULL) {
+        TF_DeleteGraph(obj->_graph);
+    }
 
-        int extendLengthAtBegin = (segmentIndex == 0) ? 0 : EXTEND_LENGTH;
-        int extendLengthAtEnd = (segmentIndex == (segmentCount - 1)) ? 0 : EXTEND_LENGTH;
+    if (obj->modelName != NULL) {
+        Memory_free(&obj->modelName);
+    }
 
-        int regionUseLength = (segmentIndex == (segmentCount - 1)) ? (inputSampleCountPerChannel - currentOffset) : SLICE_LENGTH;
-        int regionUseStart = extendLengthAtBegin;
+    Memory_free(objPtr);
+}
 
-        int regionWaveformOffset = currentOffset - extendLengthAtBegin;
-        int regionWaveformLength = min((extendLengthAtBegin + regionUseLength + extendLengthAtEnd), (inputSampleCountPerChannel - regionWaveformOffset));
+void SpleeterProcessor_getSliceParameters(int *sliceLengthOut, int *extendLengthOut, int *lastSegmentMinLengthOut) {
+    *sliceLengthOut = SLICE_LENGTH;
+    *extendLengthOut = EXTEND_LENGTH;
+    *lastSegmentMinLengthOut = LAST_SEGMENT_MIN_LENGTH;
+}
 
-        MSG_DEBUG(_T("Region: %3d, %3d; %3d, %3d\n"),
-                (regionWaveformOffset / SPLEETER_MODEL_AUDIO_SAMPLE_RATE),
-                (regionWaveformLength / SPLEETER_MODEL_AUDIO_SAMPLE_RATE),
-                (regionUseStart / SPLEETER_MODEL_AUDIO_SAMPLE_RATE),
-                (regionUseLength / SPLEETER_MODEL_AUDIO_SAMPLE_RATE));
+int SpleeterProcessor_getRegionCount(int sampleCountPerChannel) {
+    if (sampleCountPerChannel <= 0) {
+        return 0;
+    }
 
-        //////////////////////////////// Input ////////////////////////////////
+    int regionCount = (sampleCountPerChannel + (SLICE_LENGTH - 1)) / SLICE_LENGTH;
 
-        TF_Output inputs[1] = { 0 };
+    if (regionCount >= 2) {
+        int lastRegionLength = sampleCountPerChannel - (SLICE_LENGTH * (regionCount - 1));
 
-        inputs[0].oper = TF_GraphOperationByName(graph, "input_waveform");
-        inputs[0].index = 0;
-        if (inputs[0].oper == NULL) {
-            MSG_ERROR(_T("Cannot find input tensor by name \"input_waveform\".\n"));
-            goto clean_up;
+        if (lastRegionLength < LAST_SEGMENT_MIN_LENGTH) {
+            regionCount--;
         }
+    }
+
+    return regionCount;
+}
+
+void SpleeterProcessor_getRegion(int sampleCountPerChannel, int regionIndex, SpleeterProcessorRegion *regionOut) {
+    int regionCount = SpleeterProcessor_getRegionCount(sampleCountPerChannel);
 
-        int64_t inputDims[] = { regionWaveformLength, SPLEETER_MODEL_AUDIO_CHANNEL_COUNT };
+    int currentOffset = SLICE_LENGTH * regionIndex;
 
-        void *inputData = intputSampleValuesInterlaced + (regionWaveformOffset * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT);
-        size_t inputDataLength = inputDims[0] * inputDims[1] * sizeof(SpleeterModelAudioSampleValue_t);
+    int extendLengthAtBegin = (regionIndex == 0) ? 0 : EXTEND_LENGTH;
+    int extendLengthAtEnd = (regionIndex == (regionCount - 1)) ? 0 : EXTEND_LENGTH;
 
-        TF_Tensor *inputTensors[1] = { NULL };
-        inputTensors[0] = TF_NewTensor(
-            TF_FLOAT,                       // data_type
-            inputDims, 2,                   // dims, num_dims
-            inputData, inputDataLength,     // data, len
-            &_noOpDeallocator, NULL         // deallocator, deallocator_arg
-        );
+    int regionUseLength = (regionIndex == (regionCount - 1)) ? (sampleCountPerChannel - currentOffset) : SLICE_LENGTH;
 
-        //////////////////////////////// Output ////////////////////////////////
+    int regionWaveformOffset = currentOffset - extendLengthAtBegin;
+    int regionWaveformLength = min((extendLengthAtBegin + regionUseLength + extendLengthAtEnd), (sampleCountPerChannel - regionWaveformOffset));
 
-        TF_Output outputs[SPLEETER_MODEL_MAX_OUTPUT_COUNT] = { 0 };
+    regionOut->offset = currentOffset;
+    regionOut->length = regionUseLength;
+    regionOut->waveformOffset = regionWaveformOffset;
+    regionOut->waveformLength = regionWaveformLength;
+}
+
+/**
+ * 对单个分段运行模型，成功时 outputTensors 中为各音轨的输出张量 (包含前后扩展部分)，由调用者释放
+ */
+static bool _runRegion(SpleeterModel *model, const SpleeterModelAudioSampleValue_t *inputSampleValuesInterlaced,
+        const SpleeterProcessorRegion *region, TF_Status *status, TF_Tensor **outputTensors) {
+    const SpleeterModelInfo *modelInfo = model->modelInfo;
+
+    MSG_DEBUG(_T("Region: %3d, %3d; %3d, %3d\n"),
+            (region->waveformOffset / SPLEETER_MODEL_AUDIO_SAMPLE_RATE),
+            (region->waveformLength / SPLEETER_MODEL_AUDIO_SAMPLE_RATE),
+            ((region->offset - region->waveformOffset) / SPLEETER_MODEL_AUDIO_SAMPLE_RATE),
+            (region->length / SPLEETER_MODEL_AUDIO_SAMPLE_RATE));
+
+    //////////////////////////////// Input ////////////////////////////////
+
+    int64_t inputDims[] = { region->waveformLength, SPLEETER_MODEL_AUDIO_CHANNEL_COUNT };
+
+    void *inputData = (void *)(inputSampleValuesInterlaced + (region->waveformOffset * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT));
+    size_t inputDataLength = inputDims[0] * inputDims[1] * sizeof(SpleeterModelAudioSampleValue_t);
+
+    TF_Tensor *inputTensors[1] = { NULL };
+    inputTensors[0] = TF_NewTensor(
+        TF_FLOAT,                       // data_type
+        inputDims, 2,                   // dims, num_dims
+        inputData, inputDataLength,     // data, len
+        &_noOpDeallocator, NULL         // deallocator, deallocator_arg
+    );
+
+    //////////////////////////////// Output ////////////////////////////////
+
+    for (int i = 0; i < modelInfo->outputCount; i++) {
+        outputTensors[i] = NULL;
+    }
+
+    //////////////////////////////// Run Session ////////////////////////////////
+
+    TF_SessionRun(
+        model->_session,    // session
+        NULL,               // run_options
+        &model->_input, inputTensors, 1,                            // inputs, input_values, ninputs
+        model->_outputs, outputTensors, modelInfo->outputCount,     // outputs, output_values, noutputs
+        NULL, 0,            // target_opers, ntargets
+        NULL,               // run_metadata
+        status              // output_status
+    );
+
+    TF_DeleteTensor(inputTensors[0]);
+
+    if (TF_GetCode(status) != TF_OK) {
+        MSG_ERROR(_T("TF_SessionRun() failed: ") _T(A_STR_FMT) _T("\n"), TF_Message(status));
 
         for (int i = 0; i < modelInfo->outputCount; i++) {
-            outputs[i].oper = TF_GraphOperationByName(graph, modelInfo->outputNames[i]);
-            outputs[i].index = 0;
-            if (outputs[i].oper == NULL) {
-                MSG_ERROR(_T("Cannot find output tensor by name \"") _T(A_STR_FMT) _T("\".\n"), modelInfo->outputNames[i]);
-                goto clean_up;
+            if (outputTensors[i] != NULL) {
+                TF_DeleteTensor(outputTensors[i]);
+                outputTensors[i] = NULL;
             }
         }
 
-        TF_Tensor *outputTensors[SPLEETER_MODEL_MAX_OUTPUT_COUNT] = { 0 };
-        for (int i = 0; i < modelInfo->outputCount; i++) {
-            outputTensors[i] = NULL;
-        }
+        return false;
+    }
 
-        //////////////////////////////// Run Session ////////////////////////////////
+    return true;
+}
 
-        TF_SessionRun(
-            session,            // session
-            NULL,               // run_options
-            inputs, inputTensors, 1,                            // inputs, input_values, ninputs
-            outputs, outputTensors, modelInfo->outputCount,     // outputs, output_values, noutputs
-            NULL, 0,            // target_opers, ntargets
-            NULL,               // run_metadata
-            status              // output_status
-        );
+/**
+ * 检查输入音频数据源是否符合模型的要求
+ */
+static bool _checkAudioDataSource(const AudioDataSource *audioDataSource) {
+    if (audioDataSource->channelCount != SPLEETER_MODEL_AUDIO_CHANNEL_COUNT) {
+        MSG_ERROR(_T("wrong channel count: %d\n"), audioDataSource->channelCount);
+        return false;
+    }
 
-        if (TF_GetCode(status) != TF_OK) {
-            MSG_ERROR(_T("TF_SessionRun() failed: ") _T(A_STR_FMT) _T("\n"), TF_Message(status));
-            goto clean_up;
-        }
+    if (audioDataSource->sampleRate != SPLEETER_MODEL_AUDIO_SAMPLE_RATE) {
+        MSG_ERROR(_T("wrong sample rate: %d\n"), audioDataSource->sampleRate);
+        return false;
+    }
 
-        //////////////////////////////// Process Result ////////////////////////////////
+    if (audioDataSource->sampleValues == NULL) {
+        MSG_ERROR(_T("audioDataSource->sampleValues is NULL\n"));
+        return false;
+    }
 
-        for (int i = 0; i < modelInfo->outputCount; i++) {
-            SpleeterModelAudioSampleValue_t *outputSampleValues = (SpleeterModelAudioSampleValue_t *)TF_TensorData(outputTensors[i]);
-            memcpy((outputSampleValuesBufferList[i] + (currentOffset * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)), (outputSampleValues + (regionUseStart * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)),
-                    (regionUseLength * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT * sizeof(SpleeterModelAudioSampleValue_t)));
-            TF_DeleteTensor(outputTensors[i]);
-        }
+    if (audioDataSource->sampleCountPerChannel <= 0) {
+        MSG_ERROR(_T("audioDataSource->sampleCountPerChannel is less than or equal to 0\n"));
+        return false;
+    }
+
+    return true;
+}
+
+int SpleeterProcessor_processRegion(SpleeterModel *model, AudioDataSource *audioDataSource,
+        const SpleeterProcessorRegion *region, SpleeterProcessorResult *result) {
+    if ((model == NULL) || (result == NULL)) {
+        MSG_ERROR(_T("model or result is NULL\n"));
+        return -1;
+    }
 
-        Common_updateProgress(STAGE_SPLEETER_PROCESSOR_PROCESS_SEGMENT, (currentOffset + regionUseLength), inputSampleCountPerChannel);
+    if (!_checkAudioDataSource(audioDataSource)) {
+        return -1;
     }
 
-    //////////////////////////////// Create Result ////////////////////////////////
+    const SpleeterModelInfo *modelInfo = model->modelInfo;
+
+    // TF_Status 不是线程安全的，每次调用使用独立的实例，使多个线程可以同时处理不同的分段
+    TF_Status *status = TF_NewStatus();
+
+    TF_Tensor *outputTensors[SPLEETER_MODEL_MAX_OUTPUT_COUNT] = { 0 };
+    if (!_runRegion(model, audioDataSource->sampleValues, region, status, outputTensors)) {
+        TF_DeleteStatus(status);
+        return -1;
+    }
 
-    result = MEMORY_ALLOC_STRUCT(SpleeterProcessorResult);
+    int regionUseStart = region->offset - region->waveformOffset;
 
     for (int i = 0; i < modelInfo->outputCount; i++) {
-        result->trackList[i].trackName = _tcsdup(modelInfo->trackNames[i]);
-        result->trackList[i].audioDataSource = _createAudioDataSource(outputSampleValuesBufferList[i], inputSampleCountPerChannel);
+        const SpleeterModelAudioSampleValue_t *outputSampleValues = (const SpleeterModelAudioSampleValue_t *)TF_TensorData(outputTensors[i]);
+
+        // 各分段写入结果中互不重叠的部分，因此不需要加锁
+        memcpy((result->trackList[i].audioDataSource->sampleValues + (region->offset * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)),
+                (outputSampleValues + (regionUseStart * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)),
+                (region->length * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT * sizeof(SpleeterModelAudioSampleValue_t)));
+
+        TF_DeleteTensor(outputTensors[i]);
     }
 
-    result->trackCount = modelInfo->outputCount;
+    TF_DeleteStatus(status);
 
-    //////////////////////////////// Clean Up ////////////////////////////////
+    return 0;
+}
 
-clean_up:
+int SpleeterProcessor_splitWithModel(SpleeterModel *model, AudioDataSource *audioDataSource, SpleeterProcessorResult **resultOut) {
+    return SpleeterProcessor_splitWithCallback(model, audioDataSource, NULL, NULL, resultOut);
+}
 
-    if (session != NULL) {
-        TF_CloseSession(session, status);
-        if (TF_GetCode(status) != TF_OK) {
-            MSG_ERROR(_T("TF_CloseSession() failed: ") _T(A_STR_FMT) _T("\n"), TF_Message(status));
-        }
+int SpleeterProcessor_splitWithCallback(SpleeterModel *model, AudioDataSource *audioDataSource,
+        SpleeterProcessorSegmentCallback segmentCallback, void *userData, SpleeterProcessorResult **resultOut) {
+    SpleeterProcessorResult *result = NULL;
+    bool succeeded = false;
 
-        TF_DeleteSession(session, status);
-        if (TF_GetCode(status) != TF_OK) {
-            MSG_ERROR(_T("TF_DeleteSession() failed: ") _T(A_STR_FMT) _T("\n"), TF_Message(status));
-        }
-    }
+    // TF_Status 不是线程安全的，每次分离使用独立的实例，使同一个模型可以被多个线程同时使用
+    TF_Status *status = NULL;
 
-    if (sessionOptions != NULL) {
-        TF_DeleteSessionOptions(sessionOptions);
+    //////////////////////////////// Check Input ////////////////////////////////
+
+    if (model == NULL) {
+        MSG_ERROR(_T("model is NULL\n"));
+        goto clean_up;
     }
-    if (graph != NULL) {
-        TF_DeleteGraph(graph);
+
+    const SpleeterModelInfo *modelInfo = model->modelInfo;
+
+    if (!_checkAudioDataSource(audioDataSource)) {
+        goto clean_up;
     }
 
-    if (runOptions != NULL) {
-        TF_DeleteBuffer(runOptions);
+    //////////////////////////////// Prepare Input ////////////////////////////////
+
+    SpleeterModelAudioSampleValue_t *intputSampleValuesInterlaced = audioDataSource->sampleValues;
+    int inputSampleCountPerChannel = audioDataSource->sampleCountPerChannel;
+
+    //////////////////////////////// Allocate Buffers ////////////////////////////////
+
+    // 只通过回调函数获取结果时，不需要分配保存完整结果的 buffer
+    if (resultOut != NULL) {
+        result = SpleeterProcessorResult_alloc(modelInfo, inputSampleCountPerChannel);
     }
-    if (metaGraphDef != NULL) {
-        TF_DeleteBuffer(metaGraphDef);
+
+    status = TF_NewStatus();
+
+    //////////////////////////////// Segmented Processing ////////////////////////////////
+
+    int segmentCount = SpleeterProcessor_getRegionCount(inputSampleCountPerChannel);
+
+    for (int segmentIndex = 0; segmentIndex < segmentCount; segmentIndex++) {
+        SpleeterProcessorRegion region;
+        SpleeterProcessor_getRegion(inputSampleCountPerChannel, segmentIndex, &region);
+
+        int regionUseStart = region.offset - region.waveformOffset;
+
+        TF_Tensor *outputTensors[SPLEETER_MODEL_MAX_OUTPUT_COUNT] = { 0 };
+        if (!_runRegion(model, intputSampleValuesInterlaced, &region, status, outputTensors)) {
+            goto clean_up;
+        }
+
+        //////////////////////////////// Process Result ////////////////////////////////
+
+        SpleeterProcessorSegment segment = {
+            .offset = region.offset,
+            .length = region.length,
+            .trackCount = modelInfo->outputCount
+        };
+
+        for (int i = 0; i < modelInfo->outputCount; i++) {
+            SpleeterModelAudioSampleValue_t *outputSampleValues = (SpleeterModelAudioSampleValue_t *)TF_TensorData(outputTensors[i]);
+            segment.trackSampleValues[i] = outputSampleValues + (regionUseStart * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT);
+
+            if (result != NULL) {
+                memcpy((result->trackList[i].audioDataSource->sampleValues + (region.offset * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT)),
+                        segment.trackSampleValues[i],
+                        (region.length * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT * sizeof(SpleeterModelAudioSampleValue_t)));
+            }
+        }
+
+        // 回调函数直接使用输出张量中的数据，之后才释放输出张量
+        bool toContinue = true;
+        if (segmentCallback != NULL) {
+            toContinue = segmentCallback(userData, &segment);
+        }
+
+        for (int i = 0; i < modelInfo->outputCount; i++) {
+            TF_DeleteTensor(outputTensors[i]);
+        }
+
+        if (!toContinue) {
+            MSG_DEBUG(_T("Processing aborted by segment callback\n"));
+            goto clean_up;
+        }
+
+        Common_updateProgress(STAGE_SPLEETER_PROCESSOR_PROCESS_SEGMENT, (region.offset + region.length), inputSampleCountPerChannel);
     }
 
+    succeeded = true;
+
+    //////////////////////////////// Clean Up ////////////////////////////////
+
+clean_up:
+
     if (status != NULL) {
         TF_DeleteStatus(status);
     }
 
-    if (savedModelFileName_utf8 != NULL) {
-        Memory_free(&savedModelFileName_utf8);
+    if (!succeeded) {
+        // 有错误产生
+        if (result != NULL) {
+            SpleeterProcessorResult_free(&result);
+        }
+        return -1;
     }
-    if (modelFolderPath_utf8 != NULL) {
-        Memory_free(&modelFolderPath_utf8);
+
+    if (resultOut != NULL) {
+        *resultOut = result;
     }
+    return 0;
+}
 
-    if (result == NULL) {
-        // 有错误产生
+int SpleeterProcessor_split(const TCHAR *modelName, AudioDataSource *audioDataSource, SpleeterProcessorResult **resultOut) {
+    SpleeterModel *model = SpleeterModel_load(modelName);
+    if (model == NULL) {
         return -1;
     }
 
-    *resultOut = result;
-    return 0;
+    int ret = SpleeterProcessor_splitWithModel(model, audioDataSource, resultOut);
+
+    SpleeterModel_free(&model);
+
+    return ret;
+}
+
+SpleeterProcessorResult *SpleeterProcessorResult_alloc(const SpleeterModelInfo *modelInfo, int sampleCountPerChannel) {
+    SpleeterProcessorResult *result = MEMORY_ALLOC_STRUCT(SpleeterProcessorResult);
+
+    for (int i = 0; i < modelInfo->outputCount; i++) {
+        SpleeterModelAudioSampleValue_t *sampleValues = MEMORY_ALLOC_ARRAY(SpleeterModelAudioSampleValue_t,
+                (sampleCountPerChannel * SPLEETER_MODEL_AUDIO_CHANNEL_COUNT));
+
+        result->trackList[i].trackName = _tcsdup(modelInfo->trackNames[i]);
+        result->trackList[i].audioDataSource = _createAudioDataSource(sampleValues, sampleCountPerChannel);
+    }
+
+    result->trackCount = modelInfo->outputCount;
+
+    return result;
 }
 
 SpleeterProcessorResultTrack *SpleeterProcessorResult_getTrack(SpleeterProcessorResult *obj, const TCHAR *trackName) {
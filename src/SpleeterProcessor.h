@@ -25,6 +25,7 @@
 #ifndef _SPLEETER_PROCESSOR_H_
 #define _SPLEETER_PROCESSOR_H_
 
+#include "tensorflow/c/c_api.h"
 #include "Common.h"
 #include "AudioFile.h"
 
@@ -69,6 +70,86 @@ typedef struct {
     int                             trackCount;
 } SpleeterProcessorResult;
 
+/**
+ * 分离过程中的单个分段结果
+ */
+typedef struct {
+    /** 分段在整个音频中的起始位置 (每声道样本数) */
+    int                                     offset;
+
+    /** 分段的长度 (每声道样本数) */
+    int                                     length;
+
+    /** 音轨数量 */
+    int                                     trackCount;
+
+    /** 各音轨在该分段中的样本值 (声道交错存储，仅在回调函数执行期间有效) */
+    const SpleeterModelAudioSampleValue_t   *trackSampleValues[SPLEETER_MODEL_MAX_OUTPUT_COUNT];
+} SpleeterProcessorSegment;
+
+/**
+ * 分段 (region) 的位置信息
+ *
+ * 长音频被切分为多个分段分别送入模型，每个分段前后各扩展一部分波形作为上下文，但只使用中间的有效部分
+ */
+typedef struct {
+    /** 有效部分在整个音频中的起始位置 (每声道样本数) */
+    int         offset;
+
+    /** 有效部分的长度 (每声道样本数) */
+    int         length;
+
+    /** 送入模型的波形 (包含前后扩展部分) 在整个音频中的起始位置 (每声道样本数) */
+    int         waveformOffset;
+
+    /** 送入模型的波形的长度 (每声道样本数) */
+    int         waveformLength;
+} SpleeterProcessorRegion;
+
+/**
+ * 分段结果回调函数
+ *
+ * @param   userData            调用时传入的用户数据
+ * @param   segment             分段结果
+ *
+ * @return  返回 true 继续处理，返回 false 中止处理
+ */
+typedef bool (*SpleeterProcessorSegmentCallback)(void *userData, const SpleeterProcessorSegment *segment);
+
+/**
+ * 已加载的 Spleeter 模型
+ *
+ * 加载一次后可重复用于处理多个音频数据源，避免每次处理都重新加载模型和初始化 TensorFlow 线程池
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 public 成员，只读
+
+    /** 模型名称 ("2stems", "4stems", "5stems-16khz" 等) */
+    TCHAR                       *modelName;
+
+    /** 模型信息 */
+    const SpleeterModelInfo     *modelInfo;
+
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 计算图 */
+    TF_Graph                    *_graph;
+
+    /** 会话选项 */
+    TF_SessionOptions           *_sessionOptions;
+
+    /** 会话 */
+    TF_Session                  *_session;
+
+    /** 输入张量 */
+    TF_Output                   _input;
+
+    /** 输出张量列表 */
+    TF_Output                   _outputs[SPLEETER_MODEL_MAX_OUTPUT_COUNT];
+} SpleeterModel;
+
 /**
  * 根据 Spleeter 模型的目录名称获取模型信息
  *
@@ -79,7 +160,92 @@ typedef struct {
 const SpleeterModelInfo *SpleeterProcessor_getModelInfo(const TCHAR *modelName);
 
 /**
- * 使用 Spleeter 模型对音频进行分离
+ * 加载 Spleeter 模型
+ *
+ * @param   modelName           要加载的模型名称 ("2stems", "4stems", "5stems-16khz" 等)
+ *
+ * @return  成功时返回指向已加载 SpleeterModel 结构体的指针，失败时返回 NULL
+ */
+SpleeterModel *SpleeterModel_load(const TCHAR *modelName);
+
+/**
+ * 释放已加载的 Spleeter 模型
+ *
+ * @param   objPtr              指向 SpleeterModel 结构体的指针的指针
+ */
+void SpleeterModel_free(SpleeterModel **objPtr);
+
+/**
+ * 使用已加载的 Spleeter 模型对音频进行分离
+ *
+ * @param   model               已加载的模型
+ * @param   audioDataSource     输入音频数据源
+ * @param   resultOut           分离结果
+ *
+ * @return  成功时返回 0, 失败时返回小于 0 的错误码
+ */
+int SpleeterProcessor_splitWithModel(SpleeterModel *model, AudioDataSource *audioDataSource, SpleeterProcessorResult **resultOut);
+
+/**
+ * 使用已加载的 Spleeter 模型对音频进行分离，每完成一个分段即调用回调函数
+ *
+ * 分段按顺序完成，各分段首尾相接，可直接拼接为完整的音轨
+ *
+ * @param   model               已加载的模型
+ * @param   audioDataSource     输入音频数据源
+ * @param   segmentCallback     分段结果回调函数，可为 NULL
+ * @param   userData            传递给回调函数的用户数据
+ * @param   resultOut           分离结果，为 NULL 时不保存完整的分离结果 (仅通过回调函数获取)
+ *
+ * @return  成功时返回 0, 失败时返回小于 0 的错误码
+ */
+int SpleeterProcessor_splitWithCallback(SpleeterModel *model, AudioDataSource *audioDataSource,
+        SpleeterProcessorSegmentCallback segmentCallback, void *userData, SpleeterProcessorResult **resultOut);
+
+/**
+ * 获取分段处理所使用的参数 (影响分离结果，可用于判断缓存的结果是否仍然有效)
+ *
+ * @param   sliceLengthOut              每个分段有效部分的长度 (每声道样本数)
+ * @param   extendLengthOut             每个分段前后扩展部分的长度 (每声道样本数)
+ * @param   lastSegmentMinLengthOut     最后一个分段的最小长度 (更短时合并到前一个分段中)
+ */
+void SpleeterProcessor_getSliceParameters(int *sliceLengthOut, int *extendLengthOut, int *lastSegmentMinLengthOut);
+
+/**
+ * 获取指定长度的音频被切分成的分段数量
+ *
+ * @param   sampleCountPerChannel   音频的长度 (每声道样本数)
+ *
+ * @return  分段数量
+ */
+int SpleeterProcessor_getRegionCount(int sampleCountPerChannel);
+
+/**
+ * 获取指定长度的音频中第 regionIndex 个分段的位置信息
+ *
+ * @param   sampleCountPerChannel   音频的长度 (每声道样本数)
+ * @param   regionIndex             分段序号，从 0 开始
+ * @param   regionOut               分段的位置信息
+ */
+void SpleeterProcessor_getRegion(int sampleCountPerChannel, int regionIndex, SpleeterProcessorRegion *regionOut);
+
+/**
+ * 使用已加载的 Spleeter 模型处理单个分段，并将结果写入 result 中对应的位置
+ *
+ * 不同分段写入的位置互不重叠，因此同一音频的多个分段可以在多个线程中同时处理
+ *
+ * @param   model               已加载的模型
+ * @param   audioDataSource     输入音频数据源
+ * @param   region              要处理的分段
+ * @param   result              通过 SpleeterProcessorResult_alloc() 分配的分离结果
+ *
+ * @return  成功时返回 0, 失败时返回小于 0 的错误码
+ */
+int SpleeterProcessor_processRegion(SpleeterModel *model, AudioDataSource *audioDataSource,
+        const SpleeterProcessorRegion *region, SpleeterProcessorResult *result);
+
+/**
+ * 使用 Spleeter 模型对音频进行分离 (加载模型，分离，然后释放模型)
  *
  * @param   modelName           要使用的模型名称 ("2stems", "4stems", "5stems-16khz" 等)
  * @param   audioDataSource     输入音频数据源
@@ -89,6 +255,16 @@ const SpleeterModelInfo *SpleeterProcessor_getModelInfo(const TCHAR *modelName);
  */
 int SpleeterProcessor_split(const TCHAR *modelName, AudioDataSource *audioDataSource, SpleeterProcessorResult **resultOut);
 
+/**
+ * 分配用于保存分离结果的 SpleeterProcessorResult 结构体，以及各音轨的音频数据 buffer
+ *
+ * @param   modelInfo               模型信息
+ * @param   sampleCountPerChannel   音频的长度 (每声道样本数)
+ *
+ * @return  指向 SpleeterProcessorResult 结构体的指针
+ */
+SpleeterProcessorResult *SpleeterProcessorResult_alloc(const SpleeterModelInfo *modelInfo, int sampleCountPerChannel);
+
 /**
  * 根据轨道名称获取 SpleeterProcessorResult 中的轨道
  *
@@ -0,0 +1,1393 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <io.h>
+#include <Windows.h>
+#include <Shlwapi.h>
+#include <process.h>
+#include "Common.h"
+#include "AudioFileWriter.h"
+#include "SampleMixer.h"
+#include "TrackOutput.h"
+
+#pragma comment(lib, "shlwapi.lib")
+
+/** 计算轨道时每次计算的每声道样本数 (计算结果送入编码器时仍在 CPU 缓存中，使用时调整为编码器帧大小的整数倍) */
+#define TRACK_MIX_BLOCK_SAMPLE_COUNT        4096
+
+/** 直接写入需要运算的轨道时，每次写入的每声道样本数 (减少 WriteFile() 的调用次数) */
+#define TRACK_RAW_WRITE_BLOCK_SAMPLE_COUNT  (256 * 1024)
+
+/**
+ * 编译后的轨道运算表达式
+ *
+ * 输出轨道的样本值为各源轨道样本值的加权和 (系数为 --tracks 中指定的浮点数，减去的轨道为负数，未指定时为 1 或 -1)，
+ * 在写入时按块计算，不保存整个轨道的计算结果
+ */
+typedef struct {
+    /** 源轨道数量 */
+    int                             sourceCount;
+
+    /** 各源轨道的样本值 (声道交错存储) */
+    const AudioSampleValue_t        *sourceSampleValues[SOURCE_TRACK_MAX_COUNT];
+
+    /** 各源轨道的系数 (已包含符号，例如 "input-0.8*vocals" 中 vocals 的系数为 -0.8) */
+    float                           sourceGains[SOURCE_TRACK_MAX_COUNT];
+} TrackMixExpression;
+
+/**
+ * 单个输出轨道的写入任务
+ */
+typedef struct {
+    /** 输出文件路径 (写入单个文件时不使用) */
+    TCHAR                       outputFilePath[FILE_PATH_MAX_SIZE];
+
+    /** 输出轨道名称 */
+    const TCHAR                 *trackName;
+
+    /** 输出轨道的样本值的计算方式 (不需要运算时只有一个系数为 1 的源轨道) */
+    TrackMixExpression          expression;
+} TrackOutputWriteJob;
+
+/**
+ * 同时写入多个输出轨道时各线程共享的状态
+ */
+typedef struct {
+    /** 输出配置 */
+    const TrackOutputConfig     *config;
+
+    /** 输入音频数据源 (用于 "input" 轨道) */
+    AudioDataSource             *inputAudioDataSource;
+
+    /** 写入任务列表 */
+    TrackOutputWriteJob         *jobs;
+
+    /** 写入任务数量 */
+    int                         jobCount;
+
+    /** 下一个要执行的任务序号 */
+    volatile LONG               nextJobIndex;
+
+    /** 是否有任务失败 */
+    volatile bool               failed;
+
+    /** 保护 completedJobCount 的锁 */
+    CRITICAL_SECTION            lock;
+
+    /** 有任务完成时通知调用者线程 */
+    CONDITION_VARIABLE          jobCompleted;
+
+    /** 已完成 (包括失败和跳过) 的任务数量 */
+    int                         completedJobCount;
+} TrackOutputWriteState;
+
+/**
+ * 在文件路径原有的扩展名前添加额外的扩展名
+ *
+ * 例如对于 srcFilePath = "dir\file.mp3", extraExtension = "vocals", 返回结果为
+ * "dir\file.vocals.mp3"
+ *
+ * @param   destFilePathBuffer              目标文件路径缓冲区
+ * @param   destFilePathBufferCharCount     destFilePathBuffer 所能容纳的字符数
+ * @param   srcFilePath                     原始文件路径
+ * @param   extraExtension                  要添加的额外扩展名 (不包含起始位置的 ".")
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+static bool _addExtraExtensionBeforeOriginalExtension(TCHAR *destFilePathBuffer, size_t destFilePathBufferCharCount,
+        const TCHAR *srcFilePath, const TCHAR *extraExtension) {
+    TCHAR *originalExtension = PathFindExtension(srcFilePath);
+
+    int srcFilePathWithoutExtensionLength = (int)(originalExtension - srcFilePath);
+    if ((srcFilePathWithoutExtensionLength < 0)
+            || (srcFilePathWithoutExtensionLength > (FILE_PATH_MAX_SIZE - 1))) {
+        return false;
+    }
+
+    TCHAR srcFilePathWithoutExtension[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    _tcsncpy(srcFilePathWithoutExtension, srcFilePath, srcFilePathWithoutExtensionLength);
+    srcFilePathWithoutExtension[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+
+    int writtenLength = _sntprintf(destFilePathBuffer, destFilePathBufferCharCount, _T("%s.%s%s"),
+            srcFilePathWithoutExtension, extraExtension, originalExtension);
+    if ((writtenLength >= 0) && (writtenLength < destFilePathBufferCharCount)) {
+        return true;
+    } else {
+        return false;
+    }
+}
+
+/**
+ * 根据输出文件路径格式字符串生成指定轨道对应的输出文件路径
+ *
+ * @param   dest                    用于存储所生成指定轨道对应的输出文件路径的缓冲区 (大小为 FILE_PATH_MAX_SIZE)
+ * @param   src                     输出文件路径格式字符串
+ * @param   inputFileFullPath       输入文件完整路径
+ * @param   trackName               当前轨道名称
+ * @param   outputTrackCount        要输出的所有轨道的数量
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+static bool _convertOutputFilePathFormatString(TCHAR *dest, const TCHAR *src,
+        const TCHAR *inputFileFullPath, const TCHAR *trackName, int outputTrackCount) {
+    TCHAR *destPtr = dest;
+    TCHAR *destEnd = dest + FILE_PATH_MAX_SIZE;
+
+    size_t srcLength = _tcsnlen(src, FILE_PATH_MAX_SIZE);
+    if (srcLength >= FILE_PATH_MAX_SIZE) {
+        MSG_ERROR(_T("The specified output file path format \"%s\" is too long.\n"), src);
+        return false;
+    }
+    const TCHAR *srcEnd = src + srcLength;
+
+    bool containsTrackName = false;
+
+    const TCHAR *srcPtr = src;
+    while (srcPtr < srcEnd) {
+        if ((*srcPtr == _T('$')) && ((srcPtr + 1) < srcEnd) && (*(srcPtr + 1) == _T('('))) {
+            // 遇到了 $(VariableName) 形式变量名的起始部分 "$("
+
+            const TCHAR *variableNameBegin = srcPtr + 2;
+            const TCHAR *variableNameEnd = _tcschr(variableNameBegin, _T(')'));
+            if (variableNameEnd != NULL) {
+                // 查找到了变量名的结束部分 ")"
+
+                // 计算变量名的长度
+                size_t variableNameLength = variableNameEnd - variableNameBegin;
+
+                // 复制变量名到 variableNameBuffer 中，用于后续字符串比较
+                TCHAR variableNameBuffer[FILE_PATH_MAX_SIZE] = { _T('\0') };
+                memcpy(variableNameBuffer, variableNameBegin, variableNameLength * sizeof(TCHAR));
+                variableNameBuffer[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+
+                // 将对应的变量值复制到 variableValueBuffer 中
+                TCHAR variableValueBuffer[FILE_PATH_MAX_SIZE] = { _T('\0') };
+                if (_tcscmp(_T("FullPath"), variableNameBuffer) == 0) {
+                    // 输入文件的完整路径
+                    _tcsncpy(variableValueBuffer, inputFileFullPath, (FILE_PATH_MAX_SIZE - 1));
+                } else if (_tcscmp(_T("DirPath"), variableNameBuffer) == 0) {
+                    // 输入文件所在目录的路径
+                    _tcsncpy(variableValueBuffer, inputFileFullPath, (FILE_PATH_MAX_SIZE - 1));
+                    if (!PathRemoveFileSpec(variableValueBuffer)) {
+                        MSG_ERROR(_T("Failed to call PathRemoveFileSpec()\n"));
+                        return false;
+                    }
+                } else if (_tcscmp(_T("FileName"), variableNameBuffer) == 0) {
+                    TCHAR *inputFileName = PathFindFileName(inputFileFullPath);
+                    if (inputFileName != inputFileFullPath) {
+                        // 输入文件的文件名
+                        _tcsncpy(variableValueBuffer, inputFileName, (FILE_PATH_MAX_SIZE - 1));
+                    } else {
+                        // 查找输入文件路径中的文件名失败
+                        variableValueBuffer[0] = _T('\0');
+                    }
+                } else if (_tcscmp(_T("BaseName"), variableNameBuffer) == 0) {
+                    TCHAR *inputFileName = PathFindFileName(inputFileFullPath);
+                    if (inputFileName != inputFileFullPath) {
+                        // 输入文件的文件名去除扩展名后的结果
+                        _tcsncpy(variableValueBuffer, inputFileName, (FILE_PATH_MAX_SIZE - 1));
+                        TCHAR *fileExtension = PathFindExtension(variableValueBuffer);
+                        if (*fileExtension == '.') {
+                            *fileExtension = _T('\0');
+                        }
+                    } else {
+                        // 查找输入文件路径中的文件名失败
+                        variableValueBuffer[0] = _T('\0');
+                    }
+                } else if (_tcscmp(_T("Ext"), variableNameBuffer) == 0) {
+                    TCHAR *inputFileExtension = PathFindExtension(inputFileFullPath);
+                    if (*inputFileExtension == '.') {
+                        // 输入文件的扩展名
+                        _tcsncpy(variableValueBuffer, inputFileExtension + 1, (FILE_PATH_MAX_SIZE - 1));
+                    } else {
+                        // 查找输入文件路径中的扩展名失败
+                        variableValueBuffer[0] = _T('\0');
+                    }
+                } else if (_tcscmp(_T("TrackName"), variableNameBuffer) == 0) {
+                    // 轨道名称
+                    _tcsncpy(variableValueBuffer, trackName, (FILE_PATH_MAX_SIZE - 1));
+
+                    containsTrackName = true;
+                } else {
+                    // 不合法的变量名
+                    MSG_ERROR(_T("Unrecognized variable name \"%s\"\n"),
+                            variableNameBuffer);
+                    return false;
+                }
+
+                variableValueBuffer[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+                size_t variableValueLength = _tcsclen(variableValueBuffer);
+                if ((destPtr + variableValueLength) >= destEnd) {
+                    // 变量值的长度超过 FILE_PATH_MAX_SIZE 的限制
+                    MSG_ERROR(_T("The variable value \"%s\" is too long\n"), variableValueBuffer);
+                    return false;
+                }
+                memcpy(destPtr, variableValueBuffer, variableValueLength * sizeof(TCHAR));
+                destPtr += variableValueLength;
+                srcPtr += 2 + variableNameLength + 1;   // 跳过已处理完的 $(VariableName) 形式的变量名
+                continue;
+            }
+        }
+
+        if ((destPtr + 1) >= destEnd) {
+            // dest 缓冲区已满
+            MSG_ERROR(_T("The concatenating output file path is already too long.\n"));
+            return false;
+        }
+        *(destPtr++) = *(srcPtr++);
+    }
+
+    if ((outputTrackCount > 1) && !containsTrackName) {
+        // 输出文件名格式字符串中不包含轨道名称
+        MSG_ERROR(_T("The output file path format must contain a \"$(TrackName)\" when output multiple tracks.\n"));
+        return false;
+    }
+
+    if ((destPtr + 1) >= destEnd) {
+        // dest 缓冲区已满
+        MSG_ERROR(_T("The concatenating output file path is already too long.\n"));
+        return false;
+    }
+    *(destPtr++) = _T('\0');
+
+    return true;
+}
+
+/**
+ * 尝试解析轨道名称
+ *
+ * 合法的轨道名称长度为 1 至 (TRACK_NAME_MAX_SIZE - 1) 个字符，仅可包含字母、数字和下划线
+ *
+ * @param   parsedTrackName     用于存放解析结果的字符数组
+ * @param   str                 要解析的文本
+ */
+static size_t _tryParseTrackName(TCHAR parsedTrackName[TRACK_NAME_MAX_SIZE], const TCHAR *str) {
+    size_t trackNameLength = _tcsspn(str, _T("0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_"));
+    if ((trackNameLength > 0) && (trackNameLength < TRACK_NAME_MAX_SIZE)) {
+        _tcsncpy(parsedTrackName, str, trackNameLength);
+        parsedTrackName[trackNameLength] = _T('\0');
+
+        return trackNameLength;
+    } else {
+        return 0;
+    }
+}
+
+/**
+ * 尝试解析源轨道的系数 (后面紧跟 '*' 的不超过 1000 的非负十进制数)
+ *
+ * 解析成功时将 *gain 乘以所解析的系数 (保留已解析的符号)
+ *
+ * @param   gain                用于存放解析结果的变量
+ * @param   str                 要解析的文本
+ *
+ * @return  返回包括 '*' 在内的已解析的字符数，不是系数时返回 0
+ */
+static size_t _tryParseGain(float *gain, const TCHAR *str) {
+    size_t numberLength = _tcsspn(str, _T("0123456789."));
+    if ((numberLength == 0) || (str[numberLength] != _T('*'))) {
+        return 0;
+    }
+
+    // 不使用 _tcstod()，以免小数点随区域设置变为 ','
+    const TCHAR *numberEnd = NULL;
+    double value = Common_parseDecimal(str, &numberEnd);
+    if ((numberEnd != (str + numberLength)) || !(value >= 0.0) || (value > 1000.0)) {
+        return 0;
+    }
+
+    *gain *= (float)value;
+
+    return (numberLength + 1);
+}
+
+/**
+ * 检查已选择的 Spleeter 模型中是否包含指定名称的输出轨道
+ *
+ * @param   modelInfo       指向 SpleeterModelInfo 结构体的指针
+ * @param   trackName       要检查的轨道名称
+ *
+ * @return  如果包含则返回 true, 否则返回 false
+ */
+static bool _checkSpleeterModelTrackName(const SpleeterModelInfo *modelInfo, const TCHAR *trackName) {
+    bool foundTrackName = false;
+    for (int i = 0; i < modelInfo->outputCount; i++) {
+        if (_tcscmp(trackName, modelInfo->trackNames[i]) == 0) {
+            foundTrackName = true;
+            break;
+        }
+    }
+
+    if (!foundTrackName) {
+        MSG_ERROR(_T("Specified track name \"%s\" does not exist in %s model.\n"), trackName, modelInfo->basicName);
+        return false;
+    }
+
+    return true;
+}
+
+bool TrackOutput_getFilePath(TCHAR *outputFilePathBuffer, const TCHAR *outputFilePathFormat,
+        int outputTrackCount, const TCHAR *outputTrackName, const TCHAR *inputFileFullPath) {
+    if (_tcsclen(outputFilePathFormat) == 0) {
+        // 检查 inputFileFullPath 加上 trackName 后是否超长
+        if (!_addExtraExtensionBeforeOriginalExtension(outputFilePathBuffer, FILE_PATH_MAX_SIZE,
+                inputFileFullPath, outputTrackName)) {
+            MSG_ERROR(_T("The output file path for track \"%s\" is too long.\n"), outputTrackName);
+            return false;
+        }
+        outputFilePathBuffer[FILE_PATH_MAX_SIZE - 1] = _T('\0');
+    } else {
+        if (!_convertOutputFilePathFormatString(outputFilePathBuffer, outputFilePathFormat,
+                inputFileFullPath, outputTrackName, outputTrackCount)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TrackOutput_getTrackFilePath(TCHAR *outputFilePathBuffer, const TrackOutputConfig *config,
+        const TCHAR *outputTrackName, const TCHAR *inputFileFullPath) {
+    if (!TrackOutput_getFilePath(outputFilePathBuffer, config->outputFilePathFormat,
+            TrackOutput_getTrackCount(config), outputTrackName, inputFileFullPath)) {
+        return false;
+    }
+
+    if ((config->rawFormat != RAW_FILE_FORMAT_NONE) && (_tcsclen(config->outputFilePathFormat) == 0)) {
+        // 将扩展名替换为直接写入格式的扩展名
+        TCHAR *extension = PathFindExtension(outputFilePathBuffer);
+        const TCHAR *rawExtension = RawFileWriter_getExtension(config->rawFormat);
+        if (((extension - outputFilePathBuffer) + _tcsclen(rawExtension)) >= FILE_PATH_MAX_SIZE) {
+            MSG_ERROR(_T("The output file path for track \"%s\" is too long.\n"), outputTrackName);
+            return false;
+        }
+        _tcscpy(extension, rawExtension);
+    }
+
+    return true;
+}
+
+/**
+ * 容器格式的信息
+ */
+typedef struct {
+    /** 输出文件格式字符串为空时使用的扩展名 */
+    const TCHAR         *extension;
+
+    /** FFmpeg 的输出格式名称 */
+    const char          *formatName;
+
+    /** 编码格式 */
+    enum AVCodecID      codecId;
+} TrackOutputContainerInfo;
+
+/**
+ * 获取容器格式的信息
+ */
+static const TrackOutputContainerInfo *_getContainerInfo(TrackOutputContainer container) {
+    static const TrackOutputContainerInfo containerInfos[] = {
+        [TRACK_OUTPUT_CONTAINER_MKA] = { _T(".stems.mka"), "matroska", AV_CODEC_ID_FLAC },
+        [TRACK_OUTPUT_CONTAINER_MP4] = { _T(".stems.mp4"), "mp4", AV_CODEC_ID_AAC },
+        [TRACK_OUTPUT_CONTAINER_NI_STEMS] = { _T(".stem.mp4"), "mp4", AV_CODEC_ID_AAC }
+    };
+
+    assert((container > TRACK_OUTPUT_CONTAINER_NONE) && (container <= TRACK_OUTPUT_CONTAINER_NI_STEMS));
+
+    return &containerInfos[container];
+}
+
+bool TrackOutput_getContainerFilePath(TCHAR *outputFilePathBuffer, const TrackOutputConfig *config,
+        const TCHAR *inputFileFullPath) {
+    if (_tcsclen(config->outputFilePathFormat) > 0) {
+        return _convertOutputFilePathFormatString(outputFilePathBuffer, config->outputFilePathFormat,
+                inputFileFullPath, _T("stems"), 1);
+    }
+
+    // 将输入文件的扩展名替换为容器格式对应的扩展名
+    const TCHAR *extension = _getContainerInfo(config->container)->extension;
+    const TCHAR *inputFileExtension = PathFindExtension(inputFileFullPath);
+    size_t baseLength = inputFileExtension - inputFileFullPath;
+    if ((baseLength + _tcsclen(extension)) >= FILE_PATH_MAX_SIZE) {
+        MSG_ERROR(_T("The output file path for \"%s\" is too long.\n"), inputFileFullPath);
+        return false;
+    }
+
+    memcpy(outputFilePathBuffer, inputFileFullPath, baseLength * sizeof(TCHAR));
+    _tcscpy(outputFilePathBuffer + baseLength, extension);
+
+    return true;
+}
+
+bool TrackOutput_checkFilePath(const TCHAR *outputFilePath, int overwriteFlag) {
+    // 流式输出不是普通文件，无需检查
+    if (AudioFileWriter_isStreamingOutput(outputFilePath)) {
+        return true;
+    }
+
+    // 如果 outputFilePath 存在
+    if (_taccess(outputFilePath, 0) != -1) {
+        // 如果未指定 --overwrite 选项
+        if (!overwriteFlag) {
+            MSG_ERROR(_T("The output file \"%s\" has already existed. Add --overwrite option to ignore.\n"), outputFilePath);
+            return false;
+        }
+
+        // 如果 outputFilePath 不可写入
+        if (_taccess(outputFilePath, 2) == -1) {
+            MSG_ERROR(_T("The output file \"%s\" cannot be written.\n"), outputFilePath);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TrackOutput_isStreamingOutput(const TrackOutputConfig *config) {
+    return AudioFileWriter_isStreamingOutput(config->outputFilePathFormat);
+}
+
+bool TrackOutput_parseBitrate(int *parsedResultBitrate, const TCHAR *optionValue) {
+    if (parsedResultBitrate == NULL) {
+        return false;
+    }
+
+    TCHAR optionValueBuffer[10] = { _T('\0') };
+    _tcsncpy(optionValueBuffer, optionValue, (10 - 1));
+    optionValueBuffer[10 - 1] = _T('\0');
+
+    size_t optionValueLength = _tcsclen(optionValueBuffer);
+
+    int multiplier;
+    if ((optionValueBuffer[optionValueLength - 1] == 'k')
+            || (optionValueBuffer[optionValueLength - 1] == 'K')) {
+        multiplier = 1000;
+    } else {
+        multiplier = 1;
+    }
+
+    unsigned long parsedValue = _tcstoul(optionValueBuffer, NULL, 10);
+    if (parsedValue >= 0) {
+        *parsedResultBitrate = parsedValue * multiplier;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool TrackOutput_parseTrackList(TrackList *parsedTrackList, const TCHAR *optionValue) {
+    memset(parsedTrackList, 0, sizeof(TrackList));
+
+    const TCHAR *p = optionValue;
+    const TCHAR *pEnd = p + _tcsclen(p);
+    while (p < pEnd) {
+        if (parsedTrackList->trackItemCount >= TRACK_ITEM_MAX_COUNT) {
+            return false;
+        }
+        TrackItem *trackItem = &parsedTrackList->trackItems[parsedTrackList->trackItemCount];
+
+        size_t trackNameLength = _tryParseTrackName(trackItem->trackName, p);
+        if (trackNameLength == 0) {
+            return false;
+        }
+        parsedTrackList->trackItemCount++;
+        p += trackNameLength;
+        if (p >= pEnd) {
+            break;
+        }
+
+        if (*p == _T(',')) {
+            p++;    // skip ','
+            continue;
+        }
+
+        if (*p == _T('=')) {
+            p++;    // skip '='
+            if (p >= pEnd) {
+                return false;
+            }
+
+            while (p < pEnd) {
+                if (trackItem->sourceTrackItemCount >= SOURCE_TRACK_MAX_COUNT) {
+                    return false;
+                }
+                SourceTrackItem *sourceTrackItem = &trackItem->sourceTrackItems[trackItem->sourceTrackItemCount];
+
+                if (*p == _T('-')) {
+                    sourceTrackItem->gain = -1.0f;
+                    p++;
+                } else {
+                    if (*p == _T('+')) {
+                        p++;
+                    }
+                    sourceTrackItem->gain = 1.0f;
+                }
+                if (p >= pEnd) {
+                    return false;
+                }
+
+                // 可选的系数，例如 "0.8*vocals" (数字开头的轨道名称后面不会紧跟 '*')
+                size_t gainLength = _tryParseGain(&sourceTrackItem->gain, p);
+                p += gainLength;
+                if (p >= pEnd) {
+                    return false;
+                }
+
+                size_t sourceTrackNameLength = _tryParseTrackName(sourceTrackItem->trackName, p);
+                if (sourceTrackNameLength == 0) {
+                    return false;
+                }
+                trackItem->sourceTrackItemCount++;
+                p += sourceTrackNameLength;
+                if (p >= pEnd) {
+                    break;
+                }
+
+                if (*p == _T(',')) {
+                    p++;
+                    break;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TrackOutput_checkTrackList(const SpleeterModelInfo *modelInfo, const TrackList *trackList) {
+    for (int i = 0; i < trackList->trackItemCount; i++) {
+        const TrackItem *trackItem = &trackList->trackItems[i];
+
+        if (trackItem->sourceTrackItemCount == 0) {
+            // 该 TrackItem 仅选择了一条已知的轨道，不涉及轨道更名或运算
+
+            // 检查轨道名称是否存在
+            if (!_checkSpleeterModelTrackName(modelInfo, trackItem->trackName)) {
+                return false;
+            }
+        } else {
+            // 该 TrackItem 指定了 source track list, 涉及轨道更名或运算
+
+            // 检查源轨道名称是否存在
+            for (int j = 0; j < trackItem->sourceTrackItemCount; j++) {
+                const SourceTrackItem *sourceTrackItem = &trackItem->sourceTrackItems[j];
+                if (_tcscmp(sourceTrackItem->trackName, _T("input")) == 0) {
+                    continue;
+                }
+                if (!_checkSpleeterModelTrackName(modelInfo, sourceTrackItem->trackName)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+int TrackOutput_getTrackCount(const TrackOutputConfig *config) {
+    if (config->trackList->trackItemCount == 0) {
+        return config->modelInfo->outputCount;
+    } else {
+        return config->trackList->trackItemCount;
+    }
+}
+
+const TCHAR *TrackOutput_getTrackName(const TrackOutputConfig *config, int index) {
+    if (config->trackList->trackItemCount == 0) {
+        return config->modelInfo->trackNames[index];
+    } else {
+        return config->trackList->trackItems[index].trackName;
+    }
+}
+
+/**
+ * 只读取了部分时间范围时，去掉输入和分离结果中仅作为模型上下文的部分
+ */
+static void _removeContext(AudioDataSource *inputAudioDataSource, SpleeterProcessorResult *result) {
+    int contextLengthAtBegin = inputAudioDataSource->contextLengthAtBegin;
+    int contextLengthAtEnd = inputAudioDataSource->contextLengthAtEnd;
+    if ((contextLengthAtBegin == 0) && (contextLengthAtEnd == 0)) {
+        return;
+    }
+
+    int length = inputAudioDataSource->sampleCountPerChannel - contextLengthAtBegin - contextLengthAtEnd;
+
+    for (int i = 0; i < result->trackCount; i++) {
+        AudioDataSource_trim(result->trackList[i].audioDataSource, contextLengthAtBegin, length);
+    }
+
+    AudioDataSource_trim(inputAudioDataSource, contextLengthAtBegin, length);
+    inputAudioDataSource->contextLengthAtBegin = 0;
+    inputAudioDataSource->contextLengthAtEnd = 0;
+}
+
+/**
+ * 将轨道条目编译为轨道运算表达式
+ *
+ * @param   expression              用于存放编译结果的结构体
+ * @param   trackName               轨道条目的轨道名称 (未指定 track list 时为模型中的轨道名称)
+ * @param   trackItem               轨道条目 (未指定 track list 时为 NULL)
+ * @param   inputAudioDataSource    输入音频数据源 (用于 "input" 轨道)
+ * @param   result                  分离结果
+ *
+ * @return  成功时返回 true, 源轨道不存在时返回 false
+ */
+static bool _compileTrackExpression(TrackMixExpression *expression, const TCHAR *trackName, const TrackItem *trackItem,
+        AudioDataSource *inputAudioDataSource, SpleeterProcessorResult *result) {
+    memset(expression, 0, sizeof(TrackMixExpression));
+
+    // 不涉及轨道更名或运算时，唯一的源轨道即为该轨道本身
+    int sourceCount = ((trackItem == NULL) || (trackItem->sourceTrackItemCount == 0)) ? 1 : trackItem->sourceTrackItemCount;
+
+    for (int j = 0; j < sourceCount; j++) {
+        const TCHAR *sourceTrackName = trackName;
+        float gain = 1.0f;
+        if ((trackItem != NULL) && (trackItem->sourceTrackItemCount > 0)) {
+            sourceTrackName = trackItem->sourceTrackItems[j].trackName;
+            gain = trackItem->sourceTrackItems[j].gain;
+        }
+
+        AudioDataSource *sourceTrackAudioDataSource = NULL;
+        if (_tcscmp(sourceTrackName, _T("input")) == 0) {
+            sourceTrackAudioDataSource = inputAudioDataSource;
+        } else {
+            SpleeterProcessorResultTrack *sourceTrack = SpleeterProcessorResult_getTrack(result, sourceTrackName);
+            if (sourceTrack == NULL) {
+                MSG_ERROR(_T("Track \"%s\" does not exist.\n"), sourceTrackName);
+                return false;
+            }
+
+            sourceTrackAudioDataSource = sourceTrack->audioDataSource;
+        }
+
+        expression->sourceSampleValues[j] = sourceTrackAudioDataSource->sampleValues;
+        expression->sourceGains[j] = gain;
+    }
+
+    expression->sourceCount = sourceCount;
+
+    return true;
+}
+
+/**
+ * 将每次写入的样本数调整为编码器帧大小的整数倍 (至少为一帧)，使写入的样本值不需要在 AudioFileWriter 中暂存
+ *
+ * @param   sampleCountPerChannel   期望的每声道样本数
+ * @param   frameSampleCount        编码器的帧大小 (每声道样本数)
+ *
+ * @return  返回调整后的每声道样本数
+ */
+static int _alignToFrameSize(int sampleCountPerChannel, int frameSampleCount) {
+    if (frameSampleCount <= 1) {
+        return sampleCountPerChannel;
+    }
+
+    return max(1, (sampleCountPerChannel / frameSampleCount)) * frameSampleCount;
+}
+
+/**
+ * 检查轨道运算表达式是否不需要运算 (可直接写入唯一源轨道的样本值)
+ */
+static bool _isDirectTrackExpression(const TrackMixExpression *expression) {
+    return (expression->sourceCount == 1) && (expression->sourceGains[0] == 1.0f);
+}
+
+/**
+ * 计算轨道运算表达式在指定范围内的结果
+ *
+ * 由 SampleMixer 在一次遍历中计算各源轨道的加权和，各源轨道只读取一次，结果只写入一次
+ *
+ * @param   expression              轨道运算表达式
+ * @param   position                范围的起始位置 (每声道样本数)
+ * @param   sampleCountPerChannel   范围的长度 (每声道样本数)
+ * @param   channelCount            声道数
+ * @param   dest                    用于存放计算结果的缓冲区
+ */
+static void _evaluateTrackExpression(const TrackMixExpression *expression, int position, int sampleCountPerChannel,
+        int channelCount, AudioSampleValue_t *dest) {
+    size_t sampleOffset = (size_t)position * channelCount;
+
+    const AudioSampleValue_t *sources[SOURCE_TRACK_MAX_COUNT];
+    for (int j = 0; j < expression->sourceCount; j++) {
+        sources[j] = expression->sourceSampleValues[j] + sampleOffset;
+    }
+
+    SampleMixer_mix(dest, sources, expression->sourceGains, expression->sourceCount,
+            ((size_t)sampleCountPerChannel * channelCount));
+}
+
+/**
+ * 按块计算需要运算的轨道并写入输出文件 (不保存整个轨道的计算结果)
+ *
+ * 每块计算完成后即送入编码器 (或直接写入文件)，计算结果在写入时仍在 CPU 缓存中
+ */
+static bool _writeComputedTrack(const TrackOutputConfig *config, const TCHAR *outputFilePath,
+        const TrackMixExpression *expression, int sampleCountPerChannel) {
+    int channelCount = config->sampleType.channelCount;
+    bool isRaw = (config->rawFormat != RAW_FILE_FORMAT_NONE);
+    int blockSampleCount = TRACK_RAW_WRITE_BLOCK_SAMPLE_COUNT;
+
+    RawFileWriter *rawFileWriter = NULL;
+    AudioFileWriter *audioFileWriter = NULL;
+    if (isRaw) {
+        rawFileWriter = RawFileWriter_open(outputFilePath, config->rawFormat, &config->sampleType, sampleCountPerChannel);
+        if (rawFileWriter == NULL) {
+            return false;
+        }
+    } else {
+        audioFileWriter = AudioFileWriter_open(outputFilePath, &config->outputAudioFileFormat, &config->sampleType);
+        if (audioFileWriter == NULL) {
+            return false;
+        }
+
+        // 每块为编码器帧大小的整数倍，计算结果直接送入编码器
+        blockSampleCount = _alignToFrameSize(TRACK_MIX_BLOCK_SAMPLE_COUNT, AudioFileWriter_getFrameSampleCount(audioFileWriter, 0));
+    }
+
+    AudioSampleValue_t *block = MEMORY_ALLOC_ARRAY(AudioSampleValue_t, (size_t)blockSampleCount * channelCount);
+
+    bool succeeded = true;
+    for (int offset = 0; succeeded && (offset < sampleCountPerChannel); offset += blockSampleCount) {
+        int length = min(blockSampleCount, (sampleCountPerChannel - offset));
+
+        _evaluateTrackExpression(expression, offset, length, channelCount, block);
+
+        if (isRaw) {
+            succeeded = RawFileWriter_write(rawFileWriter, block, length);
+        } else {
+            succeeded = (AudioFileWriter_write(audioFileWriter, block, length) == length);
+        }
+    }
+
+    Memory_free(&block);
+
+    if (isRaw) {
+        RawFileWriter_close(&rawFileWriter);
+    } else if (!AudioFileWriter_close(&audioFileWriter)) {
+        succeeded = false;
+    }
+
+    return succeeded;
+}
+
+/**
+ * 执行单个输出轨道的写入任务 (需要运算的轨道在写入时按块计算)
+ */
+static bool _runWriteJob(const TrackOutputWriteState *state, const TrackOutputWriteJob *job) {
+    const TrackOutputConfig *config = state->config;
+    const TrackMixExpression *expression = &job->expression;
+    int sampleCountPerChannel = state->inputAudioDataSource->sampleCountPerChannel;
+
+    bool written;
+    if (!_isDirectTrackExpression(expression)) {
+        written = _writeComputedTrack(config, job->outputFilePath, expression, sampleCountPerChannel);
+    } else if (config->rawFormat != RAW_FILE_FORMAT_NONE) {
+        // 不经过编码器，直接写入样本值
+        written = RawFileWriter_writeAll(job->outputFilePath, config->rawFormat, &config->sampleType,
+                expression->sourceSampleValues[0], sampleCountPerChannel);
+    } else {
+        written = AudioFile_writeAll(job->outputFilePath, &config->outputAudioFileFormat, &config->sampleType,
+                (void *)expression->sourceSampleValues[0], sampleCountPerChannel);
+    }
+
+    if (!written) {
+        MSG_ERROR(_T("Failed to write output file \"%s\".\n"), job->outputFilePath);
+        return false;
+    }
+
+    return true;
+}
+
+static unsigned __stdcall _writeThreadProc(void *arg) {
+    TrackOutputWriteState *state = (TrackOutputWriteState *)arg;
+
+    // 进度由调用 TrackOutput_writeFiles() 的线程统一输出
+    Common_setProgressMuted(true);
+
+    while (true) {
+        int jobIndex = (int)InterlockedIncrement(&state->nextJobIndex) - 1;
+        if (jobIndex >= state->jobCount) {
+            break;
+        }
+
+        // 已有任务失败时，跳过其余的任务
+        if (!state->failed && !_runWriteJob(state, &state->jobs[jobIndex])) {
+            state->failed = true;
+        }
+
+        EnterCriticalSection(&state->lock);
+        state->completedJobCount++;
+        LeaveCriticalSection(&state->lock);
+
+        WakeConditionVariable(&state->jobCompleted);
+    }
+
+    return 0;
+}
+
+/**
+ * 在当前线程中逐个执行所有写入任务，并输出进度
+ *
+ * @return  所有任务都成功时返回 true, 否则返回 false
+ */
+static bool _runWriteJobsInCurrentThread(const TrackOutputWriteState *state) {
+    for (int i = 0; i < state->jobCount; i++) {
+        if (!_runWriteJob(state, &state->jobs[i])) {
+            return false;
+        }
+
+        Common_updateProgress(STAGE_AUDIO_FILE_WRITER, (i + 1), state->jobCount);
+    }
+
+    return true;
+}
+
+/**
+ * 生成 NI Stems 格式的 stem box 的内容 (JSON 格式的分轨名称、颜色和母带处理参数，母带处理均未启用)
+ *
+ * @return  成功时返回生成的字符串 (UTF-8 编码)，失败时返回 NULL
+ */
+static char *_getNiStemsMetadata(const TrackOutputWriteJob *jobs) {
+    // 各分轨在播放器中显示的颜色
+    static const char *stemColors[TRACK_OUTPUT_NI_STEMS_TRACK_COUNT] = {
+        "#FF4A4A", "#FFA43C", "#3CC8FF", "#A05AFF"
+    };
+
+    size_t bufferSize = 4096;
+    char *buffer = MEMORY_ALLOC_ARRAY(char, bufferSize);
+    if (buffer == NULL) {
+        return NULL;
+    }
+
+    int length = snprintf(buffer, bufferSize,
+            "{\"version\":1,\"mastering_dsp\":{"
+            "\"compressor\":{\"enabled\":false,\"input_gain\":0.0,\"output_gain\":0.0,\"threshold\":0.0,"
+            "\"dry_wet\":100,\"attack\":0.003,\"release\":0.3,\"ratio\":3.0,\"hp_cutoff\":20},"
+            "\"limiter\":{\"enabled\":false,\"threshold\":0.0,\"ceiling\":-0.35,\"release\":0.05}},"
+            "\"stems\":[");
+
+    for (int i = 0; i < TRACK_OUTPUT_NI_STEMS_TRACK_COUNT; i++) {
+        // 轨道名称只包含字母、数字和下划线，无需转义
+        char *trackNameUtf8 = AudioFileCommon_getUtf8StringFromUnicodeString(jobs[i].trackName);
+        if (trackNameUtf8 == NULL) {
+            Memory_free(&buffer);
+            return NULL;
+        }
+
+        length += snprintf(buffer + length, bufferSize - length, "%s{\"name\":\"%s\",\"color\":\"%s\"}",
+                ((i > 0) ? "," : ""), trackNameUtf8, stemColors[i]);
+
+        Memory_free(&trackNameUtf8);
+    }
+
+    snprintf(buffer + length, bufferSize - length, "]}");
+
+    return buffer;
+}
+
+/**
+ * 将所有输出轨道作为音频流写入到同一个文件中
+ *
+ * 轮流向各音频流写入 1 秒的样本值，使各音频流的 packet 在文件中交错存放。需要运算的轨道在当前线程中按块计算，
+ * 各音频流的编码器的输出由同一个 muxer 交错写入
+ */
+static bool _writeContainerFile(const TrackOutputWriteState *state, const TCHAR *inputFileFullPath) {
+    const TrackOutputConfig *config = state->config;
+    const TrackOutputContainerInfo *containerInfo = _getContainerInfo(config->container);
+    int channelCount = config->sampleType.channelCount;
+    int sampleCountPerChannel = state->inputAudioDataSource->sampleCountPerChannel;
+
+    TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+    if (!TrackOutput_getContainerFilePath(outputFilePath, config, inputFileFullPath)) {
+        return false;
+    }
+
+    if (!TrackOutput_checkFilePath(outputFilePath, config->overwriteFlag)) {
+        return false;
+    }
+
+    TrackMixExpression streamExpressions[AUDIO_FILE_WRITER_MAX_STREAM_COUNT];
+    const TCHAR *streamTitles[AUDIO_FILE_WRITER_MAX_STREAM_COUNT] = { NULL };
+    int streamCount = 0;
+
+    // NI Stems 格式的第一个音频流为混音 (输入音频)
+    if (config->container == TRACK_OUTPUT_CONTAINER_NI_STEMS) {
+        if (state->jobCount != TRACK_OUTPUT_NI_STEMS_TRACK_COUNT) {
+            MSG_ERROR(_T("The NI Stems format requires exactly %d output tracks.\n"), TRACK_OUTPUT_NI_STEMS_TRACK_COUNT);
+            return false;
+        }
+
+        TrackMixExpression *masterExpression = &streamExpressions[streamCount];
+        memset(masterExpression, 0, sizeof(TrackMixExpression));
+        masterExpression->sourceCount = 1;
+        masterExpression->sourceSampleValues[0] = state->inputAudioDataSource->sampleValues;
+        masterExpression->sourceGains[0] = 1.0f;
+        streamTitles[streamCount] = _T("master");
+        streamCount++;
+    }
+
+    if ((streamCount + state->jobCount) > AUDIO_FILE_WRITER_MAX_STREAM_COUNT) {
+        MSG_ERROR(_T("Too many output tracks for a single file.\n"));
+        return false;
+    }
+
+    for (int i = 0; i < state->jobCount; i++) {
+        streamExpressions[streamCount] = state->jobs[i].expression;
+        streamTitles[streamCount] = state->jobs[i].trackName;
+        streamCount++;
+    }
+
+    AudioFileFormat fileFormat = config->outputAudioFileFormat;
+    fileFormat.formatName = containerInfo->formatName;
+    fileFormat.codecId = containerInfo->codecId;
+
+    AudioFileWriter *writer = AudioFileWriter_openStreams(outputFilePath, &fileFormat, &config->sampleType,
+            streamCount, streamTitles);
+    if (writer == NULL) {
+        MSG_ERROR(_T("Failed to write output file \"%s\".\n"), outputFilePath);
+        return false;
+    }
+
+    // 轮流向各音频流写入约 1 秒的样本值 (各音频流使用相同的编码器，按第一个音频流的帧大小对齐)
+    int frameSampleCount = AudioFileWriter_getFrameSampleCount(writer, 0);
+    int chunkLength = _alignToFrameSize(config->sampleType.sampleRate, frameSampleCount);
+    int blockSampleCount = _alignToFrameSize(TRACK_MIX_BLOCK_SAMPLE_COUNT, frameSampleCount);
+
+    AudioSampleValue_t *block = MEMORY_ALLOC_ARRAY(AudioSampleValue_t, (size_t)blockSampleCount * channelCount);
+
+    bool succeeded = true;
+    for (int offset = 0; succeeded && (offset < sampleCountPerChannel); offset += chunkLength) {
+        int length = min(chunkLength, (sampleCountPerChannel - offset));
+
+        for (int i = 0; succeeded && (i < streamCount); i++) {
+            const TrackMixExpression *expression = &streamExpressions[i];
+
+            if (_isDirectTrackExpression(expression)) {
+                void *sampleValues = (void *)(expression->sourceSampleValues[0] + ((size_t)offset * channelCount));
+                succeeded = (AudioFileWriter_writeStream(writer, i, sampleValues, length) == length);
+                continue;
+            }
+
+            // 需要运算的轨道按块计算，每块计算完成后即送入编码器
+            for (int blockBegin = 0; succeeded && (blockBegin < length); blockBegin += blockSampleCount) {
+                int blockLength = min(blockSampleCount, (length - blockBegin));
+                _evaluateTrackExpression(expression, (offset + blockBegin), blockLength, channelCount, block);
+                succeeded = (AudioFileWriter_writeStream(writer, i, block, blockLength) == blockLength);
+            }
+        }
+    }
+
+    Memory_free(&block);
+
+    if (!AudioFileWriter_close(&writer)) {
+        succeeded = false;
+    }
+
+    if (!succeeded) {
+        MSG_ERROR(_T("Failed to write output file \"%s\".\n"), outputFilePath);
+        return false;
+    }
+
+    if (config->container == TRACK_OUTPUT_CONTAINER_NI_STEMS) {
+        char *metadata = _getNiStemsMetadata(state->jobs);
+        if (metadata == NULL) {
+            return false;
+        }
+
+        bool added = AudioFileWriter_addMp4UserData(outputFilePath, "stem", metadata, (int)strlen(metadata));
+        Memory_free(&metadata);
+        if (!added) {
+            return false;
+        }
+    }
+
+    Common_updateProgress(STAGE_AUDIO_FILE_WRITER, 1, 1);
+
+    return true;
+}
+
+/**
+ * 获取同时写入输出轨道的线程数
+ */
+static int _getWriteThreadCount(const TrackOutputConfig *config, int jobCount) {
+    int threadCount = config->encodeThreadCount;
+
+    if (threadCount <= 0) {
+        // 自动选择，不超过处理器数
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        threadCount = (int)systemInfo.dwNumberOfProcessors;
+    }
+
+    return (threadCount < jobCount) ? threadCount : jobCount;
+}
+
+bool TrackOutput_writeFiles(const TrackOutputConfig *config, const TCHAR *inputFileFullPath,
+        AudioDataSource *inputAudioDataSource, SpleeterProcessorResult *result) {
+    const TrackList *trackList = config->trackList;
+
+    _removeContext(inputAudioDataSource, result);
+
+    // 先确定所有输出轨道的文件路径和数据，检查通过后再开始写入
+
+    TrackOutputWriteJob jobs[TRACK_ITEM_MAX_COUNT + SPLEETER_MODEL_MAX_OUTPUT_COUNT];
+    int jobCount = 0;
+
+    int outputTrackCount = TrackOutput_getTrackCount(config);
+    for (int i = 0; i < outputTrackCount; i++) {
+        TrackOutputWriteJob *job = &jobs[jobCount];
+        memset(job, 0, sizeof(TrackOutputWriteJob));
+
+        const TCHAR *trackName = TrackOutput_getTrackName(config, i);
+        const TrackItem *trackItem = (trackList->trackItemCount == 0) ? NULL : &trackList->trackItems[i];
+
+        // 需要运算的轨道在写入时按块计算
+        if (!_compileTrackExpression(&job->expression, trackName, trackItem, inputAudioDataSource, result)) {
+            return false;
+        }
+
+        job->trackName = trackName;
+
+        if (config->container == TRACK_OUTPUT_CONTAINER_NONE) {
+            if (!TrackOutput_getTrackFilePath(job->outputFilePath, config, trackName, inputFileFullPath)) {
+                return false;
+            }
+
+            if (!TrackOutput_checkFilePath(job->outputFilePath, config->overwriteFlag)) {
+                return false;
+            }
+        }
+
+        jobCount++;
+    }
+
+    TrackOutputWriteState state = {
+        .config = config,
+        .inputAudioDataSource = inputAudioDataSource,
+        .jobs = jobs,
+        .jobCount = jobCount
+    };
+
+    if (config->container != TRACK_OUTPUT_CONTAINER_NONE) {
+        return _writeContainerFile(&state, inputFileFullPath);
+    }
+
+    int threadCount = _getWriteThreadCount(config, jobCount);
+    if (threadCount <= 1) {
+        return _runWriteJobsInCurrentThread(&state);
+    }
+
+    // 各输出轨道在多个线程中同时编码，每个线程使用各自的 AudioFileWriter
+
+    InitializeCriticalSection(&state.lock);
+    InitializeConditionVariable(&state.jobCompleted);
+
+    HANDLE threadHandles[TRACK_ITEM_MAX_COUNT + SPLEETER_MODEL_MAX_OUTPUT_COUNT];
+    int startedThreadCount = 0;
+    for (int i = 0; i < threadCount; i++) {
+        threadHandles[i] = (HANDLE)_beginthreadex(NULL, 0, _writeThreadProc, &state, 0, NULL);
+        if (threadHandles[i] == NULL) {
+            MSG_WARNING(_T("Failed to start the output writing thread.\n"));
+            break;
+        }
+
+        startedThreadCount++;
+    }
+
+    if (startedThreadCount == 0) {
+        // 没有可用的线程，在当前线程中写入 (不经过 _writeThreadProc()，以免进度输出被关闭)
+        DeleteCriticalSection(&state.lock);
+        return _runWriteJobsInCurrentThread(&state);
+    }
+
+    // 等待所有任务完成，并在当前线程中输出进度
+    EnterCriticalSection(&state.lock);
+    int reportedJobCount = 0;
+    while (reportedJobCount < jobCount) {
+        while (state.completedJobCount == reportedJobCount) {
+            SleepConditionVariableCS(&state.jobCompleted, &state.lock, INFINITE);
+        }
+
+        reportedJobCount = state.completedJobCount;
+
+        LeaveCriticalSection(&state.lock);
+        Common_updateProgress(STAGE_AUDIO_FILE_WRITER, reportedJobCount, jobCount);
+        EnterCriticalSection(&state.lock);
+    }
+    LeaveCriticalSection(&state.lock);
+
+    for (int i = 0; i < startedThreadCount; i++) {
+        WaitForSingleObject(threadHandles[i], INFINITE);
+        CloseHandle(threadHandles[i]);
+    }
+
+    DeleteCriticalSection(&state.lock);
+
+    return !state.failed;
+}
+
+/**
+ * 获取指定名称的轨道在模型输出中的序号
+ *
+ * @return  成功时返回序号，"input" 返回 -1, 不存在时返回 -2
+ */
+static int _getModelTrackIndex(const SpleeterModelInfo *modelInfo, const TCHAR *trackName) {
+    if (_tcscmp(trackName, _T("input")) == 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < modelInfo->outputCount; i++) {
+        if (_tcscmp(trackName, modelInfo->trackNames[i]) == 0) {
+            return i;
+        }
+    }
+
+    return -2;
+}
+
+TrackOutputStream *TrackOutput_openStream(const TrackOutputConfig *config, const TCHAR *inputFileFullPath,
+        AudioDataSource *inputAudioDataSource) {
+    TrackOutputStream *obj = NULL;
+
+    if ((config->container == TRACK_OUTPUT_CONTAINER_NI_STEMS) || (config->rawFormat != RAW_FILE_FORMAT_NONE)) {
+        MSG_ERROR(_T("The NI Stems format and the raw output cannot be written as a stream.\n"));
+        goto err;
+    }
+
+    obj = MEMORY_ALLOC_STRUCT(TrackOutputStream);
+    if (obj == NULL) {
+        MSG_ERROR(_T("allocating TrackOutputStream struct failed\n"));
+        goto err;
+    }
+
+    obj->config = config;
+    obj->trackCount = TrackOutput_getTrackCount(config);
+    obj->_inputAudioDataSource = inputAudioDataSource;
+
+    // 确定各输出轨道的源轨道
+
+    const TCHAR *trackNames[TRACK_ITEM_MAX_COUNT + SPLEETER_MODEL_MAX_OUTPUT_COUNT] = { NULL };
+    for (int i = 0; i < obj->trackCount; i++) {
+        TrackOutputStreamTrack *track = &obj->_tracks[i];
+        trackNames[i] = TrackOutput_getTrackName(config, i);
+
+        const TrackItem *trackItem = (config->trackList->trackItemCount > 0) ? &config->trackList->trackItems[i] : NULL;
+        if ((trackItem == NULL) || (trackItem->sourceTrackItemCount == 0)) {
+            // 不涉及轨道更名或运算
+            track->_sourceCount = 1;
+            track->_sourceTrackIndexes[0] = _getModelTrackIndex(config->modelInfo, trackNames[i]);
+            track->_sourceGains[0] = 1.0f;
+        } else {
+            track->_sourceCount = trackItem->sourceTrackItemCount;
+            for (int j = 0; j < trackItem->sourceTrackItemCount; j++) {
+                track->_sourceTrackIndexes[j] = _getModelTrackIndex(config->modelInfo, trackItem->sourceTrackItems[j].trackName);
+                track->_sourceGains[j] = trackItem->sourceTrackItems[j].gain;
+            }
+        }
+
+        for (int j = 0; j < track->_sourceCount; j++) {
+            if (track->_sourceTrackIndexes[j] < -1) {
+                MSG_ERROR(_T("Source track of \"%s\" does not exist.\n"), trackNames[i]);
+                goto err;
+            }
+        }
+
+        if (config->container == TRACK_OUTPUT_CONTAINER_NONE) {
+            track->_writerIndex = i;
+            track->_streamIndex = 0;
+        } else {
+            track->_writerIndex = 0;
+            track->_streamIndex = i;
+        }
+    }
+
+    // 打开所有输出文件，之后每完成一个分段即写入
+
+    if (config->container == TRACK_OUTPUT_CONTAINER_NONE) {
+        for (int i = 0; i < obj->trackCount; i++) {
+            TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+            if (!TrackOutput_getTrackFilePath(outputFilePath, config, trackNames[i], inputFileFullPath)) {
+                goto err;
+            }
+
+            if (!TrackOutput_checkFilePath(outputFilePath, config->overwriteFlag)) {
+                goto err;
+            }
+
+            obj->_writers[i] = AudioFileWriter_open(outputFilePath, &config->outputAudioFileFormat, &config->sampleType);
+            if (obj->_writers[i] == NULL) {
+                MSG_ERROR(_T("Failed to open output file \"%s\".\n"), outputFilePath);
+                goto err;
+            }
+            obj->_writerCount++;
+        }
+    } else {
+        if (obj->trackCount > AUDIO_FILE_WRITER_MAX_STREAM_COUNT) {
+            MSG_ERROR(_T("Too many output tracks for a single file.\n"));
+            goto err;
+        }
+
+        TCHAR outputFilePath[FILE_PATH_MAX_SIZE] = { _T('\0') };
+        if (!TrackOutput_getContainerFilePath(outputFilePath, config, inputFileFullPath)) {
+            goto err;
+        }
+
+        if (!TrackOutput_checkFilePath(outputFilePath, config->overwriteFlag)) {
+            goto err;
+        }
+
+        const TrackOutputContainerInfo *containerInfo = _getContainerInfo(config->container);
+        AudioFileFormat fileFormat = config->outputAudioFileFormat;
+        fileFormat.formatName = containerInfo->formatName;
+        fileFormat.codecId = containerInfo->codecId;
+
+        obj->_writers[0] = AudioFileWriter_openStreams(outputFilePath, &fileFormat, &config->sampleType,
+                obj->trackCount, trackNames);
+        if (obj->_writers[0] == NULL) {
+            MSG_ERROR(_T("Failed to open output file \"%s\".\n"), outputFilePath);
+            goto err;
+        }
+        obj->_writerCount = 1;
+    }
+
+    // 各输出文件使用相同的编码器，按第一个音频流的帧大小对齐每次写入的样本数
+    int frameSampleCount = AudioFileWriter_getFrameSampleCount(obj->_writers[0], 0);
+    obj->_mixBlockSampleCountPerChannel = _alignToFrameSize(TRACK_MIX_BLOCK_SAMPLE_COUNT, frameSampleCount);
+    obj->_chunkSampleCountPerChannel = _alignToFrameSize(config->sampleType.sampleRate, frameSampleCount);
+
+    obj->_mixBlock = MEMORY_ALLOC_ARRAY(AudioSampleValue_t, (size_t)obj->_mixBlockSampleCountPerChannel * config->sampleType.channelCount);
+
+    return obj;
+
+err:
+    if (obj != NULL) {
+        TrackOutput_closeStream(&obj);
+    }
+
+    return NULL;
+}
+
+/**
+ * 将输出轨道在分段中指定范围内的样本值写入输出文件，需要运算的轨道按块计算后写入
+ *
+ * @param   position                范围在整个音频中的起始位置 (每声道样本数)
+ * @param   sampleCountPerChannel   范围的长度 (每声道样本数)
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+static bool _writeStreamTrack(TrackOutputStream *obj, const TrackOutputStreamTrack *track,
+        const SpleeterProcessorSegment *segment, int position, int sampleCountPerChannel) {
+    AudioFileWriter *writer = obj->_writers[track->_writerIndex];
+    int channelCount = obj->config->sampleType.channelCount;
+    size_t segmentSampleOffset = (size_t)(position - segment->offset) * channelCount;
+    size_t inputSampleOffset = (size_t)position * channelCount;
+
+    // 以范围的起始位置为各源轨道的起点编译轨道运算表达式
+    TrackMixExpression expression = { .sourceCount = track->_sourceCount };
+    for (int j = 0; j < track->_sourceCount; j++) {
+        int trackIndex = track->_sourceTrackIndexes[j];
+        if (trackIndex < 0) {
+            expression.sourceSampleValues[j] = obj->_inputAudioDataSource->sampleValues + inputSampleOffset;
+        } else {
+            expression.sourceSampleValues[j] = (const AudioSampleValue_t *)segment->trackSampleValues[trackIndex] + segmentSampleOffset;
+        }
+        expression.sourceGains[j] = track->_sourceGains[j];
+    }
+
+    // 不涉及运算时直接写入源轨道的样本值
+    if (_isDirectTrackExpression(&expression)) {
+        return (AudioFileWriter_writeStream(writer, track->_streamIndex, (void *)expression.sourceSampleValues[0],
+                sampleCountPerChannel) == sampleCountPerChannel);
+    }
+
+    // 计算结果写入后即可重用 _mixBlock (AudioFileWriter_writeStream() 返回后不再引用其数据)
+    for (int blockBegin = 0; blockBegin < sampleCountPerChannel; blockBegin += obj->_mixBlockSampleCountPerChannel) {
+        int blockLength = min(obj->_mixBlockSampleCountPerChannel, (sampleCountPerChannel - blockBegin));
+        _evaluateTrackExpression(&expression, blockBegin, blockLength, channelCount, obj->_mixBlock);
+        if (AudioFileWriter_writeStream(writer, track->_streamIndex, obj->_mixBlock, blockLength) != blockLength) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TrackOutput_writeSegment(void *userData, const SpleeterProcessorSegment *segment) {
+    TrackOutputStream *obj = (TrackOutputStream *)userData;
+    const AudioDataSource *inputAudioDataSource = obj->_inputAudioDataSource;
+
+    // 去掉仅作为模型上下文的部分
+    int outputBegin = inputAudioDataSource->contextLengthAtBegin;
+    int outputEnd = inputAudioDataSource->sampleCountPerChannel - inputAudioDataSource->contextLengthAtEnd;
+    int begin = max(segment->offset, outputBegin);
+    int end = min((segment->offset + segment->length), outputEnd);
+    if (begin >= end) {
+        return true;
+    }
+    int length = end - begin;
+
+    // 写入单个文件时，各音频流轮流写入约 1 秒的样本值，使 packet 在文件中交错存放
+    int chunkLength = (obj->config->container == TRACK_OUTPUT_CONTAINER_NONE) ? length : obj->_chunkSampleCountPerChannel;
+
+    for (int chunkBegin = 0; chunkBegin < length; chunkBegin += chunkLength) {
+        int chunkSampleCountPerChannel = min(chunkLength, (length - chunkBegin));
+
+        for (int i = 0; i < obj->trackCount; i++) {
+            if (!_writeStreamTrack(obj, &obj->_tracks[i], segment, (begin + chunkBegin), chunkSampleCountPerChannel)) {
+                MSG_ERROR(_T("Failed to write output track \"%s\".\n"), TrackOutput_getTrackName(obj->config, i));
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TrackOutput_closeStream(TrackOutputStream **objPtr) {
+    if ((objPtr == NULL) || (*objPtr == NULL)) {
+        return false;
+    }
+
+    TrackOutputStream *obj = *objPtr;
+    bool succeeded = true;
+
+    // 其中一个文件关闭失败时，仍然关闭其余的文件
+    for (int i = 0; i < obj->_writerCount; i++) {
+        if (!AudioFileWriter_close(&obj->_writers[i])) {
+            succeeded = false;
+        }
+    }
+
+    if (obj->_mixBlock != NULL) {
+        Memory_free(&obj->_mixBlock);
+    }
+
+    Memory_free(objPtr);
+
+    return succeeded;
+}
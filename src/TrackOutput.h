@@ -0,0 +1,356 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 Wudi <wudi@wudilabs.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _TRACK_OUTPUT_H_
+#define _TRACK_OUTPUT_H_
+
+#include "Common.h"
+#include "AudioFile.h"
+#include "RawFileWriter.h"
+#include "SpleeterProcessor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** TrackList 中 TrackItem 的最大数量 */
+#define TRACK_ITEM_MAX_COUNT        10
+
+/** TrackItem 中 SourceTrackItem 的最大数量 */
+#define SOURCE_TRACK_MAX_COUNT      10
+
+/** trackName 字符数组的大小 */
+#define TRACK_NAME_MAX_SIZE         100
+
+/**
+ * 源轨道条目
+ */
+typedef struct {
+    /** 混音时该轨道的系数 (减去该轨道时为负数) */
+    float   gain;
+
+    /** 轨道名称 (vocals, drums, ...) */
+    TCHAR   trackName[TRACK_NAME_MAX_SIZE];
+} SourceTrackItem;
+
+/**
+ * 轨道条目
+ */
+typedef struct {
+    /** 轨道名称 (当源轨道条目列表不为空时，为最终输出的轨道名称；否则为 Spleeter 模型中的轨道名称) */
+    TCHAR               trackName[TRACK_NAME_MAX_SIZE];
+
+    /** 源轨道条目列表 */
+    SourceTrackItem     sourceTrackItems[SOURCE_TRACK_MAX_COUNT];
+
+    /** 源轨道条目数量 */
+    int                 sourceTrackItemCount;
+} TrackItem;
+
+/**
+ * 轨道列表
+ */
+typedef struct {
+    /** 轨道条目列表 */
+    TrackItem   trackItems[TRACK_ITEM_MAX_COUNT];
+
+    /** 轨道条目数量 */
+    int         trackItemCount;
+} TrackList;
+
+/**
+ * 将所有输出轨道写入单个文件时使用的容器格式
+ */
+typedef enum {
+    /** 每个输出轨道写入单独的文件 */
+    TRACK_OUTPUT_CONTAINER_NONE = 0,
+
+    /** 所有输出轨道作为音频流写入一个 Matroska 文件 (FLAC 编码) */
+    TRACK_OUTPUT_CONTAINER_MKA,
+
+    /** 所有输出轨道作为音频流写入一个 MP4 文件 (AAC 编码) */
+    TRACK_OUTPUT_CONTAINER_MP4,
+
+    /** NI Stems 格式 (.stem.mp4): 第一个音频流为输入音频 (混音)，之后为 4 个输出轨道 */
+    TRACK_OUTPUT_CONTAINER_NI_STEMS
+} TrackOutputContainer;
+
+/** NI Stems 格式所需的输出轨道数量 */
+#define TRACK_OUTPUT_NI_STEMS_TRACK_COUNT   4
+
+/**
+ * 轨道输出配置
+ */
+typedef struct {
+    /** 所使用模型的信息 */
+    const SpleeterModelInfo     *modelInfo;
+
+    /** 输出文件路径格式字符串 */
+    const TCHAR                 *outputFilePathFormat;
+
+    /** 输出轨道列表 (trackItemCount 为 0 时输出模型的所有轨道) */
+    const TrackList             *trackList;
+
+    /** 当目标输出文件已存在时，是否允许覆盖 */
+    int                         overwriteFlag;
+
+    /** 输出文件格式 */
+    AudioFileFormat             outputAudioFileFormat;
+
+    /** 输出样本类型 */
+    AudioSampleType             sampleType;
+
+    /** 同时编码输出轨道的线程数，为 0 时自动选择 (不超过处理器数)，为 1 时逐个编码 */
+    int                         encodeThreadCount;
+
+    /** 将所有输出轨道写入单个文件时使用的容器格式，为 TRACK_OUTPUT_CONTAINER_NONE 时每个轨道写入单独的文件 */
+    TrackOutputContainer        container;
+
+    /** 不经过编码器直接写入样本值的输出文件格式，为 RAW_FILE_FORMAT_NONE 时通过编码器写入 */
+    RawFileFormat               rawFormat;
+} TrackOutputConfig;
+
+/**
+ * 获取输出文件路径
+ *
+ * @param   outputFilePathBuffer    用于存储输出文件路径的缓冲区
+ * @param   outputFilePathFormat    输出文件路径格式字符串 (为空时将直接在 inputFileFullPath 的原有扩展名前添加 outputTrackName)
+ * @param   outputTrackCount        输出轨道的总数量
+ * @param   outputTrackName         当前输出轨道名称
+ * @param   inputFileFullPath       输入音频文件的完整路径
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool TrackOutput_getFilePath(TCHAR *outputFilePathBuffer, const TCHAR *outputFilePathFormat,
+        int outputTrackCount, const TCHAR *outputTrackName, const TCHAR *inputFileFullPath);
+
+/**
+ * 获取指定输出轨道的输出文件路径
+ *
+ * 同 TrackOutput_getFilePath()，但输出文件路径格式字符串为空且指定了 config->rawFormat 时，
+ * 将扩展名替换为相应格式的扩展名
+ *
+ * @param   outputFilePathBuffer    用于存储输出文件路径的缓冲区
+ * @param   config                  输出配置
+ * @param   outputTrackName         当前输出轨道名称
+ * @param   inputFileFullPath       输入音频文件的完整路径
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool TrackOutput_getTrackFilePath(TCHAR *outputFilePathBuffer, const TrackOutputConfig *config,
+        const TCHAR *outputTrackName, const TCHAR *inputFileFullPath);
+
+/**
+ * 获取将所有输出轨道写入单个文件时的输出文件路径
+ *
+ * 输出文件路径格式字符串为空时，将 inputFileFullPath 的扩展名替换为容器格式对应的扩展名
+ * (.stems.mka, .stems.mp4, .stem.mp4)，否则按格式字符串生成，其中 $(TrackName) 为 "stems"
+ *
+ * @param   outputFilePathBuffer    用于存储输出文件路径的缓冲区
+ * @param   config                  输出配置 (config->container 不为 TRACK_OUTPUT_CONTAINER_NONE)
+ * @param   inputFileFullPath       输入音频文件的完整路径
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool TrackOutput_getContainerFilePath(TCHAR *outputFilePathBuffer, const TrackOutputConfig *config,
+        const TCHAR *inputFileFullPath);
+
+/**
+ * 检查指定的输出文件路径是否可用
+ *
+ * 标准输出、管道和命名管道等流式输出总是可用
+ *
+ * @param   outputFilePath      要检查的输出文件路径
+ * @param   overwriteFlag       当指定路径的输出文件已存在时，是否允许覆盖
+ *
+ * @return  如果指定路径的文件已存在，或不可覆盖，或不可写入，则返回 false, 否则返回 true
+ */
+bool TrackOutput_checkFilePath(const TCHAR *outputFilePath, int overwriteFlag);
+
+/**
+ * 检查输出文件路径格式字符串是否表示流式输出 (标准输出、管道或命名管道)
+ *
+ * 流式输出时应通过 TrackOutput_openStream() 在每个分段完成时即写入，而不是在分离完成后写入
+ */
+bool TrackOutput_isStreamingOutput(const TrackOutputConfig *config);
+
+/**
+ * 尝试解析比特率数值
+ *
+ * @param   parsedResultBitrate     指向用于存储解析结果的变量的指针
+ * @param   optionValue             要解析的文本 (可为纯数字，也可包含 'k' 或 'K' 单位后缀)
+ *
+ * @return  解析成功时返回 true, 失败时返回 false
+ */
+bool TrackOutput_parseBitrate(int *parsedResultBitrate, const TCHAR *optionValue);
+
+/**
+ * 尝试解析轨道列表表达式
+ *
+ * @param   parsedTrackList     用于存放解析结果的结构体
+ * @param   optionValue         要解析的文本
+ *
+ * @return  解析成功时返回 true, 失败时返回 false
+ */
+bool TrackOutput_parseTrackList(TrackList *parsedTrackList, const TCHAR *optionValue);
+
+/**
+ * 检查轨道列表中的轨道名称在已选择的 Spleeter 模型中是否都存在
+ *
+ * @param   modelInfo       指向 SpleeterModelInfo 结构体的指针
+ * @param   trackList       要检查的轨道列表
+ *
+ * @return  如果都存在则返回 true, 否则返回 false
+ */
+bool TrackOutput_checkTrackList(const SpleeterModelInfo *modelInfo, const TrackList *trackList);
+
+/**
+ * 获取要输出轨道的数量
+ */
+int TrackOutput_getTrackCount(const TrackOutputConfig *config);
+
+/**
+ * 获取指定输出轨道的名称
+ */
+const TCHAR *TrackOutput_getTrackName(const TrackOutputConfig *config, int index);
+
+/**
+ * 将分离结果按输出配置写入到输出文件
+ *
+ * 输入只读取了部分时间范围时，先去掉输入和分离结果中仅作为模型上下文的部分。
+ * 所有输出文件路径都检查通过后才开始写入，各输出轨道 (包括需要运算的轨道) 按 config->encodeThreadCount
+ * 在多个线程中同时编码，进度在调用者线程中输出。指定了 config->container 时，所有输出轨道作为音频流
+ * 交错写入到同一个文件中
+ *
+ * @param   config                  输出配置
+ * @param   inputFileFullPath       输入文件的完整路径
+ * @param   inputAudioDataSource    输入音频数据源 (用于 "input" 轨道)
+ * @param   result                  分离结果
+ *
+ * @return  成功时返回 true, 失败时返回 false
+ */
+bool TrackOutput_writeFiles(const TrackOutputConfig *config, const TCHAR *inputFileFullPath,
+        AudioDataSource *inputAudioDataSource, SpleeterProcessorResult *result);
+
+/**
+ * 逐段写入时单个输出轨道的数据来源 (仅内部使用)
+ */
+typedef struct {
+    /** 写入的 AudioFileWriter 在 _writers 中的序号 */
+    int                 _writerIndex;
+
+    /** 在 AudioFileWriter 中的音频流序号 */
+    int                 _streamIndex;
+
+    /** 源轨道数量 (为 1 且系数为 1 时直接写入该源轨道) */
+    int                 _sourceCount;
+
+    /** 各源轨道在模型输出中的序号 (-1 表示输入音频) */
+    int                 _sourceTrackIndexes[SOURCE_TRACK_MAX_COUNT];
+
+    /** 各源轨道的系数 */
+    float               _sourceGains[SOURCE_TRACK_MAX_COUNT];
+} TrackOutputStreamTrack;
+
+/**
+ * 逐段写入输出文件的上下文数据
+ *
+ * 每完成一个分段即将其写入所有输出文件，用于标准输出和命名管道等流式输出，使输出不必等待所有分段完成
+ *
+ * 此处未通过不透明结构体 (opaque structure) 的方式隐藏 private 成员，目的是便于 debug
+ */
+typedef struct {
+    // 以下部分为 public 成员，只读
+
+    /** 输出配置 */
+    const TrackOutputConfig     *config;
+
+    /** 输出轨道数量 */
+    int                         trackCount;
+
+    // 以下部分为 private 成员，仅内部使用
+
+    /** 输入音频数据源 (用于 "input" 轨道和去掉上下文部分) */
+    AudioDataSource             *_inputAudioDataSource;
+
+    /** 各输出文件的 AudioFileWriter (写入单个文件时只有一个) */
+    AudioFileWriter             *_writers[TRACK_ITEM_MAX_COUNT + SPLEETER_MODEL_MAX_OUTPUT_COUNT];
+
+    /** AudioFileWriter 的数量 */
+    int                         _writerCount;
+
+    /** 各输出轨道 */
+    TrackOutputStreamTrack      _tracks[TRACK_ITEM_MAX_COUNT + SPLEETER_MODEL_MAX_OUTPUT_COUNT];
+
+    /** 按块计算需要运算的轨道时使用的缓冲区 */
+    AudioSampleValue_t          *_mixBlock;
+
+    /** _mixBlock 所能容纳的每声道样本数 (编码器帧大小的整数倍) */
+    int                         _mixBlockSampleCountPerChannel;
+
+    /** 写入单个文件时，各音频流每次轮流写入的每声道样本数 (编码器帧大小的整数倍) */
+    int                         _chunkSampleCountPerChannel;
+} TrackOutputStream;
+
+/**
+ * 打开所有输出文件，准备逐段写入
+ *
+ * 不支持 NI Stems 格式和 config->rawFormat (都需要在写入完成后回写文件)
+ *
+ * @param   config                  输出配置
+ * @param   inputFileFullPath       输入文件的完整路径
+ * @param   inputAudioDataSource    输入音频数据源 (在调用 TrackOutput_closeStream() 之前应保持有效)
+ *
+ * @return  成功时返回所创建的 TrackOutputStream 对象，失败时返回 NULL
+ */
+TrackOutputStream *TrackOutput_openStream(const TrackOutputConfig *config, const TCHAR *inputFileFullPath,
+        AudioDataSource *inputAudioDataSource);
+
+/**
+ * 将一个分段的分离结果写入所有输出文件 (可直接作为 SpleeterProcessor_splitWithCallback() 的回调函数)
+ *
+ * 分段中仅作为模型上下文的部分 (只读取了部分时间范围时) 不会写入。分段的样本值在写入时送入编码器，
+ * 不足一帧的部分复制到 AudioFileWriter 内部暂存，本函数返回后不再引用 segment->trackSampleValues
+ *
+ * @param   userData        指向 TrackOutputStream 对象的指针
+ * @param   segment         分段结果
+ *
+ * @return  成功时返回 true, 失败时返回 false (此时应中止分离)
+ */
+bool TrackOutput_writeSegment(void *userData, const SpleeterProcessorSegment *segment);
+
+/**
+ * 关闭所有输出文件
+ *
+ * @param   objPtr          指向 TrackOutputStream 对象的指针的指针
+ *
+ * @return  所有输出文件都成功写入时返回 true, 否则返回 false
+ */
+bool TrackOutput_closeStream(TrackOutputStream **objPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TRACK_OUTPUT_H_